@@ -9,7 +9,10 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <array>
 #include <vector>
 
@@ -17,17 +20,66 @@
 // CONFIGURATION
 // ============================================================================
 
-constexpr uint32_t MAX_MILESTONES_PER_AGREEMENT = 10;
-constexpr uint32_t MAX_AGREEMENTS = 10000;
+// A vault's shape is fixed at compile time by a configuration type: slot and
+// milestone capacities, which text fields it stores (0 bytes drops the field
+// from the layout), the release fee and feature toggles. The contract's types
+// are templates over it; the plain names (Agreement, PronexmaVaultState,
+// PronexmaVaultEngine, MAX_AGREEMENTS, ...) are DefaultVaultConfig's.
+struct DefaultVaultConfig {
+    static constexpr uint32_t MAX_AGREEMENTS = 10000;
+    static constexpr uint32_t MAX_MILESTONES = 10;       // Per agreement
+    static constexpr uint32_t TITLE_BYTES = 256;         // Agreement title, terminating NUL included
+    static constexpr uint32_t METADATA_BYTES = 512;      // Agreement metadata (JSON string)
+    static constexpr uint32_t DESCRIPTION_BYTES = 128;   // Milestone description
+    static constexpr uint32_t FEE_BASIS_POINTS = 50;     // Protocol fee withheld from each release
+    static constexpr bool STORE_EVIDENCE = true;         // Keep the oracle's evidence hash per milestone
+    static constexpr bool COUNT_PERFORMANCE = true;      // Per-procedure counters (getPerfCounters)
+    static constexpr uint32_t TICK_BUCKETS = 4096;       // Buckets per tick-activity tree (a power of two)
+    static constexpr uint32_t TICK_BUCKET_SHIFT = 6;     // Initial bucket width: 2^6 ticks
+};
+
+// Invoices: a few milestones and a short reference, no free text.
+struct LeanInvoiceVaultConfig : DefaultVaultConfig {
+    static constexpr uint32_t MAX_MILESTONES = 4;
+    static constexpr uint32_t TITLE_BYTES = 64;
+    static constexpr uint32_t METADATA_BYTES = 0;
+    static constexpr uint32_t DESCRIPTION_BYTES = 0;
+};
+
+// Launchpads: many raises released in tranches; no prose, no counters.
+struct LaunchpadVaultConfig : DefaultVaultConfig {
+    static constexpr uint32_t MAX_AGREEMENTS = 100000;
+    static constexpr uint32_t MAX_MILESTONES = 5;
+    static constexpr uint32_t TITLE_BYTES = 64;
+    static constexpr uint32_t METADATA_BYTES = 0;
+    static constexpr uint32_t DESCRIPTION_BYTES = 0;
+    static constexpr uint32_t FEE_BASIS_POINTS = 100;
+    static constexpr bool COUNT_PERFORMANCE = false;
+};
+
+constexpr uint32_t MAX_MILESTONES_PER_AGREEMENT = DefaultVaultConfig::MAX_MILESTONES;
+constexpr uint32_t MAX_AGREEMENTS = DefaultVaultConfig::MAX_AGREEMENTS;
 constexpr uint32_t AGREEMENT_ID_PREFIX = 0x50524E58; // "PRNX" in hex
 constexpr uint64_t REFUND_TIMEOUT_TICKS = 1000000;   // Ticks before refund eligible
 
+// Audit builds check the accounting identities after every procedure (see
+// ACCOUNTING). Debug builds audit unless PRONEXMA_VAULT_AUDIT=0; release
+// builds only when PRONEXMA_VAULT_AUDIT=1.
+#ifndef PRONEXMA_VAULT_AUDIT
+#ifdef NDEBUG
+#define PRONEXMA_VAULT_AUDIT 0
+#else
+#define PRONEXMA_VAULT_AUDIT 1
+#endif
+#endif
+
 // ============================================================================
 // TYPE DEFINITIONS
 // ============================================================================
 
-// Qubic address type (60 characters typically, using fixed array)
-using QubicAddress = std::array<char, 64>;
+// Qubic address: the account's 32-byte public key. Its 60-letter identity text
+// exists only at the host boundary (host/VaultIdentity.h).
+using QubicAddress = std::array<uint8_t, 32>;
 using TransactionId = std::array<uint8_t, 32>;
 
 // Agreement states
@@ -39,6 +91,7 @@ enum class AgreementState : uint8_t {
     REFUNDED = 4,     // Agreement cancelled, funds returned
     DISPUTED = 5      // Under dispute (future: DAO resolution)
 };
+constexpr uint32_t AGREEMENT_STATE_COUNT = 6;
 
 // Milestone states
 enum class MilestoneState : uint8_t {
@@ -52,17 +105,34 @@ enum class MilestoneState : uint8_t {
 // DATA STRUCTURES
 // ============================================================================
 
-struct Milestone {
+// Optional fields sit in bases that are empty when the configuration drops
+// them, so a dropped field takes no bytes. With every field enabled the
+// layout is byte for byte the flat struct snapshots were written with.
+template <uint32_t Bytes> struct MilestoneDescriptionField {
+    std::array<char, Bytes> description;   // Description/title
+};
+template <> struct MilestoneDescriptionField<0> {};
+
+template <bool Stored> struct MilestoneEvidenceField {
+    std::array<uint8_t, 64> evidenceHash;  // Hash of verification evidence
+};
+template <> struct MilestoneEvidenceField<false> {};
+
+struct MilestoneFields {
     uint32_t id;                           // Milestone ID within agreement
     uint64_t amount;                       // Amount to release (in QU)
     MilestoneState state;                  // Current state
     uint64_t verifiedAtTick;               // Tick when verified (0 if not)
     uint64_t releasedAtTick;               // Tick when released (0 if not)
-    std::array<char, 128> description;     // Description/title
-    std::array<uint8_t, 64> evidenceHash;  // Hash of verification evidence
 };
 
-struct Agreement {
+template <typename Config>
+struct BasicMilestone : MilestoneFields,
+                        MilestoneDescriptionField<Config::DESCRIPTION_BYTES>,
+                        MilestoneEvidenceField<Config::STORE_EVIDENCE> {};
+
+template <typename Config>
+struct AgreementFields {
     uint64_t id;                           // Unique agreement ID
     QubicAddress payer;                    // Address that deposits funds
     QubicAddress beneficiary;              // Address that receives releases
@@ -79,17 +149,515 @@ struct Agreement {
     uint64_t timeoutTick;                  // Tick after which refund is allowed
     
     uint32_t milestoneCount;               // Number of milestones
-    std::array<Milestone, MAX_MILESTONES_PER_AGREEMENT> milestones;
-    
-    std::array<char, 256> title;           // Agreement title
-    std::array<char, 512> metadata;        // Additional metadata (JSON string)
+    std::array<BasicMilestone<Config>, Config::MAX_MILESTONES> milestones;
+};
+
+template <uint32_t Bytes> struct AgreementTitleField {
+    std::array<char, Bytes> title;         // Agreement title
+};
+template <> struct AgreementTitleField<0> {};
+
+template <uint32_t Bytes> struct AgreementMetadataField {
+    std::array<char, Bytes> metadata;      // Additional metadata (JSON string)
+};
+template <> struct AgreementMetadataField<0> {};
+
+template <typename Config>
+struct BasicAgreement : AgreementFields<Config>,
+                        AgreementTitleField<Config::TITLE_BYTES>,
+                        AgreementMetadataField<Config::METADATA_BYTES> {};
+
+// Longest title a vault stores; the field keeps a terminating NUL.
+template <typename Config>
+constexpr uint32_t titleCapacity() {
+    return Config::TITLE_BYTES == 0 ? 0 : Config::TITLE_BYTES - 1;
+}
+
+using Milestone = BasicMilestone<DefaultVaultConfig>;
+using Agreement = BasicAgreement<DefaultVaultConfig>;
+static_assert(sizeof(Milestone) == 232 && sizeof(Agreement) == 3256,
+              "default record layout changed: bump SNAPSHOT_LAYOUT_VERSION and add a migration");
+
+// ============================================================================
+// PERFORMANCE COUNTERS
+// ============================================================================
+
+// Procedures that count calls. Views are not counted: on-chain they cannot
+// write contract state.
+enum class VaultProcedure : uint8_t {
+    CREATE_AGREEMENT = 0,
+    DEPOSIT = 1,
+    MARK_MILESTONE_VERIFIED = 2,
+    RELEASE_MILESTONE = 3,
+    REFUND = 4,
+    SET_FEE_RECIPIENT = 5
+};
+constexpr uint32_t VAULT_PROCEDURE_COUNT = 6;
+
+inline const char* vaultProcedureName(VaultProcedure procedure) {
+    switch (procedure) {
+        case VaultProcedure::CREATE_AGREEMENT: return "createAgreement";
+        case VaultProcedure::DEPOSIT: return "deposit";
+        case VaultProcedure::MARK_MILESTONE_VERIFIED: return "markMilestoneVerified";
+        case VaultProcedure::RELEASE_MILESTONE: return "releaseMilestone";
+        case VaultProcedure::REFUND: return "refund";
+        case VaultProcedure::SET_FEE_RECIPIENT: return "setFeeRecipient";
+    }
+    return "unknown";
+}
+
+// Why a procedure returned its error value.
+enum class VaultError : uint8_t {
+    NONE = 0,
+    AGREEMENT_NOT_FOUND = 1,
+    INVALID_ADDRESS = 2,
+    INVALID_MILESTONE_COUNT = 3,
+    CAPACITY_REACHED = 4,
+    AMOUNT_MISMATCH = 5,      // Milestones don't sum to the total
+    NOT_PAYER = 6,
+    NOT_ORACLE = 7,
+    INVALID_STATE = 8,        // Agreement state does not allow the call
+    WRONG_VALUE = 9,          // Deposit value is not the total
+    INVALID_MILESTONE = 10,
+    MILESTONE_NOT_PENDING = 11,
+    MILESTONE_NOT_VERIFIED = 12,
+    TIMEOUT_NOT_REACHED = 13,
+    NOTHING_TO_REFUND = 14,
+    WORK_LIMIT_EXCEEDED = 15  // Aborted before any write; see WORK METERING
+};
+constexpr uint32_t VAULT_ERROR_COUNT = 16;
+
+inline const char* vaultErrorName(VaultError error) {
+    switch (error) {
+        case VaultError::NONE: return "NONE";
+        case VaultError::AGREEMENT_NOT_FOUND: return "AGREEMENT_NOT_FOUND";
+        case VaultError::INVALID_ADDRESS: return "INVALID_ADDRESS";
+        case VaultError::INVALID_MILESTONE_COUNT: return "INVALID_MILESTONE_COUNT";
+        case VaultError::CAPACITY_REACHED: return "CAPACITY_REACHED";
+        case VaultError::AMOUNT_MISMATCH: return "AMOUNT_MISMATCH";
+        case VaultError::NOT_PAYER: return "NOT_PAYER";
+        case VaultError::NOT_ORACLE: return "NOT_ORACLE";
+        case VaultError::INVALID_STATE: return "INVALID_STATE";
+        case VaultError::WRONG_VALUE: return "WRONG_VALUE";
+        case VaultError::INVALID_MILESTONE: return "INVALID_MILESTONE";
+        case VaultError::MILESTONE_NOT_PENDING: return "MILESTONE_NOT_PENDING";
+        case VaultError::MILESTONE_NOT_VERIFIED: return "MILESTONE_NOT_VERIFIED";
+        case VaultError::TIMEOUT_NOT_REACHED: return "TIMEOUT_NOT_REACHED";
+        case VaultError::NOTHING_TO_REFUND: return "NOTHING_TO_REFUND";
+        case VaultError::WORK_LIMIT_EXCEEDED: return "WORK_LIMIT_EXCEEDED";
+    }
+    return "UNKNOWN";
+}
+
+struct ProcedureCounters {
+    uint64_t calls;
+    uint64_t successes;
+    uint64_t failures;
+    uint64_t agreementsScanned;            // Slots compared while looking up the agreement
+    uint64_t milestonesTouched;            // Milestone records read or written
+    uint64_t workUnits;                    // Metered work, aborted calls included
+    std::array<uint64_t, VAULT_ERROR_COUNT> failuresByReason;
 };
 
+struct VaultPerfCounters {
+    uint64_t epoch;                        // Bumped by every reset
+    uint64_t sinceTick;                    // Tick of the last reset
+    std::array<ProcedureCounters, VAULT_PROCEDURE_COUNT> procedures;
+};
+
+// ============================================================================
+// WORK METERING
+// ============================================================================
+
+// Every call is charged abstract work units for its data-dependent loops: one
+// per agreement slot compared in the ID lookup, one per milestone record read
+// or written, one per 64 bytes copied. Work that follows the first write is
+// charged up front, so a call that would exceed the engine's work limit aborts
+// before mutating anything.
+constexpr uint64_t WORK_PER_SLOT_PROBE = 1;
+constexpr uint64_t WORK_PER_MILESTONE = 1;
+constexpr uint64_t WORK_BYTES_PER_UNIT = 64;
+
+constexpr uint64_t workForBytes(uint64_t bytes) {
+    return (bytes + WORK_BYTES_PER_UNIT - 1) / WORK_BYTES_PER_UNIT;
+}
+
+// Aggregate views read one state byte and one 64-bit column entry per used slot.
+constexpr uint64_t COLUMN_SCAN_BYTES_PER_SLOT = sizeof(AgreementState) + sizeof(uint64_t);
+
+// Worst case per call: a full table with the agreement in the last slot (or
+// missing), the most milestones and the longest title the vault allows.
+template <typename Config>
+struct VaultWorkBounds {
+    static constexpr uint64_t FULL_SCAN = Config::MAX_AGREEMENTS * WORK_PER_SLOT_PROBE;
+    static constexpr uint64_t EVIDENCE = Config::STORE_EVIDENCE ? workForBytes(64) : 0;
+
+    static constexpr uint64_t CREATE_AGREEMENT =
+        2 * Config::MAX_MILESTONES * WORK_PER_MILESTONE + workForBytes(titleCapacity<Config>());
+    static constexpr uint64_t DEPOSIT = FULL_SCAN;
+    static constexpr uint64_t MARK_MILESTONE_VERIFIED = FULL_SCAN + WORK_PER_MILESTONE + EVIDENCE;
+    static constexpr uint64_t RELEASE_MILESTONE = FULL_SCAN + (1 + Config::MAX_MILESTONES) * WORK_PER_MILESTONE;
+    static constexpr uint64_t REFUND = FULL_SCAN + Config::MAX_MILESTONES * WORK_PER_MILESTONE;
+    static constexpr uint64_t SET_FEE_RECIPIENT = workForBytes(sizeof(QubicAddress));
+    static constexpr uint64_t GET_AGREEMENT = FULL_SCAN + workForBytes(sizeof(BasicAgreement<Config>));
+    static constexpr uint64_t GET_MILESTONE = FULL_SCAN + workForBytes(sizeof(BasicMilestone<Config>));
+    static constexpr uint64_t GET_PROTOCOL_STATS = 1;
+    static constexpr uint64_t GET_CAPACITY_STATS = 1;
+    static constexpr uint64_t SUM_LOCKED_BY_STATE = workForBytes(Config::MAX_AGREEMENTS * COLUMN_SCAN_BYTES_PER_SLOT);
+    static constexpr uint64_t COUNT_EXPIRING_BEFORE = workForBytes(Config::MAX_AGREEMENTS * COLUMN_SCAN_BYTES_PER_SLOT);
+    static constexpr uint64_t GET_TICK_FLOW = 1;
+};
+
+using DefaultWorkBounds = VaultWorkBounds<DefaultVaultConfig>;
+constexpr uint64_t WORK_BOUND_CREATE_AGREEMENT = DefaultWorkBounds::CREATE_AGREEMENT;
+constexpr uint64_t WORK_BOUND_DEPOSIT = DefaultWorkBounds::DEPOSIT;
+constexpr uint64_t WORK_BOUND_MARK_MILESTONE_VERIFIED = DefaultWorkBounds::MARK_MILESTONE_VERIFIED;
+constexpr uint64_t WORK_BOUND_RELEASE_MILESTONE = DefaultWorkBounds::RELEASE_MILESTONE;
+constexpr uint64_t WORK_BOUND_REFUND = DefaultWorkBounds::REFUND;
+constexpr uint64_t WORK_BOUND_SET_FEE_RECIPIENT = DefaultWorkBounds::SET_FEE_RECIPIENT;
+constexpr uint64_t WORK_BOUND_GET_AGREEMENT = DefaultWorkBounds::GET_AGREEMENT;
+constexpr uint64_t WORK_BOUND_GET_MILESTONE = DefaultWorkBounds::GET_MILESTONE;
+constexpr uint64_t WORK_BOUND_GET_PROTOCOL_STATS = DefaultWorkBounds::GET_PROTOCOL_STATS;
+constexpr uint64_t WORK_BOUND_GET_CAPACITY_STATS = DefaultWorkBounds::GET_CAPACITY_STATS;
+constexpr uint64_t WORK_BOUND_SUM_LOCKED_BY_STATE = DefaultWorkBounds::SUM_LOCKED_BY_STATE;
+constexpr uint64_t WORK_BOUND_COUNT_EXPIRING_BEFORE = DefaultWorkBounds::COUNT_EXPIRING_BEFORE;
+constexpr uint64_t WORK_BOUND_GET_TICK_FLOW = DefaultWorkBounds::GET_TICK_FLOW;
+
+// Work charged to the engine's most recent call, and how it ended.
+struct WorkReceipt {
+    uint64_t units;
+    bool aborted;                          // Hit the work limit; nothing was written
+    VaultError error;                      // NONE on success
+};
+
+// ============================================================================
+// CAPACITY TELEMETRY
+// ============================================================================
+
+// Slots are never reclaimed: a COMPLETED or REFUNDED agreement keeps its slot
+// as a tombstone until MAX_AGREEMENTS is reached.
+inline bool isTombstoneState(AgreementState agreementState) {
+    return agreementState == AgreementState::COMPLETED || agreementState == AgreementState::REFUNDED;
+}
+
+// Kept current by every procedure so the capacity view is O(1).
+struct CapacityCounters {
+    std::array<uint32_t, AGREEMENT_STATE_COUNT> agreementsByState;
+    uint64_t milestonesUsed;               // Sum of milestoneCount over used slots
+};
+
+// Agreement bytes by access pattern.
+enum class StateCategory : uint8_t {
+    HOT = 0,          // IDs, amounts, states, ticks, counts: read by every call
+    COLD = 1,         // Party addresses: read on authorization and payout
+    TEXT = 2,         // Title, metadata, milestone descriptions: never read on-chain
+    EVIDENCE = 3      // Milestone evidence hashes: written once on verification
+};
+constexpr uint32_t STATE_CATEGORY_COUNT = 4;
+
+inline const char* stateCategoryName(StateCategory category) {
+    switch (category) {
+        case StateCategory::HOT: return "hot";
+        case StateCategory::COLD: return "cold";
+        case StateCategory::TEXT: return "text";
+        case StateCategory::EVIDENCE: return "evidence";
+    }
+    return "unknown";
+}
+
+template <typename Config>
+struct VaultSlotBytes {
+    static constexpr uint64_t TEXT = Config::TITLE_BYTES + Config::METADATA_BYTES +
+                                     uint64_t(Config::MAX_MILESTONES) * Config::DESCRIPTION_BYTES;
+    static constexpr uint64_t EVIDENCE = Config::STORE_EVIDENCE ? uint64_t(Config::MAX_MILESTONES) * 64 : 0;
+    static constexpr uint64_t COLD = 3 * sizeof(QubicAddress);  // payer, beneficiary, oracleAdmin
+    static constexpr uint64_t HOT = sizeof(BasicAgreement<Config>) - TEXT - EVIDENCE - COLD;
+    static constexpr std::array<uint64_t, STATE_CATEGORY_COUNT> BY_CATEGORY = {HOT, COLD, TEXT, EVIDENCE};
+};
+
+constexpr uint64_t TEXT_BYTES_PER_SLOT = VaultSlotBytes<DefaultVaultConfig>::TEXT;
+constexpr uint64_t EVIDENCE_BYTES_PER_SLOT = VaultSlotBytes<DefaultVaultConfig>::EVIDENCE;
+constexpr uint64_t COLD_BYTES_PER_SLOT = VaultSlotBytes<DefaultVaultConfig>::COLD;
+constexpr uint64_t HOT_BYTES_PER_SLOT = VaultSlotBytes<DefaultVaultConfig>::HOT;
+constexpr std::array<uint64_t, STATE_CATEGORY_COUNT> STATE_BYTES_PER_SLOT = VaultSlotBytes<DefaultVaultConfig>::BY_CATEGORY;
+
+struct VaultCapacityStats {
+    uint32_t capacity;                     // Config::MAX_AGREEMENTS
+    uint32_t usedSlots;                    // activeAgreementCount
+    uint32_t liveSlots;                    // Agreements not yet COMPLETED or REFUNDED
+    uint32_t tombstonedSlots;              // COMPLETED or REFUNDED, still holding a slot
+    uint32_t freeSlots;
+    std::array<uint32_t, AGREEMENT_STATE_COUNT> agreementsByState;
+
+    uint64_t milestoneSlotsUsed;           // Milestones defined
+    uint64_t milestoneSlotsReserved;       // Config::MAX_MILESTONES per used slot
+
+    // The ID index is a scan of the used slots: its load factor is
+    // usedSlots/capacity and a lookup probes up to usedSlots entries.
+    uint32_t indexLoadBasisPoints;
+    uint32_t expectedHitProbes;            // (usedSlots + 1) / 2 for a uniform hit
+    uint32_t expectedMissProbes;           // usedSlots
+    uint64_t observedLookups;              // Scanning calls since the last counter reset
+    uint64_t observedProbes;               // Slots they compared
+
+    std::array<uint64_t, STATE_CATEGORY_COUNT> bytesInUse;     // Held by used slots
+    std::array<uint64_t, STATE_CATEGORY_COUNT> bytesReserved;  // Held by all slots
+    uint64_t stateBytes;                   // sizeof the vault state
+};
+
+// ============================================================================
+// ACCOUNTING
+// ============================================================================
+
+// Funds enter only by deposit and leave only as a release (beneficiary share
+// plus protocol fee) or a refund, so at every call boundary
+//
+//   depositedByPayers == totalValueLocked + totalValueReleased
+//                        + protocolFeeAccrued + refundedToPayers
+//
+// and totalValueLocked is the sum of lockedByState. Procedures keep these sums
+// current, so both identities are checked in O(1).
+struct AccountingCounters {
+    std::array<uint64_t, AGREEMENT_STATE_COUNT> lockedByState;  // Sum of lockedAmount per agreement state
+    uint64_t depositedByPayers;            // Paid in by deposit
+    uint64_t refundedToPayers;             // Paid back by refund
+};
+
+enum class AccountingViolation : uint8_t {
+    NONE = 0,
+    TVL_NOT_STATE_SUM = 1,     // totalValueLocked != sum of lockedByState
+    LOCKED_WHILE_SETTLED = 2,  // Funds locked in a CREATED, COMPLETED or REFUNDED agreement
+    FUNDS_NOT_CONSERVED = 3,   // Deposits != locked + released + fees + refunded
+    // Found by a full scan only (host/VaultAudit.h)
+    COUNTERS_DRIFTED = 4,      // Running sums differ from a recount of the slots
+    RELEASED_MISMATCH = 5,     // Sum of releasedAmount != totalValueReleased
+    FEES_MISMATCH = 6,         // Fees implied by released milestones != protocolFeeAccrued
+    AGREEMENT_UNBALANCED = 7,  // lockedAmount + released milestones != totalAmount
+    COLUMNS_DRIFTED = 8,       // Hot columns differ from the records they shadow
+    TICK_FLOWS_DRIFTED = 9     // Tick-activity totals differ from the slots and running sums
+};
+constexpr uint32_t ACCOUNTING_VIOLATION_COUNT = 10;
+
+inline const char* accountingViolationName(AccountingViolation violation) {
+    switch (violation) {
+        case AccountingViolation::NONE: return "NONE";
+        case AccountingViolation::TVL_NOT_STATE_SUM: return "TVL_NOT_STATE_SUM";
+        case AccountingViolation::LOCKED_WHILE_SETTLED: return "LOCKED_WHILE_SETTLED";
+        case AccountingViolation::FUNDS_NOT_CONSERVED: return "FUNDS_NOT_CONSERVED";
+        case AccountingViolation::COUNTERS_DRIFTED: return "COUNTERS_DRIFTED";
+        case AccountingViolation::RELEASED_MISMATCH: return "RELEASED_MISMATCH";
+        case AccountingViolation::FEES_MISMATCH: return "FEES_MISMATCH";
+        case AccountingViolation::AGREEMENT_UNBALANCED: return "AGREEMENT_UNBALANCED";
+        case AccountingViolation::COLUMNS_DRIFTED: return "COLUMNS_DRIFTED";
+        case AccountingViolation::TICK_FLOWS_DRIFTED: return "TICK_FLOWS_DRIFTED";
+    }
+    return "UNKNOWN";
+}
+
+// ============================================================================
+// HOT COLUMNS
+// ============================================================================
+
+// The record fields aggregate views filter and sum, mirrored by slot in
+// parallel arrays. A view over every agreement then reads a state byte and a
+// 64-bit entry per slot instead of striding through 3.3 KB records, in
+// branch-free loops the compiler vectorizes. Procedures copy a slot's fields
+// after writing its record; entries at or above activeAgreementCount are
+// leftovers and never read.
+template <typename Config>
+struct AgreementColumns {
+    std::array<AgreementState, Config::MAX_AGREEMENTS> state;
+    std::array<uint64_t, Config::MAX_AGREEMENTS> locked;          // lockedAmount
+    std::array<uint64_t, Config::MAX_AGREEMENTS> released;        // releasedAmount
+    std::array<uint64_t, Config::MAX_AGREEMENTS> timeoutTick;
+    std::array<uint64_t, Config::MAX_AGREEMENTS> createdAtTick;
+};
+
+// ============================================================================
+// TICK ACTIVITY
+// ============================================================================
+
+// Fund flows by tick, so "released in the last N ticks" or "funded between
+// two ticks" is answered without scanning agreements. Each flow keeps two
+// Fenwick trees over TICK_BUCKETS tick buckets, amounts and event counts:
+// recording an event and summing a range of buckets are both O(log
+// TICK_BUCKETS). Bucket 0 starts at the tick of initialize and buckets are
+// 2^bucketShift ticks wide. A tick past the last bucket doubles the width,
+// merging neighbouring buckets, so the trees cover any horizon at a
+// resolution that coarsens as the vault ages. Ticks before the origin count
+// in bucket 0.
+//
+// The trees only use their first `span` entries, a power of two past every
+// bucket written so far; the rest stay zero. span doubles as later buckets
+// are reached (one entry per tree to fill in), so a reset clears only what
+// was written since the last one, not all TICK_BUCKETS entries.
+enum class TickFlow : uint8_t {
+    CREATED = 0,      // createAgreement: totalAmount
+    FUNDED = 1,       // deposit: the amount locked
+    RELEASED = 2,     // releaseMilestone: the milestone amount, protocol fee included
+    REFUNDED = 3      // refund: the amount returned to the payer, at the agreement's timeoutTick
+};
+constexpr uint32_t TICK_FLOW_COUNT = 4;
+
+inline const char* tickFlowName(TickFlow flow) {
+    switch (flow) {
+        case TickFlow::CREATED: return "created";
+        case TickFlow::FUNDED: return "funded";
+        case TickFlow::RELEASED: return "released";
+        case TickFlow::REFUNDED: return "refunded";
+    }
+    return "unknown";
+}
+
+template <typename Config>
+struct TickActivity {
+    static_assert(Config::TICK_BUCKETS >= 2 && (Config::TICK_BUCKETS & (Config::TICK_BUCKETS - 1)) == 0,
+                  "buckets merge in pairs and span doubles up to TICK_BUCKETS");
+    using Tree = std::array<uint64_t, Config::TICK_BUCKETS>;
+
+    uint64_t originTick;                   // First tick of bucket 0
+    uint32_t bucketShift;                  // Buckets are 2^bucketShift ticks wide
+    uint32_t span;                         // Entries in use; entries at or past span are zero
+    // Fenwick trees: entry i - 1 sums buckets (i - lowbit(i), i]
+    std::array<Tree, TICK_FLOW_COUNT> amounts;
+    std::array<Tree, TICK_FLOW_COUNT> counts;
+};
+
+// One flow's totals over a tick range. Ranges are widened to bucket edges;
+// fromTick/toTick report the range actually summed (toTick exclusive).
+struct TickFlowTotals {
+    uint64_t amount;
+    uint64_t count;
+    uint64_t fromTick;
+    uint64_t toTick;
+};
+
+/** Adds `value` to `bucket` of a tree over its first `size` entries. */
+template <size_t N>
+void fenwickAdd(std::array<uint64_t, N>& tree, uint32_t size, uint32_t bucket, uint64_t value) {
+    for (uint32_t i = bucket + 1; i <= size; i += i & (0u - i)) tree[i - 1] += value;
+}
+
+/** Sum over buckets [0, end). */
+template <size_t N>
+uint64_t fenwickPrefix(const std::array<uint64_t, N>& tree, uint32_t end) {
+    uint64_t sum = 0;
+    for (uint32_t i = end; i > 0; i -= i & (0u - i)) sum += tree[i - 1];
+    return sum;
+}
+
+/** Turns the first `size` per-bucket values into a Fenwick tree in place, in O(size). */
+template <size_t N>
+void fenwickFromBuckets(std::array<uint64_t, N>& tree, uint32_t size) {
+    for (uint32_t i = 1; i <= size; ++i) {
+        uint32_t parent = i + (i & (0u - i));
+        if (parent <= size) tree[parent - 1] += tree[i - 1];
+    }
+}
+
+/** The inverse of fenwickFromBuckets: back to per-bucket values, in O(size). */
+template <size_t N>
+void fenwickToBuckets(std::array<uint64_t, N>& tree, uint32_t size) {
+    for (uint32_t i = size; i > 0; --i) {
+        uint32_t parent = i + (i & (0u - i));
+        if (parent <= size) tree[parent - 1] -= tree[i - 1];
+    }
+}
+
+// Bucket b of a tree at twice the width holds old buckets 2b and 2b + 1, so a
+// tree over `size` entries becomes one over size / 2; the upper half is zeroed.
+template <size_t N>
+void mergeBucketPairs(std::array<uint64_t, N>& tree, uint32_t size) {
+    fenwickToBuckets(tree, size);
+    for (uint32_t b = 0; b < size / 2; ++b) tree[b] = tree[2 * b] + tree[2 * b + 1];
+    for (uint32_t b = size / 2; b < size; ++b) tree[b] = 0;
+    fenwickFromBuckets(tree, size / 2);
+}
+
+/** Empties the trees in O(span): only entries below span can be non-zero. */
+template <typename Config>
+void resetTickActivity(TickActivity<Config>& activity, uint64_t originTick) {
+    uint32_t used = activity.span < Config::TICK_BUCKETS ? activity.span : Config::TICK_BUCKETS;
+    for (uint32_t f = 0; f < TICK_FLOW_COUNT; ++f) {
+        for (uint32_t i = 0; i < used; ++i) {
+            activity.amounts[f][i] = 0;
+            activity.counts[f][i] = 0;
+        }
+    }
+    activity.originTick = originTick;
+    activity.bucketShift = Config::TICK_BUCKET_SHIFT;
+    activity.span = 1;
+}
+
+/** Ticks since bucket 0 began; ticks before the origin count as 0. */
+template <typename Config>
+uint64_t tickOffset(const TickActivity<Config>& activity, uint64_t tick) {
+    return tick > activity.originTick ? tick - activity.originTick : 0;
+}
+
+/** First tick of bucket `bucket`, saturating; bucket 0 also holds earlier ticks. */
+template <typename Config>
+uint64_t bucketStartTick(const TickActivity<Config>& activity, uint64_t bucket) {
+    if (bucket == 0) return 0;
+    if (bucket > (UINT64_MAX >> activity.bucketShift)) return UINT64_MAX;
+    uint64_t offset = bucket << activity.bucketShift;
+    return offset > UINT64_MAX - activity.originTick ? UINT64_MAX : activity.originTick + offset;
+}
+
+/** Adds one event of `amount` at `tick`, widening the buckets if the tick is past the last one. */
+template <typename Config>
+void recordTickFlow(TickActivity<Config>& activity, TickFlow flow, uint64_t tick, uint64_t amount) {
+    if (activity.span == 0) activity.span = 1;  // Zeroed state, never initialized
+    uint64_t offset = tickOffset(activity, tick);
+    while ((offset >> activity.bucketShift) >= Config::TICK_BUCKETS) {
+        if (activity.span > 1) {
+            for (uint32_t f = 0; f < TICK_FLOW_COUNT; ++f) {
+                mergeBucketPairs(activity.amounts[f], activity.span);
+                mergeBucketPairs(activity.counts[f], activity.span);
+            }
+            activity.span /= 2;
+        }
+        ++activity.bucketShift;
+    }
+    uint32_t bucket = static_cast<uint32_t>(offset >> activity.bucketShift);
+    // Entry 2 * span covers buckets [0, 2 * span): everything so far, all of it below span.
+    while (bucket >= activity.span) {
+        for (uint32_t f = 0; f < TICK_FLOW_COUNT; ++f) {
+            activity.amounts[f][2 * activity.span - 1] = activity.amounts[f][activity.span - 1];
+            activity.counts[f][2 * activity.span - 1] = activity.counts[f][activity.span - 1];
+        }
+        activity.span *= 2;
+    }
+    fenwickAdd(activity.amounts[static_cast<uint32_t>(flow)], activity.span, bucket, amount);
+    fenwickAdd(activity.counts[static_cast<uint32_t>(flow)], activity.span, bucket, 1);
+}
+
+/** One flow's totals over the buckets holding ticks [fromTick, toTick). */
+template <typename Config>
+TickFlowTotals sumTickFlow(const TickActivity<Config>& activity, TickFlow flow, uint64_t fromTick, uint64_t toTick) {
+    TickFlowTotals totals = {};
+    uint32_t f = static_cast<uint32_t>(flow);
+    if (f >= TICK_FLOW_COUNT || toTick <= fromTick) return totals;
+    uint64_t first = tickOffset(activity, fromTick) >> activity.bucketShift;
+    if (first >= Config::TICK_BUCKETS) return totals;  // Past every recorded tick
+    uint64_t end = (tickOffset(activity, toTick - 1) >> activity.bucketShift) + 1;
+    if (end > Config::TICK_BUCKETS) end = Config::TICK_BUCKETS;
+    // Buckets at or past span are empty.
+    uint32_t low = static_cast<uint32_t>(first < activity.span ? first : activity.span);
+    uint32_t high = static_cast<uint32_t>(end < activity.span ? end : activity.span);
+    totals.amount = fenwickPrefix(activity.amounts[f], high) - fenwickPrefix(activity.amounts[f], low);
+    totals.count = fenwickPrefix(activity.counts[f], high) - fenwickPrefix(activity.counts[f], low);
+    totals.fromTick = bucketStartTick(activity, first);
+    totals.toTick = end == Config::TICK_BUCKETS ? UINT64_MAX : bucketStartTick(activity, end);
+    return totals;
+}
+
 // ============================================================================
 // CONTRACT STATE
 // ============================================================================
 
-struct PronexmaVaultState {
+template <typename Config>
+struct BasicVaultState {
     uint64_t agreementCounter;             // Auto-incrementing ID
     uint64_t totalValueLocked;             // Sum of all locked funds
     uint64_t totalValueReleased;           // Sum of all released funds
@@ -97,49 +665,504 @@ struct PronexmaVaultState {
     QubicAddress protocolFeeRecipient;     // Address to receive fees
     
     uint32_t activeAgreementCount;         // Number of active agreements
-    std::array<Agreement, MAX_AGREEMENTS> agreements;
+    std::array<BasicAgreement<Config>, Config::MAX_AGREEMENTS> agreements;
+
+    VaultPerfCounters perfCounters;        // Per-procedure calls, failures and work since the last reset
+    CapacityCounters capacityCounters;     // Agreements by state, milestones defined
+    AccountingCounters accountingCounters; // Locked funds by state, payer inflows and refunds
+    AgreementColumns<Config> columns;      // Hot fields by slot, for aggregate views
+    TickActivity<Config> tickActivity;     // Fund flows by tick bucket, for range views
+
+    uint32_t staleSlotCount;               // Slots below this may hold bytes from before the last initialize
     
     // Index mappings (simplified - in production use proper hash maps)
     // agreementsByPayer[address] -> list of agreement IDs
     // agreementsByBeneficiary[address] -> list of agreement IDs
 };
 
-// Global state instance
-static PronexmaVaultState state;
+using PronexmaVaultState = BasicVaultState<DefaultVaultConfig>;
+
+// ============================================================================
+// HOST HOOKS
+// ============================================================================
+
+// Invoked before a procedure mutates an agreement slot. Native hosts use it to
+// keep copy-on-write checkpoint views consistent; on-chain it stays unset.
+using AgreementWriteBarrier = void (*)(void* context, uint32_t slot);
+
+// Invoked in audit builds when a call leaves the accounting identities broken.
+// Without one, an audit build aborts.
+using AccountingViolationHandler = void (*)(void* context, VaultProcedure procedure, AccountingViolation violation);
+
+struct HostHooks {
+    AgreementWriteBarrier beforeAgreementWrite = nullptr;
+    void* context = nullptr;
+    AccountingViolationHandler onAccountingViolation = nullptr;
+    void* violationContext = nullptr;
+};
 
 // ============================================================================
 // HELPER FUNCTIONS
 // ============================================================================
 
+// Two 16-byte halves, compared without a byte loop.
 inline bool addressEquals(const QubicAddress& a, const QubicAddress& b) {
-    for (size_t i = 0; i < a.size(); ++i) {
-        if (a[i] != b[i]) return false;
-    }
-    return true;
+    return std::memcmp(a.data(), b.data(), 16) == 0 && std::memcmp(a.data() + 16, b.data() + 16, 16) == 0;
 }
 
 inline bool isValidAddress(const QubicAddress& addr) {
-    // Basic validation - non-empty
-    return addr[0] != '\0';
+    // The all-zero key is the null identity: no one holds it
+    uint64_t words[4];
+    std::memcpy(words, addr.data(), sizeof(words));
+    return (words[0] | words[1] | words[2] | words[3]) != 0;
 }
 
-inline uint64_t getCurrentTick() {
+constexpr uint32_t AGREEMENT_NOT_FOUND = 0xFFFFFFFF;
+
+/** Copies `slot`'s hot fields into the columns after its record was written. */
+template <typename Config>
+void syncAgreementColumns(BasicVaultState<Config>& vault, uint32_t slot) {
+    const BasicAgreement<Config>& agreement = vault.agreements[slot];
+    AgreementColumns<Config>& columns = vault.columns;
+    columns.state[slot] = agreement.state;
+    columns.locked[slot] = agreement.lockedAmount;
+    columns.released[slot] = agreement.releasedAmount;
+    columns.timeoutTick[slot] = agreement.timeoutTick;
+    columns.createdAtTick[slot] = agreement.createdAtTick;
+}
+
+/** Refills the columns from the used slots, for hosts that write slots directly. */
+template <typename Config>
+void rebuildAgreementColumns(BasicVaultState<Config>& vault) {
+    for (uint32_t i = 0; i < vault.activeAgreementCount; ++i) syncAgreementColumns(vault, i);
+}
+
+/**
+ * Records one agreement's flows as its record shows them. Records keep no
+ * refund tick, so a refund is placed at its timeoutTick, the first tick it
+ * was allowed; refund() records it there too, so both paths agree.
+ */
+template <typename Config>
+void recordAgreementTickFlows(TickActivity<Config>& activity, const BasicAgreement<Config>& agreement) {
+    recordTickFlow(activity, TickFlow::CREATED, agreement.createdAtTick, agreement.totalAmount);
+    if (agreement.state == AgreementState::CREATED) return;
+    recordTickFlow(activity, TickFlow::FUNDED, agreement.fundedAtTick, agreement.totalAmount);
+    uint64_t paidOut = 0;
+    for (uint32_t m = 0; m < agreement.milestoneCount && m < Config::MAX_MILESTONES; ++m) {
+        const BasicMilestone<Config>& milestone = agreement.milestones[m];
+        if (milestone.state != MilestoneState::RELEASED) continue;
+        recordTickFlow(activity, TickFlow::RELEASED, milestone.releasedAtTick, milestone.amount);
+        paidOut += milestone.amount;
+    }
+    if (agreement.state == AgreementState::REFUNDED) {
+        recordTickFlow(activity, TickFlow::REFUNDED, agreement.timeoutTick, agreement.totalAmount - paidOut);
+    }
+}
+
+/**
+ * Re-records every flow from the used slots, for hosts that write slots
+ * directly and have no trees to go with them (snapshots carry theirs).
+ * Bucket 0 starts at slot 0's creation tick: slots fill in creation order,
+ * and a stream of records (VaultMigration.h) knows it before the rest.
+ */
+template <typename Config>
+void rebuildTickActivity(BasicVaultState<Config>& vault) {
+    TickActivity<Config>& activity = vault.tickActivity;
+    resetTickActivity(activity, vault.activeAgreementCount == 0 ? activity.originTick
+                                                                : vault.agreements[0].createdAtTick);
+    for (uint32_t i = 0; i < vault.activeAgreementCount; ++i) {
+        recordAgreementTickFlows(activity, vault.agreements[i]);
+    }
+}
+
+/** Whether `slot`'s columns still match its record. */
+template <typename Config>
+bool agreementColumnsMatch(const BasicVaultState<Config>& vault, uint32_t slot) {
+    const BasicAgreement<Config>& agreement = vault.agreements[slot];
+    const AgreementColumns<Config>& columns = vault.columns;
+    return columns.state[slot] == agreement.state && columns.locked[slot] == agreement.lockedAmount &&
+           columns.released[slot] == agreement.releasedAmount && columns.timeoutTick[slot] == agreement.timeoutTick &&
+           columns.createdAtTick[slot] == agreement.createdAtTick;
+}
+
+/**
+ * Recounts capacityCounters from the used slots. Procedures keep them current;
+ * hosts that write slots directly (snapshot restore, bulk load) call this after.
+ */
+template <typename Config>
+void rebuildCapacityCounters(BasicVaultState<Config>& vault) {
+    vault.capacityCounters = CapacityCounters{};
+    for (uint32_t i = 0; i < vault.activeAgreementCount; ++i) {
+        const BasicAgreement<Config>& agreement = vault.agreements[i];
+        uint32_t stateIndex = static_cast<uint32_t>(agreement.state);
+        if (stateIndex < AGREEMENT_STATE_COUNT) ++vault.capacityCounters.agreementsByState[stateIndex];
+        vault.capacityCounters.milestonesUsed += agreement.milestoneCount;
+    }
+}
+
+/**
+ * Marks the used slots stale before activeAgreementCount is lowered (a reset,
+ * a restore). Stale slots keep their bytes until createAgreement claims them
+ * again and clears them, so a reset costs O(1) instead of clearing every slot.
+ */
+template <typename Config>
+void retireAgreementSlots(BasicVaultState<Config>& vault) {
+    if (vault.activeAgreementCount > vault.staleSlotCount) {
+        vault.staleSlotCount = vault.activeAgreementCount;
+    }
+}
+
+// Protocol fee withheld from a milestone release (FEE_BASIS_POINTS, rounded
+// down); 0.5% in the default vault.
+template <typename Config = DefaultVaultConfig>
+constexpr uint64_t releaseFee(uint64_t releaseAmount) {
+    constexpr uint64_t bps = Config::FEE_BASIS_POINTS;
+    static_assert(bps <= 10000, "fee above 100%");
+    if constexpr (bps == 0) {
+        return 0;
+    } else if constexpr (10000 % bps == 0) {
+        return releaseAmount / (10000 / bps);
+    } else {
+        return releaseAmount / 10000 * bps + releaseAmount % 10000 * bps / 10000;  // No overflow
+    }
+}
+
+/**
+ * Adds one agreement to `counters`: every agreement past CREATED was deposited
+ * in full, and a REFUNDED one returned what its released milestones did not
+ * pay out.
+ */
+template <typename Config>
+void accountAgreement(AccountingCounters& counters, const BasicAgreement<Config>& agreement) {
+    uint32_t stateIndex = static_cast<uint32_t>(agreement.state);
+    if (stateIndex < AGREEMENT_STATE_COUNT) counters.lockedByState[stateIndex] += agreement.lockedAmount;
+    if (agreement.state == AgreementState::CREATED) return;
+    counters.depositedByPayers += agreement.totalAmount;
+    if (agreement.state != AgreementState::REFUNDED) return;
+    uint64_t paidOut = 0;
+    for (uint32_t m = 0; m < agreement.milestoneCount && m < Config::MAX_MILESTONES; ++m) {
+        if (agreement.milestones[m].state == MilestoneState::RELEASED) paidOut += agreement.milestones[m].amount;
+    }
+    counters.refundedToPayers += agreement.totalAmount - paidOut;
+}
+
+/**
+ * Whether one agreement's own books balance: past CREATED it still locks
+ * whatever was deposited and neither released nor refunded, and
+ * releasedAmount is what its released milestones paid the beneficiary. The
+ * per-record form of the identities checkAccountingInvariants checks in sum.
+ */
+template <typename Config>
+bool agreementBalanced(const BasicAgreement<Config>& agreement) {
+    if (static_cast<uint32_t>(agreement.state) >= AGREEMENT_STATE_COUNT) return false;
+    uint64_t paidOut = 0, fees = 0;
+    for (uint32_t m = 0; m < agreement.milestoneCount && m < Config::MAX_MILESTONES; ++m) {
+        if (agreement.milestones[m].state != MilestoneState::RELEASED) continue;
+        paidOut += agreement.milestones[m].amount;
+        fees += releaseFee<Config>(agreement.milestones[m].amount);
+    }
+    if (paidOut > agreement.totalAmount) return false;
+    bool holdsFunds = agreement.state != AgreementState::CREATED && agreement.state != AgreementState::REFUNDED;
+    uint64_t expectedLocked = holdsFunds ? agreement.totalAmount - paidOut : 0;
+    return agreement.lockedAmount == expectedLocked && agreement.releasedAmount == paidOut - fees;
+}
+
+/** Recounts accountingCounters from the used slots, like rebuildCapacityCounters. */
+template <typename Config>
+void rebuildAccountingCounters(BasicVaultState<Config>& vault) {
+    vault.accountingCounters = AccountingCounters{};
+    for (uint32_t i = 0; i < vault.activeAgreementCount; ++i) {
+        accountAgreement(vault.accountingCounters, vault.agreements[i]);
+    }
+}
+
+/** The accounting identities over running sums and the vault totals they must match. */
+inline AccountingViolation checkAccountingIdentities(const AccountingCounters& counters, uint64_t totalValueLocked,
+                                                     uint64_t totalValueReleased, uint64_t protocolFeeAccrued) {
+    uint64_t lockedSum = 0;
+    for (uint64_t locked : counters.lockedByState) lockedSum += locked;
+    if (lockedSum != totalValueLocked) {
+        return AccountingViolation::TVL_NOT_STATE_SUM;
+    }
+    if (counters.lockedByState[static_cast<uint32_t>(AgreementState::CREATED)] != 0 ||
+        counters.lockedByState[static_cast<uint32_t>(AgreementState::COMPLETED)] != 0 ||
+        counters.lockedByState[static_cast<uint32_t>(AgreementState::REFUNDED)] != 0) {
+        return AccountingViolation::LOCKED_WHILE_SETTLED;
+    }
+    if (counters.depositedByPayers != totalValueLocked + totalValueReleased + protocolFeeAccrued +
+                                          counters.refundedToPayers) {
+        return AccountingViolation::FUNDS_NOT_CONSERVED;
+    }
+    return AccountingViolation::NONE;
+}
+
+/** The O(1) accounting identities over the running sums. */
+template <typename Config>
+AccountingViolation checkAccountingInvariants(const BasicVaultState<Config>& vault) {
+    return checkAccountingIdentities(vault.accountingCounters, vault.totalValueLocked, vault.totalValueReleased,
+                                     vault.protocolFeeAccrued);
+}
+
+// ============================================================================
+// HOST CONTEXT
+// ============================================================================
+
+// On-chain, the Qubic runtime supplies the tick, the invocator, the invocation
+// value and transfers. Native hosts (tests, benchmarks, replicas) bind a
+// HostContext to an engine instead; while none is bound the placeholders in
+// BasicVaultEngine apply.
+struct HostContext {
+    void* self = nullptr;
+    uint64_t (*currentTick)(void* self) = nullptr;
+    QubicAddress (*messageSender)(void* self) = nullptr;
+    uint64_t (*messageValue)(void* self) = nullptr;
+    void (*transfer)(void* self, const QubicAddress& recipient, uint64_t amount) = nullptr;
+};
+
+// ============================================================================
+// VAULT ENGINE
+// ============================================================================
+
+/**
+ * One vault: its state plus the host bindings its procedures use. Engines share
+ * nothing mutable, so any number can run side by side, each on its own thread.
+ * The free functions at the end of this file drive a default engine over the
+ * global `state`.
+ */
+template <typename Config>
+class BasicVaultEngine {
+public:
+    using AgreementType = BasicAgreement<Config>;
+    using MilestoneType = BasicMilestone<Config>;
+    using StateType = BasicVaultState<Config>;
+
+    explicit BasicVaultEngine(StateType& vaultState) : state(vaultState) {}
+
+    BasicVaultEngine(const BasicVaultEngine&) = delete;
+    BasicVaultEngine& operator=(const BasicVaultEngine&) = delete;
+
+    StateType& state;
+    HostContext hostContext;
+    HostHooks hostHooks;
+
+    // Procedures
+    uint64_t createAgreement(const QubicAddress& beneficiary, const QubicAddress& oracleAdmin, uint64_t totalAmount,
+                             const uint64_t* milestoneAmounts, uint32_t milestoneCount, const char* title);
+    bool deposit(uint64_t agreementId);
+    bool markMilestoneVerified(uint64_t agreementId, uint32_t milestoneId, const std::array<uint8_t, 64>& evidenceHash);
+    bool releaseMilestone(uint64_t agreementId, uint32_t milestoneId);
+    bool refund(uint64_t agreementId);
+
+    // Views
+    AgreementType getAgreement(uint64_t agreementId) const;
+    MilestoneType getMilestone(uint64_t agreementId, uint32_t milestoneId) const;
+    void getProtocolStats(uint64_t& tvl, uint64_t& released, uint64_t& fees, uint32_t& count) const;
+    VaultPerfCounters getPerfCounters() const;
+    VaultCapacityStats getCapacityStats() const;
+    uint64_t sumLockedByState(AgreementState agreementState) const;
+    uint32_t countExpiringBefore(uint64_t tick) const;
+    TickFlowTotals getTickFlow(TickFlow flow, uint64_t fromTick, uint64_t toTick) const;
+
+    // Admin
+    bool setFeeRecipient(const QubicAddress& recipient);
+    void resetPerfCounters();
+    void initialize(const QubicAddress& feeRecipient);
+
+    uint32_t findAgreementSlot(uint64_t agreementId) const;
+
+    // Work metering: receipt of the last call, and the per-call cap (0 = none)
+    WorkReceipt lastWork() const { return work_; }
+    void setWorkUnitLimit(uint64_t limit) { workUnitLimit_ = limit; }
+    uint64_t workUnitLimit() const { return workUnitLimit_; }
+
+    uint64_t getCurrentTick() const;
+    QubicAddress getMessageSender() const;
+    uint64_t getMessageValue() const;
+    void transferTo(const QubicAddress& recipient, uint64_t amount);
+
+private:
+    void notifyAgreementWrite(uint32_t slot) {
+        if (hostHooks.beforeAgreementWrite != nullptr) {
+            hostHooks.beforeAgreementWrite(hostHooks.context, slot);
+        }
+    }
+
+    void setAgreementState(AgreementType& agreement, AgreementState next) {
+        std::array<uint32_t, AGREEMENT_STATE_COUNT>& byState = state.capacityCounters.agreementsByState;
+        std::array<uint64_t, AGREEMENT_STATE_COUNT>& lockedByState = state.accountingCounters.lockedByState;
+        --byState[static_cast<uint32_t>(agreement.state)];
+        ++byState[static_cast<uint32_t>(next)];
+        lockedByState[static_cast<uint32_t>(agreement.state)] -= agreement.lockedAmount;
+        lockedByState[static_cast<uint32_t>(next)] += agreement.lockedAmount;
+        agreement.state = next;
+    }
+
+    void setLockedAmount(AgreementType& agreement, uint64_t locked) {
+        uint64_t& lockedInState = state.accountingCounters.lockedByState[static_cast<uint32_t>(agreement.state)];
+        lockedInState = lockedInState - agreement.lockedAmount + locked;
+        agreement.lockedAmount = locked;
+    }
+
+    // Last write of a successful procedure: mirrors the slot into the columns.
+    void syncColumns(uint32_t slot) {
+        syncAgreementColumns(state, slot);
+    }
+
+    void recordFlow(TickFlow flow, uint64_t tick, uint64_t amount) {
+        recordTickFlow(state.tickActivity, flow, tick, amount);
+    }
+
+    // Views over the columns charge their bytes; false when that passes the limit.
+    bool chargeColumnScan() const {
+        work_ = WorkReceipt{};
+        if (chargeWork(workForBytes(uint64_t(state.activeAgreementCount) * COLUMN_SCAN_BYTES_PER_SLOT))) return true;
+        work_.error = VaultError::WORK_LIMIT_EXCEEDED;
+        return false;
+    }
+
+    // Audit builds: checks the O(1) accounting identities once the call is done.
+    void auditAccounting(VaultProcedure procedure) {
+#if PRONEXMA_VAULT_AUDIT
+        AccountingViolation violation = checkAccountingInvariants(state);
+        if (violation == AccountingViolation::NONE) return;
+        if (hostHooks.onAccountingViolation == nullptr) std::abort();
+        hostHooks.onAccountingViolation(hostHooks.violationContext, procedure, violation);
+#else
+        (void)procedure;
+#endif
+    }
+
+    // Without COUNT_PERFORMANCE the counters go to engine-local scratch and the
+    // state's perfCounters are never written.
+    ProcedureCounters& beginProcedure(VaultProcedure procedure) {
+        work_ = WorkReceipt{};
+        procedure_ = procedure;
+        if constexpr (Config::COUNT_PERFORMANCE) {
+            ProcedureCounters& counters = state.perfCounters.procedures[static_cast<uint32_t>(procedure)];
+            ++counters.calls;
+            return counters;
+        } else {
+            return uncounted_;
+        }
+    }
+
+    void recordFailure(ProcedureCounters& counters, VaultError reason) {
+        work_.error = reason;
+        ++counters.failures;
+        ++counters.failuresByReason[static_cast<uint32_t>(reason)];
+        counters.workUnits += work_.units;
+        auditAccounting(procedure_);
+    }
+
+    void recordSuccess(ProcedureCounters& counters) {
+        ++counters.successes;
+        counters.workUnits += work_.units;
+        auditAccounting(procedure_);
+    }
+
+    // Charges `units` unless that would pass the limit, in which case the call
+    // is marked aborted and must return before writing anything.
+    bool chargeWork(uint64_t units) const {
+        if (workUnitLimit_ != 0 && work_.units + units > workUnitLimit_) {
+            work_.aborted = true;
+            return false;
+        }
+        work_.units += units;
+        return true;
+    }
+
+    // findAgreementSlot, metered: stops probing when the work limit is reached.
+    uint32_t meteredFind(uint64_t agreementId, uint32_t* probed = nullptr) const {
+        uint32_t probes = state.activeAgreementCount;
+        if (workUnitLimit_ != 0) {
+            uint64_t remaining = work_.units < workUnitLimit_ ? workUnitLimit_ - work_.units : 0;
+            if (remaining / WORK_PER_SLOT_PROBE < probes) {
+                probes = static_cast<uint32_t>(remaining / WORK_PER_SLOT_PROBE);
+            }
+        }
+        uint32_t slot = AGREEMENT_NOT_FOUND;
+        for (uint32_t i = 0; i < probes; ++i) {
+            if (state.agreements[i].id == agreementId) {
+                slot = i;
+                probes = i + 1;
+                break;
+            }
+        }
+        work_.units += probes * WORK_PER_SLOT_PROBE;
+        work_.aborted = slot == AGREEMENT_NOT_FOUND && probes < state.activeAgreementCount;
+        if (probed != nullptr) {
+            *probed = probes;
+        }
+        return slot;
+    }
+
+    // meteredFind, also counting the slots it compares.
+    uint32_t scanForAgreement(uint64_t agreementId, ProcedureCounters& counters) const {
+        uint32_t probed = 0;
+        uint32_t slot = meteredFind(agreementId, &probed);
+        counters.agreementsScanned += probed;
+        return slot;
+    }
+
+    // Why a lookup returned AGREEMENT_NOT_FOUND.
+    VaultError lookupError() const {
+        return work_.aborted ? VaultError::WORK_LIMIT_EXCEEDED : VaultError::AGREEMENT_NOT_FOUND;
+    }
+
+    // Written by views too; like the rest of the engine, one thread at a time.
+    mutable WorkReceipt work_ = {};
+    uint64_t workUnitLimit_ = 0;
+    VaultProcedure procedure_ = VaultProcedure::CREATE_AGREEMENT;  // The call in progress
+    ProcedureCounters uncounted_ = {};
+};
+
+using PronexmaVaultEngine = BasicVaultEngine<DefaultVaultConfig>;
+
+template <typename Config>
+uint32_t BasicVaultEngine<Config>::findAgreementSlot(uint64_t agreementId) const {
+    for (uint32_t i = 0; i < state.activeAgreementCount; ++i) {
+        if (state.agreements[i].id == agreementId) {
+            return i;
+        }
+    }
+    return AGREEMENT_NOT_FOUND;
+}
+
+
+template <typename Config>
+uint64_t BasicVaultEngine<Config>::getCurrentTick() const {
+    if (hostContext.currentTick != nullptr) {
+        return hostContext.currentTick(hostContext.self);
+    }
     // Placeholder: In Qubic, this would return the current consensus tick
     return 0; // Replace with actual Qubic tick retrieval
 }
 
-inline QubicAddress getMessageSender() {
+template <typename Config>
+QubicAddress BasicVaultEngine<Config>::getMessageSender() const {
+    if (hostContext.messageSender != nullptr) {
+        return hostContext.messageSender(hostContext.self);
+    }
     // Placeholder: In Qubic, this returns the transaction sender
     QubicAddress sender = {};
     return sender; // Replace with actual sender retrieval
 }
 
-inline uint64_t getMessageValue() {
+template <typename Config>
+uint64_t BasicVaultEngine<Config>::getMessageValue() const {
+    if (hostContext.messageValue != nullptr) {
+        return hostContext.messageValue(hostContext.self);
+    }
     // Placeholder: In Qubic, this returns QU sent with the transaction
     return 0; // Replace with actual value retrieval
 }
 
-inline void transferTo(const QubicAddress& recipient, uint64_t amount) {
+template <typename Config>
+void BasicVaultEngine<Config>::transferTo(const QubicAddress& recipient, uint64_t amount) {
+    if (hostContext.transfer != nullptr) {
+        hostContext.transfer(hostContext.self, recipient, amount);
+        return;
+    }
     // Placeholder: In Qubic, this transfers QU to an address
     // Implementation depends on Qubic's native transfer mechanism
 }
@@ -158,7 +1181,8 @@ inline void transferTo(const QubicAddress& recipient, uint64_t amount) {
  * @param title Agreement title
  * @return agreementId The ID of the created agreement
  */
-uint64_t createAgreement(
+template <typename Config>
+uint64_t BasicVaultEngine<Config>::createAgreement(
     const QubicAddress& beneficiary,
     const QubicAddress& oracleAdmin,
     uint64_t totalAmount,
@@ -166,32 +1190,57 @@ uint64_t createAgreement(
     uint32_t milestoneCount,
     const char* title
 ) {
+    ProcedureCounters& counters = beginProcedure(VaultProcedure::CREATE_AGREEMENT);
+
     // Validation
     if (!isValidAddress(beneficiary)) {
+        recordFailure(counters, VaultError::INVALID_ADDRESS);
         return 0; // Error: Invalid beneficiary
     }
     if (!isValidAddress(oracleAdmin)) {
+        recordFailure(counters, VaultError::INVALID_ADDRESS);
         return 0; // Error: Invalid oracle admin
     }
-    if (milestoneCount == 0 || milestoneCount > MAX_MILESTONES_PER_AGREEMENT) {
+    if (milestoneCount == 0 || milestoneCount > Config::MAX_MILESTONES) {
+        recordFailure(counters, VaultError::INVALID_MILESTONE_COUNT);
         return 0; // Error: Invalid milestone count
     }
-    if (state.activeAgreementCount >= MAX_AGREEMENTS) {
+    if (state.activeAgreementCount >= Config::MAX_AGREEMENTS) {
+        recordFailure(counters, VaultError::CAPACITY_REACHED);
         return 0; // Error: Max agreements reached
     }
     
     // Verify milestone amounts sum to total
+    if (!chargeWork(milestoneCount * WORK_PER_MILESTONE)) {
+        recordFailure(counters, VaultError::WORK_LIMIT_EXCEEDED);
+        return 0; // Error: Work limit reached
+    }
     uint64_t milestoneSum = 0;
     for (uint32_t i = 0; i < milestoneCount; ++i) {
         milestoneSum += milestoneAmounts[i];
     }
     if (milestoneSum != totalAmount) {
+        recordFailure(counters, VaultError::AMOUNT_MISMATCH);
         return 0; // Error: Milestone amounts don't match total
     }
     
+    size_t titleLength = 0;
+    while (titleLength < titleCapacity<Config>() && title[titleLength] != '\0') {
+        ++titleLength;
+    }
+    if (!chargeWork(milestoneCount * WORK_PER_MILESTONE + workForBytes(titleLength))) {
+        recordFailure(counters, VaultError::WORK_LIMIT_EXCEEDED);
+        return 0; // Error: Work limit reached
+    }
+    
     // Create agreement
-    uint64_t agreementId = (AGREEMENT_ID_PREFIX << 32) | (++state.agreementCounter);
-    Agreement& agreement = state.agreements[state.activeAgreementCount++];
+    uint32_t slot = state.activeAgreementCount;
+    notifyAgreementWrite(slot);
+    uint64_t agreementId = (static_cast<uint64_t>(AGREEMENT_ID_PREFIX) << 32) | (++state.agreementCounter);
+    AgreementType& agreement = state.agreements[state.activeAgreementCount++];
+    if (slot < state.staleSlotCount) {
+        agreement = AgreementType{}; // Written before the last reset: drop its title, metadata and evidence
+    }
     
     agreement.id = agreementId;
     agreement.payer = getMessageSender();
@@ -201,14 +1250,18 @@ uint64_t createAgreement(
     agreement.lockedAmount = 0;
     agreement.releasedAmount = 0;
     agreement.state = AgreementState::CREATED;
+    ++state.capacityCounters.agreementsByState[static_cast<uint32_t>(AgreementState::CREATED)];
+    state.capacityCounters.milestonesUsed += milestoneCount;
     agreement.createdAtTick = getCurrentTick();
     agreement.fundedAtTick = 0;
     agreement.timeoutTick = 0;
     agreement.milestoneCount = milestoneCount;
     
     // Copy title
-    for (size_t i = 0; i < 255 && title[i] != '\0'; ++i) {
-        agreement.title[i] = title[i];
+    if constexpr (Config::TITLE_BYTES > 0) {
+        for (size_t i = 0; i < titleLength; ++i) {
+            agreement.title[i] = title[i];
+        }
     }
     
     // Initialize milestones
@@ -223,6 +1276,10 @@ uint64_t createAgreement(
     // Emit event (placeholder - depends on Qubic event system)
     // emit AgreementCreated(agreementId, payer, beneficiary, totalAmount);
     
+    recordFlow(TickFlow::CREATED, agreement.createdAtTick, totalAmount);
+    syncColumns(slot);
+    counters.milestonesTouched += milestoneCount;
+    recordSuccess(counters);
     return agreementId;
 }
 
@@ -231,47 +1288,53 @@ uint64_t createAgreement(
  * @param agreementId The agreement to fund
  * @return success Whether the deposit succeeded
  */
-bool deposit(uint64_t agreementId) {
+template <typename Config>
+bool BasicVaultEngine<Config>::deposit(uint64_t agreementId) {
+    ProcedureCounters& counters = beginProcedure(VaultProcedure::DEPOSIT);
+
     // Find agreement
-    Agreement* agreement = nullptr;
-    for (uint32_t i = 0; i < state.activeAgreementCount; ++i) {
-        if (state.agreements[i].id == agreementId) {
-            agreement = &state.agreements[i];
-            break;
-        }
-    }
-    
-    if (agreement == nullptr) {
-        return false; // Error: Agreement not found
+    uint32_t slot = scanForAgreement(agreementId, counters);
+    if (slot == AGREEMENT_NOT_FOUND) {
+        recordFailure(counters, lookupError());
+        return false; // Error: Agreement not found (or work limit reached)
     }
+    AgreementType* agreement = &state.agreements[slot];
     
     // Validate sender is payer
     if (!addressEquals(getMessageSender(), agreement->payer)) {
+        recordFailure(counters, VaultError::NOT_PAYER);
         return false; // Error: Only payer can deposit
     }
     
     // Validate state
     if (agreement->state != AgreementState::CREATED) {
+        recordFailure(counters, VaultError::INVALID_STATE);
         return false; // Error: Agreement already funded or completed
     }
     
     // Validate amount
     uint64_t depositAmount = getMessageValue();
     if (depositAmount != agreement->totalAmount) {
+        recordFailure(counters, VaultError::WRONG_VALUE);
         return false; // Error: Must deposit exact total amount
     }
     
     // Update state
-    agreement->lockedAmount = depositAmount;
-    agreement->state = AgreementState::FUNDED;
+    notifyAgreementWrite(slot);
+    setLockedAmount(*agreement, depositAmount);
+    setAgreementState(*agreement, AgreementState::FUNDED);
     agreement->fundedAtTick = getCurrentTick();
     agreement->timeoutTick = getCurrentTick() + REFUND_TIMEOUT_TICKS;
     
     state.totalValueLocked += depositAmount;
+    state.accountingCounters.depositedByPayers += depositAmount;
+    recordFlow(TickFlow::FUNDED, agreement->fundedAtTick, depositAmount);
     
     // Emit event
     // emit FundsDeposited(agreementId, depositAmount);
     
+    syncColumns(slot);
+    recordSuccess(counters);
     return true;
 }
 
@@ -282,58 +1345,70 @@ bool deposit(uint64_t agreementId) {
  * @param evidenceHash Hash of the verification evidence
  * @return success Whether verification succeeded
  */
-bool markMilestoneVerified(
+template <typename Config>
+bool BasicVaultEngine<Config>::markMilestoneVerified(
     uint64_t agreementId,
     uint32_t milestoneId,
     const std::array<uint8_t, 64>& evidenceHash
 ) {
+    ProcedureCounters& counters = beginProcedure(VaultProcedure::MARK_MILESTONE_VERIFIED);
+
     // Find agreement
-    Agreement* agreement = nullptr;
-    for (uint32_t i = 0; i < state.activeAgreementCount; ++i) {
-        if (state.agreements[i].id == agreementId) {
-            agreement = &state.agreements[i];
-            break;
-        }
-    }
-    
-    if (agreement == nullptr) {
-        return false; // Error: Agreement not found
+    uint32_t slot = scanForAgreement(agreementId, counters);
+    if (slot == AGREEMENT_NOT_FOUND) {
+        recordFailure(counters, lookupError());
+        return false; // Error: Agreement not found (or work limit reached)
     }
+    AgreementType* agreement = &state.agreements[slot];
     
     // Validate sender is oracle admin
     if (!addressEquals(getMessageSender(), agreement->oracleAdmin)) {
+        recordFailure(counters, VaultError::NOT_ORACLE);
         return false; // Error: Only oracle admin can verify
     }
     
     // Validate agreement state
     if (agreement->state != AgreementState::FUNDED && 
         agreement->state != AgreementState::ACTIVE) {
+        recordFailure(counters, VaultError::INVALID_STATE);
         return false; // Error: Agreement not in verifiable state
     }
     
     // Find milestone
     if (milestoneId == 0 || milestoneId > agreement->milestoneCount) {
+        recordFailure(counters, VaultError::INVALID_MILESTONE);
         return false; // Error: Invalid milestone ID
     }
     
-    Milestone& milestone = agreement->milestones[milestoneId - 1];
+    MilestoneType& milestone = agreement->milestones[milestoneId - 1];
+    ++counters.milestonesTouched;
     
     // Validate milestone state
     if (milestone.state != MilestoneState::PENDING) {
+        recordFailure(counters, VaultError::MILESTONE_NOT_PENDING);
         return false; // Error: Milestone already verified or released
     }
+    if (!chargeWork(WORK_PER_MILESTONE + VaultWorkBounds<Config>::EVIDENCE)) {
+        recordFailure(counters, VaultError::WORK_LIMIT_EXCEEDED);
+        return false; // Error: Work limit reached
+    }
     
     // Update milestone
+    notifyAgreementWrite(slot);
     milestone.state = MilestoneState::VERIFIED;
     milestone.verifiedAtTick = getCurrentTick();
-    milestone.evidenceHash = evidenceHash;
+    if constexpr (Config::STORE_EVIDENCE) {
+        milestone.evidenceHash = evidenceHash;
+    }
     
     // Update agreement state
-    agreement->state = AgreementState::ACTIVE;
+    setAgreementState(*agreement, AgreementState::ACTIVE);
     
     // Emit event
     // emit MilestoneVerified(agreementId, milestoneId, evidenceHash);
     
+    syncColumns(slot);
+    recordSuccess(counters);
     return true;
 }
 
@@ -343,41 +1418,48 @@ bool markMilestoneVerified(
  * @param milestoneId The milestone to release
  * @return success Whether release succeeded
  */
-bool releaseMilestone(uint64_t agreementId, uint32_t milestoneId) {
+template <typename Config>
+bool BasicVaultEngine<Config>::releaseMilestone(uint64_t agreementId, uint32_t milestoneId) {
+    ProcedureCounters& counters = beginProcedure(VaultProcedure::RELEASE_MILESTONE);
+
     // Find agreement
-    Agreement* agreement = nullptr;
-    for (uint32_t i = 0; i < state.activeAgreementCount; ++i) {
-        if (state.agreements[i].id == agreementId) {
-            agreement = &state.agreements[i];
-            break;
-        }
-    }
-    
-    if (agreement == nullptr) {
-        return false; // Error: Agreement not found
+    uint32_t slot = scanForAgreement(agreementId, counters);
+    if (slot == AGREEMENT_NOT_FOUND) {
+        recordFailure(counters, lookupError());
+        return false; // Error: Agreement not found (or work limit reached)
     }
+    AgreementType* agreement = &state.agreements[slot];
     
     // Anyone can call release for a verified milestone (no permission needed)
     // This allows automation and reduces trust requirements
     
     // Find milestone
     if (milestoneId == 0 || milestoneId > agreement->milestoneCount) {
+        recordFailure(counters, VaultError::INVALID_MILESTONE);
         return false; // Error: Invalid milestone ID
     }
     
-    Milestone& milestone = agreement->milestones[milestoneId - 1];
+    MilestoneType& milestone = agreement->milestones[milestoneId - 1];
+    ++counters.milestonesTouched;
     
     // Validate milestone state
     if (milestone.state != MilestoneState::VERIFIED) {
+        recordFailure(counters, VaultError::MILESTONE_NOT_VERIFIED);
         return false; // Error: Milestone not verified
     }
+    // The release plus the completion check over every milestone
+    if (!chargeWork((1 + agreement->milestoneCount) * WORK_PER_MILESTONE)) {
+        recordFailure(counters, VaultError::WORK_LIMIT_EXCEEDED);
+        return false; // Error: Work limit reached
+    }
     
     // Calculate release amount (minus protocol fee)
     uint64_t releaseAmount = milestone.amount;
-    uint64_t protocolFee = releaseAmount / 200; // 0.5% fee
+    uint64_t protocolFee = releaseFee<Config>(releaseAmount); // 0.5% fee by default
     uint64_t beneficiaryAmount = releaseAmount - protocolFee;
     
     // Transfer to beneficiary
+    notifyAgreementWrite(slot);
     transferTo(agreement->beneficiary, beneficiaryAmount);
     
     // Transfer fee to protocol
@@ -388,17 +1470,19 @@ bool releaseMilestone(uint64_t agreementId, uint32_t milestoneId) {
     milestone.releasedAtTick = getCurrentTick();
     
     // Update agreement
-    agreement->lockedAmount -= releaseAmount;
+    setLockedAmount(*agreement, agreement->lockedAmount - releaseAmount);
     agreement->releasedAmount += beneficiaryAmount;
     
     // Update global state
     state.totalValueLocked -= releaseAmount;
     state.totalValueReleased += beneficiaryAmount;
     state.protocolFeeAccrued += protocolFee;
+    recordFlow(TickFlow::RELEASED, milestone.releasedAtTick, releaseAmount);
     
     // Check if all milestones released
     bool allReleased = true;
     for (uint32_t i = 0; i < agreement->milestoneCount; ++i) {
+        ++counters.milestonesTouched;
         if (agreement->milestones[i].state != MilestoneState::RELEASED) {
             allReleased = false;
             break;
@@ -406,12 +1490,14 @@ bool releaseMilestone(uint64_t agreementId, uint32_t milestoneId) {
     }
     
     if (allReleased) {
-        agreement->state = AgreementState::COMPLETED;
+        setAgreementState(*agreement, AgreementState::COMPLETED);
     }
     
     // Emit event
     // emit MilestoneReleased(agreementId, milestoneId, beneficiaryAmount);
     
+    syncColumns(slot);
+    recordSuccess(counters);
     return true;
 }
 
@@ -420,33 +1506,34 @@ bool releaseMilestone(uint64_t agreementId, uint32_t milestoneId) {
  * @param agreementId The agreement to refund
  * @return success Whether refund succeeded
  */
-bool refund(uint64_t agreementId) {
+template <typename Config>
+bool BasicVaultEngine<Config>::refund(uint64_t agreementId) {
+    ProcedureCounters& counters = beginProcedure(VaultProcedure::REFUND);
+
     // Find agreement
-    Agreement* agreement = nullptr;
-    for (uint32_t i = 0; i < state.activeAgreementCount; ++i) {
-        if (state.agreements[i].id == agreementId) {
-            agreement = &state.agreements[i];
-            break;
-        }
-    }
-    
-    if (agreement == nullptr) {
-        return false; // Error: Agreement not found
+    uint32_t slot = scanForAgreement(agreementId, counters);
+    if (slot == AGREEMENT_NOT_FOUND) {
+        recordFailure(counters, lookupError());
+        return false; // Error: Agreement not found (or work limit reached)
     }
+    AgreementType* agreement = &state.agreements[slot];
     
     // Only payer can request refund
     if (!addressEquals(getMessageSender(), agreement->payer)) {
+        recordFailure(counters, VaultError::NOT_PAYER);
         return false; // Error: Only payer can request refund
     }
     
     // Check timeout (must have exceeded timeout tick)
     if (getCurrentTick() < agreement->timeoutTick) {
+        recordFailure(counters, VaultError::TIMEOUT_NOT_REACHED);
         return false; // Error: Timeout not reached
     }
     
     // Check state
     if (agreement->state == AgreementState::COMPLETED ||
         agreement->state == AgreementState::REFUNDED) {
+        recordFailure(counters, VaultError::INVALID_STATE);
         return false; // Error: Cannot refund completed/refunded agreement
     }
     
@@ -454,15 +1541,21 @@ bool refund(uint64_t agreementId) {
     uint64_t refundAmount = agreement->lockedAmount;
     
     if (refundAmount == 0) {
+        recordFailure(counters, VaultError::NOTHING_TO_REFUND);
         return false; // Error: No funds to refund
     }
+    if (!chargeWork(agreement->milestoneCount * WORK_PER_MILESTONE)) {
+        recordFailure(counters, VaultError::WORK_LIMIT_EXCEEDED);
+        return false; // Error: Work limit reached
+    }
     
     // Transfer to payer
+    notifyAgreementWrite(slot);
     transferTo(agreement->payer, refundAmount);
     
     // Update agreement
-    agreement->lockedAmount = 0;
-    agreement->state = AgreementState::REFUNDED;
+    setLockedAmount(*agreement, 0);
+    setAgreementState(*agreement, AgreementState::REFUNDED);
     
     // Mark unreleased milestones as cancelled
     for (uint32_t i = 0; i < agreement->milestoneCount; ++i) {
@@ -474,10 +1567,15 @@ bool refund(uint64_t agreementId) {
     
     // Update global state
     state.totalValueLocked -= refundAmount;
+    state.accountingCounters.refundedToPayers += refundAmount;
+    recordFlow(TickFlow::REFUNDED, agreement->timeoutTick, refundAmount);   // Where a rebuild puts it
     
     // Emit event
     // emit AgreementRefunded(agreementId, refundAmount);
     
+    syncColumns(slot);
+    counters.milestonesTouched += agreement->milestoneCount;
+    recordSuccess(counters);
     return true;
 }
 
@@ -490,13 +1588,15 @@ bool refund(uint64_t agreementId) {
  * @param agreementId The agreement to query
  * @return agreement The agreement data (or empty if not found)
  */
-Agreement getAgreement(uint64_t agreementId) {
-    for (uint32_t i = 0; i < state.activeAgreementCount; ++i) {
-        if (state.agreements[i].id == agreementId) {
-            return state.agreements[i];
-        }
+template <typename Config>
+BasicAgreement<Config> BasicVaultEngine<Config>::getAgreement(uint64_t agreementId) const {
+    work_ = WorkReceipt{};
+    uint32_t slot = meteredFind(agreementId);
+    if (slot == AGREEMENT_NOT_FOUND || !chargeWork(workForBytes(sizeof(AgreementType)))) {
+        work_.error = lookupError();
+        return AgreementType{}; // Empty agreement if not found (or work limit reached)
     }
-    return Agreement{}; // Empty agreement if not found
+    return state.agreements[slot];
 }
 
 /**
@@ -505,10 +1605,22 @@ Agreement getAgreement(uint64_t agreementId) {
  * @param milestoneId The milestone to query
  * @return milestone The milestone data
  */
-Milestone getMilestone(uint64_t agreementId, uint32_t milestoneId) {
-    Agreement agreement = getAgreement(agreementId);
-    if (agreement.id == 0 || milestoneId == 0 || milestoneId > agreement.milestoneCount) {
-        return Milestone{}; // Empty milestone if not found
+template <typename Config>
+BasicMilestone<Config> BasicVaultEngine<Config>::getMilestone(uint64_t agreementId, uint32_t milestoneId) const {
+    work_ = WorkReceipt{};
+    uint32_t slot = meteredFind(agreementId);
+    if (slot == AGREEMENT_NOT_FOUND) {
+        work_.error = lookupError();
+        return MilestoneType{}; // Empty milestone if not found (or work limit reached)
+    }
+    const AgreementType& agreement = state.agreements[slot];
+    if (milestoneId == 0 || milestoneId > agreement.milestoneCount) {
+        work_.error = VaultError::INVALID_MILESTONE;
+        return MilestoneType{}; // Empty milestone if not found
+    }
+    if (!chargeWork(workForBytes(sizeof(MilestoneType)))) {
+        work_.error = VaultError::WORK_LIMIT_EXCEEDED;
+        return MilestoneType{}; // Error: Work limit reached
     }
     return agreement.milestones[milestoneId - 1];
 }
@@ -520,13 +1632,107 @@ Milestone getMilestone(uint64_t agreementId, uint32_t milestoneId) {
  * @return fees Total protocol fees accrued
  * @return count Active agreement count
  */
-void getProtocolStats(uint64_t& tvl, uint64_t& released, uint64_t& fees, uint32_t& count) {
+template <typename Config>
+void BasicVaultEngine<Config>::getProtocolStats(uint64_t& tvl, uint64_t& released, uint64_t& fees, uint32_t& count) const {
+    work_ = WorkReceipt{VaultWorkBounds<Config>::GET_PROTOCOL_STATS, false, VaultError::NONE};
     tvl = state.totalValueLocked;
     released = state.totalValueReleased;
     fees = state.protocolFeeAccrued;
     count = state.activeAgreementCount;
 }
 
+/**
+ * @notice Gets per-procedure call, failure and work counters
+ * @return counters Counters accumulated since the last reset (see epoch, sinceTick)
+ */
+template <typename Config>
+VaultPerfCounters BasicVaultEngine<Config>::getPerfCounters() const {
+    return state.perfCounters;
+}
+
+/**
+ * @notice Gets slot, milestone, index and byte occupancy, in O(1)
+ * @return stats Occupancy now; observed probes cover the perf counter epoch
+ */
+template <typename Config>
+VaultCapacityStats BasicVaultEngine<Config>::getCapacityStats() const {
+    work_ = WorkReceipt{VaultWorkBounds<Config>::GET_CAPACITY_STATS, false, VaultError::NONE};
+    const CapacityCounters& counters = state.capacityCounters;
+    VaultCapacityStats stats = {};
+    stats.capacity = Config::MAX_AGREEMENTS;
+    stats.usedSlots = state.activeAgreementCount;
+    stats.tombstonedSlots = counters.agreementsByState[static_cast<uint32_t>(AgreementState::COMPLETED)] +
+                            counters.agreementsByState[static_cast<uint32_t>(AgreementState::REFUNDED)];
+    stats.liveSlots = stats.usedSlots - stats.tombstonedSlots;
+    stats.freeSlots = Config::MAX_AGREEMENTS - stats.usedSlots;
+    stats.agreementsByState = counters.agreementsByState;
+
+    stats.milestoneSlotsUsed = counters.milestonesUsed;
+    stats.milestoneSlotsReserved = uint64_t(stats.usedSlots) * Config::MAX_MILESTONES;
+
+    stats.indexLoadBasisPoints = static_cast<uint32_t>(uint64_t(stats.usedSlots) * 10000 / Config::MAX_AGREEMENTS);
+    stats.expectedHitProbes = (stats.usedSlots + 1) / 2;
+    stats.expectedMissProbes = stats.usedSlots;
+    for (uint32_t p = static_cast<uint32_t>(VaultProcedure::DEPOSIT); p <= static_cast<uint32_t>(VaultProcedure::REFUND);
+         ++p) {
+        stats.observedLookups += state.perfCounters.procedures[p].calls;
+        stats.observedProbes += state.perfCounters.procedures[p].agreementsScanned;
+    }
+
+    for (uint32_t c = 0; c < STATE_CATEGORY_COUNT; ++c) {
+        stats.bytesInUse[c] = uint64_t(stats.usedSlots) * VaultSlotBytes<Config>::BY_CATEGORY[c];
+        stats.bytesReserved[c] = uint64_t(Config::MAX_AGREEMENTS) * VaultSlotBytes<Config>::BY_CATEGORY[c];
+    }
+    stats.stateBytes = sizeof(StateType);
+    return stats;
+}
+
+/**
+ * @notice Sums lockedAmount over the agreements in a state, from the hot columns
+ * @param agreementState The state to total
+ * @return locked Funds held by agreements in that state (0 if the work limit is reached)
+ */
+template <typename Config>
+uint64_t BasicVaultEngine<Config>::sumLockedByState(AgreementState agreementState) const {
+    if (!chargeColumnScan()) return 0; // Error: Work limit reached
+    const AgreementColumns<Config>& columns = state.columns;
+    uint64_t locked = 0;
+    for (uint32_t i = 0; i < state.activeAgreementCount; ++i) {
+        locked += columns.locked[i] & (uint64_t(0) - static_cast<uint64_t>(columns.state[i] == agreementState));
+    }
+    return locked;
+}
+
+/**
+ * @notice Counts funded agreements whose refund window opens before a tick
+ * @param tick End of the window (exclusive)
+ * @return count FUNDED or ACTIVE agreements with timeoutTick < tick (0 if the work limit is reached)
+ */
+template <typename Config>
+uint32_t BasicVaultEngine<Config>::countExpiringBefore(uint64_t tick) const {
+    if (!chargeColumnScan()) return 0; // Error: Work limit reached
+    const AgreementColumns<Config>& columns = state.columns;
+    uint32_t expiring = 0;
+    for (uint32_t i = 0; i < state.activeAgreementCount; ++i) {
+        bool live = (columns.state[i] == AgreementState::FUNDED) | (columns.state[i] == AgreementState::ACTIVE);
+        expiring += static_cast<uint32_t>(live & (columns.timeoutTick[i] < tick));
+    }
+    return expiring;
+}
+
+/**
+ * @notice Gets one fund flow's amount and event count over a tick range, in O(log TICK_BUCKETS)
+ * @param flow CREATED, FUNDED, RELEASED or REFUNDED
+ * @param fromTick First tick of the range
+ * @param toTick End of the range (exclusive)
+ * @return totals Sums over the buckets the range touches, and the tick range they cover
+ */
+template <typename Config>
+TickFlowTotals BasicVaultEngine<Config>::getTickFlow(TickFlow flow, uint64_t fromTick, uint64_t toTick) const {
+    work_ = WorkReceipt{VaultWorkBounds<Config>::GET_TICK_FLOW, false, VaultError::NONE};
+    return sumTickFlow(state.tickActivity, flow, fromTick, toTick);
+}
+
 // ============================================================================
 // ADMIN FUNCTIONS
 // ============================================================================
@@ -536,16 +1742,36 @@ void getProtocolStats(uint64_t& tvl, uint64_t& released, uint64_t& fees, uint32_
  * @param recipient New fee recipient address
  * @return success Whether update succeeded
  */
-bool setFeeRecipient(const QubicAddress& recipient) {
+template <typename Config>
+bool BasicVaultEngine<Config>::setFeeRecipient(const QubicAddress& recipient) {
+    ProcedureCounters& counters = beginProcedure(VaultProcedure::SET_FEE_RECIPIENT);
     // In production, this would check for contract owner/admin
     // For now, placeholder
     if (!isValidAddress(recipient)) {
+        recordFailure(counters, VaultError::INVALID_ADDRESS);
+        return false;
+    }
+    if (!chargeWork(workForBytes(sizeof(QubicAddress)))) {
+        recordFailure(counters, VaultError::WORK_LIMIT_EXCEEDED);
         return false;
     }
     state.protocolFeeRecipient = recipient;
+    recordSuccess(counters);
     return true;
 }
 
+/**
+ * @notice Zeroes the performance counters and starts a new epoch (admin only)
+ */
+template <typename Config>
+void BasicVaultEngine<Config>::resetPerfCounters() {
+    // In production, this would check for contract owner/admin
+    uint64_t epoch = state.perfCounters.epoch + 1;
+    state.perfCounters = VaultPerfCounters{};
+    state.perfCounters.epoch = epoch;
+    state.perfCounters.sinceTick = getCurrentTick();
+}
+
 // ============================================================================
 // CONTRACT INITIALIZATION
 // ============================================================================
@@ -554,11 +1780,130 @@ bool setFeeRecipient(const QubicAddress& recipient) {
  * @notice Called once when contract is deployed
  * @param feeRecipient Initial protocol fee recipient
  */
-void initialize(const QubicAddress& feeRecipient) {
+template <typename Config>
+void BasicVaultEngine<Config>::initialize(const QubicAddress& feeRecipient) {
+    // Slots are not cleared here; createAgreement clears stale ones as it reuses them
+    retireAgreementSlots(state);
     state.agreementCounter = 0;
     state.totalValueLocked = 0;
     state.totalValueReleased = 0;
     state.protocolFeeAccrued = 0;
     state.protocolFeeRecipient = feeRecipient;
     state.activeAgreementCount = 0;
+    state.capacityCounters = CapacityCounters{};
+    state.accountingCounters = AccountingCounters{};
+    resetTickActivity(state.tickActivity, getCurrentTick());  // Clears only buckets written since the last reset
+    resetPerfCounters();
+}
+
+// ============================================================================
+// GLOBAL API
+// ============================================================================
+
+// Global state instance, driven by the default engine. The free functions
+// below are the single-vault API; they only forward.
+static PronexmaVaultState state;
+static PronexmaVaultEngine defaultEngine(state);
+
+// Host bindings of the default engine.
+static HostContext& hostContext = defaultEngine.hostContext;
+static HostHooks& hostHooks = defaultEngine.hostHooks;
+
+uint64_t createAgreement(
+    const QubicAddress& beneficiary,
+    const QubicAddress& oracleAdmin,
+    uint64_t totalAmount,
+    const uint64_t* milestoneAmounts,
+    uint32_t milestoneCount,
+    const char* title
+) {
+    return defaultEngine.createAgreement(beneficiary, oracleAdmin, totalAmount, milestoneAmounts, milestoneCount, title);
+}
+
+bool deposit(uint64_t agreementId) {
+    return defaultEngine.deposit(agreementId);
+}
+
+bool markMilestoneVerified(uint64_t agreementId, uint32_t milestoneId, const std::array<uint8_t, 64>& evidenceHash) {
+    return defaultEngine.markMilestoneVerified(agreementId, milestoneId, evidenceHash);
+}
+
+bool releaseMilestone(uint64_t agreementId, uint32_t milestoneId) {
+    return defaultEngine.releaseMilestone(agreementId, milestoneId);
+}
+
+bool refund(uint64_t agreementId) {
+    return defaultEngine.refund(agreementId);
+}
+
+Agreement getAgreement(uint64_t agreementId) {
+    return defaultEngine.getAgreement(agreementId);
+}
+
+Milestone getMilestone(uint64_t agreementId, uint32_t milestoneId) {
+    return defaultEngine.getMilestone(agreementId, milestoneId);
+}
+
+void getProtocolStats(uint64_t& tvl, uint64_t& released, uint64_t& fees, uint32_t& count) {
+    defaultEngine.getProtocolStats(tvl, released, fees, count);
+}
+
+VaultPerfCounters getPerfCounters() {
+    return defaultEngine.getPerfCounters();
+}
+
+VaultCapacityStats getCapacityStats() {
+    return defaultEngine.getCapacityStats();
+}
+
+uint64_t sumLockedByState(AgreementState agreementState) {
+    return defaultEngine.sumLockedByState(agreementState);
+}
+
+uint32_t countExpiringBefore(uint64_t tick) {
+    return defaultEngine.countExpiringBefore(tick);
+}
+
+TickFlowTotals getTickFlow(TickFlow flow, uint64_t fromTick, uint64_t toTick) {
+    return defaultEngine.getTickFlow(flow, fromTick, toTick);
+}
+
+bool setFeeRecipient(const QubicAddress& recipient) {
+    return defaultEngine.setFeeRecipient(recipient);
+}
+
+void resetPerfCounters() {
+    defaultEngine.resetPerfCounters();
+}
+
+void initialize(const QubicAddress& feeRecipient) {
+    defaultEngine.initialize(feeRecipient);
+}
+
+inline uint32_t findAgreementSlot(uint64_t agreementId) {
+    return defaultEngine.findAgreementSlot(agreementId);
+}
+
+inline WorkReceipt lastWork() {
+    return defaultEngine.lastWork();
+}
+
+inline void setWorkUnitLimit(uint64_t limit) {
+    defaultEngine.setWorkUnitLimit(limit);
+}
+
+inline uint64_t getCurrentTick() {
+    return defaultEngine.getCurrentTick();
+}
+
+inline QubicAddress getMessageSender() {
+    return defaultEngine.getMessageSender();
+}
+
+inline uint64_t getMessageValue() {
+    return defaultEngine.getMessageValue();
+}
+
+inline void transferTo(const QubicAddress& recipient, uint64_t amount) {
+    defaultEngine.transferTo(recipient, amount);
 }
@@ -0,0 +1,132 @@
+// contracts/bench/BenchCounters.h
+// Pronexma Protocol - Cycle and hardware counters for the native benchmarks
+//
+// benchCycles() reads the CPU timestamp counter (rdtsc on x86, cntvct on
+// AArch64) and falls back to steady_clock nanoseconds elsewhere. PerfCounters
+// opens a user-space-only perf_event group (cycles, instructions, cache and
+// branch misses) when the kernel allows it; otherwise available() is false and
+// benchmarks report the counters as null.
+
+#pragma once
+
+#include "BenchSupport.h"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+inline uint64_t benchCycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return benchNowNanos();
+#endif
+}
+
+inline const char* benchCycleSource() {
+#if defined(__x86_64__) || defined(__i386__)
+    return "rdtsc";
+#elif defined(__aarch64__)
+    return "cntvct";
+#else
+    return "steady_clock_ns";
+#endif
+}
+
+// Keeps the optimizer from discarding a benchmarked result.
+template <typename T>
+inline void benchKeep(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+class PerfCounters {
+public:
+    enum Event { CYCLES, INSTRUCTIONS, CACHE_MISSES, BRANCH_MISSES, EVENT_COUNT };
+
+    PerfCounters() {
+#if defined(__linux__)
+        const uint64_t configs[EVENT_COUNT] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                               PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+        for (int i = 0; i < EVENT_COUNT; ++i) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = configs[i];
+            attr.disabled = i == 0 ? 1 : 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP;
+            int fd = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, i == 0 ? -1 : fds_[0], 0));
+            if (fd < 0) {
+                close();
+                return;
+            }
+            fds_[i] = fd;
+        }
+        available_ = true;
+#endif
+    }
+
+    ~PerfCounters() { close(); }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available() const { return available_; }
+
+    void reset() {
+        std::memset(totals_, 0, sizeof(totals_));
+    }
+
+    void start() {
+#if defined(__linux__)
+        if (!available_) return;
+        ::ioctl(fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ::ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    /** Stops counting and adds the interval to the running totals. */
+    void stop() {
+#if defined(__linux__)
+        if (!available_) return;
+        ::ioctl(fds_[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        uint64_t values[1 + EVENT_COUNT];
+        if (::read(fds_[0], values, sizeof(values)) == static_cast<ssize_t>(sizeof(values))) {
+            for (int i = 0; i < EVENT_COUNT; ++i) totals_[i] += values[1 + i];
+        }
+#endif
+    }
+
+    uint64_t total(Event event) const { return totals_[event]; }
+
+private:
+    void close() {
+#if defined(__linux__)
+        for (int& fd : fds_) {
+            if (fd >= 0) ::close(fd);
+            fd = -1;
+        }
+#endif
+        available_ = false;
+    }
+
+    int fds_[EVENT_COUNT] = {-1, -1, -1, -1};
+    uint64_t totals_[EVENT_COUNT] = {};
+    bool available_ = false;
+};
@@ -0,0 +1,130 @@
+// contracts/bench/BenchSupport.h
+// Pronexma Protocol - Shared helpers for the native vault benchmarks
+
+#pragma once
+
+#include "PronexmaVault.cpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+inline uint64_t benchNowNanos() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// The key holding the label "<prefix><n>" (see host/VaultIdentity.h).
+inline QubicAddress benchAddress(const char* prefix, uint64_t n) {
+    char label[sizeof(QubicAddress) + 1];
+    int length = std::snprintf(label, sizeof(label), "%s%llu", prefix, static_cast<unsigned long long>(n));
+    QubicAddress address = {};
+    std::memcpy(address.data(), label, std::min<size_t>(static_cast<size_t>(length), address.size()));
+    return address;
+}
+
+// Nearest-rank percentile over an unsorted sample; sorts in place.
+inline uint64_t benchPercentile(std::vector<uint64_t>& samples, double p) {
+    if (samples.empty()) return 0;
+    std::sort(samples.begin(), samples.end());
+    size_t rank = static_cast<size_t>(p / 100.0 * static_cast<double>(samples.size()));
+    return samples[std::min(rank, samples.size() - 1)];
+}
+
+// xorshift64*: deterministic and cheap enough to not show up in timings.
+struct BenchRng {
+    uint64_t s;
+    explicit BenchRng(uint64_t seed) : s(seed ? seed : 0x9E3779B97F4A7C15ull) {}
+    uint64_t next() {
+        s ^= s >> 12;
+        s ^= s << 25;
+        s ^= s >> 27;
+        return s * 0x2545F4914F6CDD1Dull;
+    }
+    uint32_t below(uint32_t n) { return static_cast<uint32_t>(next() % n); }
+};
+
+// Parses "--name value" style options; returns fallback when absent.
+inline uint64_t benchArg(int argc, char** argv, const char* name, uint64_t fallback) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], name) == 0) {
+            return std::strtoull(argv[i + 1], nullptr, 10);
+        }
+    }
+    return fallback;
+}
+
+inline const char* benchArgString(int argc, char** argv, const char* name, const char* fallback) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], name) == 0) {
+            return argv[i + 1];
+        }
+    }
+    return fallback;
+}
+
+// A random key, as a decoded Qubic identity looks.
+inline QubicAddress benchIdentity(BenchRng& rng) {
+    QubicAddress address;
+    for (size_t i = 0; i < address.size(); i += 8) {
+        uint64_t word = rng.next();
+        std::memcpy(address.data() + i, &word, 8);
+    }
+    return address;
+}
+
+inline void benchCopyText(char* dst, size_t capacity, const std::string& text) {
+    std::memcpy(dst, text.data(), std::min(capacity - 1, text.size()));
+}
+
+// Agreement shapes resembling the backend mirror: a few hundred parties,
+// 2-6 milestones, short titles and JSON metadata, partial verification.
+inline void populateRealisticVault(uint32_t count, uint64_t seed = 7) {
+    BenchRng rng(seed);
+    std::vector<QubicAddress> parties;
+    for (int i = 0; i < 400; ++i) parties.push_back(benchIdentity(rng));
+
+    initialize(parties[0]);
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t milestones = 2 + rng.below(5);
+        uint64_t amounts[MAX_MILESTONES_PER_AGREEMENT];
+        uint64_t total = 0;
+        for (uint32_t m = 0; m < milestones; ++m) {
+            amounts[m] = 1000 * (1 + rng.below(500000));
+            total += amounts[m];
+        }
+        std::string title = "Nostromo launch vesting #" + std::to_string(i);
+        createAgreement(parties[rng.below(400)], parties[rng.below(8)], total, amounts, milestones, title.c_str());
+
+        Agreement& agreement = state.agreements[i];
+        agreement.payer = parties[rng.below(400)];
+        agreement.createdAtTick = 12000000 + i * 3;
+        benchCopyText(agreement.metadata.data(), agreement.metadata.size(),
+                 "{\"source\":\"nostromo\",\"round\":\"seed\",\"tags\":[\"ido\",\"vesting\"],\"n\":" + std::to_string(i) + "}");
+        if (rng.below(4) != 0) {
+            agreement.state = AgreementState::FUNDED;
+            agreement.lockedAmount = total;
+            agreement.fundedAtTick = agreement.createdAtTick + 40;
+            agreement.timeoutTick = agreement.fundedAtTick + REFUND_TIMEOUT_TICKS;
+        }
+        for (uint32_t m = 0; m < milestones; ++m) {
+            Milestone& milestone = agreement.milestones[m];
+            benchCopyText(milestone.description.data(), milestone.description.size(), "Milestone " + std::to_string(m + 1) + ": deliverable shipped");
+            if (agreement.state != AgreementState::CREATED && rng.below(3) == 0) {
+                agreement.state = AgreementState::ACTIVE;   // As markMilestoneVerified leaves it
+                milestone.state = MilestoneState::VERIFIED;
+                milestone.verifiedAtTick = agreement.fundedAtTick + 1000 * (m + 1);
+                for (size_t b = 0; b < 32; ++b) milestone.evidenceHash[b] = static_cast<uint8_t>(rng.next());
+            }
+        }
+    }
+    for (uint32_t i = 0; i < count; ++i) state.totalValueLocked += state.agreements[i].lockedAmount;
+    rebuildCapacityCounters(state);
+    rebuildAccountingCounters(state);
+    rebuildAgreementColumns(state);
+    rebuildTickActivity(state);
+}
@@ -0,0 +1,91 @@
+// contracts/bench/address_bench.cpp
+// Addresses as 32-byte keys: identity text <-> key conversion at the host
+// boundary, and the contract's sender check against the 64-byte text compare
+// it replaced.
+//
+// Usage: address_bench [--addresses N] [--rounds R]
+//
+// Output: one JSON object.
+
+#include "BenchCounters.h"
+#include "BenchSupport.h"
+#include "host/VaultIdentity.h"
+
+namespace {
+
+using TextAddress = std::array<char, 64>;
+
+// The sender check before binary addresses: a byte loop over 64 chars.
+bool textAddressEquals(const TextAddress& a, const TextAddress& b) {
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i] != b[i]) return false;
+    }
+    return true;
+}
+
+double nanosPer(uint64_t nanos, uint64_t operations) {
+    return operations == 0 ? 0.0 : static_cast<double>(nanos) / static_cast<double>(operations);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t count = static_cast<uint32_t>(std::max<uint64_t>(2, benchArg(argc, argv, "--addresses", 4096)));
+    uint32_t rounds = static_cast<uint32_t>(std::max<uint64_t>(1, benchArg(argc, argv, "--rounds", 200)));
+
+    BenchRng rng(11);
+    std::vector<QubicAddress> keys(count);
+    std::vector<TextAddress> texts(count);
+    std::vector<std::string> identities(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        keys[i] = benchIdentity(rng);
+        identities[i] = addressIdentity(keys[i]);
+        texts[i] = TextAddress{};
+        std::memcpy(texts[i].data(), identities[i].data(), identities[i].size());
+    }
+
+    char identity[QUBIC_IDENTITY_LENGTH + 1];
+    uint64_t start = benchNowNanos();
+    for (uint32_t i = 0; i < count; ++i) {
+        addressToIdentity(keys[i], identity);
+        benchKeep(identity);
+    }
+    uint64_t encodeNs = benchNowNanos() - start;
+
+    QubicAddress decoded = {};
+    uint32_t decodeFailures = 0;
+    start = benchNowNanos();
+    for (uint32_t i = 0; i < count; ++i) {
+        decodeFailures += !identityToAddress(identities[i].data(), identities[i].size(), decoded);
+        benchKeep(&decoded);
+    }
+    uint64_t decodeNs = benchNowNanos() - start;
+
+    // Sender checks against matching addresses, the case every authorized call pays.
+    std::vector<QubicAddress> keyCopies = keys;
+    std::vector<TextAddress> textCopies = texts;
+    uint64_t matches = 0;
+    start = benchNowNanos();
+    for (uint32_t r = 0; r < rounds; ++r) {
+        for (uint32_t i = 0; i < count; ++i) matches += textAddressEquals(texts[i], textCopies[i]);
+        benchKeep(textCopies.data());
+    }
+    uint64_t textCompareNs = benchNowNanos() - start;
+    start = benchNowNanos();
+    for (uint32_t r = 0; r < rounds; ++r) {
+        for (uint32_t i = 0; i < count; ++i) matches += addressEquals(keys[i], keyCopies[i]);
+        benchKeep(keyCopies.data());
+    }
+    uint64_t keyCompareNs = benchNowNanos() - start;
+
+    uint64_t compares = uint64_t(count) * rounds;
+    std::printf("{\"bench\":\"address\",\"addresses\":%u,\"rounds\":%u,\"addressBytes\":%zu,\"textAddressBytes\":%zu,"
+                "\"agreementBytes\":%zu,\"toIdentityNs\":%.1f,\"fromIdentityNs\":%.1f,\"decodeFailures\":%u,"
+                "\"textCompareNs\":%.2f,\"keyCompareNs\":%.2f,\"compareSpeedup\":%.2f,\"matches\":%llu}\n",
+                count, rounds, sizeof(QubicAddress), sizeof(TextAddress), sizeof(Agreement), nanosPer(encodeNs, count),
+                nanosPer(decodeNs, count), decodeFailures, nanosPer(textCompareNs, compares),
+                nanosPer(keyCompareNs, compares),
+                keyCompareNs == 0 ? 0.0 : static_cast<double>(textCompareNs) / static_cast<double>(keyCompareNs),
+                static_cast<unsigned long long>(matches));
+    return decodeFailures == 0 ? 0 : 1;
+}
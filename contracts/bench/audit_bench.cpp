@@ -0,0 +1,67 @@
+// contracts/bench/audit_bench.cpp
+// Cost of checking the vault's accounting: the O(1) identities over the
+// running sums, the column-wise full-scan audit (host/VaultAudit.h), and the
+// per-slot recount it replaces.
+//
+// Usage: audit_bench [--agreements N] [--runs R]
+
+#include "BenchCounters.h"
+#include "BenchSupport.h"
+#include "host/VaultAudit.h"
+
+namespace {
+
+// The straightforward audit: walk each record, branch on its state.
+bool recountPerSlot(const PronexmaVaultState& vault) {
+    AccountingCounters counters = {};
+    uint64_t locked = 0, released = 0, fees = 0;
+    for (uint32_t i = 0; i < vault.activeAgreementCount; ++i) {
+        const Agreement& agreement = vault.agreements[i];
+        accountAgreement(counters, agreement);
+        locked += agreement.lockedAmount;
+        released += agreement.releasedAmount;
+        for (uint32_t m = 0; m < agreement.milestoneCount; ++m) {
+            if (agreement.milestones[m].state == MilestoneState::RELEASED) fees += releaseFee(agreement.milestones[m].amount);
+        }
+    }
+    return counters.lockedByState == vault.accountingCounters.lockedByState &&
+           counters.depositedByPayers == vault.accountingCounters.depositedByPayers &&
+           counters.refundedToPayers == vault.accountingCounters.refundedToPayers && locked == vault.totalValueLocked &&
+           released == vault.totalValueReleased && fees == vault.protocolFeeAccrued;
+}
+
+template <typename Check>
+uint64_t medianNanos(uint32_t runs, Check check, bool& clean) {
+    std::vector<uint64_t> samples;
+    for (uint32_t r = 0; r < runs; ++r) {
+        uint64_t start = benchNowNanos();
+        clean = check() && clean;
+        samples.push_back(benchNowNanos() - start);
+    }
+    return benchPercentile(samples, 50.0);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t agreements = static_cast<uint32_t>(
+        std::min<uint64_t>(benchArg(argc, argv, "--agreements", MAX_AGREEMENTS), MAX_AGREEMENTS));
+    uint32_t runs = static_cast<uint32_t>(std::max<uint64_t>(1, benchArg(argc, argv, "--runs", 50)));
+    populateRealisticVault(agreements);
+
+    bool clean = true;
+    uint64_t invariantNs = medianNanos(runs * 100, [] {
+        benchKeep(&state);
+        return checkAccountingInvariants(state) == AccountingViolation::NONE;
+    }, clean);
+    uint64_t perSlotNs = medianNanos(runs, [] { return recountPerSlot(state); }, clean);
+    uint64_t columnNs = medianNanos(runs, [] { return auditVaultAccounting(state).clean(); }, clean);
+
+    std::printf("{\"bench\":\"audit\",\"agreements\":%u,\"runs\":%u,\"invariantCheckNs\":%llu,\"perSlotScanNs\":%llu,"
+                "\"columnAuditNs\":%llu,\"speedup\":%.2f,\"clean\":%s}\n",
+                agreements, runs, static_cast<unsigned long long>(invariantNs),
+                static_cast<unsigned long long>(perSlotNs), static_cast<unsigned long long>(columnNs),
+                columnNs == 0 ? 0.0 : static_cast<double>(perSlotNs) / static_cast<double>(columnNs),
+                clean ? "true" : "false");
+    return clean ? 0 : 1;
+}
@@ -0,0 +1,85 @@
+// contracts/bench/bulk_load_bench.cpp
+// Historical import throughput: per-call createAgreement + deposit with
+// incremental index maintenance vs the bulk loader (host/VaultBulkLoad.h).
+//
+// Usage: bulk_load_bench [--agreements N] [--runs R]
+//
+// The per-call path runs against a NativeHost so every deposit is really
+// funded by the record's payer.
+
+#include "BenchSupport.h"
+#include "host/VaultBulkLoad.h"
+#include "host/VaultHost.h"
+
+#include <memory>
+
+namespace {
+
+uint64_t perCallLoad(const std::vector<Agreement>& records) {
+    NativeHost host;
+    HostContextBinding binding(host.context());
+    for (const Agreement& record : records) host.credit(record.payer, record.totalAmount);
+
+    VaultIndexes indexes;
+    uint64_t start = benchNowNanos();
+    initialize(records[0].payer);
+    buildVaultIndexes(state, indexes);
+    for (const Agreement& record : records) {
+        uint64_t amounts[MAX_MILESTONES_PER_AGREEMENT];
+        for (uint32_t m = 0; m < record.milestoneCount; ++m) amounts[m] = record.milestones[m].amount;
+        host.setSender(record.payer);
+        uint64_t id = createAgreement(record.beneficiary, record.oracleAdmin, record.totalAmount, amounts,
+                                      record.milestoneCount, record.title.data());
+        host.invoke(record.payer, record.totalAmount, [&] { return deposit(id); });
+        uint32_t slot = state.activeAgreementCount - 1;
+        addToVaultIndexes(indexes, state.agreements[slot], slot);
+    }
+    return benchNowNanos() - start;
+}
+
+uint64_t bulkLoad(const std::vector<Agreement>& records, BulkLoadReport& report) {
+    VaultIndexes indexes;
+    uint64_t start = benchNowNanos();
+    initialize(records[0].payer);
+    SnapshotStatus status = bulkLoadAgreements(state, records.data(), static_cast<uint32_t>(records.size()),
+                                               indexes, &report);
+    uint64_t elapsed = benchNowNanos() - start;
+    if (status != SnapshotStatus::OK) {
+        std::fprintf(stderr, "bulk load failed: %s\n", snapshotStatusName(status));
+    }
+    return elapsed;
+}
+
+void report(const char* mode, uint32_t agreements, uint64_t nanos, double speedup) {
+    std::printf("{\"bench\":\"bulk_load\",\"mode\":\"%s\",\"agreements\":%u,\"totalNs\":%llu,"
+                "\"agreementsPerSecond\":%.0f,\"speedup\":%.2f}\n",
+                mode, agreements, static_cast<unsigned long long>(nanos),
+                nanos == 0 ? 0.0 : agreements * 1e9 / static_cast<double>(nanos), speedup);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t agreements = static_cast<uint32_t>(benchArg(argc, argv, "--agreements", MAX_AGREEMENTS));
+    int runs = static_cast<int>(benchArg(argc, argv, "--runs", 3));
+    agreements = std::max<uint32_t>(1, std::min<uint32_t>(agreements, MAX_AGREEMENTS));
+
+    populateRealisticVault(agreements);
+    std::vector<Agreement> records(state.agreements.begin(), state.agreements.begin() + agreements);
+
+    std::vector<uint64_t> perCall;
+    std::vector<uint64_t> bulk;
+    BulkLoadReport loadReport;
+    for (int run = 0; run < runs; ++run) {
+        perCall.push_back(perCallLoad(records));
+        bulk.push_back(bulkLoad(records, loadReport));
+    }
+    uint64_t perCallNs = benchPercentile(perCall, 50.0);
+    uint64_t bulkNs = benchPercentile(bulk, 50.0);
+    report("per_call", agreements, perCallNs, 1.0);
+    report("bulk", agreements, bulkNs, bulkNs == 0 ? 0.0 : static_cast<double>(perCallNs) / static_cast<double>(bulkNs));
+    std::printf("{\"bench\":\"bulk_load\",\"mode\":\"bulk_phases\",\"loadUs\":%llu,\"indexUs\":%llu}\n",
+                static_cast<unsigned long long>(loadReport.loadMicros),
+                static_cast<unsigned long long>(loadReport.indexMicros));
+    return 0;
+}
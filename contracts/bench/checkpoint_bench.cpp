@@ -0,0 +1,106 @@
+// contracts/bench/checkpoint_bench.cpp
+// Tick latency with no checkpoint, with a background checkpoint in flight, and
+// with a blocking snapshot taken inside the tick.
+//
+// Usage: checkpoint_bench [--agreements N] [--ticks T] [--ops-per-tick K] [--path FILE]
+// Output: one JSON object per mode on stdout.
+
+#include "BenchSupport.h"
+#include "host/VaultCheckpoint.h"
+
+#include <string>
+
+namespace {
+
+struct Options {
+    uint32_t agreements;
+    uint32_t ticks;
+    uint32_t opsPerTick;
+    std::string path;
+};
+
+enum class Mode { NONE, BACKGROUND, BLOCKING };
+
+const char* modeName(Mode mode) {
+    switch (mode) {
+        case Mode::NONE: return "none";
+        case Mode::BACKGROUND: return "background";
+        case Mode::BLOCKING: return "blocking";
+    }
+    return "?";
+}
+
+void prefill(uint32_t count) {
+    initialize(benchAddress("FEE", 0));
+    const uint64_t amounts[4] = {0, 0, 0, 0};
+    for (uint32_t i = 0; i < count; ++i) {
+        createAgreement(benchAddress("BEN", i), benchAddress("ORA", i % 16), 0, amounts, 4, "benchmark agreement");
+    }
+}
+
+// Half the operations create agreements (slots outside any captured view),
+// half deposit into random existing slots (copy-on-write candidates).
+void runTick(BenchRng& rng, uint32_t ops, uint64_t tick) {
+    const uint64_t amounts[4] = {0, 0, 0, 0};
+    for (uint32_t i = 0; i < ops; ++i) {
+        if ((i & 1) == 0 && state.activeAgreementCount < MAX_AGREEMENTS) {
+            createAgreement(benchAddress("BEN", tick), benchAddress("ORA", i), 0, amounts, 4, "tick agreement");
+        } else {
+            deposit(state.agreements[rng.below(state.activeAgreementCount)].id);
+        }
+    }
+}
+
+void runMode(const Options& options, Mode mode) {
+    prefill(options.agreements);
+    BenchRng rng(42);
+    VaultCheckpointer checkpointer(defaultEngine);
+    std::vector<uint64_t> latencies;
+    uint32_t checkpoints = 0;
+
+    for (uint32_t tick = 0; tick < options.ticks; ++tick) {
+        uint64_t start = benchNowNanos();
+        if (mode == Mode::BACKGROUND && !checkpointer.inFlight()) {
+            if (checkpointer.begin(options.path, tick) == SnapshotStatus::OK) ++checkpoints;
+        }
+        if (mode == Mode::BLOCKING && tick % 16 == 0) {
+            if (writeSnapshot(state, tick, options.path) == SnapshotStatus::OK) ++checkpoints;
+        }
+        runTick(rng, options.opsPerTick, tick);
+        uint64_t elapsed = benchNowNanos() - start;
+
+        // Background mode only samples ticks that actually overlapped a checkpoint.
+        if (mode != Mode::BACKGROUND || checkpointer.inFlight()) {
+            latencies.push_back(elapsed);
+        }
+    }
+    checkpointer.wait();
+
+    uint64_t samples = latencies.size();
+    uint64_t p50 = benchPercentile(latencies, 50.0);
+    uint64_t p99 = benchPercentile(latencies, 99.0);
+    uint64_t max = latencies.empty() ? 0 : latencies.back();
+    std::printf("{\"bench\":\"checkpoint\",\"mode\":\"%s\",\"agreements\":%u,\"opsPerTick\":%u,"
+                "\"samples\":%llu,\"checkpoints\":%u,\"p50Ns\":%llu,\"p99Ns\":%llu,\"maxNs\":%llu,"
+                "\"lastPreservedSlots\":%u}\n",
+                modeName(mode), options.agreements, options.opsPerTick,
+                static_cast<unsigned long long>(samples), checkpoints,
+                static_cast<unsigned long long>(p50), static_cast<unsigned long long>(p99),
+                static_cast<unsigned long long>(max), checkpointer.lastStats().preservedSlots);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    options.agreements = static_cast<uint32_t>(benchArg(argc, argv, "--agreements", 6000));
+    options.ticks = static_cast<uint32_t>(benchArg(argc, argv, "--ticks", 200));
+    options.opsPerTick = static_cast<uint32_t>(benchArg(argc, argv, "--ops-per-tick", 32));
+    options.path = benchArgString(argc, argv, "--path", "/tmp/pronexma_checkpoint_bench.snap");
+
+    runMode(options, Mode::NONE);
+    runMode(options, Mode::BACKGROUND);
+    runMode(options, Mode::BLOCKING);
+    ::unlink(options.path.c_str());
+    return 0;
+}
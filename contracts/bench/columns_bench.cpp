@@ -0,0 +1,93 @@
+// contracts/bench/columns_bench.cpp
+// Aggregate views over the hot columns against the same scans striding
+// through the agreement records: locked funds per state (the engine's view
+// and the dispatched SIMD kernel) and agreements expiring before a tick.
+//
+// Usage: columns_bench [--agreements N] [--runs R]
+//
+// Output: one JSON object. Times are whole-vault scans in nanoseconds
+// (median of R runs); the per-state sums cover all five states.
+
+#include "BenchCounters.h"
+#include "BenchSupport.h"
+#include "host/VaultKernels.h"
+
+namespace {
+
+template <typename Scan>
+uint64_t medianNanos(uint32_t runs, Scan scan) {
+    std::vector<uint64_t> samples;
+    for (uint32_t r = 0; r < runs; ++r) {
+        uint64_t start = benchNowNanos();
+        benchKeep(scan());
+        samples.push_back(benchNowNanos() - start);
+    }
+    return benchPercentile(samples, 50.0);
+}
+
+uint64_t recordLockedByState(AgreementState agreementState) {
+    uint64_t locked = 0;
+    for (uint32_t i = 0; i < state.activeAgreementCount; ++i) {
+        if (state.agreements[i].state == agreementState) locked += state.agreements[i].lockedAmount;
+    }
+    return locked;
+}
+
+uint32_t recordExpiringBefore(uint64_t tick) {
+    uint32_t expiring = 0;
+    for (uint32_t i = 0; i < state.activeAgreementCount; ++i) {
+        const Agreement& agreement = state.agreements[i];
+        bool live = agreement.state == AgreementState::FUNDED || agreement.state == AgreementState::ACTIVE;
+        if (live && agreement.timeoutTick < tick) ++expiring;
+    }
+    return expiring;
+}
+
+template <typename SumLocked>
+uint64_t sumAllStates(SumLocked sumLocked) {
+    uint64_t folded = 0;
+    for (uint32_t s = 0; s < AGREEMENT_STATE_COUNT; ++s) folded = folded * 31 + sumLocked(static_cast<AgreementState>(s));
+    return folded;
+}
+
+double ratio(uint64_t before, uint64_t after) {
+    return after == 0 ? 0.0 : static_cast<double>(before) / static_cast<double>(after);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t agreements = static_cast<uint32_t>(
+        std::min<uint64_t>(benchArg(argc, argv, "--agreements", MAX_AGREEMENTS), MAX_AGREEMENTS));
+    uint32_t runs = static_cast<uint32_t>(std::max<uint64_t>(1, benchArg(argc, argv, "--runs", 200)));
+    populateRealisticVault(agreements);
+    // Half the funded agreements' refund windows open before this tick.
+    const uint64_t tick = 12000000 + uint64_t(agreements) * 3 / 2 + 40 + REFUND_TIMEOUT_TICKS;
+
+    uint64_t recordLocked = 0, columnLocked = 0, kernelLocked = 0;
+    uint32_t recordExpiring = 0, columnExpiring = 0;
+    uint64_t recordLockedNs = medianNanos(runs, [&] { return recordLocked = sumAllStates(recordLockedByState); });
+    uint64_t columnLockedNs = medianNanos(runs, [&] {
+        return columnLocked = sumAllStates([](AgreementState s) { return sumLockedByState(s); });
+    });
+    uint64_t kernelLockedNs = medianNanos(runs, [&] {
+        return kernelLocked = sumAllStates([](AgreementState s) { return kernelSumLockedByState(state, s); });
+    });
+    uint64_t recordExpiringNs = medianNanos(runs, [&] { return recordExpiring = recordExpiringBefore(tick); });
+    uint64_t columnExpiringNs = medianNanos(runs, [&] { return columnExpiring = countExpiringBefore(tick); });
+
+    bool agree = recordLocked == columnLocked && recordLocked == kernelLocked && recordExpiring == columnExpiring;
+    std::printf("{\"bench\":\"columns\",\"agreements\":%u,\"runs\":%u,\"kernelLevel\":\"%s\",\"recordBytes\":%zu,"
+                "\"columnBytesPerSlot\":%llu,\"recordLockedByStateNs\":%llu,\"columnLockedByStateNs\":%llu,"
+                "\"kernelLockedByStateNs\":%llu,\"lockedSpeedup\":%.2f,\"kernelLockedSpeedup\":%.2f,"
+                "\"recordExpiringNs\":%llu,\"columnExpiringNs\":%llu,\"expiringSpeedup\":%.2f,\"expiring\":%u,"
+                "\"agree\":%s}\n",
+                agreements, runs, kernelLevelName(vaultKernels().level), sizeof(Agreement),
+                static_cast<unsigned long long>(COLUMN_SCAN_BYTES_PER_SLOT),
+                static_cast<unsigned long long>(recordLockedNs), static_cast<unsigned long long>(columnLockedNs),
+                static_cast<unsigned long long>(kernelLockedNs), ratio(recordLockedNs, columnLockedNs),
+                ratio(recordLockedNs, kernelLockedNs), static_cast<unsigned long long>(recordExpiringNs),
+                static_cast<unsigned long long>(columnExpiringNs), ratio(recordExpiringNs, columnExpiringNs),
+                columnExpiring, agree ? "true" : "false");
+    return agree ? 0 : 1;
+}
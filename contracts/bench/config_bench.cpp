@@ -0,0 +1,88 @@
+// contracts/bench/config_bench.cpp
+// The same workload on each preset vault configuration (DefaultVaultConfig,
+// LeanInvoiceVaultConfig, LaunchpadVaultConfig): record and state size, then
+// per-call cost of filling, looking up and settling agreements.
+//
+// Usage: config_bench [--agreements N] [--samples S]
+//
+// Every preset is filled with N (capped at its capacity) two-milestone
+// agreements. getAgreement targets the last slot, so it scans the whole table
+// and shows how record size drives the lookup. Output: one JSON object per
+// preset.
+
+#include "BenchSupport.h"
+#include "host/VaultHost.h"
+
+#include <memory>
+
+namespace {
+
+const QubicAddress payer = benchAddress("PAYER", 0);
+const QubicAddress beneficiary = benchAddress("BENEFICIARY", 0);
+const QubicAddress oracle = benchAddress("ORACLE", 0);
+const QubicAddress feeRecipient = benchAddress("FEES", 0);
+
+template <typename Config>
+void runPreset(const char* name, uint32_t requested, uint32_t samples) {
+    auto vault = std::make_unique<BasicVaultState<Config>>();
+    BasicVaultEngine<Config> engine(*vault);
+    NativeHost host;
+    HostContextBinding binding(engine, host.context());
+    engine.initialize(feeRecipient);
+    host.credit(payer, UINT64_MAX / 4);
+    host.credit(host.contractAccount(), UINT64_MAX / 4);
+
+    uint32_t agreements = std::max<uint32_t>(1, std::min(requested, Config::MAX_AGREEMENTS));
+    const uint64_t amounts[2] = {1000000, 1000000};
+    std::vector<uint64_t> ids;
+    ids.reserve(agreements);
+    uint64_t start = benchNowNanos();
+    for (uint32_t i = 0; i < agreements; ++i) {
+        host.setSender(payer);
+        uint64_t id = engine.createAgreement(beneficiary, oracle, 2000000, amounts, 2, "bench agreement");
+        host.invoke(payer, 2000000, [&] { return engine.deposit(id); });
+        ids.push_back(id);
+    }
+    uint64_t fillNs = benchNowNanos() - start;
+
+    std::vector<uint64_t> lookups;
+    for (uint32_t s = 0; s < samples; ++s) {
+        uint64_t begin = benchNowNanos();
+        BasicAgreement<Config> agreement = engine.getAgreement(ids.back());
+        lookups.push_back(benchNowNanos() - begin);
+        if (agreement.id != ids.back()) std::fprintf(stderr, "config_bench: lookup missed\n");
+    }
+
+    std::array<uint8_t, 64> evidence = {};
+    std::vector<uint64_t> settles;
+    uint32_t settled = std::min(samples, agreements);
+    for (uint32_t s = 0; s < settled; ++s) {
+        uint64_t id = ids[uint64_t(s) * agreements / settled];  // Spread over the table, each once
+        uint64_t begin = benchNowNanos();
+        host.invoke(oracle, 0, [&] { return engine.markMilestoneVerified(id, 1, evidence); });
+        host.invoke(beneficiary, 0, [&] { return engine.releaseMilestone(id, 1); });
+        settles.push_back(benchNowNanos() - begin);
+    }
+
+    std::printf("{\"bench\":\"config\",\"config\":\"%s\",\"maxAgreements\":%u,\"maxMilestones\":%u,"
+                "\"feeBasisPoints\":%u,\"milestoneBytes\":%zu,\"agreementBytes\":%zu,\"stateBytes\":%zu,"
+                "\"agreements\":%u,\"fillNsPerAgreement\":%.0f,\"getAgreementLastNsP50\":%llu,"
+                "\"verifyReleaseNsP50\":%llu,\"protocolFees\":%llu}\n",
+                name, Config::MAX_AGREEMENTS, Config::MAX_MILESTONES, Config::FEE_BASIS_POINTS,
+                sizeof(BasicMilestone<Config>), sizeof(BasicAgreement<Config>), sizeof(BasicVaultState<Config>),
+                agreements, static_cast<double>(fillNs) / agreements,
+                static_cast<unsigned long long>(benchPercentile(lookups, 50.0)),
+                static_cast<unsigned long long>(benchPercentile(settles, 50.0)),
+                static_cast<unsigned long long>(vault->protocolFeeAccrued));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t agreements = static_cast<uint32_t>(benchArg(argc, argv, "--agreements", MAX_AGREEMENTS));
+    uint32_t samples = static_cast<uint32_t>(std::max<uint64_t>(1, benchArg(argc, argv, "--samples", 200)));
+    runPreset<DefaultVaultConfig>("default", agreements, samples);
+    runPreset<LeanInvoiceVaultConfig>("lean_invoice", agreements, samples);
+    runPreset<LaunchpadVaultConfig>("launchpad", agreements, samples);
+    return 0;
+}
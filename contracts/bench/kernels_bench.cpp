@@ -0,0 +1,165 @@
+// contracts/bench/kernels_bench.cpp
+// SIMD kernels (host/VaultKernels.h) at every level this CPU runs, against
+// the loops the contract and the host use today: addressEquals over the
+// records, per-agreement milestone loops and a vault-wide pending sum.
+//
+// Usage: kernels_bench [--agreements N] [--runs R]
+//
+// Output: one JSON object for the current loops, then one per kernel level.
+// Scans are whole-vault times in nanoseconds (median of R runs).
+
+#include "BenchCounters.h"
+#include "BenchSupport.h"
+#include "host/VaultKernels.h"
+
+namespace {
+
+template <typename Scan>
+uint64_t medianNanos(uint32_t runs, Scan scan) {
+    std::vector<uint64_t> samples;
+    for (uint32_t r = 0; r < runs; ++r) {
+        uint64_t start = benchNowNanos();
+        benchKeep(scan());
+        samples.push_back(benchNowNanos() - start);
+    }
+    return benchPercentile(samples, 50.0);
+}
+
+struct ScanTimes {
+    uint64_t payerScanNs = 0;       // Agreements whose payer is one key
+    uint64_t completionNs = 0;      // Per agreement: are all milestones released?
+    uint64_t verifiedNs = 0;        // Per agreement: is any milestone verified?
+    uint64_t pendingSumNs = 0;      // Vault-wide sum of pending milestone amounts
+    uint64_t checksum = 0;          // Results folded together; equal across levels
+};
+
+ScanTimes timeCurrentLoops(uint32_t runs, const QubicAddress& payer) {
+    const uint32_t count = state.activeAgreementCount;
+    ScanTimes times;
+    uint64_t matches = 0, completed = 0, verified = 0, pending = 0;
+    times.payerScanNs = medianNanos(runs, [&] {
+        matches = 0;
+        for (uint32_t i = 0; i < count; ++i) matches += addressEquals(state.agreements[i].payer, payer);
+        return matches;
+    });
+    times.completionNs = medianNanos(runs, [&] {
+        completed = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            const Agreement& agreement = state.agreements[i];
+            bool allReleased = true;
+            for (uint32_t m = 0; m < agreement.milestoneCount; ++m) {
+                if (agreement.milestones[m].state != MilestoneState::RELEASED) {
+                    allReleased = false;
+                    break;
+                }
+            }
+            completed += allReleased;
+        }
+        return completed;
+    });
+    times.verifiedNs = medianNanos(runs, [&] {
+        verified = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            const Agreement& agreement = state.agreements[i];
+            for (uint32_t m = 0; m < agreement.milestoneCount; ++m) {
+                if (agreement.milestones[m].state == MilestoneState::VERIFIED) {
+                    ++verified;
+                    break;
+                }
+            }
+        }
+        return verified;
+    });
+    times.pendingSumNs = medianNanos(runs, [&] {
+        pending = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            const Agreement& agreement = state.agreements[i];
+            for (uint32_t m = 0; m < agreement.milestoneCount; ++m) {
+                if (agreement.milestones[m].state == MilestoneState::PENDING) pending += agreement.milestones[m].amount;
+            }
+        }
+        return pending;
+    });
+    times.checksum = matches ^ completed << 16 ^ verified << 32 ^ pending;
+    return times;
+}
+
+ScanTimes timeKernels(const VaultKernels& kernels, uint32_t runs, const QubicAddress& payer,
+                      const std::vector<QubicAddress>& payers, const MilestoneColumns& columns) {
+    const uint32_t count = static_cast<uint32_t>(payers.size());
+    const uint8_t released = static_cast<uint8_t>(MilestoneState::RELEASED);
+    const uint8_t verifiedState = static_cast<uint8_t>(MilestoneState::VERIFIED);
+    const uint8_t pendingState = static_cast<uint8_t>(MilestoneState::PENDING);
+    ScanTimes times;
+    uint64_t matches = 0, completed = 0, verified = 0, pending = 0;
+    times.payerScanNs = medianNanos(runs, [&] {
+        matches = kernels.countAddressMatches(payers.data(), count, payer);
+        return matches;
+    });
+    times.completionNs = medianNanos(runs, [&] {
+        completed = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            completed += kernels.allInState(columns.state.data() + columns.first[i], columns.milestonesOf(i), released);
+        }
+        return completed;
+    });
+    times.verifiedNs = medianNanos(runs, [&] {
+        verified = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            verified += kernels.anyInState(columns.state.data() + columns.first[i], columns.milestonesOf(i),
+                                           verifiedState);
+        }
+        return verified;
+    });
+    times.pendingSumNs = medianNanos(runs, [&] {
+        pending = kernels.sumInState(columns.state.data(), columns.amount.data(),
+                                     static_cast<uint32_t>(columns.state.size()), pendingState);
+        return pending;
+    });
+    times.checksum = matches ^ completed << 16 ^ verified << 32 ^ pending;
+    return times;
+}
+
+void printTimes(const char* level, uint32_t agreements, uint32_t milestones, const ScanTimes& times,
+                const ScanTimes& loops) {
+    auto speedup = [](uint64_t before, uint64_t after) {
+        return after == 0 ? 0.0 : static_cast<double>(before) / static_cast<double>(after);
+    };
+    std::printf("{\"bench\":\"kernels\",\"level\":\"%s\",\"agreements\":%u,\"milestones\":%u,\"payerScanNs\":%llu,"
+                "\"completionNs\":%llu,\"verifiedNs\":%llu,\"pendingSumNs\":%llu,\"payerScanSpeedup\":%.2f,"
+                "\"completionSpeedup\":%.2f,\"verifiedSpeedup\":%.2f,\"pendingSumSpeedup\":%.2f,\"matchesLoops\":%s}\n",
+                level, agreements, milestones, static_cast<unsigned long long>(times.payerScanNs),
+                static_cast<unsigned long long>(times.completionNs), static_cast<unsigned long long>(times.verifiedNs),
+                static_cast<unsigned long long>(times.pendingSumNs), speedup(loops.payerScanNs, times.payerScanNs),
+                speedup(loops.completionNs, times.completionNs), speedup(loops.verifiedNs, times.verifiedNs),
+                speedup(loops.pendingSumNs, times.pendingSumNs), times.checksum == loops.checksum ? "true" : "false");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t agreements = static_cast<uint32_t>(
+        std::min<uint64_t>(benchArg(argc, argv, "--agreements", MAX_AGREEMENTS), MAX_AGREEMENTS));
+    uint32_t runs = static_cast<uint32_t>(std::max<uint64_t>(1, benchArg(argc, argv, "--runs", 50)));
+    populateRealisticVault(agreements);
+
+    // The packed columns the kernels scan; a host mirror keeps these as it goes.
+    std::vector<QubicAddress> payers(state.activeAgreementCount);
+    for (uint32_t i = 0; i < state.activeAgreementCount; ++i) payers[i] = state.agreements[i].payer;
+    MilestoneColumns columns;
+    packMilestoneColumns(state, columns);
+    const QubicAddress payer = state.agreements[state.activeAgreementCount / 2].payer;
+    const uint32_t milestones = static_cast<uint32_t>(columns.state.size());
+
+    ScanTimes loops = timeCurrentLoops(runs, payer);
+    printTimes("loops", state.activeAgreementCount, milestones, loops, loops);
+    bool agree = true;
+    for (uint32_t level = 0; level < KERNEL_LEVEL_COUNT; ++level) {
+        const VaultKernels* kernels = vaultKernelsFor(static_cast<KernelLevel>(level));
+        if (kernels == nullptr) continue;
+        ScanTimes times = timeKernels(*kernels, runs, payer, payers, columns);
+        printTimes(kernelLevelName(kernels->level), state.activeAgreementCount, milestones, times, loops);
+        agree = agree && times.checksum == loops.checksum;
+    }
+    return agree ? 0 : 1;
+}
@@ -0,0 +1,273 @@
+// contracts/bench/procedure_bench.cpp
+// Per-call cost of every public procedure and view at 1/10/50/100% occupancy.
+//
+// Usage: procedure_bench [--iterations N] [--occupancy P]
+//
+// Each case targets the first slot, the last slot or a missing ID. Every
+// iteration prepares the target untimed (state, tick, sender, value), times
+// one call with the cycle counter and restores the slot and every vault
+// counter and tree it may have written, so all iterations see the same state. Hardware counters are sampled around
+// the call only; their per-call averages include a few hundred instructions of
+// ioctl entry/exit. workUnits is the metered work of the last call. Output:
+// one JSON object per line.
+
+#include "BenchCounters.h"
+#include "host/VaultHost.h"
+#include "host/VaultSnapshot.h"
+
+#include <memory>
+
+namespace {
+
+const QubicAddress payer = benchAddress("PAYER", 0);
+const QubicAddress beneficiary = benchAddress("BENEFICIARY", 0);
+const QubicAddress oracle = benchAddress("ORACLE", 0);
+const QubicAddress feeRecipient = benchAddress("FEES", 0);
+constexpr uint64_t MISSING_ID = 0xFFFFFFFFFFFFFFFEull;
+constexpr uint64_t MILESTONE_AMOUNT = 1000000;
+
+struct Bench {
+    PronexmaVaultEngine& engine;
+    NativeHost& host;
+    PerfCounters& perf;
+    uint32_t iterations;
+    uint32_t occupancyPercent;
+};
+
+// Funded two-milestone agreements in every slot up to `count`.
+void fillVault(PronexmaVaultEngine& engine, uint32_t count) {
+    PronexmaVaultState& vault = engine.state;
+    engine.initialize(feeRecipient);
+    for (uint32_t i = 0; i < count; ++i) {
+        Agreement& agreement = vault.agreements[i];
+        agreement = Agreement{};
+        agreement.id = (static_cast<uint64_t>(AGREEMENT_ID_PREFIX) << 32) | (i + 1);
+        agreement.payer = payer;
+        agreement.beneficiary = beneficiary;
+        agreement.oracleAdmin = oracle;
+        agreement.totalAmount = 2 * MILESTONE_AMOUNT;
+        agreement.lockedAmount = 2 * MILESTONE_AMOUNT;
+        agreement.state = AgreementState::FUNDED;
+        agreement.fundedAtTick = 1;
+        agreement.timeoutTick = 1 + REFUND_TIMEOUT_TICKS;
+        agreement.milestoneCount = 2;
+        for (uint32_t m = 0; m < 2; ++m) {
+            agreement.milestones[m].id = m + 1;
+            agreement.milestones[m].amount = MILESTONE_AMOUNT;
+        }
+        std::snprintf(agreement.title.data(), agreement.title.size(), "bench #%u", i);
+    }
+    vault.activeAgreementCount = count;
+    vault.agreementCounter = count;
+    vault.totalValueLocked = uint64_t(count) * 2 * MILESTONE_AMOUNT;
+    rebuildCapacityCounters(vault);
+    rebuildAccountingCounters(vault);
+    rebuildAgreementColumns(vault);
+    rebuildTickActivity(vault);
+}
+
+// Puts a FUNDED agreement back to CREATED, counters included, so the timed
+// deposit starts from a state the procedures could have produced.
+void undoDeposit(PronexmaVaultState& vault, Agreement& agreement) {
+    --vault.capacityCounters.agreementsByState[static_cast<uint32_t>(AgreementState::FUNDED)];
+    ++vault.capacityCounters.agreementsByState[static_cast<uint32_t>(AgreementState::CREATED)];
+    vault.accountingCounters.lockedByState[static_cast<uint32_t>(AgreementState::FUNDED)] -= agreement.lockedAmount;
+    vault.accountingCounters.depositedByPayers -= agreement.totalAmount;
+    vault.totalValueLocked -= agreement.lockedAmount;
+    agreement.state = AgreementState::CREATED;
+    agreement.lockedAmount = 0;
+    syncAgreementColumns(vault, static_cast<uint32_t>(&agreement - vault.agreements.data()));
+}
+
+// Every field of the state a call can write, and the one slot it may touch.
+// The tick trees are kept as their entries in use (SnapshotTicks), not the
+// whole 256 KB, so saving them stays cheap and leaves the caches alone.
+struct SavedVault {
+    uint64_t agreementCounter, totalValueLocked, totalValueReleased, protocolFeeAccrued;
+    QubicAddress protocolFeeRecipient;
+    uint32_t activeAgreementCount;
+    uint32_t staleSlotCount;
+    VaultPerfCounters perfCounters;
+    CapacityCounters capacityCounters;
+    AccountingCounters accountingCounters;
+    SnapshotTicks tickActivity;
+    uint32_t slot;
+    Agreement agreement;
+
+    void save(const PronexmaVaultState& vault, uint32_t target) {
+        agreementCounter = vault.agreementCounter;
+        totalValueLocked = vault.totalValueLocked;
+        totalValueReleased = vault.totalValueReleased;
+        protocolFeeAccrued = vault.protocolFeeAccrued;
+        protocolFeeRecipient = vault.protocolFeeRecipient;
+        activeAgreementCount = vault.activeAgreementCount;
+        staleSlotCount = vault.staleSlotCount;
+        perfCounters = vault.perfCounters;
+        capacityCounters = vault.capacityCounters;
+        accountingCounters = vault.accountingCounters;
+        captureSnapshotTicks(vault.tickActivity, tickActivity);
+        slot = std::min(target, MAX_AGREEMENTS - 1);
+        agreement = vault.agreements[slot];
+    }
+
+    void restore(PronexmaVaultState& vault) const {
+        vault.agreementCounter = agreementCounter;
+        vault.totalValueLocked = totalValueLocked;
+        vault.totalValueReleased = totalValueReleased;
+        vault.protocolFeeAccrued = protocolFeeAccrued;
+        vault.protocolFeeRecipient = protocolFeeRecipient;
+        vault.activeAgreementCount = activeAgreementCount;
+        vault.staleSlotCount = staleSlotCount;
+        vault.perfCounters = perfCounters;
+        vault.capacityCounters = capacityCounters;
+        vault.accountingCounters = accountingCounters;
+        installSnapshotTicks(tickActivity, vault.tickActivity);
+        vault.agreements[slot] = agreement;
+        syncAgreementColumns(vault, slot);
+    }
+};
+
+void printCounter(const PerfCounters& perf, PerfCounters::Event event, uint32_t iterations, const char* name) {
+    if (perf.available()) {
+        std::printf(",\"%s\":%.1f", name, static_cast<double>(perf.total(event)) / iterations);
+    } else {
+        std::printf(",\"%s\":null", name);
+    }
+}
+
+/**
+ * Runs `iterations` of prepare() / timed call() / restore. `slot` is the slot
+ * the call may write (saved and restored around it).
+ */
+template <typename Prepare, typename Call>
+void measure(Bench& bench, const char* procedure, const char* caseName, uint32_t slot, Prepare prepare, Call call) {
+    static SavedVault saved;
+    PronexmaVaultState& vault = bench.engine.state;
+    std::vector<uint64_t> cycles;
+    cycles.reserve(bench.iterations);
+    uint32_t succeeded = 0;
+    uint64_t nanos = 0;
+    bench.perf.reset();
+
+    for (uint32_t i = 0; i < bench.iterations; ++i) {
+        saved.save(vault, slot);
+        prepare();
+        uint64_t startNs = benchNowNanos();
+        bench.perf.start();
+        uint64_t start = benchCycles();
+        bool ok = call();
+        uint64_t end = benchCycles();
+        bench.perf.stop();
+        nanos += benchNowNanos() - startNs;
+        benchKeep(ok);
+        cycles.push_back(end - start);
+        succeeded += ok ? 1 : 0;
+        saved.restore(vault);
+    }
+
+    uint64_t p50 = benchPercentile(cycles, 50.0);
+    uint64_t p99 = benchPercentile(cycles, 99.0);
+    std::printf("{\"bench\":\"procedure\",\"procedure\":\"%s\",\"case\":\"%s\",\"occupancy\":%u,\"agreements\":%u,"
+                "\"iterations\":%u,\"succeeded\":%u,\"cycleSource\":\"%s\",\"cyclesP50\":%llu,\"cyclesP99\":%llu,"
+                "\"cyclesMin\":%llu,\"nsMean\":%.1f,\"workUnits\":%llu",
+                procedure, caseName, bench.occupancyPercent, vault.activeAgreementCount, bench.iterations, succeeded,
+                benchCycleSource(), static_cast<unsigned long long>(p50), static_cast<unsigned long long>(p99),
+                static_cast<unsigned long long>(cycles.front()), static_cast<double>(nanos) / bench.iterations,
+                static_cast<unsigned long long>(bench.engine.lastWork().units));
+    printCounter(bench.perf, PerfCounters::CYCLES, bench.iterations, "hwCycles");
+    printCounter(bench.perf, PerfCounters::INSTRUCTIONS, bench.iterations, "instructions");
+    printCounter(bench.perf, PerfCounters::CACHE_MISSES, bench.iterations, "cacheMisses");
+    printCounter(bench.perf, PerfCounters::BRANCH_MISSES, bench.iterations, "branchMisses");
+    std::printf("}\n");
+}
+
+struct Target {
+    const char* name;
+    uint32_t slot;                         // Slot written on success (miss: any live slot)
+    uint64_t id;
+};
+
+void runOccupancy(Bench& bench, uint32_t count) {
+    PronexmaVaultEngine& engine = bench.engine;
+    NativeHost& host = bench.host;
+    PronexmaVaultState& vault = engine.state;
+    fillVault(engine, count);
+    const Target targets[3] = {
+        {"first", 0, vault.agreements[0].id},
+        {"last", count - 1, vault.agreements[count - 1].id},
+        {"miss", count - 1, MISSING_ID},
+    };
+    std::array<uint8_t, 64> evidence = {};
+    evidence[0] = 0xE5;
+    const uint64_t amounts[2] = {MILESTONE_AMOUNT, MILESTONE_AMOUNT};
+
+    measure(bench, "createAgreement", count < MAX_AGREEMENTS ? "append" : "full", count,
+            [&] { host.setSender(payer); },
+            [&] { return engine.createAgreement(beneficiary, oracle, 2 * MILESTONE_AMOUNT, amounts, 2, "bench") != 0; });
+
+    for (const Target& target : targets) {
+        Agreement& agreement = vault.agreements[target.slot];
+        measure(bench, "deposit", target.name, target.slot,
+                [&] {
+                    undoDeposit(vault, agreement);
+                    host.beginInvocation(payer, agreement.totalAmount);
+                },
+                [&] { return engine.deposit(target.id); });
+        measure(bench, "markMilestoneVerified", target.name, target.slot,
+                [&] { host.setSender(oracle); },
+                [&] { return engine.markMilestoneVerified(target.id, 1, evidence); });
+        measure(bench, "releaseMilestone", target.name, target.slot,
+                [&] {
+                    agreement.milestones[0].state = MilestoneState::VERIFIED;
+                    host.setSender(beneficiary);
+                },
+                [&] { return engine.releaseMilestone(target.id, 1); });
+        measure(bench, "refund", target.name, target.slot,
+                [&] {
+                    host.setTick(agreement.timeoutTick);
+                    host.setSender(payer);
+                },
+                [&] { return engine.refund(target.id); });
+        measure(bench, "getAgreement", target.name, target.slot, [] {},
+                [&] { return engine.getAgreement(target.id).id != 0; });
+        measure(bench, "getMilestone", target.name, target.slot, [] {},
+                [&] { return engine.getMilestone(target.id, 2).id != 0; });
+    }
+
+    measure(bench, "getProtocolStats", "-", 0, [] {},
+            [&] {
+                uint64_t tvl, released, fees;
+                uint32_t agreements;
+                engine.getProtocolStats(tvl, released, fees, agreements);
+                benchKeep(tvl + released + fees);
+                return agreements == count;
+            });
+    measure(bench, "setFeeRecipient", "-", 0, [] {}, [&] { return engine.setFeeRecipient(feeRecipient); });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t iterations = static_cast<uint32_t>(std::max<uint64_t>(1, benchArg(argc, argv, "--iterations", 1000)));
+    uint32_t onlyOccupancy = static_cast<uint32_t>(benchArg(argc, argv, "--occupancy", 0));
+
+    auto vault = std::make_unique<PronexmaVaultState>();
+    PronexmaVaultEngine engine(*vault);
+    NativeHost host;
+    HostContextBinding binding(engine, host.context());
+    // Enough QU on both sides that deposits and releases never run dry.
+    host.credit(payer, UINT64_MAX / 4);
+    host.credit(host.contractAccount(), UINT64_MAX / 4);
+    PerfCounters perf;
+    if (!perf.available()) {
+        std::fprintf(stderr, "procedure_bench: hardware counters unavailable; reporting cycles only\n");
+    }
+
+    Bench bench{engine, host, perf, iterations, 0};
+    for (uint32_t percent : {1u, 10u, 50u, 100u}) {
+        if (onlyOccupancy != 0 && percent != onlyOccupancy) continue;
+        bench.occupancyPercent = percent;
+        runOccupancy(bench, MAX_AGREEMENTS * percent / 100);
+    }
+    return 0;
+}
@@ -0,0 +1,77 @@
+// contracts/bench/reset_bench.cpp
+// Fresh-vault test cases per second: a newly allocated (zeroed) state, a
+// reused state cleared in full, and a reused state reset by initialize alone
+// (stale slots are cleared as createAgreement reclaims them).
+//
+// Usage: reset_bench [--cases N] [--agreements-per-case K]
+//
+// Each case resets the vault, then creates and funds K agreements.
+
+#include "BenchSupport.h"
+#include "host/VaultHost.h"
+
+#include <cstring>
+#include <memory>
+
+namespace {
+
+const QubicAddress payer = benchAddress("PAYER", 0);
+const QubicAddress beneficiary = benchAddress("BENEFICIARY", 0);
+const QubicAddress oracle = benchAddress("ORACLE", 0);
+const QubicAddress feeRecipient = benchAddress("FEES", 0);
+
+enum class ResetMode { FRESH, CLEAR, LAZY };
+
+void runCase(PronexmaVaultEngine& engine, NativeHost& host, uint32_t agreements) {
+    const uint64_t amounts[2] = {500, 500};
+    for (uint32_t i = 0; i < agreements; ++i) {
+        host.setSender(payer);
+        uint64_t id = engine.createAgreement(beneficiary, oracle, 1000, amounts, 2, "case");
+        host.invoke(payer, 1000, [&] { return engine.deposit(id); });
+    }
+}
+
+uint64_t runCases(ResetMode mode, uint32_t cases, uint32_t agreements) {
+    NativeHost host;
+    host.credit(payer, UINT64_MAX / 4);
+    auto reused = std::make_unique<PronexmaVaultState>();
+    uint64_t start = benchNowNanos();
+    for (uint32_t c = 0; c < cases; ++c) {
+        std::unique_ptr<PronexmaVaultState> fresh;
+        PronexmaVaultState* vault = reused.get();
+        if (mode == ResetMode::FRESH) {
+            fresh = std::make_unique<PronexmaVaultState>();
+            vault = fresh.get();
+        } else if (mode == ResetMode::CLEAR) {
+            std::memset(static_cast<void*>(vault->agreements.data()), 0, sizeof(vault->agreements));
+        }
+        PronexmaVaultEngine engine(*vault);
+        HostContextBinding binding(engine, host.context());
+        engine.initialize(feeRecipient);
+        runCase(engine, host, agreements);
+    }
+    return benchNowNanos() - start;
+}
+
+void report(const char* mode, uint32_t cases, uint32_t agreements, uint64_t nanos, double speedup) {
+    std::printf("{\"bench\":\"reset\",\"mode\":\"%s\",\"cases\":%u,\"agreementsPerCase\":%u,\"nsPerCase\":%.0f,"
+                "\"casesPerSecond\":%.0f,\"speedup\":%.2f}\n",
+                mode, cases, agreements, static_cast<double>(nanos) / cases,
+                nanos == 0 ? 0.0 : cases * 1e9 / static_cast<double>(nanos), speedup);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t cases = static_cast<uint32_t>(std::max<uint64_t>(1, benchArg(argc, argv, "--cases", 200)));
+    uint32_t agreements = static_cast<uint32_t>(
+        std::min<uint64_t>(benchArg(argc, argv, "--agreements-per-case", 4), MAX_AGREEMENTS));
+
+    uint64_t freshNs = runCases(ResetMode::FRESH, cases, agreements);
+    uint64_t clearNs = runCases(ResetMode::CLEAR, cases, agreements);
+    uint64_t lazyNs = runCases(ResetMode::LAZY, cases, agreements);
+    report("fresh", cases, agreements, freshNs, 1.0);
+    report("clear", cases, agreements, clearNs, clearNs == 0 ? 0.0 : static_cast<double>(freshNs) / clearNs);
+    report("lazy", cases, agreements, lazyNs, lazyNs == 0 ? 0.0 : static_cast<double>(freshNs) / lazyNs);
+    return 0;
+}
@@ -0,0 +1,65 @@
+// contracts/bench/restore_bench.cpp
+// Replica bring-up time: snapshot restore plus lookup/payer/beneficiary/timeout
+// index rebuild, serial vs parallel, for RAW and COLUMNAR images.
+//
+// Usage: restore_bench [--agreements N] [--max-workers W] [--path FILE]
+
+#include "BenchSupport.h"
+#include "host/VaultRestore.h"
+
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace {
+
+void measure(const char* encodingName, BlockEncoding encoding, const std::string& path, uint32_t maxWorkers) {
+    if (writeSnapshot(state, 1, path, encoding) != SnapshotStatus::OK) {
+        std::fprintf(stderr, "failed to write %s snapshot\n", encodingName);
+        return;
+    }
+    auto restored = std::make_unique<PronexmaVaultState>();
+
+    // Baseline: sequential reader followed by a single-threaded index build.
+    std::vector<uint64_t> serial;
+    for (int run = 0; run < 3; ++run) {
+        VaultIndexes indexes;
+        uint64_t start = benchNowNanos();
+        readSnapshot(path, *restored);
+        buildVaultIndexes(*restored, indexes);
+        serial.push_back(benchNowNanos() - start);
+    }
+    std::printf("{\"bench\":\"restore\",\"encoding\":\"%s\",\"mode\":\"serial\",\"workers\":1,\"agreements\":%u,\"totalNs\":%llu}\n",
+                encodingName, state.activeAgreementCount, static_cast<unsigned long long>(benchPercentile(serial, 50.0)));
+
+    for (uint32_t workers = 1; workers <= maxWorkers; workers *= 2) {
+        std::vector<uint64_t> totals;
+        RestoreStats stats;
+        SnapshotStatus status = SnapshotStatus::OK;
+        for (int run = 0; run < 3; ++run) {
+            VaultIndexes indexes;
+            uint64_t start = benchNowNanos();
+            status = restoreSnapshotParallel(path, *restored, indexes, workers, &stats);
+            totals.push_back(benchNowNanos() - start);
+        }
+        std::printf("{\"bench\":\"restore\",\"encoding\":\"%s\",\"mode\":\"parallel\",\"status\":\"%s\",\"workers\":%u,"
+                    "\"agreements\":%u,\"totalNs\":%llu,\"decodeUs\":%llu,\"mergeUs\":%llu}\n",
+                    encodingName, snapshotStatusName(status), stats.workers, state.activeAgreementCount,
+                    static_cast<unsigned long long>(benchPercentile(totals, 50.0)),
+                    static_cast<unsigned long long>(stats.decodeMicros), static_cast<unsigned long long>(stats.mergeMicros));
+    }
+    ::unlink(path.c_str());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t agreements = static_cast<uint32_t>(benchArg(argc, argv, "--agreements", MAX_AGREEMENTS));
+    uint32_t maxWorkers = static_cast<uint32_t>(benchArg(argc, argv, "--max-workers", std::max(1u, std::thread::hardware_concurrency())));
+    std::string path = benchArgString(argc, argv, "--path", "/tmp/pronexma_restore_bench.snap");
+
+    populateRealisticVault(std::min<uint32_t>(agreements, MAX_AGREEMENTS));
+    measure("raw", BlockEncoding::RAW, path, maxWorkers);
+    measure("columnar", BlockEncoding::COLUMNAR, path, maxWorkers);
+    return 0;
+}
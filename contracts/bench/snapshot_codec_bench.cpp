@@ -0,0 +1,64 @@
+// contracts/bench/snapshot_codec_bench.cpp
+// Raw vs COLUMNAR snapshot size, write time and restore time (page cache warm
+// and evicted with posix_fadvise).
+//
+// Usage: snapshot_codec_bench [--agreements N] [--path FILE]
+
+#include "BenchSupport.h"
+#include "host/VaultSnapshot.h"
+
+#include <memory>
+#include <string>
+#include <sys/stat.h>
+
+namespace {
+
+uint64_t fileSize(const std::string& path) {
+    struct stat st;
+    return ::stat(path.c_str(), &st) == 0 ? static_cast<uint64_t>(st.st_size) : 0;
+}
+
+void evictFromPageCache(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        ::close(fd);
+    }
+}
+
+void measure(const char* name, BlockEncoding encoding, const std::string& path) {
+    uint64_t start = benchNowNanos();
+    SnapshotStatus status = writeSnapshot(state, 1, path, encoding);
+    uint64_t writeNs = benchNowNanos() - start;
+
+    auto restored = std::make_unique<PronexmaVaultState>();
+    std::vector<uint64_t> warm;
+    for (int i = 0; i < 5; ++i) {
+        start = benchNowNanos();
+        if (readSnapshot(path, *restored) != SnapshotStatus::OK) status = SnapshotStatus::CORRUPT_BLOCK;
+        warm.push_back(benchNowNanos() - start);
+    }
+    evictFromPageCache(path);
+    start = benchNowNanos();
+    if (readSnapshot(path, *restored) != SnapshotStatus::OK) status = SnapshotStatus::CORRUPT_BLOCK;
+    uint64_t coldNs = benchNowNanos() - start;
+
+    std::printf("{\"bench\":\"snapshot_codec\",\"encoding\":\"%s\",\"status\":\"%s\",\"agreements\":%u,"
+                "\"bytes\":%llu,\"writeNs\":%llu,\"restoreWarmNs\":%llu,\"restoreColdNs\":%llu}\n",
+                name, snapshotStatusName(status), state.activeAgreementCount,
+                static_cast<unsigned long long>(fileSize(path)), static_cast<unsigned long long>(writeNs),
+                static_cast<unsigned long long>(benchPercentile(warm, 50.0)), static_cast<unsigned long long>(coldNs));
+    ::unlink(path.c_str());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint32_t agreements = static_cast<uint32_t>(benchArg(argc, argv, "--agreements", MAX_AGREEMENTS));
+    std::string path = benchArgString(argc, argv, "--path", "/tmp/pronexma_codec_bench.snap");
+
+    populateRealisticVault(std::min<uint32_t>(agreements, MAX_AGREEMENTS));
+    measure("raw", BlockEncoding::RAW, path);
+    measure("columnar", BlockEncoding::COLUMNAR, path);
+    return 0;
+}
@@ -0,0 +1,117 @@
+// contracts/bench/tickflow_bench.cpp
+// Tick-range flow queries over the Fenwick trees against the scans they
+// replace: "released in the last W ticks" walking every milestone's
+// releasedAtTick, and "funded between two ticks" walking fundedAtTick. The
+// vault comes from a generated workload, so ticks and releases are spread as
+// the procedures leave them.
+//
+// Usage: tickflow_bench [--operations N] [--runs R]
+//
+// Output: one JSON object. Query times are nanoseconds (median of R runs);
+// recordNs is the mean cost of adding one event to the trees.
+
+#include "BenchCounters.h"
+#include "BenchSupport.h"
+#include "host/VaultReplay.h"
+
+#include <memory>
+
+namespace {
+
+template <typename Query>
+uint64_t medianNanos(uint32_t runs, Query query) {
+    std::vector<uint64_t> samples;
+    for (uint32_t r = 0; r < runs; ++r) {
+        uint64_t start = benchNowNanos();
+        benchKeep(query());
+        samples.push_back(benchNowNanos() - start);
+    }
+    return benchPercentile(samples, 50.0);
+}
+
+uint64_t recordReleased(const PronexmaVaultState& vault, uint64_t fromTick, uint64_t toTick) {
+    uint64_t released = 0;
+    for (uint32_t i = 0; i < vault.activeAgreementCount; ++i) {
+        const Agreement& agreement = vault.agreements[i];
+        for (uint32_t m = 0; m < agreement.milestoneCount; ++m) {
+            const Milestone& milestone = agreement.milestones[m];
+            bool inRange = milestone.releasedAtTick >= fromTick && milestone.releasedAtTick < toTick;
+            if (milestone.state == MilestoneState::RELEASED && inRange) released += milestone.amount;
+        }
+    }
+    return released;
+}
+
+uint64_t recordFunded(const PronexmaVaultState& vault, uint64_t fromTick, uint64_t toTick) {
+    uint64_t funded = 0;
+    for (uint32_t i = 0; i < vault.activeAgreementCount; ++i) {
+        const Agreement& agreement = vault.agreements[i];
+        bool inRange = agreement.fundedAtTick >= fromTick && agreement.fundedAtTick < toTick;
+        if (agreement.state != AgreementState::CREATED && inRange) funded += agreement.totalAmount;
+    }
+    return funded;
+}
+
+double ratio(uint64_t before, uint64_t after) {
+    return after == 0 ? 0.0 : static_cast<double>(before) / static_cast<double>(after);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint64_t operations = std::max<uint64_t>(1, benchArg(argc, argv, "--operations", 200000));
+    uint32_t runs = static_cast<uint32_t>(std::max<uint64_t>(1, benchArg(argc, argv, "--runs", 50)));
+
+    auto vault = std::make_unique<PronexmaVaultState>();
+    PronexmaVaultEngine engine(*vault);
+    NativeHost host;
+    HostContextBinding binding(engine, host.context());
+    BenchRng rng(3);
+    engine.initialize(benchIdentity(rng));
+    WorkloadConfig config;
+    config.operations = operations;
+    WorkloadGenerator generator(config);
+    fundWorkloadParties(host, generator);
+    WorkloadOp op;
+    while (generator.next(op)) runWorkloadOp(engine, host, op);
+
+    // The last tenth of the run, as a dashboard's "recent" window. The trees
+    // answer for whole buckets, so the scans use the range the view reports.
+    const uint64_t lastTick = host.tick() + 1;
+    TickFlowTotals released = engine.getTickFlow(TickFlow::RELEASED, lastTick - lastTick / 10, lastTick);
+    TickFlowTotals funded = engine.getTickFlow(TickFlow::FUNDED, lastTick / 4, lastTick / 2);
+    uint64_t scanReleased = 0, scanFunded = 0;
+    uint64_t scanReleasedNs = medianNanos(runs, [&] {
+        return scanReleased = recordReleased(*vault, released.fromTick, released.toTick);
+    });
+    uint64_t treeReleasedNs = medianNanos(runs, [&] {
+        return engine.getTickFlow(TickFlow::RELEASED, lastTick - lastTick / 10, lastTick).amount;
+    });
+    uint64_t scanFundedNs = medianNanos(runs, [&] {
+        return scanFunded = recordFunded(*vault, funded.fromTick, funded.toTick);
+    });
+    uint64_t treeFundedNs = medianNanos(runs, [&] {
+        return engine.getTickFlow(TickFlow::FUNDED, lastTick / 4, lastTick / 2).amount;
+    });
+
+    // Event cost, on a scratch copy so the vault's trees stay as the run left them.
+    auto scratch = std::make_unique<TickActivity<DefaultVaultConfig>>(vault->tickActivity);
+    const uint32_t events = 1000000;
+    uint64_t start = benchNowNanos();
+    for (uint32_t e = 0; e < events; ++e) recordTickFlow(*scratch, TickFlow::RELEASED, lastTick - e % lastTick, e);
+    double recordNs = static_cast<double>(benchNowNanos() - start) / events;
+    benchKeep(scratch->amounts[static_cast<uint32_t>(TickFlow::RELEASED)][0]);
+
+    bool agree = scanReleased == released.amount && scanFunded == funded.amount;
+    std::printf("{\"bench\":\"tickflow\",\"operations\":%llu,\"agreements\":%u,\"runs\":%u,\"ticks\":%llu,"
+                "\"bucketTicks\":%llu,\"treeBytes\":%zu,\"scanReleasedNs\":%llu,\"treeReleasedNs\":%llu,"
+                "\"releasedSpeedup\":%.1f,\"scanFundedNs\":%llu,\"treeFundedNs\":%llu,\"fundedSpeedup\":%.1f,"
+                "\"recordNs\":%.1f,\"agree\":%s}\n",
+                static_cast<unsigned long long>(operations), vault->activeAgreementCount, runs,
+                static_cast<unsigned long long>(lastTick), 1ull << vault->tickActivity.bucketShift,
+                sizeof(TickActivity<DefaultVaultConfig>), static_cast<unsigned long long>(scanReleasedNs),
+                static_cast<unsigned long long>(treeReleasedNs), ratio(scanReleasedNs, treeReleasedNs),
+                static_cast<unsigned long long>(scanFundedNs), static_cast<unsigned long long>(treeFundedNs),
+                ratio(scanFundedNs, treeFundedNs), recordNs, agree ? "true" : "false");
+    return agree ? 0 : 1;
+}
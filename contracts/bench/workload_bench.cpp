@@ -0,0 +1,159 @@
+// contracts/bench/workload_bench.cpp
+// Sustained throughput and latency under the synthetic production mix.
+//
+// Usage: workload_bench [--operations N] [--seed S] [--prefill N] [--skew THETA]
+//                       [--burst N] [--ticks-per-op N] [--scrambled]
+//                       [--mix name=weight,...] [--record run.tlog]
+//                       [--histograms out.hist] [--label NAME]
+//
+// A fresh engine is prefilled through ordinary create/deposit calls, then the
+// generator's measured operations run back to back. Each call is timed with the
+// cycle counter into a histogram per procedure and outcome code; cycles are
+// converted to nanoseconds with the TSC rate measured over the run. Output:
+// one JSON line per procedure, one per procedure/outcome, then a summary line.
+// --record also writes every call, warmup included, as a tick log for
+// vault_replay. --histograms writes the histograms in the mergeable format of
+// host/VaultHistogram.h, tagged with --label.
+
+#include "BenchCounters.h"
+#include "host/VaultReplay.h"
+
+#include <memory>
+
+namespace {
+
+bool hasFlag(int argc, char** argv, const char* name) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], name) == 0) return true;
+    }
+    return false;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    WorkloadConfig config;
+    config.operations = benchArg(argc, argv, "--operations", config.operations);
+    config.seed = benchArg(argc, argv, "--seed", config.seed);
+    config.prefillAgreements = static_cast<uint32_t>(benchArg(argc, argv, "--prefill", config.prefillAgreements));
+    config.zipfTheta = std::atof(benchArgString(argc, argv, "--skew", "0.99"));
+    config.verificationBurst = static_cast<uint32_t>(benchArg(argc, argv, "--burst", config.verificationBurst));
+    config.ticksPerOperation = benchArg(argc, argv, "--ticks-per-op", config.ticksPerOperation);
+    config.recentIsHot = !hasFlag(argc, argv, "--scrambled");
+    const char* mix = benchArgString(argc, argv, "--mix", nullptr);
+    if (mix != nullptr && !parseWorkloadMix(mix, config.mix)) {
+        std::fprintf(stderr, "workload_bench: bad --mix '%s' (expected name=weight,...)\n", mix);
+        return 2;
+    }
+
+    auto vault = std::make_unique<PronexmaVaultState>();
+    PronexmaVaultEngine engine(*vault);
+    NativeHost host;
+    HostContextBinding binding(engine, host.context());
+    WorkloadGenerator generator(config);
+    engine.initialize(hostAddress("WORKLOADFEES"));
+    fundWorkloadParties(host, generator);
+
+    const char* recordPath = benchArgString(argc, argv, "--record", nullptr);
+    int recordFd = -1;
+    std::unique_ptr<TickLogWriter> recorder;
+    if (recordPath != nullptr) {
+        recordFd = ::open(recordPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (recordFd < 0) {
+            std::fprintf(stderr, "workload_bench: cannot create %s\n", recordPath);
+            return 2;
+        }
+        recorder = std::make_unique<TickLogWriter>(recordFd);
+        recorder->begin(config.startTick);
+    }
+
+    LatencyHistograms cycles;
+    WorkloadOp op;
+    uint64_t warmupFailures = 0;
+    uint64_t startNs = 0, startCycles = 0;
+    bool measuring = false;
+
+    while (generator.next(op)) {
+        if (op.warmup) {
+            bool ok = runWorkloadOp(engine, host, op);
+            warmupFailures += ok ? 0 : 1;
+            if (recorder) recorder->append(op, ok ? TickLogOutcome::SUCCEEDED : TickLogOutcome::FAILED);
+            continue;
+        }
+        if (!measuring) {
+            measuring = true;
+            startNs = benchNowNanos();
+            startCycles = benchCycles();
+        }
+        uint64_t begin = benchCycles();
+        bool ok = runWorkloadOp(engine, host, op);
+        uint64_t elapsed = benchCycles() - begin;
+        cycles.record(op.kind, latencyOutcome(engine, ok), elapsed);
+        if (recorder) recorder->append(op, ok ? TickLogOutcome::SUCCEEDED : TickLogOutcome::FAILED);
+    }
+    uint64_t wallNs = measuring ? benchNowNanos() - startNs : 0;
+    uint64_t wallCycles = measuring ? benchCycles() - startCycles : 0;
+    double nanosPerCycle = wallCycles > 0 ? static_cast<double>(wallNs) / static_cast<double>(wallCycles) : 0.0;
+    if (recorder) {
+        bool recorded = recorder->finish(engine.state) == SnapshotStatus::OK;
+        ::close(recordFd);
+        if (!recorded) {
+            std::fprintf(stderr, "workload_bench: failed writing %s\n", recordPath);
+            return 2;
+        }
+    }
+
+    LatencyHistograms nanos = cycles.scaled(nanosPerCycle);
+    LatencyHistogram all = cycles.total();
+    uint64_t failures = 0;
+    for (uint32_t k = 0; k < WORKLOAD_OP_KINDS; ++k) {
+        WorkloadOpKind kind = static_cast<WorkloadOpKind>(k);
+        LatencyHistogram procedure = nanos.procedure(kind);
+        if (procedure.count() == 0) continue;
+        uint64_t kindFailures = procedure.count() - nanos.at(kind, static_cast<uint32_t>(VaultError::NONE)).count();
+        failures += kindFailures;
+        std::printf("{\"bench\":\"workload\",\"procedure\":\"%s\",\"calls\":%llu,\"share\":%.4f,\"failures\":%llu,",
+                    workloadOpName(kind), static_cast<unsigned long long>(procedure.count()),
+                    static_cast<double>(procedure.count()) / static_cast<double>(all.count()),
+                    static_cast<unsigned long long>(kindFailures));
+        printLatencyPercentiles(stdout, procedure);
+        std::printf("}\n");
+        for (uint32_t o = 0; o < LATENCY_OUTCOMES; ++o) {
+            const LatencyHistogram& outcome = nanos.at(kind, o);
+            if (outcome.count() == 0) continue;
+            std::printf("{\"bench\":\"workload\",\"procedure\":\"%s\",\"outcome\":\"%s\",\"calls\":%llu,",
+                        workloadOpName(kind), latencyOutcomeName(o), static_cast<unsigned long long>(outcome.count()));
+            printLatencyPercentiles(stdout, outcome);
+            std::printf("}\n");
+        }
+    }
+    const char* histogramPath = benchArgString(argc, argv, "--histograms", nullptr);
+    if (histogramPath != nullptr) {
+        std::FILE* out = std::fopen(histogramPath, "w");
+        bool written = out != nullptr && writeLatencyHistograms(out, nanos, benchArgString(argc, argv, "--label", ""));
+        if (out != nullptr && std::fclose(out) != 0) written = false;
+        if (!written) {
+            std::fprintf(stderr, "workload_bench: failed writing %s\n", histogramPath);
+            return 2;
+        }
+    }
+
+    uint64_t tvl, released, fees;
+    uint32_t agreements;
+    engine.getProtocolStats(tvl, released, fees, agreements);
+    double seconds = static_cast<double>(wallNs) / 1e9;
+    double engineSeconds = static_cast<double>(all.sum()) * nanosPerCycle / 1e9;
+    std::printf("{\"bench\":\"workload\",\"summary\":true,\"seed\":%llu,\"operations\":%llu,\"prefill\":%u,"
+                "\"theta\":%.3f,\"recentIsHot\":%s,\"burst\":%u,\"seconds\":%.3f,\"opsPerSec\":%.0f,"
+                "\"engineOpsPerSec\":%.0f,\"failures\":%llu,\"warmupFailures\":%llu,\"agreements\":%u,\"tvl\":%llu,",
+                static_cast<unsigned long long>(config.seed), static_cast<unsigned long long>(all.count()),
+                config.prefillAgreements, config.zipfTheta,
+                config.recentIsHot ? "true" : "false", config.verificationBurst, seconds,
+                seconds > 0 ? static_cast<double>(all.count()) / seconds : 0.0,
+                engineSeconds > 0 ? static_cast<double>(all.count()) / engineSeconds : 0.0,
+                static_cast<unsigned long long>(failures), static_cast<unsigned long long>(warmupFailures), agreements,
+                static_cast<unsigned long long>(tvl));
+    printLatencyPercentiles(stdout, nanos.total());
+    std::printf("}\n");
+    return warmupFailures == 0 ? 0 : 1;
+}
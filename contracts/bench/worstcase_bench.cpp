@@ -0,0 +1,176 @@
+// contracts/bench/worstcase_bench.cpp
+// Guided search for the costliest input of each procedure, and the regression
+// benchmark over the inputs it saved.
+//
+// Usage: worstcase_bench [--evaluations N] [--seed S] [--metric units|cycles] [--out DIR]
+//        worstcase_bench --run DIR [--iterations N]
+//
+// Search mode runs WorstCaseSearch (host/VaultWorstCase.h) and prints one JSON
+// line per procedure with the worst input found, its work units against the
+// documented WORK_BOUND_* and its cycles. --out saves each champion as
+// DIR/<procedure>.snap + .tlog and lists them in DIR/worst.jsonl. Exit status
+// 1 if any call exceeded its bound.
+//
+// Run mode replays every saved case --iterations times from its snapshot and
+// reports the scoring call's units and median cycles. Exit status 1 if a case
+// now costs more work units than when it was saved.
+
+#include "BenchCounters.h"
+#include "host/VaultWorstCase.h"
+
+#include <memory>
+#include <sys/stat.h>
+
+namespace {
+
+const char* prefillName(WorstCasePrefill prefill) {
+    switch (prefill) {
+        case WorstCasePrefill::CREATED: return "created";
+        case WorstCasePrefill::FUNDED: return "funded";
+        case WorstCasePrefill::VERIFIED: return "verified";
+        case WorstCasePrefill::LAST_MILESTONE_LEFT: return "lastMilestoneLeft";
+    }
+    return "unknown";
+}
+
+int search(int argc, char** argv) {
+    uint64_t evaluations = benchArg(argc, argv, "--evaluations", 2000);
+    uint64_t seed = benchArg(argc, argv, "--seed", 1);
+    const char* metricName = benchArgString(argc, argv, "--metric", "units");
+    const char* outDir = benchArgString(argc, argv, "--out", nullptr);
+    WorstCaseMetric metric;
+    if (std::strcmp(metricName, "units") == 0) {
+        metric = WorstCaseMetric::WORK_UNITS;
+    } else if (std::strcmp(metricName, "cycles") == 0) {
+        metric = WorstCaseMetric::CLOCK;
+    } else {
+        std::fprintf(stderr, "worstcase_bench: --metric must be units or cycles\n");
+        return 2;
+    }
+
+    auto searcher = std::make_unique<WorstCaseSearch>(seed, metric, benchCycles);
+    uint64_t startNs = benchNowNanos();
+    searcher->run(evaluations);
+    double seconds = static_cast<double>(benchNowNanos() - startNs) / 1e9;
+
+    std::FILE* manifest = nullptr;
+    if (outDir != nullptr) {
+        ::mkdir(outDir, 0755);
+        manifest = std::fopen((std::string(outDir) + "/worst.jsonl").c_str(), "w");
+        if (manifest == nullptr) {
+            std::fprintf(stderr, "worstcase_bench: cannot write to %s\n", outDir);
+            return 2;
+        }
+    }
+
+    bool overBound = false;
+    for (uint32_t k = 0; k < WORKLOAD_OP_KINDS; ++k) {
+        WorkloadOpKind kind = static_cast<WorkloadOpKind>(k);
+        const WorstCaseChampion& champion = searcher->champion(kind);
+        if (!champion.found) continue;
+        uint64_t bound = workloadWorkBound(kind);
+        overBound = overBound || champion.units > bound;
+        std::printf("{\"bench\":\"worstcase\",\"procedure\":\"%s\",\"units\":%llu,\"bound\":%llu,\"cycles\":%llu,"
+                    "\"succeeded\":%s,\"prefill\":%u,\"milestones\":%u,\"prefillState\":\"%s\",\"calls\":%zu,"
+                    "\"call\":%u,\"agreementId\":\"0x%llx\"}\n",
+                    workloadOpName(kind), static_cast<unsigned long long>(champion.units),
+                    static_cast<unsigned long long>(bound), static_cast<unsigned long long>(champion.clock),
+                    champion.succeeded ? "true" : "false", champion.input.prefill, champion.input.milestones,
+                    prefillName(champion.input.prefillState), champion.input.calls.size(), champion.call,
+                    static_cast<unsigned long long>(lowerWorstCaseCall(champion.input, champion.call, 0).agreementId));
+        if (manifest != nullptr) {
+            WorstCaseManifestEntry entry;
+            entry.procedure = workloadOpName(kind);
+            entry.name = entry.procedure;
+            entry.call = champion.call;
+            entry.units = champion.units;
+            entry.clock = champion.clock;
+            SnapshotStatus status = saveWorstCase(outDir, entry.name, champion, searcher->engine());
+            if (status != SnapshotStatus::OK) {
+                std::fprintf(stderr, "worstcase_bench: saving %s: %s\n", entry.name.c_str(), snapshotStatusName(status));
+                std::fclose(manifest);
+                return 2;
+            }
+            writeWorstCaseManifestEntry(manifest, entry);
+        }
+    }
+    if (manifest != nullptr) std::fclose(manifest);
+    std::printf("{\"bench\":\"worstcase\",\"summary\":true,\"seed\":%llu,\"metric\":\"%s\",\"evaluations\":%llu,"
+                "\"improvements\":%llu,\"seconds\":%.3f,\"overBound\":%s}\n",
+                static_cast<unsigned long long>(seed), metricName,
+                static_cast<unsigned long long>(searcher->evaluations()),
+                static_cast<unsigned long long>(searcher->improvements()), seconds, overBound ? "true" : "false");
+    return overBound ? 1 : 0;
+}
+
+int runSaved(const char* dir, uint64_t iterations) {
+    std::FILE* manifest = std::fopen((std::string(dir) + "/worst.jsonl").c_str(), "r");
+    if (manifest == nullptr) {
+        std::fprintf(stderr, "worstcase_bench: no worst.jsonl in %s\n", dir);
+        return 2;
+    }
+    auto work = std::make_unique<PronexmaVaultState>();
+    PronexmaVaultEngine engine(*work);
+    bool regressed = false;
+    char line[1024];
+    while (std::fgets(line, sizeof(line), manifest) != nullptr) {
+        std::string text(line);
+        while (!text.empty() && (text.back() == '\n' || text.back() == '\r')) text.pop_back();
+        if (text.empty()) continue;
+        WorstCaseManifestEntry entry;
+        WorstCaseReplay saved;
+        if (!parseWorstCaseManifestEntry(text, entry)) {
+            std::fprintf(stderr, "worstcase_bench: bad manifest line: %s\n", text.c_str());
+            std::fclose(manifest);
+            return 2;
+        }
+        SnapshotStatus status = loadWorstCase(dir, entry.name, saved);
+        if (status != SnapshotStatus::OK || entry.call >= saved.calls.size()) {
+            std::fprintf(stderr, "worstcase_bench: loading %s: %s\n", entry.name.c_str(),
+                         status == SnapshotStatus::OK ? "call out of range" : snapshotStatusName(status));
+            std::fclose(manifest);
+            return 2;
+        }
+
+        std::vector<uint64_t> cycles;
+        uint64_t units = 0;
+        bool outcomesMatch = true;
+        for (uint64_t i = 0; i < iterations; ++i) {
+            *work = *saved.vault;
+            NativeHost host;
+            HostContextBinding binding(engine, host.context());
+            host.credit(host.contractAccount(), work->totalValueLocked);
+            for (size_t c = 0; c < saved.calls.size(); ++c) {
+                const TickLogEntry& call = saved.calls[c];
+                host.credit(call.call.sender, call.call.value);
+                uint64_t begin = benchCycles();
+                bool ok = runWorkloadOp(engine, host, call.call);
+                uint64_t elapsed = benchCycles() - begin;
+                outcomesMatch = outcomesMatch && ok == (call.outcome == TickLogOutcome::SUCCEEDED);
+                if (c == entry.call) {
+                    cycles.push_back(elapsed);
+                    units = engine.lastWork().units;
+                }
+            }
+        }
+        bool worse = units > entry.units;
+        regressed = regressed || worse || !outcomesMatch;
+        std::printf("{\"bench\":\"worstcase\",\"case\":\"%s\",\"procedure\":\"%s\",\"units\":%llu,\"savedUnits\":%llu,"
+                    "\"medianCycles\":%llu,\"savedCycles\":%llu,\"outcomesMatch\":%s,\"regressed\":%s}\n",
+                    entry.name.c_str(), entry.procedure.c_str(), static_cast<unsigned long long>(units),
+                    static_cast<unsigned long long>(entry.units),
+                    static_cast<unsigned long long>(benchPercentile(cycles, 50.0)),
+                    static_cast<unsigned long long>(entry.clock), outcomesMatch ? "true" : "false",
+                    worse || !outcomesMatch ? "true" : "false");
+    }
+    std::fclose(manifest);
+    return regressed ? 1 : 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* runDir = benchArgString(argc, argv, "--run", nullptr);
+    if (runDir != nullptr) return runSaved(runDir, std::max<uint64_t>(1, benchArg(argc, argv, "--iterations", 20)));
+    return search(argc, argv);
+}
@@ -0,0 +1,244 @@
+// contracts/host/VaultAudit.h
+// Pronexma Protocol - Full-scan accounting audit over hot columns
+//
+// The contract keeps running sums (AccountingCounters) so its accounting
+// identities are checked in O(1) after every call. This audit re-derives all
+// of them from the slots instead: per-state locked funds, payer deposits and
+// refunds, beneficiary releases and protocol fees, plus each agreement's own
+// balance. Everything the hot columns hold (state, locked, released) is
+// reduced straight from vault.columns with the dispatched kernels
+// (VaultKernels.h); the wide records are read only for what the columns
+// lack, each agreement's total and released milestone totals, and to check
+// that its columns still match it. Column sums stand in for the records only
+// when no slot drifted, so drift is reported before anything they feed. The
+// recount also yields each fund flow's all-time totals, which the
+// tick-activity trees must match.
+//
+// Milestones are only released from ACTIVE agreements (verification moves a
+// FUNDED one there), which may go on to COMPLETED or REFUNDED. Every slot's
+// milestones are walked all the same: a RELEASED milestone in a CREATED or
+// FUNDED record was never paid out, so it is left out of the totals and the
+// agreement is reported unbalanced.
+
+#pragma once
+
+#include "VaultKernels.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+
+constexpr uint32_t AUDIT_BLOCK_SLOTS = 256;
+
+struct AccountingAudit {
+    uint32_t agreements = 0;
+    AccountingCounters recounted = {};     // accountingCounters as derived from the slots
+    uint64_t lockedSum = 0;
+    uint64_t releasedSum = 0;              // Sum of releasedAmount
+    uint64_t feeSum = 0;                   // Fees withheld from released milestones
+    uint32_t unbalancedAgreements = 0;
+    uint32_t firstUnbalancedSlot = 0;
+    uint32_t driftedSlots = 0;             // Slots whose hot columns differ from the record
+    std::array<uint64_t, TICK_FLOW_COUNT> flowAmounts = {};  // Each TickFlow's total as derived from the slots
+    std::array<uint64_t, TICK_FLOW_COUNT> flowCounts = {};
+    AccountingViolation violation = AccountingViolation::NONE;  // First found
+    uint64_t micros = 0;
+
+    bool clean() const { return violation == AccountingViolation::NONE; }
+};
+
+namespace audit_detail {
+
+// What only the records hold, for one block of slots: the total and the
+// released milestones folded into paid-out, fee and count totals, so the
+// reduction below is a flat loop over one slot per lane.
+struct RecordTotals {
+    alignas(64) uint64_t total[AUDIT_BLOCK_SLOTS];
+    alignas(64) uint64_t paidOut[AUDIT_BLOCK_SLOTS];     // Released milestone amounts, fees included
+    alignas(64) uint64_t fees[AUDIT_BLOCK_SLOTS];        // Fees withheld from them
+    alignas(64) uint64_t releases[AUDIT_BLOCK_SLOTS];    // Released milestone count
+    alignas(64) uint64_t strayReleases[AUDIT_BLOCK_SLOTS]; // RELEASED milestones in a state that never pays out
+    alignas(64) uint64_t unbalanced[AUDIT_BLOCK_SLOTS];
+    uint32_t drifted;                                    // Slots whose hot columns differ
+};
+
+/** Whether an agreement in `state` can hold released milestones. */
+inline bool mayHaveReleased(AgreementState state) {
+    return state == AgreementState::ACTIVE || state == AgreementState::COMPLETED ||
+           state == AgreementState::REFUNDED;
+}
+
+template <typename Config>
+void gatherRecordTotals(const BasicVaultState<Config>& vault, uint32_t first, uint32_t count, RecordTotals& totals) {
+    totals.drifted = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        totals.drifted += !agreementColumnsMatch(vault, first + i);
+        const BasicAgreement<Config>& agreement = vault.agreements[first + i];
+        totals.total[i] = agreement.totalAmount;
+        uint64_t paidOut = 0, fees = 0, releases = 0, stray = 0;
+        const bool paysOut = mayHaveReleased(vault.columns.state[first + i]);
+        uint32_t defined = std::min(agreement.milestoneCount, Config::MAX_MILESTONES);
+        for (uint32_t m = 0; m < defined; ++m) {
+            const BasicMilestone<Config>& milestone = agreement.milestones[m];
+            if (milestone.state != MilestoneState::RELEASED) continue;
+            if (!paysOut) {
+                ++stray;
+                continue;
+            }
+            paidOut += milestone.amount;
+            fees += releaseFee<Config>(milestone.amount);
+            ++releases;
+        }
+        totals.paidOut[i] = paidOut;
+        totals.fees[i] = fees;
+        totals.releases[i] = releases;
+        totals.strayReleases[i] = stray;
+    }
+}
+
+inline uint64_t maskIf(bool condition) {
+    return uint64_t(0) - static_cast<uint64_t>(condition);
+}
+
+/** Per-state locked funds and the locked and released sums, over the columns alone. */
+template <typename Config>
+void reduceColumns(const BasicVaultState<Config>& vault, AccountingAudit& audit) {
+    static_assert(sizeof(AgreementState) == 1, "state column must be one byte per slot");
+    const VaultKernels& kernels = vaultKernels();
+    const AgreementColumns<Config>& columns = vault.columns;
+    const uint8_t* states = reinterpret_cast<const uint8_t*>(columns.state.data());
+    const uint32_t count = vault.activeAgreementCount;
+    for (uint32_t s = 0; s < AGREEMENT_STATE_COUNT; ++s) {
+        audit.recounted.lockedByState[s] =
+            kernels.sumInState(states, columns.locked.data(), count, static_cast<uint8_t>(s));
+    }
+    uint64_t lockedSum = 0, releasedSum = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        lockedSum += columns.locked[i];
+        releasedSum += columns.released[i];
+    }
+    audit.lockedSum = lockedSum;
+    audit.releasedSum = releasedSum;
+}
+
+/** Adds one block's record totals to `audit`; flags unbalanced agreements in totals.unbalanced. */
+template <typename Config>
+void reduceRecordTotals(const AgreementColumns<Config>& columns, uint32_t first, RecordTotals& totals, uint32_t count,
+                        AccountingAudit& audit) {
+    const uint8_t* states = reinterpret_cast<const uint8_t*>(columns.state.data()) + first;
+    const uint64_t* locked = columns.locked.data() + first;
+    const uint64_t* released = columns.released.data() + first;
+    const uint8_t created = static_cast<uint8_t>(AgreementState::CREATED);
+    const uint8_t refunded = static_cast<uint8_t>(AgreementState::REFUNDED);
+
+    uint64_t deposited = 0, refundedSum = 0, feeSum = 0;
+    uint64_t createdSum = 0, paidOutSum = 0, fundedCount = 0, refundedCount = 0, releaseCount = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        uint64_t funded = maskIf(states[i] != created);
+        uint64_t wasRefunded = maskIf(states[i] == refunded);
+        uint64_t remaining = totals.total[i] - totals.paidOut[i];
+        deposited += totals.total[i] & funded;
+        refundedSum += remaining & wasRefunded;
+        feeSum += totals.fees[i];
+        createdSum += totals.total[i];
+        paidOutSum += totals.paidOut[i];
+        fundedCount += funded & 1;
+        refundedCount += wasRefunded & 1;
+        releaseCount += totals.releases[i];
+        // Still locked: whatever was deposited and neither released nor refunded.
+        uint64_t expectedLocked = remaining & funded & ~wasRefunded;
+        totals.unbalanced[i] = static_cast<uint64_t>(locked[i] != expectedLocked) |
+                               static_cast<uint64_t>(released[i] != totals.paidOut[i] - totals.fees[i]) |
+                               static_cast<uint64_t>(totals.paidOut[i] > totals.total[i]) |
+                               static_cast<uint64_t>(totals.strayReleases[i] != 0) |
+                               static_cast<uint64_t>(states[i] >= AGREEMENT_STATE_COUNT);
+    }
+    audit.recounted.depositedByPayers += deposited;
+    audit.recounted.refundedToPayers += refundedSum;
+    audit.feeSum += feeSum;
+    const uint32_t createdFlow = static_cast<uint32_t>(TickFlow::CREATED);
+    const uint32_t fundedFlow = static_cast<uint32_t>(TickFlow::FUNDED);
+    const uint32_t releasedFlow = static_cast<uint32_t>(TickFlow::RELEASED);
+    const uint32_t refundedFlow = static_cast<uint32_t>(TickFlow::REFUNDED);
+    audit.flowAmounts[createdFlow] += createdSum;
+    audit.flowCounts[createdFlow] += count;
+    audit.flowAmounts[fundedFlow] += deposited;
+    audit.flowCounts[fundedFlow] += fundedCount;
+    audit.flowAmounts[releasedFlow] += paidOutSum;
+    audit.flowCounts[releasedFlow] += releaseCount;
+    audit.flowAmounts[refundedFlow] += refundedSum;
+    audit.flowCounts[refundedFlow] += refundedCount;
+}
+
+inline void recordViolation(AccountingAudit& audit, AccountingViolation violation) {
+    if (audit.violation == AccountingViolation::NONE) audit.violation = violation;
+}
+
+} // namespace audit_detail
+
+/**
+ * Scans every used slot and checks the recount against the running sums and
+ * the globals. The first violation found is reported; the O(1) identities
+ * are checked first, so a clean vault passes both.
+ */
+template <typename Config>
+AccountingAudit auditVaultAccounting(const BasicVaultState<Config>& vault) {
+    using namespace audit_detail;
+    auto started = std::chrono::steady_clock::now();
+    AccountingAudit audit;
+    audit.violation = checkAccountingInvariants(vault);
+
+    reduceColumns(vault, audit);
+    auto totals = std::make_unique<RecordTotals>();
+    for (uint32_t first = 0; first < vault.activeAgreementCount; first += AUDIT_BLOCK_SLOTS) {
+        uint32_t count = std::min(AUDIT_BLOCK_SLOTS, vault.activeAgreementCount - first);
+        gatherRecordTotals(vault, first, count, *totals);
+        reduceRecordTotals(vault.columns, first, *totals, count, audit);
+        audit.driftedSlots += totals->drifted;
+        for (uint32_t i = 0; i < count; ++i) {
+            if (totals->unbalanced[i] == 0) continue;
+            if (audit.unbalancedAgreements++ == 0) audit.firstUnbalancedSlot = first + i;
+        }
+    }
+    audit.agreements = vault.activeAgreementCount;
+
+    const AccountingCounters& running = vault.accountingCounters;
+    if (audit.driftedSlots > 0) recordViolation(audit, AccountingViolation::COLUMNS_DRIFTED);
+    if (audit.recounted.lockedByState != running.lockedByState ||
+        audit.recounted.depositedByPayers != running.depositedByPayers ||
+        audit.recounted.refundedToPayers != running.refundedToPayers) {
+        recordViolation(audit, AccountingViolation::COUNTERS_DRIFTED);
+    }
+    if (audit.lockedSum != vault.totalValueLocked) recordViolation(audit, AccountingViolation::TVL_NOT_STATE_SUM);
+    if (audit.releasedSum != vault.totalValueReleased) recordViolation(audit, AccountingViolation::RELEASED_MISMATCH);
+    if (audit.feeSum != vault.protocolFeeAccrued) recordViolation(audit, AccountingViolation::FEES_MISMATCH);
+    if (audit.unbalancedAgreements > 0) recordViolation(audit, AccountingViolation::AGREEMENT_UNBALANCED);
+    for (uint32_t f = 0; f < TICK_FLOW_COUNT; ++f) {
+        TickFlowTotals allTime = sumTickFlow(vault.tickActivity, static_cast<TickFlow>(f), 0, UINT64_MAX);
+        if (allTime.amount != audit.flowAmounts[f] || allTime.count != audit.flowCounts[f]) {
+            recordViolation(audit, AccountingViolation::TICK_FLOWS_DRIFTED);
+        }
+    }
+    audit.micros = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - started).count());
+    return audit;
+}
+
+/** One JSON object (no newline) describing `audit`. */
+inline void printAccountingAudit(std::FILE* out, const AccountingAudit& audit) {
+    std::fprintf(out, "{\"agreements\":%u,\"violation\":\"%s\",\"unbalancedAgreements\":%u,\"firstUnbalancedSlot\":%u,"
+                      "\"driftedSlots\":%u,\"deposited\":%llu,\"refunded\":%llu,\"locked\":%llu,\"released\":%llu,"
+                      "\"fees\":%llu,\"lockedByState\":[",
+                 audit.agreements, accountingViolationName(audit.violation), audit.unbalancedAgreements,
+                 audit.firstUnbalancedSlot, audit.driftedSlots,
+                 static_cast<unsigned long long>(audit.recounted.depositedByPayers),
+                 static_cast<unsigned long long>(audit.recounted.refundedToPayers),
+                 static_cast<unsigned long long>(audit.lockedSum), static_cast<unsigned long long>(audit.releasedSum),
+                 static_cast<unsigned long long>(audit.feeSum));
+    for (uint32_t s = 0; s < AGREEMENT_STATE_COUNT; ++s) {
+        unsigned long long locked = audit.recounted.lockedByState[s];
+        std::fprintf(out, "%s%llu", s == 0 ? "" : ",", locked);
+    }
+    std::fprintf(out, "],\"micros\":%llu}", static_cast<unsigned long long>(audit.micros));
+}
@@ -0,0 +1,155 @@
+// contracts/host/VaultBulkLoad.h
+// Pronexma Protocol - Privileged bulk load of agreement records
+//
+// Importing history through createAgreement/deposit repeats validation and the
+// linear ID search on every call, and replicas then update their indexes one
+// insert at a time. The bulk loader is the replica/test path instead: it takes
+// agreement records sorted by ID, checks each record's structural invariants
+// and balance once, writes slots sequentially and builds all indexes in one bulk pass
+// (pre-sized tables, one sort for the timeout index).
+//
+// Not a contract entry point: the loader trusts the records' parties, states
+// and ticks, and it does not run the checkpoint write barrier.
+
+#pragma once
+
+#include "VaultIndexes.h"
+#include "VaultMigration.h"
+
+#include <chrono>
+
+struct BulkLoadReport {
+    uint32_t agreements = 0;
+    uint64_t milestones = 0;
+    uint64_t lockedSum = 0;
+    uint64_t releasedSum = 0;
+    uint64_t feeSum = 0;                   // Protocol fees withheld from released milestones
+    uint64_t loadMicros = 0;               // Record checks and slot writes
+    uint64_t indexMicros = 0;              // Bulk index construction
+    MigrationViolation violation = MigrationViolation::NONE;
+    AccountingViolation accountingViolation = AccountingViolation::NONE;  // Vault-wide, checked by finish
+    uint32_t failedRecord = 0;             // Record that stopped the load, if any
+};
+
+/**
+ * Streams records into an empty vault: begin, append in ascending ID order,
+ * then finish, which sets the vault counters, checks the accounting
+ * identities and builds `indexes`. On failure the vault holds a partial load
+ * and should be discarded.
+ */
+class VaultBulkLoader {
+public:
+    VaultBulkLoader(PronexmaVaultState& vault, VaultIndexes& indexes) : vault_(vault), indexes_(indexes) {}
+
+    /** BUSY if the vault already holds agreements; `expected` pre-sizes the indexes. */
+    SnapshotStatus begin(uint32_t expected = 0) {
+        if (vault_.activeAgreementCount != 0) {
+            return SnapshotStatus::BUSY;
+        }
+        report_ = BulkLoadReport();
+        partial_ = VaultIndexPartial();
+        partial_.reserve(std::min(expected, MAX_AGREEMENTS));
+        lastId_ = 0;
+        vault_.capacityCounters = CapacityCounters{};
+        vault_.accountingCounters = AccountingCounters{};
+        started_ = std::chrono::steady_clock::now();
+        return SnapshotStatus::OK;
+    }
+
+    SnapshotStatus append(const Agreement& record) {
+        uint32_t slot = report_.agreements;
+        if (slot >= MAX_AGREEMENTS) {
+            return fail(SnapshotStatus::CAPACITY_EXCEEDED);
+        }
+        // IDs must come from this vault's generator and strictly increase, so
+        // agreementCounter can resume from the last one.
+        if (record.id <= lastId_) {
+            return fail(SnapshotStatus::OUT_OF_ORDER);
+        }
+        if ((record.id >> 32) != AGREEMENT_ID_PREFIX || static_cast<uint32_t>(record.id) == 0) {
+            return fail(SnapshotStatus::INVARIANT_VIOLATION);
+        }
+        MigrationViolation violation = checkAgreementInvariants(record);
+        if (violation != MigrationViolation::NONE) {
+            report_.violation = violation;
+            return fail(SnapshotStatus::INVARIANT_VIOLATION);
+        }
+
+        vault_.agreements[slot] = record;
+        syncAgreementColumns(vault_, slot);
+        partial_.add(record, slot);
+        lastId_ = record.id;
+        report_.lockedSum += record.lockedAmount;
+        report_.releasedSum += record.releasedAmount;
+        report_.milestones += record.milestoneCount;
+        uint32_t stateIndex = static_cast<uint32_t>(record.state);
+        if (stateIndex < AGREEMENT_STATE_COUNT) ++vault_.capacityCounters.agreementsByState[stateIndex];
+        vault_.capacityCounters.milestonesUsed += record.milestoneCount;
+        accountAgreement(vault_.accountingCounters, record);
+        for (uint32_t m = 0; m < record.milestoneCount; ++m) {
+            if (record.milestones[m].state == MilestoneState::RELEASED) {
+                report_.feeSum += releaseFee(record.milestones[m].amount);
+            }
+        }
+        ++report_.agreements;
+        return SnapshotStatus::OK;
+    }
+
+    SnapshotStatus finish() {
+        report_.loadMicros = elapsedMicros();
+        vault_.activeAgreementCount = report_.agreements;
+        vault_.agreementCounter = static_cast<uint32_t>(lastId_);
+        vault_.totalValueLocked = report_.lockedSum;
+        vault_.totalValueReleased = report_.releasedSum;
+        vault_.protocolFeeAccrued = report_.feeSum;
+        rebuildTickActivity(vault_);
+        // Balanced records can still break the vault-wide identities (a
+        // COMPLETED agreement with funds left locked).
+        report_.accountingViolation = checkAccountingInvariants(vault_);
+        if (report_.accountingViolation != AccountingViolation::NONE) {
+            report_.failedRecord = report_.agreements;
+            return SnapshotStatus::INVARIANT_VIOLATION;
+        }
+
+        started_ = std::chrono::steady_clock::now();
+        partial_.finish();
+        std::vector<VaultIndexPartial> partials(1);
+        partials[0] = std::move(partial_);
+        mergeVaultIndexPartials(partials, indexes_);
+        report_.indexMicros = elapsedMicros();
+        return SnapshotStatus::OK;
+    }
+
+    const BulkLoadReport& report() const { return report_; }
+
+private:
+    SnapshotStatus fail(SnapshotStatus status) {
+        report_.failedRecord = report_.agreements;
+        return status;
+    }
+
+    uint64_t elapsedMicros() const {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - started_).count());
+    }
+
+    PronexmaVaultState& vault_;
+    VaultIndexes& indexes_;
+    VaultIndexPartial partial_;
+    BulkLoadReport report_;
+    uint64_t lastId_ = 0;
+    std::chrono::steady_clock::time_point started_;
+};
+
+/** Loads `count` ID-sorted records into an empty vault and builds its indexes. */
+inline SnapshotStatus bulkLoadAgreements(PronexmaVaultState& vault, const Agreement* records, uint32_t count,
+                                         VaultIndexes& indexes, BulkLoadReport* report = nullptr) {
+    VaultBulkLoader loader(vault, indexes);
+    SnapshotStatus status = loader.begin(count);
+    for (uint32_t i = 0; status == SnapshotStatus::OK && i < count; ++i) {
+        status = loader.append(records[i]);
+    }
+    if (status == SnapshotStatus::OK) status = loader.finish();
+    if (report != nullptr) *report = loader.report();
+    return status;
+}
@@ -0,0 +1,212 @@
+// contracts/host/VaultCheckpoint.h
+// Pronexma Protocol - Non-blocking background checkpoints
+//
+// A checkpoint captures the vault at a tick boundary and serializes it on a
+// background thread while procedures keep executing. Consistency comes from a
+// slot-granular copy-on-write: the first time a procedure is about to mutate a
+// slot that has not been written out yet, the write barrier preserves the old
+// record for the checkpoint thread. Slots created after the capture are never
+// part of the view and cost nothing.
+//
+// Per-slot protocol (one atomic byte per captured slot):
+//   PENDING -> SERIALIZING -> DONE        checkpoint thread reached it first
+//   PENDING -> PRESERVING  -> PRESERVED   a procedure reached it first
+
+#pragma once
+
+#include "VaultSnapshot.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+struct CheckpointStats {
+    uint64_t tick = 0;                     // Tick boundary of the last checkpoint
+    uint32_t agreements = 0;               // Slots in the captured view
+    uint32_t preservedSlots = 0;           // Slots copied by the write barrier
+    uint64_t bytesWritten = 0;
+    uint64_t durationMicros = 0;           // Capture to durable rename
+};
+
+class VaultCheckpointer {
+public:
+    /** Checkpoints `engine`'s state; installs the write barrier on that engine only. */
+    explicit VaultCheckpointer(PronexmaVaultEngine& engine)
+        : engine_(engine), vault_(engine.state), previousHooks_(engine.hostHooks) {
+        engine_.hostHooks.beforeAgreementWrite = &VaultCheckpointer::writeBarrier;
+        engine_.hostHooks.context = this;
+    }
+
+    ~VaultCheckpointer() {
+        wait();
+        engine_.hostHooks = previousHooks_;
+    }
+
+    VaultCheckpointer(const VaultCheckpointer&) = delete;
+    VaultCheckpointer& operator=(const VaultCheckpointer&) = delete;
+
+    /**
+     * Captures the current state and starts writing it to `path` in the
+     * background. Must be called at a tick boundary (no procedure running).
+     * Returns BUSY if the previous checkpoint is still in flight.
+     */
+    SnapshotStatus begin(const std::string& path, uint64_t tick, BlockEncoding encoding = BlockEncoding::RAW) {
+        if (inFlight()) {
+            return SnapshotStatus::BUSY;
+        }
+        join();
+
+        header_ = makeSnapshotHeader(vault_, tick);
+        captureSnapshotTicks(vault_.tickActivity, ticks_);
+        capturedCount_ = header_.agreementCount;
+        slots_.reset(new std::atomic<uint8_t>[capturedCount_]);
+        preserved_.reset(new Agreement*[capturedCount_]);
+        for (uint32_t i = 0; i < capturedCount_; ++i) {
+            slots_[i].store(PENDING, std::memory_order_relaxed);
+            preserved_[i] = nullptr;
+        }
+        preservedCount_.store(0, std::memory_order_relaxed);
+        path_ = path;
+        encoding_ = encoding;
+        result_ = SnapshotStatus::OK;
+        startedAt_ = std::chrono::steady_clock::now();
+
+        active_.store(true, std::memory_order_release);
+        worker_ = std::thread(&VaultCheckpointer::run, this);
+        return SnapshotStatus::OK;
+    }
+
+    bool inFlight() const { return active_.load(std::memory_order_acquire); }
+
+    /** Blocks until the in-flight checkpoint (if any) is durable. */
+    SnapshotStatus wait() {
+        join();
+        return result_;
+    }
+
+    const CheckpointStats& lastStats() const { return stats_; }
+
+private:
+    enum SlotState : uint8_t { PENDING, SERIALIZING, DONE, PRESERVING, PRESERVED };
+
+    static void writeBarrier(void* context, uint32_t slot) {
+        static_cast<VaultCheckpointer*>(context)->beforeWrite(slot);
+    }
+
+    void beforeWrite(uint32_t slot) {
+        if (!active_.load(std::memory_order_acquire) || slot >= capturedCount_) {
+            return;
+        }
+        uint8_t observed = PENDING;
+        if (slots_[slot].compare_exchange_strong(observed, PRESERVING, std::memory_order_acq_rel)) {
+            preserved_[slot] = new Agreement(vault_.agreements[slot]);
+            preservedCount_.fetch_add(1, std::memory_order_relaxed);
+            slots_[slot].store(PRESERVED, std::memory_order_release);
+            return;
+        }
+        // The checkpoint thread is copying this one record into its block
+        // buffer; it encodes and writes the block only after releasing the
+        // slot, so the copy finishes in well under a microsecond: spin.
+        while (observed == SERIALIZING) {
+            observed = slots_[slot].load(std::memory_order_acquire);
+        }
+    }
+
+    void run() {
+        std::string tmpPath = path_ + ".tmp";
+        int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        SnapshotStatus status = fd < 0 ? SnapshotStatus::IO_ERROR : SnapshotStatus::OK;
+        uint64_t bytesWritten = 0;
+
+        if (status == SnapshotStatus::OK) {
+            SnapshotWriter writer(fd, encoding_);
+            status = writer.writeHeader(header_);
+            for (uint32_t i = 0; i < capturedCount_; ++i) {
+                // Hold the slot only for the copy; encoding and write() of a
+                // full block happen after the write barrier can have it back.
+                const Agreement* record = claim(i);
+                if (status == SnapshotStatus::OK) {
+                    status = writer.copyAgreement(*record);
+                }
+                release(i);
+                if (status == SnapshotStatus::OK) {
+                    status = writer.flushFullBlock();
+                }
+            }
+            if (status == SnapshotStatus::OK) {
+                status = writer.finish(ticks_);
+            }
+            bytesWritten = writer.bytesWritten();
+            if (status == SnapshotStatus::OK) {
+                status = commitSnapshotFile(fd, tmpPath, path_);
+            } else {
+                ::close(fd);
+                ::unlink(tmpPath.c_str());
+            }
+        } else {
+            // Still walk the slots so the write barrier never waits on us.
+            for (uint32_t i = 0; i < capturedCount_; ++i) {
+                claim(i);
+                release(i);
+            }
+        }
+
+        result_ = status;
+        stats_.tick = header_.tick;
+        stats_.agreements = capturedCount_;
+        stats_.preservedSlots = preservedCount_.load(std::memory_order_relaxed);
+        stats_.bytesWritten = bytesWritten;
+        stats_.durationMicros = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - startedAt_).count());
+        active_.store(false, std::memory_order_release);
+    }
+
+    // Returns the record to serialize for `slot`: the live slot if we got
+    // there first, otherwise the copy taken by the write barrier.
+    const Agreement* claim(uint32_t slot) {
+        uint8_t observed = PENDING;
+        if (slots_[slot].compare_exchange_strong(observed, SERIALIZING, std::memory_order_acq_rel)) {
+            return &vault_.agreements[slot];
+        }
+        while (observed != PRESERVED) {
+            std::this_thread::yield();
+            observed = slots_[slot].load(std::memory_order_acquire);
+        }
+        return preserved_[slot];
+    }
+
+    void release(uint32_t slot) {
+        if (slots_[slot].load(std::memory_order_relaxed) == SERIALIZING) {
+            slots_[slot].store(DONE, std::memory_order_release);
+        } else {
+            delete preserved_[slot];
+            preserved_[slot] = nullptr;
+        }
+    }
+
+    void join() {
+        if (worker_.joinable()) {
+            worker_.join();
+        }
+    }
+
+    PronexmaVaultEngine& engine_;
+    PronexmaVaultState& vault_;
+    HostHooks previousHooks_;
+
+    SnapshotHeader header_{};
+    SnapshotTicks ticks_{};                // Tick trees at the capture
+    uint32_t capturedCount_ = 0;
+    std::unique_ptr<std::atomic<uint8_t>[]> slots_;
+    std::unique_ptr<Agreement*[]> preserved_;
+    std::atomic<uint32_t> preservedCount_{0};
+
+    std::string path_;
+    BlockEncoding encoding_ = BlockEncoding::RAW;
+    std::thread worker_;
+    std::atomic<bool> active_{false};
+    SnapshotStatus result_ = SnapshotStatus::OK;
+    CheckpointStats stats_;
+    std::chrono::steady_clock::time_point startedAt_;
+};
@@ -0,0 +1,398 @@
+// contracts/host/VaultColumnExport.h
+// Pronexma Protocol - Columnar export of agreements and milestones
+//
+// Writes one file per column into an export directory so analytics tools can
+// memory-map or bulk-load columns without parsing rows:
+//
+//   agreements/<column>.bin   one value per agreement, little-endian
+//   milestones/<column>.bin   one value per used milestone slot
+//   dict/<name>.offsets       uint64 byte offsets, entries + 1 values
+//   dict/<name>.data          concatenated UTF-8 bytes (no terminators)
+//   manifest.json             row counts, column types and dictionaries
+//
+// Column types: u8, u32, u64, bytes64 (fixed 64-byte values) and dict (uint32
+// codes into a dictionary; entry i is data[offsets[i] .. offsets[i + 1])).
+// Addresses share the "addresses" dictionary of Qubic identities; titles,
+// metadata and milestone descriptions share "text".
+//
+// Rows stream straight to buffered column files. Memory is bounded by the
+// column buffers plus the dictionary lookup tables, which stop growing at
+// maxDictionaryEntries; past that, unseen values still get fresh codes but are
+// not deduplicated. manifest.json is written last and marks a complete export.
+
+#pragma once
+
+#include "VaultFields.h"
+#include "VaultSnapshot.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <unordered_map>
+
+#include <sys/stat.h>
+
+// ============================================================================
+// COLUMN FILES
+// ============================================================================
+
+enum class ExportColumnType : uint8_t { U8, U32, U64, BYTES64, DICT };
+
+inline const char* exportColumnTypeName(ExportColumnType type) {
+    switch (type) {
+        case ExportColumnType::U8: return "u8";
+        case ExportColumnType::U32: return "u32";
+        case ExportColumnType::U64: return "u64";
+        case ExportColumnType::BYTES64: return "bytes64";
+        case ExportColumnType::DICT: return "dict";
+    }
+    return "unknown";
+}
+
+namespace column_export_detail {
+
+constexpr size_t COLUMN_BUFFER_BYTES = 64 * 1024;
+
+inline bool makeDirectory(const std::string& path) {
+    return ::mkdir(path.c_str(), 0755) == 0 || errno == EEXIST;
+}
+
+/** Append-only file with a small write buffer. */
+class ColumnFile {
+public:
+    ~ColumnFile() { close(); }
+
+    bool open(const std::string& path) {
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd_ < 0) return false;
+        out_.reset(new FdWriter(fd_, COLUMN_BUFFER_BYTES));
+        return true;
+    }
+
+    bool write(const void* data, size_t length) { return out_->write(data, length); }
+
+    template <typename T>
+    bool put(T value) { return out_->write(&value, sizeof(value)); }
+
+    uint64_t offset() const { return out_->offset(); }
+
+    bool close() {
+        if (fd_ < 0) return true;
+        bool ok = out_->flush();
+        ok = (::close(fd_) == 0) && ok;
+        fd_ = -1;
+        return ok;
+    }
+
+private:
+    int fd_ = -1;
+    std::unique_ptr<FdWriter> out_;
+};
+
+/**
+ * String dictionary whose entries are written out as soon as they are first
+ * seen, so only the lookup table stays in memory.
+ */
+class StreamingDictionary {
+public:
+    bool open(const std::string& directory, const std::string& name, size_t maxEntries) {
+        name_ = name;
+        maxEntries_ = maxEntries;
+        if (!offsets_.open(directory + "/" + name + ".offsets") || !data_.open(directory + "/" + name + ".data")) {
+            return false;
+        }
+        return offsets_.put<uint64_t>(0);
+    }
+
+    /** Returns the code for `text`, appending a new entry if needed. */
+    bool intern(const std::string& text, uint32_t& code) {
+        auto found = lookup_.find(text);
+        if (found != lookup_.end()) {
+            code = found->second;
+            return true;
+        }
+        code = entries_++;
+        if (lookup_.size() < maxEntries_) {
+            lookup_.emplace(text, code);
+        }
+        return data_.write(text.data(), text.size()) && offsets_.put<uint64_t>(data_.offset());
+    }
+
+    const std::string& name() const { return name_; }
+    uint32_t entries() const { return entries_; }
+    uint64_t bytes() const { return data_.offset(); }
+
+    bool close() {
+        bool ok = offsets_.close();
+        return data_.close() && ok;
+    }
+
+private:
+    std::string name_;
+    size_t maxEntries_ = 0;
+    uint32_t entries_ = 0;
+    std::unordered_map<std::string, uint32_t> lookup_;
+    ColumnFile offsets_;
+    ColumnFile data_;
+};
+
+struct ExportColumn {
+    const char* name;
+    ExportColumnType type;
+    const char* dictionary;   // DICT columns only
+    ColumnFile file;
+};
+
+} // namespace column_export_detail
+
+// ============================================================================
+// EXPORTER
+// ============================================================================
+
+struct ColumnExportStats {
+    uint32_t agreements = 0;
+    uint64_t milestones = 0;
+    uint32_t addressEntries = 0;
+    uint32_t textEntries = 0;
+    uint64_t micros = 0;
+};
+
+/**
+ * Streams agreements into an export directory: open, append each agreement in
+ * slot order, then finish (which writes manifest.json).
+ */
+class VaultColumnExporter {
+public:
+    explicit VaultColumnExporter(size_t maxDictionaryEntries = 1 << 20) : maxDictionaryEntries_(maxDictionaryEntries) {}
+
+    VaultColumnExporter(const VaultColumnExporter&) = delete;
+    VaultColumnExporter& operator=(const VaultColumnExporter&) = delete;
+
+    SnapshotStatus open(const std::string& directory) {
+        using namespace column_export_detail;
+        directory_ = directory;
+        started_ = std::chrono::steady_clock::now();
+        stats_ = ColumnExportStats();
+        if (!makeDirectory(directory) || !makeDirectory(directory + "/agreements") ||
+            !makeDirectory(directory + "/milestones") || !makeDirectory(directory + "/dict")) {
+            return SnapshotStatus::IO_ERROR;
+        }
+        // A stale manifest would describe columns we are about to overwrite.
+        ::unlink((directory + "/manifest.json").c_str());
+
+        bool ok = addresses_.open(directory + "/dict", "addresses", maxDictionaryEntries_) &&
+                  text_.open(directory + "/dict", "text", maxDictionaryEntries_);
+        for (ExportColumn& column : agreementColumns_) {
+            ok = ok && column.file.open(directory + "/agreements/" + column.name + ".bin");
+        }
+        for (ExportColumn& column : milestoneColumns_) {
+            ok = ok && column.file.open(directory + "/milestones/" + column.name + ".bin");
+        }
+        return ok ? SnapshotStatus::OK : SnapshotStatus::IO_ERROR;
+    }
+
+    SnapshotStatus append(const Agreement& agreement) {
+        ExportColumn* c = agreementColumns_;
+        uint32_t payer = 0, beneficiary = 0, oracle = 0, title = 0, metadata = 0;
+        bool ok = addresses_.intern(addressIdentity(agreement.payer), payer) &&
+                  addresses_.intern(addressIdentity(agreement.beneficiary), beneficiary) &&
+                  addresses_.intern(addressIdentity(agreement.oracleAdmin), oracle) &&
+                  text_.intern(fixedText(agreement.title), title) &&
+                  text_.intern(fixedText(agreement.metadata), metadata);
+        uint32_t milestoneCount = std::min(agreement.milestoneCount, MAX_MILESTONES_PER_AGREEMENT);
+        ok = ok &&
+             c[0].file.put<uint64_t>(agreement.id) &&
+             c[1].file.put<uint8_t>(static_cast<uint8_t>(agreement.state)) &&
+             c[2].file.put<uint64_t>(agreement.totalAmount) &&
+             c[3].file.put<uint64_t>(agreement.lockedAmount) &&
+             c[4].file.put<uint64_t>(agreement.releasedAmount) &&
+             c[5].file.put<uint64_t>(agreement.createdAtTick) &&
+             c[6].file.put<uint64_t>(agreement.fundedAtTick) &&
+             c[7].file.put<uint64_t>(agreement.timeoutTick) &&
+             c[8].file.put<uint32_t>(milestoneCount) &&
+             c[9].file.put<uint32_t>(payer) &&
+             c[10].file.put<uint32_t>(beneficiary) &&
+             c[11].file.put<uint32_t>(oracle) &&
+             c[12].file.put<uint32_t>(title) &&
+             c[13].file.put<uint32_t>(metadata);
+
+        ExportColumn* m = milestoneColumns_;
+        for (uint32_t i = 0; ok && i < milestoneCount; ++i) {
+            const Milestone& milestone = agreement.milestones[i];
+            uint32_t description = 0;
+            ok = text_.intern(fixedText(milestone.description), description) &&
+                 m[0].file.put<uint32_t>(stats_.agreements) &&
+                 m[1].file.put<uint64_t>(agreement.id) &&
+                 m[2].file.put<uint32_t>(i) &&
+                 m[3].file.put<uint32_t>(milestone.id) &&
+                 m[4].file.put<uint64_t>(milestone.amount) &&
+                 m[5].file.put<uint8_t>(static_cast<uint8_t>(milestone.state)) &&
+                 m[6].file.put<uint64_t>(milestone.verifiedAtTick) &&
+                 m[7].file.put<uint64_t>(milestone.releasedAtTick) &&
+                 m[8].file.write(milestone.evidenceHash.data(), milestone.evidenceHash.size()) &&
+                 m[9].file.put<uint32_t>(description);
+        }
+        if (!ok) return SnapshotStatus::IO_ERROR;
+        stats_.milestones += milestoneCount;
+        ++stats_.agreements;
+        return SnapshotStatus::OK;
+    }
+
+    SnapshotStatus finish() {
+        bool ok = addresses_.close() && text_.close();
+        for (ExportColumn& column : agreementColumns_) ok = column.file.close() && ok;
+        for (ExportColumn& column : milestoneColumns_) ok = column.file.close() && ok;
+        stats_.addressEntries = addresses_.entries();
+        stats_.textEntries = text_.entries();
+        if (!ok || !writeManifest()) return SnapshotStatus::IO_ERROR;
+        stats_.micros = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - started_).count());
+        return SnapshotStatus::OK;
+    }
+
+    const ColumnExportStats& stats() const { return stats_; }
+
+private:
+    using ExportColumn = column_export_detail::ExportColumn;
+
+    bool writeManifest() {
+        std::string json = "{\n  \"format\": \"pronexma-columns\",\n  \"version\": 1,\n  \"byteOrder\": \"little\",\n";
+        json += "  \"dictionaries\": [\n";
+        appendDictionary(json, addresses_, false);
+        appendDictionary(json, text_, true);
+        json += "  ],\n  \"tables\": [\n";
+        appendTable(json, "agreements", stats_.agreements, agreementColumns_, AGREEMENT_COLUMNS, false);
+        appendTable(json, "milestones", stats_.milestones, milestoneColumns_, MILESTONE_COLUMNS, true);
+        json += "  ]\n}\n";
+
+        std::string path = directory_ + "/manifest.json";
+        std::string tmpPath = path + ".tmp";
+        int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) return false;
+        FdWriter out(fd, json.size());
+        if (!out.write(json.data(), json.size()) || !out.flush()) {
+            ::close(fd);
+            ::unlink(tmpPath.c_str());
+            return false;
+        }
+        return commitSnapshotFile(fd, tmpPath, path) == SnapshotStatus::OK;
+    }
+
+    static void appendDictionary(std::string& json, const column_export_detail::StreamingDictionary& dictionary, bool last) {
+        char line[256];
+        std::snprintf(line, sizeof(line),
+                      "    {\"name\": \"%s\", \"entries\": %u, \"offsets\": \"dict/%s.offsets\", \"data\": \"dict/%s.data\"}%s\n",
+                      dictionary.name().c_str(), dictionary.entries(), dictionary.name().c_str(),
+                      dictionary.name().c_str(), last ? "" : ",");
+        json += line;
+    }
+
+    static void appendTable(std::string& json, const char* table, uint64_t rows, const ExportColumn* columns,
+                            size_t count, bool last) {
+        char line[256];
+        std::snprintf(line, sizeof(line), "    {\"name\": \"%s\", \"rows\": %llu, \"columns\": [\n",
+                      table, static_cast<unsigned long long>(rows));
+        json += line;
+        for (size_t i = 0; i < count; ++i) {
+            const ExportColumn& column = columns[i];
+            std::snprintf(line, sizeof(line), "      {\"name\": \"%s\", \"type\": \"%s\", \"file\": \"%s/%s.bin\"",
+                          column.name, exportColumnTypeName(column.type), table, column.name);
+            json += line;
+            if (column.dictionary != nullptr) {
+                json += ", \"dictionary\": \"";
+                json += column.dictionary;
+                json += "\"";
+            }
+            json += i + 1 < count ? "},\n" : "}\n";
+        }
+        json += last ? "    ]}\n" : "    ]},\n";
+    }
+
+    static constexpr size_t AGREEMENT_COLUMNS = 14;
+    static constexpr size_t MILESTONE_COLUMNS = 10;
+
+    // Order matches the writes in append().
+    ExportColumn agreementColumns_[AGREEMENT_COLUMNS] = {
+        {"id", ExportColumnType::U64, nullptr, {}},
+        {"state", ExportColumnType::U8, nullptr, {}},
+        {"totalAmount", ExportColumnType::U64, nullptr, {}},
+        {"lockedAmount", ExportColumnType::U64, nullptr, {}},
+        {"releasedAmount", ExportColumnType::U64, nullptr, {}},
+        {"createdAtTick", ExportColumnType::U64, nullptr, {}},
+        {"fundedAtTick", ExportColumnType::U64, nullptr, {}},
+        {"timeoutTick", ExportColumnType::U64, nullptr, {}},
+        {"milestoneCount", ExportColumnType::U32, nullptr, {}},
+        {"payer", ExportColumnType::DICT, "addresses", {}},
+        {"beneficiary", ExportColumnType::DICT, "addresses", {}},
+        {"oracleAdmin", ExportColumnType::DICT, "addresses", {}},
+        {"title", ExportColumnType::DICT, "text", {}},
+        {"metadata", ExportColumnType::DICT, "text", {}},
+    };
+    ExportColumn milestoneColumns_[MILESTONE_COLUMNS] = {
+        {"agreementRow", ExportColumnType::U32, nullptr, {}},
+        {"agreementId", ExportColumnType::U64, nullptr, {}},
+        {"sequence", ExportColumnType::U32, nullptr, {}},
+        {"id", ExportColumnType::U32, nullptr, {}},
+        {"amount", ExportColumnType::U64, nullptr, {}},
+        {"state", ExportColumnType::U8, nullptr, {}},
+        {"verifiedAtTick", ExportColumnType::U64, nullptr, {}},
+        {"releasedAtTick", ExportColumnType::U64, nullptr, {}},
+        {"evidenceHash", ExportColumnType::BYTES64, nullptr, {}},
+        {"description", ExportColumnType::DICT, "text", {}},
+    };
+
+    size_t maxDictionaryEntries_;
+    std::string directory_;
+    column_export_detail::StreamingDictionary addresses_;
+    column_export_detail::StreamingDictionary text_;
+    ColumnExportStats stats_;
+    std::chrono::steady_clock::time_point started_;
+};
+
+static_assert(sizeof(Milestone::evidenceHash) == 64, "bytes64 column width");
+
+// ============================================================================
+// SOURCES
+// ============================================================================
+
+/** Exports the live slots of `vault`. */
+inline SnapshotStatus exportVaultColumns(const PronexmaVaultState& vault, const std::string& directory,
+                                         ColumnExportStats* stats = nullptr) {
+    VaultColumnExporter exporter;
+    SnapshotStatus status = exporter.open(directory);
+    for (uint32_t i = 0; status == SnapshotStatus::OK && i < vault.activeAgreementCount; ++i) {
+        status = exporter.append(vault.agreements[i]);
+    }
+    if (status == SnapshotStatus::OK) status = exporter.finish();
+    if (stats != nullptr) *stats = exporter.stats();
+    return status;
+}
+
+/**
+ * Exports a snapshot file block by block, so memory does not depend on the
+ * number of agreements in the image.
+ */
+inline SnapshotStatus exportSnapshotColumns(const std::string& snapshotPath, const std::string& directory,
+                                            ColumnExportStats* stats = nullptr) {
+    int fd = ::open(snapshotPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return SnapshotStatus::IO_ERROR;
+    }
+    SnapshotReader reader(fd);
+    SnapshotHeader header;
+    SnapshotStatus status = reader.readHeader(header);
+    VaultColumnExporter exporter;
+    if (status == SnapshotStatus::OK) status = exporter.open(directory);
+    std::vector<Agreement> block(SNAPSHOT_BLOCK_CAPACITY);
+    while (status == SnapshotStatus::OK && !reader.done()) {
+        SnapshotBlockHeader blockHeader;
+        status = reader.readBlock(blockHeader, block.data());
+        for (uint32_t i = 0; status == SnapshotStatus::OK && i < blockHeader.count; ++i) {
+            status = exporter.append(block[i]);
+        }
+    }
+    ::close(fd);
+    if (status == SnapshotStatus::OK) status = exporter.finish();
+    if (stats != nullptr) *stats = exporter.stats();
+    return status;
+}
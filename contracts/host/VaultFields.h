@@ -0,0 +1,89 @@
+// contracts/host/VaultFields.h
+// Pronexma Protocol - Named, printable views of vault records
+//
+// Flattens an Agreement (including every milestone slot) into an ordered list
+// of (field, value) pairs. Used wherever host tools need field-level output.
+
+#pragma once
+
+#include "VaultIdentity.h"
+
+#include <string>
+#include <vector>
+
+inline const char* agreementStateName(AgreementState state) {
+    switch (state) {
+        case AgreementState::CREATED: return "CREATED";
+        case AgreementState::FUNDED: return "FUNDED";
+        case AgreementState::ACTIVE: return "ACTIVE";
+        case AgreementState::COMPLETED: return "COMPLETED";
+        case AgreementState::REFUNDED: return "REFUNDED";
+        case AgreementState::DISPUTED: return "DISPUTED";
+    }
+    return "UNKNOWN";
+}
+
+inline const char* milestoneStateName(MilestoneState state) {
+    switch (state) {
+        case MilestoneState::PENDING: return "PENDING";
+        case MilestoneState::VERIFIED: return "VERIFIED";
+        case MilestoneState::RELEASED: return "RELEASED";
+        case MilestoneState::CANCELLED: return "CANCELLED";
+    }
+    return "UNKNOWN";
+}
+
+/** Text up to the first NUL of a fixed-size char field. */
+template <size_t N>
+inline std::string fixedText(const std::array<char, N>& field) {
+    size_t length = 0;
+    while (length < N && field[length] != '\0') ++length;
+    return std::string(field.data(), length);
+}
+
+template <size_t N>
+inline std::string hexBytes(const std::array<uint8_t, N>& field) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out(N * 2, '0');
+    for (size_t i = 0; i < N; ++i) {
+        out[i * 2] = digits[field[i] >> 4];
+        out[i * 2 + 1] = digits[field[i] & 0xF];
+    }
+    return out;
+}
+
+struct FieldValue {
+    std::string name;
+    std::string value;
+};
+
+inline void describeMilestone(const Milestone& milestone, const std::string& prefix, std::vector<FieldValue>& out) {
+    out.push_back({prefix + "id", std::to_string(milestone.id)});
+    out.push_back({prefix + "amount", std::to_string(milestone.amount)});
+    out.push_back({prefix + "state", milestoneStateName(milestone.state)});
+    out.push_back({prefix + "verifiedAtTick", std::to_string(milestone.verifiedAtTick)});
+    out.push_back({prefix + "releasedAtTick", std::to_string(milestone.releasedAtTick)});
+    out.push_back({prefix + "description", fixedText(milestone.description)});
+    out.push_back({prefix + "evidenceHash", hexBytes(milestone.evidenceHash)});
+}
+
+inline void describeAgreement(const Agreement& agreement, std::vector<FieldValue>& out) {
+    out.clear();
+    out.push_back({"id", std::to_string(agreement.id)});
+    out.push_back({"payer", addressIdentity(agreement.payer)});
+    out.push_back({"beneficiary", addressIdentity(agreement.beneficiary)});
+    out.push_back({"oracleAdmin", addressIdentity(agreement.oracleAdmin)});
+    out.push_back({"totalAmount", std::to_string(agreement.totalAmount)});
+    out.push_back({"lockedAmount", std::to_string(agreement.lockedAmount)});
+    out.push_back({"releasedAmount", std::to_string(agreement.releasedAmount)});
+    out.push_back({"state", agreementStateName(agreement.state)});
+    out.push_back({"createdAtTick", std::to_string(agreement.createdAtTick)});
+    out.push_back({"fundedAtTick", std::to_string(agreement.fundedAtTick)});
+    out.push_back({"timeoutTick", std::to_string(agreement.timeoutTick)});
+    out.push_back({"milestoneCount", std::to_string(agreement.milestoneCount)});
+    for (uint32_t i = 0; i < MAX_MILESTONES_PER_AGREEMENT; ++i) {
+        describeMilestone(agreement.milestones[i], "milestones[" + std::to_string(i) + "].", out);
+    }
+    out.push_back({"title", fixedText(agreement.title)});
+    out.push_back({"metadata", fixedText(agreement.metadata)});
+}
@@ -0,0 +1,330 @@
+// contracts/host/VaultHistogram.h
+// Pronexma Protocol - High-dynamic-range latency histograms for the harness
+//
+// LatencyHistogram uses a log-linear bucket layout in the HdrHistogram
+// style. Values below 2048 are exact. Above that, every power of two is split
+// into 1024 sub-buckets, so any recorded value is known to three significant
+// digits, from 1 ns up to the full 64-bit range. Recording is O(1) and needs
+// no samples to be kept. Histograms with the same layout merge by adding
+// counts.
+//
+// LatencyHistograms keeps one histogram per workload procedure and per outcome
+// code (VaultError, or FAILED for a failed call without a contract reason).
+// The export format is one JSON line per non-empty histogram, with sparse
+// [index,count] pairs:
+//
+//   {"histogram":"latency","label":"...","procedure":"deposit","outcome":"OK",
+//    "unit":"ns","subBucketBits":10,"count":N,"min":..,"max":..,"sum":..,
+//    "buckets":[[index,count],...]}
+//
+// Files from different runs, builds or machines can be concatenated and read
+// back with mergeHistogramLine(); vault_histo prints and compares them.
+
+#pragma once
+
+#include "VaultWorkload.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// HISTOGRAM
+// ============================================================================
+
+constexpr uint32_t HISTOGRAM_SUB_BUCKET_BITS = 10;     // 2^10 sub-buckets: 3 significant digits
+
+class LatencyHistogram {
+public:
+    static constexpr uint32_t HALF_COUNT = 1u << HISTOGRAM_SUB_BUCKET_BITS;
+    static constexpr uint64_t SUB_BUCKET_MASK = (uint64_t(HALF_COUNT) << 1) - 1;
+    static constexpr uint32_t INDEX_COUNT = (64 - HISTOGRAM_SUB_BUCKET_BITS + 1) * HALF_COUNT;
+
+    /** Index of the bucket holding `value`. */
+    static uint32_t indexOf(uint64_t value) {
+        uint32_t bucket = static_cast<uint32_t>(64 - __builtin_clzll(value | SUB_BUCKET_MASK)) -
+                          (HISTOGRAM_SUB_BUCKET_BITS + 1);
+        uint32_t subBucket = static_cast<uint32_t>(value >> bucket);
+        return ((bucket + 1) << HISTOGRAM_SUB_BUCKET_BITS) + subBucket - HALF_COUNT;
+    }
+
+    /** Smallest value that lands in `index`. */
+    static uint64_t lowestAt(uint32_t index) {
+        uint32_t bucket = index >> HISTOGRAM_SUB_BUCKET_BITS;
+        uint64_t subBucket = (index & (HALF_COUNT - 1)) + HALF_COUNT;
+        if (bucket == 0) return subBucket - HALF_COUNT;
+        return subBucket << (bucket - 1);
+    }
+
+    /** Largest value that lands in `index`. */
+    static uint64_t highestAt(uint32_t index) {
+        uint32_t bucket = index >> HISTOGRAM_SUB_BUCKET_BITS;
+        return lowestAt(index) + (bucket == 0 ? 0 : (uint64_t(1) << (bucket - 1)) - 1);
+    }
+
+    void record(uint64_t value, uint64_t times = 1) {
+        uint32_t index = indexOf(value);
+        if (index >= counts_.size()) counts_.resize(index + 1, 0);
+        counts_[index] += times;
+        if (count_ == 0 || value < min_) min_ = value;
+        max_ = std::max(max_, value);
+        count_ += times;
+        sum_ += value * times;
+    }
+
+    void merge(const LatencyHistogram& other) {
+        if (other.count_ == 0) return;
+        if (other.counts_.size() > counts_.size()) counts_.resize(other.counts_.size(), 0);
+        for (size_t i = 0; i < other.counts_.size(); ++i) counts_[i] += other.counts_[i];
+        min_ = count_ == 0 ? other.min_ : std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+        count_ += other.count_;
+        sum_ += other.sum_;
+    }
+
+    /**
+     * Value at or below which `percentile` percent of the samples fall, as the
+     * highest value equivalent to its bucket; capped at the exact max.
+     */
+    uint64_t valueAtPercentile(double percentile) const {
+        if (count_ == 0) return 0;
+        double wanted = std::min(percentile, 100.0) / 100.0 * static_cast<double>(count_);
+        uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(wanted)));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts_.size(); ++i) {
+            seen += counts_[i];
+            if (seen >= rank) return std::min(highestAt(static_cast<uint32_t>(i)), max_);
+        }
+        return max_;
+    }
+
+    /**
+     * The same distribution with every value multiplied by `factor`, one
+     * bucket at a time (e.g. cycles to nanoseconds). Adds at most the source
+     * bucket width of error.
+     */
+    LatencyHistogram scaled(double factor) const {
+        LatencyHistogram result;
+        for (size_t i = 0; i < counts_.size(); ++i) {
+            if (counts_[i] == 0) continue;
+            uint64_t mid = lowestAt(static_cast<uint32_t>(i)) +
+                           (highestAt(static_cast<uint32_t>(i)) - lowestAt(static_cast<uint32_t>(i))) / 2;
+            uint64_t value = std::max(min_, std::min(max_, mid));
+            result.record(static_cast<uint64_t>(static_cast<double>(value) * factor + 0.5), counts_[i]);
+        }
+        if (count_ > 0) {
+            result.min_ = static_cast<uint64_t>(static_cast<double>(min_) * factor + 0.5);
+            result.max_ = static_cast<uint64_t>(static_cast<double>(max_) * factor + 0.5);
+            result.sum_ = static_cast<uint64_t>(static_cast<double>(sum_) * factor + 0.5);
+        }
+        return result;
+    }
+
+    uint64_t count() const { return count_; }
+    uint64_t min() const { return min_; }
+    uint64_t max() const { return max_; }
+    uint64_t sum() const { return sum_; }
+    const std::vector<uint64_t>& counts() const { return counts_; }
+
+    /** Restores the summary fields an export carries (see mergeHistogramLine). */
+    void setSummary(uint64_t min, uint64_t max, uint64_t sum) {
+        min_ = min;
+        max_ = max;
+        sum_ = sum;
+    }
+
+private:
+    std::vector<uint64_t> counts_;         // Grown to the highest index recorded
+    uint64_t count_ = 0;
+    uint64_t min_ = 0;
+    uint64_t max_ = 0;
+    uint64_t sum_ = 0;
+};
+
+// ============================================================================
+// PER PROCEDURE AND OUTCOME
+// ============================================================================
+
+constexpr uint32_t LATENCY_OUTCOMES = VAULT_ERROR_COUNT + 1;
+constexpr uint32_t LATENCY_OUTCOME_FAILED = VAULT_ERROR_COUNT;  // Failed without a contract reason
+
+inline const char* latencyOutcomeName(uint32_t outcome) {
+    if (outcome == static_cast<uint32_t>(VaultError::NONE)) return "OK";
+    if (outcome == LATENCY_OUTCOME_FAILED) return "FAILED";
+    return vaultErrorName(static_cast<VaultError>(outcome));
+}
+
+inline bool latencyOutcomeFromName(const std::string& name, uint32_t& outcome) {
+    for (uint32_t i = 0; i < LATENCY_OUTCOMES; ++i) {
+        if (name == latencyOutcomeName(i)) {
+            outcome = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+inline bool workloadOpFromName(const std::string& name, WorkloadOpKind& kind) {
+    for (uint32_t k = 0; k < WORKLOAD_OP_KINDS; ++k) {
+        if (name == workloadOpName(static_cast<WorkloadOpKind>(k))) {
+            kind = static_cast<WorkloadOpKind>(k);
+            return true;
+        }
+    }
+    return false;
+}
+
+/** Outcome code of the engine's last call, given what the harness observed. */
+inline uint32_t latencyOutcome(const PronexmaVaultEngine& engine, bool ok) {
+    if (ok) return static_cast<uint32_t>(VaultError::NONE);
+    VaultError error = engine.lastWork().error;
+    return error == VaultError::NONE ? LATENCY_OUTCOME_FAILED : static_cast<uint32_t>(error);
+}
+
+class LatencyHistograms {
+public:
+    void record(WorkloadOpKind kind, uint32_t outcome, uint64_t value) { at(kind, outcome).record(value); }
+
+    LatencyHistogram& at(WorkloadOpKind kind, uint32_t outcome) {
+        return histograms_[static_cast<uint32_t>(kind) * LATENCY_OUTCOMES + outcome];
+    }
+    const LatencyHistogram& at(WorkloadOpKind kind, uint32_t outcome) const {
+        return histograms_[static_cast<uint32_t>(kind) * LATENCY_OUTCOMES + outcome];
+    }
+
+    /** Every outcome of one procedure. */
+    LatencyHistogram procedure(WorkloadOpKind kind) const {
+        LatencyHistogram all;
+        for (uint32_t o = 0; o < LATENCY_OUTCOMES; ++o) all.merge(at(kind, o));
+        return all;
+    }
+
+    /** Every procedure and outcome. */
+    LatencyHistogram total() const {
+        LatencyHistogram all;
+        for (const LatencyHistogram& histogram : histograms_) all.merge(histogram);
+        return all;
+    }
+
+    void merge(const LatencyHistograms& other) {
+        for (size_t i = 0; i < histograms_.size(); ++i) histograms_[i].merge(other.histograms_[i]);
+    }
+
+    LatencyHistograms scaled(double factor) const {
+        LatencyHistograms result;
+        for (size_t i = 0; i < histograms_.size(); ++i) result.histograms_[i] = histograms_[i].scaled(factor);
+        return result;
+    }
+
+private:
+    std::array<LatencyHistogram, WORKLOAD_OP_KINDS * LATENCY_OUTCOMES> histograms_;
+};
+
+// ============================================================================
+// EXPORT
+// ============================================================================
+
+/** Prints "p50Ns":..,"p99Ns":..,"p999Ns":..,"maxNs":.. for a JSON line. */
+inline void printLatencyPercentiles(std::FILE* out, const LatencyHistogram& histogram) {
+    std::fprintf(out, "\"p50Ns\":%llu,\"p99Ns\":%llu,\"p999Ns\":%llu,\"maxNs\":%llu",
+                 static_cast<unsigned long long>(histogram.valueAtPercentile(50.0)),
+                 static_cast<unsigned long long>(histogram.valueAtPercentile(99.0)),
+                 static_cast<unsigned long long>(histogram.valueAtPercentile(99.9)),
+                 static_cast<unsigned long long>(histogram.max()));
+}
+
+/** Writes every non-empty histogram as one export line; false on a write error. */
+inline bool writeLatencyHistograms(std::FILE* out, const LatencyHistograms& histograms, const char* label) {
+    for (uint32_t k = 0; k < WORKLOAD_OP_KINDS; ++k) {
+        for (uint32_t o = 0; o < LATENCY_OUTCOMES; ++o) {
+            const LatencyHistogram& histogram = histograms.at(static_cast<WorkloadOpKind>(k), o);
+            if (histogram.count() == 0) continue;
+            std::fprintf(out,
+                         "{\"histogram\":\"latency\",\"label\":\"%s\",\"procedure\":\"%s\",\"outcome\":\"%s\","
+                         "\"unit\":\"ns\",\"subBucketBits\":%u,\"count\":%llu,\"min\":%llu,\"max\":%llu,"
+                         "\"sum\":%llu,\"buckets\":[",
+                         label, workloadOpName(static_cast<WorkloadOpKind>(k)), latencyOutcomeName(o),
+                         HISTOGRAM_SUB_BUCKET_BITS, static_cast<unsigned long long>(histogram.count()),
+                         static_cast<unsigned long long>(histogram.min()),
+                         static_cast<unsigned long long>(histogram.max()),
+                         static_cast<unsigned long long>(histogram.sum()));
+            const char* separator = "";
+            const std::vector<uint64_t>& counts = histogram.counts();
+            for (size_t i = 0; i < counts.size(); ++i) {
+                if (counts[i] == 0) continue;
+                std::fprintf(out, "%s[%zu,%llu]", separator, i, static_cast<unsigned long long>(counts[i]));
+                separator = ",";
+            }
+            std::fprintf(out, "]}\n");
+        }
+    }
+    return std::ferror(out) == 0;
+}
+
+namespace histogram_detail {
+
+// Text between the quotes of "key":"value"; empty when absent.
+inline std::string stringField(const std::string& line, const char* key) {
+    std::string needle = std::string("\"") + key + "\":\"";
+    size_t at = line.find(needle);
+    if (at == std::string::npos) return std::string();
+    size_t begin = at + needle.size();
+    size_t end = line.find('"', begin);
+    return end == std::string::npos ? std::string() : line.substr(begin, end - begin);
+}
+
+inline bool numberField(const std::string& line, const char* key, uint64_t& value) {
+    std::string needle = std::string("\"") + key + "\":";
+    size_t at = line.find(needle);
+    if (at == std::string::npos) return false;
+    const char* begin = line.c_str() + at + needle.size();
+    char* end = nullptr;
+    value = std::strtoull(begin, &end, 10);
+    return end != begin;
+}
+
+} // namespace histogram_detail
+
+/**
+ * Adds one export line to `histograms`. Returns false for a line that is not
+ * a latency histogram with this layout or whose buckets disagree with its
+ * count; `histograms` is unchanged in that case.
+ */
+inline bool mergeHistogramLine(const std::string& line, LatencyHistograms& histograms) {
+    using namespace histogram_detail;
+    WorkloadOpKind kind;
+    uint32_t outcome;
+    uint64_t bits, count, min, max, sum;
+    if (stringField(line, "histogram") != "latency" || stringField(line, "unit") != "ns") return false;
+    if (!workloadOpFromName(stringField(line, "procedure"), kind)) return false;
+    if (!latencyOutcomeFromName(stringField(line, "outcome"), outcome)) return false;
+    if (!numberField(line, "subBucketBits", bits) || bits != HISTOGRAM_SUB_BUCKET_BITS) return false;
+    if (!numberField(line, "count", count) || !numberField(line, "min", min) || !numberField(line, "max", max) ||
+        !numberField(line, "sum", sum)) {
+        return false;
+    }
+    size_t at = line.find("\"buckets\":[");
+    if (at == std::string::npos) return false;
+
+    LatencyHistogram parsed;
+    const char* cursor = line.c_str() + at + 11;
+    while (*cursor == '[' || *cursor == ',') {
+        if (*cursor == ',') ++cursor;
+        if (*cursor != '[') return false;
+        char* end = nullptr;
+        uint64_t index = std::strtoull(cursor + 1, &end, 10);
+        if (*end != ',' || index >= LatencyHistogram::INDEX_COUNT) return false;
+        uint64_t times = std::strtoull(end + 1, &end, 10);
+        if (*end != ']') return false;
+        parsed.record(LatencyHistogram::lowestAt(static_cast<uint32_t>(index)), times);
+        cursor = end + 1;
+    }
+    if (*cursor != ']' || parsed.count() != count) return false;
+    parsed.setSummary(min, max, sum);
+    histograms.at(kind, outcome).merge(parsed);
+    return true;
+}
@@ -0,0 +1,224 @@
+// contracts/host/VaultHost.h
+// Pronexma Protocol - Native host contexts for the vault
+//
+// NativeHost stands in for the Qubic runtime: a settable tick, the sender and
+// value of the current invocation, and an in-memory ledger of QU balances that
+// the contract account pays transfers out of. HostRecorder wraps any context
+// and logs every host call, so tests can assert on transfers and tools can
+// capture a run. Bind either to an engine with HostContextBinding for the
+// scope of a test or benchmark.
+
+#pragma once
+
+#include "VaultIdentity.h"
+
+#include <cstring>
+#include <unordered_map>
+
+// ============================================================================
+// BINDING
+// ============================================================================
+
+/**
+ * Installs a host context on an engine (the default engine unless given) until
+ * destroyed, then restores the previous one.
+ */
+class HostContextBinding {
+public:
+    explicit HostContextBinding(const HostContext& context) : HostContextBinding(defaultEngine, context) {}
+
+    template <typename Config>
+    HostContextBinding(BasicVaultEngine<Config>& engine, const HostContext& context)
+        : bound_(engine.hostContext), previous_(engine.hostContext) {
+        bound_ = context;
+    }
+
+    ~HostContextBinding() { bound_ = previous_; }
+
+    HostContextBinding(const HostContextBinding&) = delete;
+    HostContextBinding& operator=(const HostContextBinding&) = delete;
+
+private:
+    HostContext& bound_;                   // The engine's hostContext
+    HostContext previous_;
+};
+
+// ============================================================================
+// NATIVE LEDGER
+// ============================================================================
+
+/**
+ * The address an identity or a host label names; empty if it names none. For
+ * parties the host names itself (fixtures, benches, tool defaults).
+ */
+inline QubicAddress hostAddress(const char* text) {
+    size_t length = std::strlen(text);
+    QubicAddress address = {};
+    if (!parseAddressText(text, length, address)) labelToAddress(text, length, address);
+    return address;
+}
+
+struct HostAddressHash {
+    size_t operator()(const QubicAddress& address) const {
+        uint64_t hash = 0xcbf29ce484222325ull;  // FNV-1a over the key's words
+        for (size_t i = 0; i < address.size(); i += 8) {
+            uint64_t word;
+            std::memcpy(&word, address.data() + i, 8);
+            hash = (hash ^ word) * 0x100000001b3ull;
+        }
+        return static_cast<size_t>(hash ^ (hash >> 32));
+    }
+};
+
+class NativeHost {
+public:
+    explicit NativeHost(const QubicAddress& contractAccount = hostAddress("PRONEXMAVAULTCONTRACT"))
+        : contract_(contractAccount) {}
+
+    HostContext context() {
+        HostContext context;
+        context.self = this;
+        context.currentTick = [](void* self) { return static_cast<NativeHost*>(self)->tick_; };
+        context.messageSender = [](void* self) { return static_cast<NativeHost*>(self)->sender_; };
+        context.messageValue = [](void* self) { return static_cast<NativeHost*>(self)->value_; };
+        context.transfer = [](void* self, const QubicAddress& recipient, uint64_t amount) {
+            static_cast<NativeHost*>(self)->transfer(recipient, amount);
+        };
+        return context;
+    }
+
+    void setTick(uint64_t tick) { tick_ = tick; }
+    void advanceTicks(uint64_t ticks) { tick_ += ticks; }
+    uint64_t tick() const { return tick_; }
+
+    /** Sets the invocator directly, for calls that carry no value. */
+    void setSender(const QubicAddress& sender) {
+        sender_ = sender;
+        value_ = 0;
+    }
+
+    void credit(const QubicAddress& account, uint64_t amount) { balances_[account] += amount; }
+
+    uint64_t balanceOf(const QubicAddress& account) const {
+        auto found = balances_.find(account);
+        return found == balances_.end() ? 0 : found->second;
+    }
+
+    const QubicAddress& contractAccount() const { return contract_; }
+
+    /** Sum of all balances; transfers never change it. */
+    uint64_t totalSupply() const {
+        uint64_t total = 0;
+        for (const auto& entry : balances_) total += entry.second;
+        return total;
+    }
+
+    uint64_t failedTransfers() const { return failedTransfers_; }
+
+    /**
+     * Starts an invocation: `value` moves from `sender` to the contract account,
+     * as the runtime does before the procedure runs. Returns false (and leaves
+     * everything untouched) if the sender cannot pay.
+     */
+    bool beginInvocation(const QubicAddress& sender, uint64_t value) {
+        if (value > 0) {
+            auto found = balances_.find(sender);
+            if (found == balances_.end() || found->second < value) return false;
+            found->second -= value;
+            balances_[contract_] += value;
+        }
+        sender_ = sender;
+        value_ = value;
+        return true;
+    }
+
+    /** Runs `procedure` as `sender` with `value` attached; a rejected payment yields a default result. */
+    template <typename Procedure>
+    auto invoke(const QubicAddress& sender, uint64_t value, Procedure&& procedure) -> decltype(procedure()) {
+        if (!beginInvocation(sender, value)) {
+            return decltype(procedure())();
+        }
+        return procedure();
+    }
+
+private:
+    void transfer(const QubicAddress& recipient, uint64_t amount) {
+        uint64_t& available = balances_[contract_];
+        if (available < amount) {
+            ++failedTransfers_;
+            return;
+        }
+        available -= amount;
+        balances_[recipient] += amount;
+    }
+
+    QubicAddress contract_;
+    uint64_t tick_ = 0;
+    QubicAddress sender_ = {};
+    uint64_t value_ = 0;
+    uint64_t failedTransfers_ = 0;
+    std::unordered_map<QubicAddress, uint64_t, HostAddressHash> balances_;
+};
+
+// ============================================================================
+// RECORDER
+// ============================================================================
+
+enum class HostCallKind : uint8_t { TICK, SENDER, VALUE, TRANSFER };
+
+struct HostCall {
+    HostCallKind kind;
+    QubicAddress address;                  // SENDER result or TRANSFER recipient
+    uint64_t amount;                       // TICK/VALUE result or TRANSFER amount
+};
+
+/** Forwards to `inner` and logs every call. */
+class HostRecorder {
+public:
+    explicit HostRecorder(const HostContext& inner) : inner_(inner) {}
+
+    HostContext context() {
+        HostContext context;
+        context.self = this;
+        context.currentTick = [](void* self) {
+            HostRecorder* recorder = static_cast<HostRecorder*>(self);
+            uint64_t tick = recorder->inner_.currentTick(recorder->inner_.self);
+            recorder->calls_.push_back({HostCallKind::TICK, {}, tick});
+            return tick;
+        };
+        context.messageSender = [](void* self) {
+            HostRecorder* recorder = static_cast<HostRecorder*>(self);
+            QubicAddress sender = recorder->inner_.messageSender(recorder->inner_.self);
+            recorder->calls_.push_back({HostCallKind::SENDER, sender, 0});
+            return sender;
+        };
+        context.messageValue = [](void* self) {
+            HostRecorder* recorder = static_cast<HostRecorder*>(self);
+            uint64_t value = recorder->inner_.messageValue(recorder->inner_.self);
+            recorder->calls_.push_back({HostCallKind::VALUE, {}, value});
+            return value;
+        };
+        context.transfer = [](void* self, const QubicAddress& recipient, uint64_t amount) {
+            HostRecorder* recorder = static_cast<HostRecorder*>(self);
+            recorder->calls_.push_back({HostCallKind::TRANSFER, recipient, amount});
+            recorder->inner_.transfer(recorder->inner_.self, recipient, amount);
+        };
+        return context;
+    }
+
+    const std::vector<HostCall>& calls() const { return calls_; }
+
+    std::vector<HostCall> transfers() const {
+        std::vector<HostCall> out;
+        for (const HostCall& call : calls_) {
+            if (call.kind == HostCallKind::TRANSFER) out.push_back(call);
+        }
+        return out;
+    }
+
+    void clear() { calls_.clear(); }
+
+private:
+    HostContext inner_;
+    std::vector<HostCall> calls_;
+};
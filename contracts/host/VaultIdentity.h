@@ -0,0 +1,177 @@
+// contracts/host/VaultIdentity.h
+// Pronexma Protocol - Qubic identity text <-> 32-byte address conversion
+//
+// The vault stores and compares addresses as 32-byte public keys. Text only
+// appears at the host boundary (NDJSON import, exports, diffs, tools), in the
+// Qubic identity form: each little-endian 64-bit quarter of the key as 14
+// base-26 letters 'A'-'Z', least significant first, then four checksum letters
+// from the low 18 bits of KangarooTwelve(key)'s first three bytes.
+//
+// Host fixtures also name parties with short labels ("PAYER"): a label of up
+// to 32 bytes stands for the key holding its bytes, zero padded. Labels are
+// only taken where a host names its own parties (hostAddress in VaultHost.h),
+// never from imported text.
+
+#pragma once
+
+#include "PronexmaVault.cpp"
+
+#include <cstring>
+#include <string>
+
+constexpr size_t QUBIC_IDENTITY_LENGTH = 60;           // 4 * 14 key letters + 4 checksum letters
+constexpr size_t IDENTITY_LETTERS_PER_WORD = 14;       // 26^14 > 2^64
+
+namespace identity_detail {
+
+inline uint64_t rotateLeft(uint64_t value, unsigned bits) {
+    return (value << bits) | (value >> ((64 - bits) & 63));
+}
+
+// Keccak-p[1600, 12]: the last twelve rounds of Keccak-f[1600], lane x + 5y.
+// Rho and pi are fused and written out lane by lane: b[x + 5y] is a's lane
+// that pi moves there, rotated by its rho offset.
+inline void keccakP1600Twelve(uint64_t a[25]) {
+    static const uint64_t ROUND_CONSTANTS[12] = {
+        0x000000008000808Bull, 0x800000000000008Bull, 0x8000000000008089ull, 0x8000000000008003ull,
+        0x8000000000008002ull, 0x8000000000000080ull, 0x000000000000800Aull, 0x800000008000000Aull,
+        0x8000000080008081ull, 0x8000000000008080ull, 0x0000000080000001ull, 0x8000000080008008ull};
+    uint64_t b[25];
+    for (uint64_t roundConstant : ROUND_CONSTANTS) {
+        uint64_t c0 = a[0] ^ a[5] ^ a[10] ^ a[15] ^ a[20];
+        uint64_t c1 = a[1] ^ a[6] ^ a[11] ^ a[16] ^ a[21];
+        uint64_t c2 = a[2] ^ a[7] ^ a[12] ^ a[17] ^ a[22];
+        uint64_t c3 = a[3] ^ a[8] ^ a[13] ^ a[18] ^ a[23];
+        uint64_t c4 = a[4] ^ a[9] ^ a[14] ^ a[19] ^ a[24];
+        const uint64_t d[5] = {c4 ^ rotateLeft(c1, 1), c0 ^ rotateLeft(c2, 1), c1 ^ rotateLeft(c3, 1),
+                               c2 ^ rotateLeft(c4, 1), c3 ^ rotateLeft(c0, 1)};
+        for (unsigned y = 0; y < 25; y += 5) {
+            a[y + 0] ^= d[0];
+            a[y + 1] ^= d[1];
+            a[y + 2] ^= d[2];
+            a[y + 3] ^= d[3];
+            a[y + 4] ^= d[4];
+        }
+        b[0] = a[0]; b[1] = rotateLeft(a[6], 44); b[2] = rotateLeft(a[12], 43);
+        b[3] = rotateLeft(a[18], 21); b[4] = rotateLeft(a[24], 14);
+        b[5] = rotateLeft(a[3], 28); b[6] = rotateLeft(a[9], 20); b[7] = rotateLeft(a[10], 3);
+        b[8] = rotateLeft(a[16], 45); b[9] = rotateLeft(a[22], 61);
+        b[10] = rotateLeft(a[1], 1); b[11] = rotateLeft(a[7], 6); b[12] = rotateLeft(a[13], 25);
+        b[13] = rotateLeft(a[19], 8); b[14] = rotateLeft(a[20], 18);
+        b[15] = rotateLeft(a[4], 27); b[16] = rotateLeft(a[5], 36); b[17] = rotateLeft(a[11], 10);
+        b[18] = rotateLeft(a[17], 15); b[19] = rotateLeft(a[23], 56);
+        b[20] = rotateLeft(a[2], 62); b[21] = rotateLeft(a[8], 55); b[22] = rotateLeft(a[14], 39);
+        b[23] = rotateLeft(a[15], 41); b[24] = rotateLeft(a[21], 2);
+        for (unsigned y = 0; y < 25; y += 5) {
+            const uint64_t* row = b + y;
+            a[y + 0] = row[0] ^ (~row[1] & row[2]);
+            a[y + 1] = row[1] ^ (~row[2] & row[3]);
+            a[y + 2] = row[2] ^ (~row[3] & row[4]);
+            a[y + 3] = row[3] ^ (~row[4] & row[0]);
+            a[y + 4] = row[4] ^ (~row[0] & row[1]);
+        }
+        a[0] ^= roundConstant;
+    }
+}
+
+} // namespace identity_detail
+
+constexpr size_t K12_RATE_BYTES = 168;
+
+/**
+ * KangarooTwelve with an empty customization string, for messages short
+ * enough to fit one sponge block (at most K12_RATE_BYTES - 2 bytes) and
+ * outputs of at most K12_RATE_BYTES bytes. Identity checksums hash 32 bytes,
+ * so the tree mode and multi-block absorption are never needed here.
+ */
+inline void kangarooTwelveShort(const void* message, size_t length, uint8_t* out, size_t outLength) {
+    // Single-chunk K12 is TurboSHAKE128(message || length_encode(0), 0x07).
+    uint8_t block[K12_RATE_BYTES] = {};
+    std::memcpy(block, message, length);
+    block[length] = 0x00;
+    block[length + 1] ^= 0x07;
+    block[K12_RATE_BYTES - 1] ^= 0x80;
+    uint64_t lanes[25] = {};
+    std::memcpy(lanes, block, sizeof(block));
+    identity_detail::keccakP1600Twelve(lanes);
+    std::memcpy(out, lanes, outLength);
+}
+
+/** The 18-bit identity checksum of `address`. */
+inline uint32_t identityChecksum(const QubicAddress& address) {
+    uint8_t digest[3];
+    kangarooTwelveShort(address.data(), address.size(), digest, sizeof(digest));
+    return (uint32_t(digest[0]) | uint32_t(digest[1]) << 8 | uint32_t(digest[2]) << 16) & 0x3FFFF;
+}
+
+/** Writes the 60-letter identity of `address` and a terminating NUL. */
+inline void addressToIdentity(const QubicAddress& address, char identity[QUBIC_IDENTITY_LENGTH + 1]) {
+    for (size_t word = 0; word < 4; ++word) {
+        uint64_t value;
+        std::memcpy(&value, address.data() + word * 8, 8);
+        for (size_t j = 0; j < IDENTITY_LETTERS_PER_WORD; ++j) {
+            identity[word * IDENTITY_LETTERS_PER_WORD + j] = static_cast<char>('A' + value % 26);
+            value /= 26;
+        }
+    }
+    uint32_t checksum = identityChecksum(address);
+    for (size_t j = 0; j < 4; ++j) {
+        identity[4 * IDENTITY_LETTERS_PER_WORD + j] = static_cast<char>('A' + checksum % 26);
+        checksum /= 26;
+    }
+    identity[QUBIC_IDENTITY_LENGTH] = '\0';
+}
+
+inline std::string addressIdentity(const QubicAddress& address) {
+    char identity[QUBIC_IDENTITY_LENGTH + 1];
+    addressToIdentity(address, identity);
+    return std::string(identity, QUBIC_IDENTITY_LENGTH);
+}
+
+/**
+ * Decodes a 60-letter identity. Fails on other letters, on a quarter whose
+ * letters overflow 64 bits (so every key has exactly one identity) and on a
+ * checksum mismatch.
+ */
+inline bool identityToAddress(const char* text, size_t length, QubicAddress& out) {
+    if (length != QUBIC_IDENTITY_LENGTH) return false;
+    QubicAddress address;
+    for (size_t word = 0; word < 4; ++word) {
+        uint64_t value = 0;
+        for (size_t j = IDENTITY_LETTERS_PER_WORD; j-- > 0;) {
+            char c = text[word * IDENTITY_LETTERS_PER_WORD + j];
+            if (c < 'A' || c > 'Z') return false;
+            uint64_t digit = static_cast<uint64_t>(c - 'A');
+            if (value > (UINT64_MAX - digit) / 26) return false;
+            value = value * 26 + digit;
+        }
+        std::memcpy(address.data() + word * 8, &value, 8);
+    }
+    uint32_t checksum = identityChecksum(address);
+    for (size_t j = 0; j < 4; ++j) {
+        if (text[4 * IDENTITY_LETTERS_PER_WORD + j] != static_cast<char>('A' + checksum % 26)) return false;
+        checksum /= 26;
+    }
+    out = address;
+    return true;
+}
+
+/**
+ * The key a host label stands for: its bytes, zero padded. Host-only; input
+ * from outside the host goes through parseAddressText.
+ */
+inline bool labelToAddress(const char* text, size_t length, QubicAddress& out) {
+    if (length == 0 || length > sizeof(QubicAddress)) return false;
+    out = QubicAddress{};
+    std::memcpy(out.data(), text, length);
+    return true;
+}
+
+/**
+ * Parses address text at the host boundary (imports, migrations): only a
+ * checksummed 60-letter identity names a key. A mistyped or truncated
+ * identity fails rather than turning into some other key.
+ */
+inline bool parseAddressText(const char* text, size_t length, QubicAddress& out) {
+    return identityToAddress(text, length, out);
+}
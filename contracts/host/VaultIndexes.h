@@ -0,0 +1,228 @@
+// contracts/host/VaultIndexes.h
+// Pronexma Protocol - Replica-side lookup indexes over PronexmaVaultState
+//
+// The contract resolves agreements with a linear scan. Replicas serving reads
+// keep these indexes next to the state instead:
+//   byId           agreement ID -> slot (open addressing)
+//   byPayer        payer address -> slots, ascending
+//   byBeneficiary  beneficiary address -> slots, ascending
+//   byTimeout      (timeoutTick, slot) of refundable agreements, ascending
+//
+// Indexes are built from slot ranges as VaultIndexPartial and merged in slot
+// order, so the result is identical whatever the number of builders.
+
+#pragma once
+
+#include "VaultSnapshot.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+
+struct AddressKeyHash {
+    size_t operator()(const QubicAddress& address) const {
+        return static_cast<size_t>(snapshotHashBytes(0, address.data(), address.size()));
+    }
+};
+
+using AddressSlotIndex = std::unordered_map<QubicAddress, std::vector<uint32_t>, AddressKeyHash>;
+
+struct TimeoutEntry {
+    uint64_t timeoutTick;
+    uint32_t slot;
+
+    bool operator<(const TimeoutEntry& other) const {
+        return timeoutTick != other.timeoutTick ? timeoutTick < other.timeoutTick : slot < other.slot;
+    }
+    bool operator==(const TimeoutEntry& other) const {
+        return timeoutTick == other.timeoutTick && slot == other.slot;
+    }
+};
+
+/**
+ * ID -> slot hash table with linear probing. ID 0 is the contract's error
+ * value and never a valid key, so it marks empty buckets.
+ */
+class AgreementIdIndex {
+public:
+    void build(const std::vector<std::pair<uint64_t, uint32_t>>& entries) {
+        size_t capacity = 16;
+        while (capacity < entries.size() * 2) capacity <<= 1;
+        keys_.assign(capacity, 0);
+        slots_.assign(capacity, AGREEMENT_NOT_FOUND);
+        mask_ = capacity - 1;
+        size_ = 0;
+        totalProbes_ = 0;
+        maxProbes_ = 0;
+        for (const auto& entry : entries) {
+            insert(entry.first, entry.second);
+        }
+    }
+
+    /** Incremental insert; doubles the table to keep the load factor under 1/2. */
+    void add(uint64_t id, uint32_t slot) {
+        if (id == 0) return;
+        if ((size_ + 1) * 2 > keys_.size()) {
+            std::vector<uint64_t> keys;
+            std::vector<uint32_t> slots;
+            keys.swap(keys_);
+            slots.swap(slots_);
+            size_t capacity = std::max<size_t>(16, keys.size() * 2);
+            keys_.assign(capacity, 0);
+            slots_.assign(capacity, AGREEMENT_NOT_FOUND);
+            mask_ = capacity - 1;
+            size_ = 0;
+            totalProbes_ = 0;
+            maxProbes_ = 0;
+            for (size_t i = 0; i < keys.size(); ++i) {
+                if (keys[i] != 0) insert(keys[i], slots[i]);
+            }
+        }
+        insert(id, slot);
+    }
+
+    uint32_t find(uint64_t id) const {
+        if (keys_.empty() || id == 0) return AGREEMENT_NOT_FOUND;
+        for (size_t bucket = bucketOf(id);; bucket = (bucket + 1) & mask_) {
+            if (keys_[bucket] == id) return slots_[bucket];
+            if (keys_[bucket] == 0) return AGREEMENT_NOT_FOUND;
+        }
+    }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return keys_.size(); }
+    double loadFactor() const { return keys_.empty() ? 0.0 : static_cast<double>(size_) / keys_.size(); }
+
+    /** Buckets a successful find() inspects, on average and at worst. */
+    double meanProbeLength() const { return size_ == 0 ? 0.0 : static_cast<double>(totalProbes_) / size_; }
+    size_t maxProbeLength() const { return maxProbes_; }
+
+    bool operator==(const AgreementIdIndex& other) const {
+        return keys_ == other.keys_ && slots_ == other.slots_;
+    }
+
+private:
+    size_t bucketOf(uint64_t id) const { return static_cast<size_t>(snapshotMix(id)) & mask_; }
+
+    void insert(uint64_t id, uint32_t slot) {
+        size_t bucket = bucketOf(id);
+        size_t probes = 1;
+        while (keys_[bucket] != 0 && keys_[bucket] != id) {
+            bucket = (bucket + 1) & mask_;
+            ++probes;
+        }
+        // Duplicate IDs resolve to the lowest slot, as findAgreementSlot does.
+        if (keys_[bucket] == id) return;
+        keys_[bucket] = id;
+        slots_[bucket] = slot;
+        ++size_;
+        totalProbes_ += probes;
+        maxProbes_ = std::max(maxProbes_, probes);
+    }
+
+    std::vector<uint64_t> keys_;
+    std::vector<uint32_t> slots_;
+    size_t mask_ = 0;
+    size_t size_ = 0;
+    uint64_t totalProbes_ = 0;             // Kept by insert() so the probe stats are O(1)
+    size_t maxProbes_ = 0;
+};
+
+struct VaultIndexes {
+    AgreementIdIndex byId;
+    AddressSlotIndex byPayer;
+    AddressSlotIndex byBeneficiary;
+    std::vector<TimeoutEntry> byTimeout;
+
+    bool operator==(const VaultIndexes& other) const {
+        return byId == other.byId && byPayer == other.byPayer &&
+               byBeneficiary == other.byBeneficiary && byTimeout == other.byTimeout;
+    }
+};
+
+inline bool isRefundCandidate(const Agreement& agreement) {
+    return agreement.lockedAmount > 0 &&
+           (agreement.state == AgreementState::FUNDED || agreement.state == AgreementState::ACTIVE);
+}
+
+/** Index entries for one contiguous slot range. */
+struct VaultIndexPartial {
+    std::vector<std::pair<uint64_t, uint32_t>> ids;
+    AddressSlotIndex byPayer;
+    AddressSlotIndex byBeneficiary;
+    std::vector<TimeoutEntry> byTimeout;
+
+    void reserve(size_t agreements) {
+        ids.reserve(agreements);
+        byPayer.reserve(agreements);
+        byBeneficiary.reserve(agreements);
+        byTimeout.reserve(agreements);
+    }
+
+    void add(const Agreement& agreement, uint32_t slot) {
+        ids.emplace_back(agreement.id, slot);
+        byPayer[agreement.payer].push_back(slot);
+        byBeneficiary[agreement.beneficiary].push_back(slot);
+        if (isRefundCandidate(agreement)) {
+            byTimeout.push_back({agreement.timeoutTick, slot});
+        }
+    }
+
+    void finish() { std::sort(byTimeout.begin(), byTimeout.end()); }
+};
+
+/**
+ * Merges partials that cover ascending, disjoint slot ranges (partials[0]
+ * holds the lowest slots). Consumes the partials.
+ */
+inline void mergeVaultIndexPartials(std::vector<VaultIndexPartial>& partials, VaultIndexes& out) {
+    std::vector<std::pair<uint64_t, uint32_t>> ids;
+    size_t idCount = 0;
+    for (const VaultIndexPartial& partial : partials) idCount += partial.ids.size();
+    ids.reserve(idCount);
+
+    out.byPayer.clear();
+    out.byBeneficiary.clear();
+    out.byTimeout.clear();
+    for (VaultIndexPartial& partial : partials) {
+        ids.insert(ids.end(), partial.ids.begin(), partial.ids.end());
+        for (auto& entry : partial.byPayer) {
+            std::vector<uint32_t>& slots = out.byPayer[entry.first];
+            slots.insert(slots.end(), entry.second.begin(), entry.second.end());
+        }
+        for (auto& entry : partial.byBeneficiary) {
+            std::vector<uint32_t>& slots = out.byBeneficiary[entry.first];
+            slots.insert(slots.end(), entry.second.begin(), entry.second.end());
+        }
+        size_t middle = out.byTimeout.size();
+        out.byTimeout.insert(out.byTimeout.end(), partial.byTimeout.begin(), partial.byTimeout.end());
+        std::inplace_merge(out.byTimeout.begin(), out.byTimeout.begin() + middle, out.byTimeout.end());
+        partial = VaultIndexPartial();
+    }
+    out.byId.build(ids);
+}
+
+/** Single-threaded build over the live slots. */
+inline void buildVaultIndexes(const PronexmaVaultState& vault, VaultIndexes& out) {
+    std::vector<VaultIndexPartial> partials(1);
+    for (uint32_t i = 0; i < vault.activeAgreementCount; ++i) {
+        partials[0].add(vault.agreements[i], i);
+    }
+    partials[0].finish();
+    mergeVaultIndexPartials(partials, out);
+}
+
+/**
+ * Per-call maintenance for a slot appended after the indexes were built, as a
+ * replica applying procedures one at a time does. Slots must be appended in
+ * ascending order.
+ */
+inline void addToVaultIndexes(VaultIndexes& indexes, const Agreement& agreement, uint32_t slot) {
+    indexes.byId.add(agreement.id, slot);
+    indexes.byPayer[agreement.payer].push_back(slot);
+    indexes.byBeneficiary[agreement.beneficiary].push_back(slot);
+    if (isRefundCandidate(agreement)) {
+        TimeoutEntry entry{agreement.timeoutTick, slot};
+        indexes.byTimeout.insert(std::upper_bound(indexes.byTimeout.begin(), indexes.byTimeout.end(), entry), entry);
+    }
+}
@@ -0,0 +1,344 @@
+// contracts/host/VaultKernels.h
+// Pronexma Protocol - SIMD kernels for address and milestone-state scans
+//
+// Host scans over packed columns: 32-byte address equality (one pair, or one
+// key against a column of keys) and milestone state/amount scans (all in a
+// state, any in a state, sum of the amounts in a state). Each kernel has a
+// portable version and, on x86, SSE2 and AVX2 versions compiled with target
+// attributes; vaultKernels() picks the widest one the CPU supports the first
+// time it is called. Every level returns the same results. The vector paths
+// pay off on long columns (a vault-wide pending sum, a payer column); an
+// agreement's own slice of at most MAX_MILESTONES states mostly runs the
+// scalar tail.
+//
+// The contract keeps its own portable addressEquals and milestone loops: it
+// runs under the Qubic toolchain, where CPU probing is not available, and its
+// per-agreement loops cover at most MAX_MILESTONES strided records.
+
+#pragma once
+
+#include "PronexmaVault.cpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PRONEXMA_VAULT_X86_KERNELS 1
+#include <immintrin.h>
+#else
+#define PRONEXMA_VAULT_X86_KERNELS 0
+#endif
+
+enum class KernelLevel : uint8_t {
+    PORTABLE = 0,
+    SSE2 = 1,
+    AVX2 = 2
+};
+
+constexpr uint32_t KERNEL_LEVEL_COUNT = 3;
+
+inline const char* kernelLevelName(KernelLevel level) {
+    switch (level) {
+        case KernelLevel::PORTABLE: return "portable";
+        case KernelLevel::SSE2: return "sse2";
+        case KernelLevel::AVX2: return "avx2";
+    }
+    return "unknown";
+}
+
+/**
+ * One implementation of every kernel. States are MilestoneState (or
+ * AgreementState) bytes; `amounts[i]` belongs to `states[i]`.
+ */
+struct VaultKernels {
+    KernelLevel level;
+    bool (*addressEquals)(const QubicAddress& a, const QubicAddress& b);
+    uint32_t (*countAddressMatches)(const QubicAddress* keys, uint32_t count, const QubicAddress& key);
+    bool (*allInState)(const uint8_t* states, uint32_t count, uint8_t state);
+    bool (*anyInState)(const uint8_t* states, uint32_t count, uint8_t state);
+    uint64_t (*sumInState)(const uint8_t* states, const uint64_t* amounts, uint32_t count, uint8_t state);
+};
+
+namespace kernels_detail {
+
+// ============================================================================
+// PORTABLE
+// ============================================================================
+
+inline bool portableAddressEquals(const QubicAddress& a, const QubicAddress& b) {
+    uint64_t x[4], y[4];
+    std::memcpy(x, a.data(), sizeof(x));
+    std::memcpy(y, b.data(), sizeof(y));
+    return ((x[0] ^ y[0]) | (x[1] ^ y[1]) | (x[2] ^ y[2]) | (x[3] ^ y[3])) == 0;
+}
+
+inline uint32_t portableCountAddressMatches(const QubicAddress* keys, uint32_t count, const QubicAddress& key) {
+    uint32_t matches = 0;
+    for (uint32_t i = 0; i < count; ++i) matches += portableAddressEquals(keys[i], key);
+    return matches;
+}
+
+inline bool portableAllInState(const uint8_t* states, uint32_t count, uint8_t state) {
+    for (uint32_t i = 0; i < count; ++i) {
+        if (states[i] != state) return false;
+    }
+    return true;
+}
+
+inline bool portableAnyInState(const uint8_t* states, uint32_t count, uint8_t state) {
+    for (uint32_t i = 0; i < count; ++i) {
+        if (states[i] == state) return true;
+    }
+    return false;
+}
+
+inline uint64_t portableSumInState(const uint8_t* states, const uint64_t* amounts, uint32_t count, uint8_t state) {
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < count; ++i) sum += amounts[i] & (uint64_t(0) - static_cast<uint64_t>(states[i] == state));
+    return sum;
+}
+
+#if PRONEXMA_VAULT_X86_KERNELS
+
+// ============================================================================
+// SSE2
+// ============================================================================
+
+__attribute__((target("sse2"))) inline bool sse2AddressEquals(const QubicAddress& a, const QubicAddress& b) {
+    const __m128i* x = reinterpret_cast<const __m128i*>(a.data());
+    const __m128i* y = reinterpret_cast<const __m128i*>(b.data());
+    __m128i low = _mm_cmpeq_epi8(_mm_loadu_si128(x), _mm_loadu_si128(y));
+    __m128i high = _mm_cmpeq_epi8(_mm_loadu_si128(x + 1), _mm_loadu_si128(y + 1));
+    return _mm_movemask_epi8(_mm_and_si128(low, high)) == 0xFFFF;
+}
+
+__attribute__((target("sse2"))) inline uint32_t sse2CountAddressMatches(const QubicAddress* keys, uint32_t count,
+                                                                        const QubicAddress& key) {
+    const __m128i* k = reinterpret_cast<const __m128i*>(key.data());
+    const __m128i low = _mm_loadu_si128(k), high = _mm_loadu_si128(k + 1);
+    uint32_t matches = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        const __m128i* x = reinterpret_cast<const __m128i*>(keys[i].data());
+        __m128i equal = _mm_and_si128(_mm_cmpeq_epi8(_mm_loadu_si128(x), low),
+                                      _mm_cmpeq_epi8(_mm_loadu_si128(x + 1), high));
+        matches += _mm_movemask_epi8(equal) == 0xFFFF;
+    }
+    return matches;
+}
+
+__attribute__((target("sse2"))) inline bool sse2AllInState(const uint8_t* states, uint32_t count, uint8_t state) {
+    const __m128i wanted = _mm_set1_epi8(static_cast<char>(state));
+    uint32_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i equal = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(states + i)), wanted);
+        if (_mm_movemask_epi8(equal) != 0xFFFF) return false;
+    }
+    return portableAllInState(states + i, count - i, state);
+}
+
+__attribute__((target("sse2"))) inline bool sse2AnyInState(const uint8_t* states, uint32_t count, uint8_t state) {
+    const __m128i wanted = _mm_set1_epi8(static_cast<char>(state));
+    uint32_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i equal = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(states + i)), wanted);
+        if (_mm_movemask_epi8(equal) != 0) return true;
+    }
+    return portableAnyInState(states + i, count - i, state);
+}
+
+// Sixteen states at a time: the byte mask is widened to one 64-bit lane mask
+// per amount by unpacking it with itself three times.
+__attribute__((target("sse2"))) inline uint64_t sse2SumInState(const uint8_t* states, const uint64_t* amounts,
+                                                               uint32_t count, uint8_t state) {
+    const __m128i wanted = _mm_set1_epi8(static_cast<char>(state));
+    __m128i sum = _mm_setzero_si128();
+    uint32_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i mask8 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(states + i)), wanted);
+        __m128i mask16[2] = {_mm_unpacklo_epi8(mask8, mask8), _mm_unpackhi_epi8(mask8, mask8)};
+        const __m128i* lanes = reinterpret_cast<const __m128i*>(amounts + i);
+        for (uint32_t h = 0; h < 2; ++h) {
+            __m128i mask32[2] = {_mm_unpacklo_epi16(mask16[h], mask16[h]), _mm_unpackhi_epi16(mask16[h], mask16[h])};
+            for (uint32_t q = 0; q < 2; ++q) {
+                __m128i low = _mm_unpacklo_epi32(mask32[q], mask32[q]);
+                __m128i high = _mm_unpackhi_epi32(mask32[q], mask32[q]);
+                uint32_t pair = h * 4 + q * 2;
+                sum = _mm_add_epi64(sum, _mm_and_si128(_mm_loadu_si128(lanes + pair), low));
+                sum = _mm_add_epi64(sum, _mm_and_si128(_mm_loadu_si128(lanes + pair + 1), high));
+            }
+        }
+    }
+    uint64_t halves[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(halves), sum);
+    return halves[0] + halves[1] + portableSumInState(states + i, amounts + i, count - i, state);
+}
+
+// ============================================================================
+// AVX2
+// ============================================================================
+
+__attribute__((target("avx2"))) inline bool avx2AddressEquals(const QubicAddress& a, const QubicAddress& b) {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a.data()));
+    __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b.data()));
+    return _mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)) == -1;
+}
+
+__attribute__((target("avx2"))) inline uint32_t avx2CountAddressMatches(const QubicAddress* keys, uint32_t count,
+                                                                        const QubicAddress& key) {
+    const __m256i wanted = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(key.data()));
+    uint32_t matches = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys[i].data()));
+        matches += _mm256_movemask_epi8(_mm256_cmpeq_epi8(x, wanted)) == -1;
+    }
+    return matches;
+}
+
+__attribute__((target("avx2"))) inline bool avx2AllInState(const uint8_t* states, uint32_t count, uint8_t state) {
+    const __m256i wanted = _mm256_set1_epi8(static_cast<char>(state));
+    uint32_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i equal = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(states + i)), wanted);
+        if (_mm256_movemask_epi8(equal) != -1) return false;
+    }
+    return portableAllInState(states + i, count - i, state);
+}
+
+__attribute__((target("avx2"))) inline bool avx2AnyInState(const uint8_t* states, uint32_t count, uint8_t state) {
+    const __m256i wanted = _mm256_set1_epi8(static_cast<char>(state));
+    uint32_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i equal = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(states + i)), wanted);
+        if (_mm256_movemask_epi8(equal) != 0) return true;
+    }
+    return portableAnyInState(states + i, count - i, state);
+}
+
+// Sixteen states at a time: each group of four mask bytes sign-extends to
+// four 64-bit lane masks, one per amount.
+__attribute__((target("avx2"))) inline uint64_t avx2SumInState(const uint8_t* states, const uint64_t* amounts,
+                                                               uint32_t count, uint8_t state) {
+    const __m128i wanted = _mm_set1_epi8(static_cast<char>(state));
+    __m256i sums[4] = {_mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256()};
+    uint32_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i mask8 = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(states + i)), wanted);
+        const __m256i* lanes = reinterpret_cast<const __m256i*>(amounts + i);
+        sums[0] = _mm256_add_epi64(sums[0], _mm256_and_si256(_mm256_loadu_si256(lanes), _mm256_cvtepi8_epi64(mask8)));
+        sums[1] = _mm256_add_epi64(sums[1], _mm256_and_si256(_mm256_loadu_si256(lanes + 1),
+                                                              _mm256_cvtepi8_epi64(_mm_srli_si128(mask8, 4))));
+        sums[2] = _mm256_add_epi64(sums[2], _mm256_and_si256(_mm256_loadu_si256(lanes + 2),
+                                                              _mm256_cvtepi8_epi64(_mm_srli_si128(mask8, 8))));
+        sums[3] = _mm256_add_epi64(sums[3], _mm256_and_si256(_mm256_loadu_si256(lanes + 3),
+                                                              _mm256_cvtepi8_epi64(_mm_srli_si128(mask8, 12))));
+    }
+    __m256i sum = _mm256_add_epi64(_mm256_add_epi64(sums[0], sums[1]), _mm256_add_epi64(sums[2], sums[3]));
+    uint64_t quarters[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(quarters), sum);
+    return quarters[0] + quarters[1] + quarters[2] + quarters[3] +
+           portableSumInState(states + i, amounts + i, count - i, state);
+}
+
+#endif // PRONEXMA_VAULT_X86_KERNELS
+
+inline bool cpuSupports(KernelLevel level) {
+    switch (level) {
+        case KernelLevel::PORTABLE: return true;
+#if PRONEXMA_VAULT_X86_KERNELS
+        case KernelLevel::SSE2: return __builtin_cpu_supports("sse2");
+        case KernelLevel::AVX2: return __builtin_cpu_supports("avx2");
+#else
+        case KernelLevel::SSE2:
+        case KernelLevel::AVX2: return false;
+#endif
+    }
+    return false;
+}
+
+} // namespace kernels_detail
+
+/** The kernels for `level`, or nullptr when this build or CPU lacks them. */
+inline const VaultKernels* vaultKernelsFor(KernelLevel level) {
+    using namespace kernels_detail;
+    static const VaultKernels TABLE[KERNEL_LEVEL_COUNT] = {
+        {KernelLevel::PORTABLE, &portableAddressEquals, &portableCountAddressMatches, &portableAllInState,
+         &portableAnyInState, &portableSumInState},
+#if PRONEXMA_VAULT_X86_KERNELS
+        {KernelLevel::SSE2, &sse2AddressEquals, &sse2CountAddressMatches, &sse2AllInState, &sse2AnyInState,
+         &sse2SumInState},
+        {KernelLevel::AVX2, &avx2AddressEquals, &avx2CountAddressMatches, &avx2AllInState, &avx2AnyInState,
+         &avx2SumInState},
+#else
+        {KernelLevel::SSE2, nullptr, nullptr, nullptr, nullptr, nullptr},
+        {KernelLevel::AVX2, nullptr, nullptr, nullptr, nullptr, nullptr},
+#endif
+    };
+    uint32_t index = static_cast<uint32_t>(level);
+    if (index >= KERNEL_LEVEL_COUNT || !cpuSupports(level)) return nullptr;
+    return &TABLE[index];
+}
+
+/** The widest kernels this CPU runs, chosen once. */
+inline const VaultKernels& vaultKernels() {
+    static const VaultKernels* best = [] {
+        for (uint32_t level = KERNEL_LEVEL_COUNT; level-- > 1;) {
+            if (const VaultKernels* kernels = vaultKernelsFor(static_cast<KernelLevel>(level))) return kernels;
+        }
+        return vaultKernelsFor(KernelLevel::PORTABLE);
+    }();
+    return *best;
+}
+
+// ============================================================================
+// PACKED MILESTONE COLUMNS
+// ============================================================================
+
+/**
+ * Every defined milestone of the used slots, packed: one state byte and one
+ * amount per milestone, agreement by agreement. first[i] is slot i's first
+ * milestone, first[count] the total.
+ */
+struct MilestoneColumns {
+    std::vector<uint8_t> state;
+    std::vector<uint64_t> amount;
+    std::vector<uint32_t> first;
+
+    uint32_t milestonesOf(uint32_t slot) const { return first[slot + 1] - first[slot]; }
+};
+
+template <typename Config>
+void packMilestoneColumns(const BasicVaultState<Config>& vault, MilestoneColumns& columns) {
+    columns.state.clear();
+    columns.amount.clear();
+    columns.first.assign(1, 0);
+    for (uint32_t i = 0; i < vault.activeAgreementCount; ++i) {
+        const BasicAgreement<Config>& agreement = vault.agreements[i];
+        uint32_t defined = std::min(agreement.milestoneCount, Config::MAX_MILESTONES);
+        for (uint32_t m = 0; m < defined; ++m) {
+            columns.state.push_back(static_cast<uint8_t>(agreement.milestones[m].state));
+            columns.amount.push_back(agreement.milestones[m].amount);
+        }
+        columns.first.push_back(static_cast<uint32_t>(columns.state.size()));
+    }
+}
+
+inline bool allMilestonesReleased(const uint8_t* states, uint32_t count) {
+    return vaultKernels().allInState(states, count, static_cast<uint8_t>(MilestoneState::RELEASED));
+}
+
+inline bool anyMilestoneVerified(const uint8_t* states, uint32_t count) {
+    return vaultKernels().anyInState(states, count, static_cast<uint8_t>(MilestoneState::VERIFIED));
+}
+
+inline uint64_t sumPendingAmounts(const uint8_t* states, const uint64_t* amounts, uint32_t count) {
+    return vaultKernels().sumInState(states, amounts, count, static_cast<uint8_t>(MilestoneState::PENDING));
+}
+
+/** The vault's sumLockedByState view, run by the dispatched kernel over its hot columns. */
+template <typename Config>
+uint64_t kernelSumLockedByState(const BasicVaultState<Config>& vault, AgreementState agreementState) {
+    static_assert(sizeof(AgreementState) == 1, "state column must be one byte per slot");
+    const uint8_t* states = reinterpret_cast<const uint8_t*>(vault.columns.state.data());
+    return vaultKernels().sumInState(states, vault.columns.locked.data(), vault.activeAgreementCount,
+                                     static_cast<uint8_t>(agreementState));
+}
@@ -0,0 +1,359 @@
+// contracts/host/VaultMigration.h
+// Pronexma Protocol - Streaming snapshot layout migration
+//
+// Every change to the Agreement/Milestone layout bumps SNAPSHOT_LAYOUT_VERSION
+// and registers a SnapshotLayout for the version it replaces: a block decoder
+// for the old records and an upgrade to the next version. migrateSnapshot
+// streams an old snapshot block by block through the upgrade chain into the
+// current layout, so memory stays bounded by a few blocks regardless of vault
+// size, and checks accounting invariants on the way. Format 1 files carry no
+// tick section; theirs is recorded from the records as they stream past
+// (recordAgreementTickFlows), the view rebuildTickActivity would give.
+
+#pragma once
+
+#include "VaultIdentity.h"
+#include "VaultSnapshot.h"
+
+#include <chrono>
+#include <memory>
+
+// ============================================================================
+// LAYOUT REGISTRY
+// ============================================================================
+
+struct SnapshotLayout {
+    uint32_t version;
+    uint32_t recordSize;
+    // Decodes a block payload into block.count records of recordSize bytes.
+    SnapshotStatus (*decodeBlock)(const SnapshotBlockHeader& block, const uint8_t* payload, uint8_t* records);
+    // Converts `count` records to layout version + 1; nullptr for the current
+    // layout. Returns the index of the first record it could not convert
+    // faithfully (an address naming no key), or `count`.
+    uint32_t (*upgrade)(const uint8_t* records, uint32_t count, uint8_t* upgraded);
+    // Converts header fields to layout version + 1; nullptr if they did not
+    // change. Returns false under the same condition as upgrade.
+    bool (*upgradeHeader)(SnapshotHeader& header);
+};
+
+inline SnapshotStatus decodeCurrentLayoutBlock(const SnapshotBlockHeader& block, const uint8_t* payload, uint8_t* records) {
+    return decodeSnapshotBlock(block, payload, reinterpret_cast<Agreement*>(records));
+}
+
+// ---- Layout 1: text addresses ----------------------------------------------
+
+// Layout 1 held each address as NUL-padded 64-byte text. Only checksummed Qubic
+// identities are upgraded; any other text (a host label, a typo) is reported
+// as INVALID_ADDRESS and left as the null key. Milestones are unchanged in
+// layout 2.
+using TextAddressV1 = std::array<char, 64>;
+
+struct AgreementLayoutV1 {
+    uint64_t id;
+    TextAddressV1 payer;
+    TextAddressV1 beneficiary;
+    TextAddressV1 oracleAdmin;
+    uint64_t totalAmount;
+    uint64_t lockedAmount;
+    uint64_t releasedAmount;
+    AgreementState state;
+    uint64_t createdAtTick;
+    uint64_t fundedAtTick;
+    uint64_t timeoutTick;
+    uint32_t milestoneCount;
+    std::array<Milestone, MAX_MILESTONES_PER_AGREEMENT> milestones;
+    std::array<char, 256> title;
+    std::array<char, 512> metadata;
+};
+static_assert(sizeof(AgreementLayoutV1) == 3352, "layout 1 records are 3352 bytes");
+
+/**
+ * The key a layout 1 address names into `out`; empty text is the null key.
+ * Returns false, with `out` null, if the text is not a valid identity.
+ */
+inline bool upgradeTextAddress(const char* text, size_t capacity, QubicAddress& out) {
+    size_t length = 0;
+    while (length < capacity && text[length] != '\0') ++length;
+    out = QubicAddress{};
+    return length == 0 || parseAddressText(text, length, out);
+}
+
+inline SnapshotStatus decodeLayoutV1Block(const SnapshotBlockHeader& block, const uint8_t* payload, uint8_t* records) {
+    return decodeSnapshotBlock(block, payload, reinterpret_cast<AgreementLayoutV1*>(records));
+}
+
+inline uint32_t upgradeLayoutV1(const uint8_t* records, uint32_t count, uint8_t* upgraded) {
+    const AgreementLayoutV1* in = reinterpret_cast<const AgreementLayoutV1*>(records);
+    Agreement* out = reinterpret_cast<Agreement*>(upgraded);
+    uint32_t firstInvalid = count;
+    for (uint32_t i = 0; i < count; ++i) {
+        std::memset(static_cast<void*>(&out[i]), 0, sizeof(Agreement));
+        out[i].id = in[i].id;
+        bool valid = upgradeTextAddress(in[i].payer.data(), in[i].payer.size(), out[i].payer);
+        valid = upgradeTextAddress(in[i].beneficiary.data(), in[i].beneficiary.size(), out[i].beneficiary) && valid;
+        valid = upgradeTextAddress(in[i].oracleAdmin.data(), in[i].oracleAdmin.size(), out[i].oracleAdmin) && valid;
+        if (!valid && firstInvalid == count) firstInvalid = i;
+        out[i].totalAmount = in[i].totalAmount;
+        out[i].lockedAmount = in[i].lockedAmount;
+        out[i].releasedAmount = in[i].releasedAmount;
+        out[i].state = in[i].state;
+        out[i].createdAtTick = in[i].createdAtTick;
+        out[i].fundedAtTick = in[i].fundedAtTick;
+        out[i].timeoutTick = in[i].timeoutTick;
+        out[i].milestoneCount = in[i].milestoneCount;
+        out[i].milestones = in[i].milestones;
+        out[i].title = in[i].title;
+        out[i].metadata = in[i].metadata;
+    }
+    return firstInvalid;
+}
+
+// The fee recipient's text spanned protocolFeeRecipient and its tail.
+inline bool upgradeLayoutV1Header(SnapshotHeader& header) {
+    char text[sizeof(header.protocolFeeRecipient) + sizeof(header.protocolFeeRecipientTail)];
+    std::memcpy(text, header.protocolFeeRecipient.data(), sizeof(header.protocolFeeRecipient));
+    std::memcpy(text + sizeof(header.protocolFeeRecipient), header.protocolFeeRecipientTail,
+                sizeof(header.protocolFeeRecipientTail));
+    std::memset(header.protocolFeeRecipientTail, 0, sizeof(header.protocolFeeRecipientTail));
+    return upgradeTextAddress(text, sizeof(text), header.protocolFeeRecipient);
+}
+
+inline const SnapshotLayout* findSnapshotLayout(uint32_t version) {
+    static const SnapshotLayout layouts[] = {
+        {1, sizeof(AgreementLayoutV1), &decodeLayoutV1Block, &upgradeLayoutV1, &upgradeLayoutV1Header},
+        {SNAPSHOT_LAYOUT_VERSION, sizeof(Agreement), &decodeCurrentLayoutBlock, nullptr, nullptr},
+    };
+    for (const SnapshotLayout& layout : layouts) {
+        if (layout.version == version) return &layout;
+    }
+    return nullptr;
+}
+
+// ============================================================================
+// INVARIANTS
+// ============================================================================
+
+enum class MigrationViolation : uint8_t {
+    NONE = 0,
+    MILESTONE_COUNT = 1,       // milestoneCount outside 1..MAX_MILESTONES_PER_AGREEMENT
+    MILESTONE_SUM = 2,         // Milestone amounts do not add up to totalAmount
+    LOCKED_EXCEEDS_TOTAL = 3,  // lockedAmount > totalAmount
+    TVL_MISMATCH = 4,          // Sum of lockedAmount != totalValueLocked
+    RELEASED_MISMATCH = 5,     // Sum of releasedAmount != totalValueReleased
+    INVALID_ADDRESS = 6,       // Address text that is no identity, or a null beneficiary or oracleAdmin
+    UNBALANCED = 7,            // locked/released amounts disagree with the state and released milestones
+    ACCOUNTING = 8             // The header totals break the vault-wide accounting identities
+};
+
+inline const char* migrationViolationName(MigrationViolation violation) {
+    switch (violation) {
+        case MigrationViolation::NONE: return "NONE";
+        case MigrationViolation::MILESTONE_COUNT: return "MILESTONE_COUNT";
+        case MigrationViolation::MILESTONE_SUM: return "MILESTONE_SUM";
+        case MigrationViolation::LOCKED_EXCEEDS_TOTAL: return "LOCKED_EXCEEDS_TOTAL";
+        case MigrationViolation::TVL_MISMATCH: return "TVL_MISMATCH";
+        case MigrationViolation::RELEASED_MISMATCH: return "RELEASED_MISMATCH";
+        case MigrationViolation::INVALID_ADDRESS: return "INVALID_ADDRESS";
+        case MigrationViolation::UNBALANCED: return "UNBALANCED";
+        case MigrationViolation::ACCOUNTING: return "ACCOUNTING";
+    }
+    return "UNKNOWN";
+}
+
+inline MigrationViolation checkAgreementInvariants(const Agreement& agreement) {
+    if (agreement.milestoneCount == 0 || agreement.milestoneCount > MAX_MILESTONES_PER_AGREEMENT) {
+        return MigrationViolation::MILESTONE_COUNT;
+    }
+    uint64_t milestoneSum = 0;
+    for (uint32_t i = 0; i < agreement.milestoneCount; ++i) {
+        milestoneSum += agreement.milestones[i].amount;
+    }
+    if (milestoneSum != agreement.totalAmount) {
+        return MigrationViolation::MILESTONE_SUM;
+    }
+    if (agreement.lockedAmount > agreement.totalAmount) {
+        return MigrationViolation::LOCKED_EXCEEDS_TOTAL;
+    }
+    if (!isValidAddress(agreement.beneficiary) || !isValidAddress(agreement.oracleAdmin)) {
+        return MigrationViolation::INVALID_ADDRESS;
+    }
+    if (!agreementBalanced(agreement)) {
+        return MigrationViolation::UNBALANCED;
+    }
+    return MigrationViolation::NONE;
+}
+
+// ============================================================================
+// MIGRATION
+// ============================================================================
+
+struct MigrationReport {
+    uint32_t fromLayout = 0;
+    uint32_t toLayout = SNAPSHOT_LAYOUT_VERSION;
+    uint32_t agreements = 0;
+    uint32_t blocks = 0;
+    uint64_t bytesOut = 0;
+    uint64_t micros = 0;
+    uint64_t lockedSum = 0;
+    uint64_t releasedSum = 0;
+    uint32_t violations = 0;
+    MigrationViolation firstViolation = MigrationViolation::NONE;
+    uint32_t firstViolationSlot = 0;
+
+    double agreementsPerSecond() const {
+        return micros == 0 ? 0.0 : static_cast<double>(agreements) * 1e6 / static_cast<double>(micros);
+    }
+};
+
+namespace migration_detail {
+
+inline void recordViolation(MigrationReport& report, MigrationViolation violation, uint32_t slot) {
+    if (report.violations++ == 0) {
+        report.firstViolation = violation;
+        report.firstViolationSlot = slot;
+    }
+}
+
+} // namespace migration_detail
+
+/**
+ * Streams the snapshot on `inFd` into the current layout on `outFd`, re-encoding
+ * blocks with `encoding`. With `validate`, any invariant violation makes the
+ * migration fail with INVARIANT_VIOLATION (the report says which and where).
+ */
+inline SnapshotStatus migrateSnapshot(int inFd, int outFd, BlockEncoding encoding, bool validate, MigrationReport& report) {
+    auto started = std::chrono::steady_clock::now();
+    report = MigrationReport();
+
+    SnapshotReader reader(inFd);
+    SnapshotHeader header;
+    SnapshotStatus status = reader.readHeaderAnyLayout(header);
+    if (status != SnapshotStatus::OK) return status;
+    report.fromLayout = header.layoutVersion;
+
+    // Resolve the upgrade chain up front so an unknown layout fails before writing.
+    std::vector<const SnapshotLayout*> chain;
+    for (uint32_t version = header.layoutVersion;; ++version) {
+        const SnapshotLayout* layout = findSnapshotLayout(version);
+        if (layout == nullptr || (version == header.layoutVersion && layout->recordSize != header.recordSize)) {
+            return SnapshotStatus::LAYOUT_MISMATCH;
+        }
+        chain.push_back(layout);
+        if (version == SNAPSHOT_LAYOUT_VERSION) break;
+        if (layout->upgrade == nullptr) return SnapshotStatus::LAYOUT_MISMATCH;
+    }
+
+    SnapshotHeader outHeader = header;
+    for (const SnapshotLayout* layout : chain) {
+        if (layout->upgradeHeader != nullptr && !layout->upgradeHeader(outHeader)) {
+            migration_detail::recordViolation(report, MigrationViolation::INVALID_ADDRESS, header.agreementCount);
+        }
+    }
+    outHeader.formatVersion = SNAPSHOT_FORMAT_VERSION;
+    outHeader.layoutVersion = SNAPSHOT_LAYOUT_VERSION;
+    outHeader.recordSize = sizeof(Agreement);
+    outHeader.blockCapacity = SNAPSHOT_BLOCK_CAPACITY;
+    SnapshotWriter writer(outFd, encoding);
+    status = writer.writeHeader(outHeader);
+
+    // Two ping-pong record buffers sized for the largest layout in the chain.
+    size_t largestRecord = 0;
+    for (const SnapshotLayout* layout : chain) largestRecord = std::max<size_t>(largestRecord, layout->recordSize);
+    std::vector<uint8_t> current(largestRecord * SNAPSHOT_BLOCK_CAPACITY);
+    std::vector<uint8_t> next(largestRecord * SNAPSHOT_BLOCK_CAPACITY);
+    std::vector<uint8_t> payload;
+    AccountingCounters counters = {};
+    std::unique_ptr<VaultTickActivity> activity;
+    if (header.formatVersion < 2) {
+        activity.reset(new VaultTickActivity());
+        resetTickActivity(*activity, header.tick);
+    }
+
+    while (status == SnapshotStatus::OK && !reader.done()) {
+        SnapshotBlockHeader block;
+        status = reader.readRawBlock(block, payload);
+        if (status != SnapshotStatus::OK) break;
+        status = chain.front()->decodeBlock(block, payload.data(), current.data());
+        if (status != SnapshotStatus::OK) break;
+        for (size_t step = 0; step + 1 < chain.size(); ++step) {
+            uint32_t invalid = chain[step]->upgrade(current.data(), block.count, next.data());
+            if (invalid < block.count) {
+                migration_detail::recordViolation(report, MigrationViolation::INVALID_ADDRESS,
+                                                  block.firstSlot + invalid);
+            }
+            current.swap(next);
+        }
+
+        const Agreement* records = reinterpret_cast<const Agreement*>(current.data());
+        for (uint32_t i = 0; i < block.count && status == SnapshotStatus::OK; ++i) {
+            report.lockedSum += records[i].lockedAmount;
+            report.releasedSum += records[i].releasedAmount;
+            accountAgreement(counters, records[i]);
+            if (activity != nullptr) {
+                if (block.firstSlot + i == 0) resetTickActivity(*activity, records[i].createdAtTick);
+                recordAgreementTickFlows(*activity, records[i]);
+            }
+            MigrationViolation violation = checkAgreementInvariants(records[i]);
+            if (violation != MigrationViolation::NONE) {
+                migration_detail::recordViolation(report, violation, block.firstSlot + i);
+            }
+            status = writer.appendAgreement(records[i]);
+        }
+        report.agreements += block.count;
+        ++report.blocks;
+    }
+
+    if (status == SnapshotStatus::OK) {
+        if (report.lockedSum != header.totalValueLocked) {
+            migration_detail::recordViolation(report, MigrationViolation::TVL_MISMATCH, header.agreementCount);
+        }
+        if (report.releasedSum != header.totalValueReleased) {
+            migration_detail::recordViolation(report, MigrationViolation::RELEASED_MISMATCH, header.agreementCount);
+        }
+        if (checkAccountingIdentities(counters, header.totalValueLocked, header.totalValueReleased,
+                                      header.protocolFeeAccrued) != AccountingViolation::NONE) {
+            migration_detail::recordViolation(report, MigrationViolation::ACCOUNTING, header.agreementCount);
+        }
+        SnapshotTicks ticks;
+        if (activity != nullptr) {
+            captureSnapshotTicks(*activity, ticks);
+        } else {
+            status = reader.readTicks(ticks);
+            if (status == SnapshotStatus::OK) status = verifySnapshotTicks(ticks);
+        }
+        if (status == SnapshotStatus::OK) status = writer.finish(ticks);
+    }
+    if (status == SnapshotStatus::OK && validate && report.violations > 0) {
+        status = SnapshotStatus::INVARIANT_VIOLATION;
+    }
+    report.bytesOut = writer.bytesWritten();
+    report.micros = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - started).count());
+    return status;
+}
+
+/**
+ * File-to-file migration. The output only replaces `outPath` if the whole
+ * migration (including validation) succeeds.
+ */
+inline SnapshotStatus migrateSnapshotFile(const std::string& inPath, const std::string& outPath, BlockEncoding encoding,
+                                          bool validate, MigrationReport& report) {
+    int inFd = ::open(inPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (inFd < 0) {
+        return SnapshotStatus::IO_ERROR;
+    }
+    std::string tmpPath = outPath + ".tmp";
+    int outFd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (outFd < 0) {
+        ::close(inFd);
+        return SnapshotStatus::IO_ERROR;
+    }
+    SnapshotStatus status = migrateSnapshot(inFd, outFd, encoding, validate, report);
+    ::close(inFd);
+    if (status != SnapshotStatus::OK) {
+        ::close(outFd);
+        ::unlink(tmpPath.c_str());
+        return status;
+    }
+    return commitSnapshotFile(outFd, tmpPath, outPath);
+}
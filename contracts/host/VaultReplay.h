@@ -0,0 +1,538 @@
+// contracts/host/VaultReplay.h
+// Pronexma Protocol - Tick logs and deterministic replay against the engine
+//
+// A tick log is the call stream of a vault: every procedure and view with its
+// tick, sender, value and arguments, the outcome it had when it was recorded,
+// and the global counters at the end. Replaying one against an engine that
+// starts from the same state (fresh, or a snapshot) reproduces every call
+// exactly, times each one and checks the outcomes and final counters.
+//
+// Binary log: TICK_LOG_MAGIC, uint32 version, uint64 start tick, then records
+//   uint8 TICK_LOG_CALL, uint8 kind, uint8 outcome, uint64 tick, uint64 value,
+//   uint64 agreementId, uint32 milestoneId, key sender
+//   [createAgreement: key beneficiary, key oracleAdmin, uint64 totalAmount,
+//    uint8 milestoneCount, uint64 amount * milestoneCount]
+// and one closing uint8 TICK_LOG_END + TickLogTotals. Integers are
+// little-endian; keys are the 32 address bytes.
+//
+// The backend's Transaction table only holds DEPOSIT/RELEASE/REFUND/FEE rows
+// with wall-clock times, so it cannot be replayed by itself. The NDJSON import
+// (parseTransactionJson) reads rows that extend its columns with the tick and
+// the CREATE/VERIFY calls the table does not keep; see the function comment.
+
+#pragma once
+
+#include "VaultHistogram.h"
+#include "VaultSnapshot.h"
+#include "VaultWorkload.h"
+
+#include <chrono>
+
+constexpr char TICK_LOG_MAGIC[8] = {'P', 'R', 'N', 'X', 'T', 'L', 'O', 'G'};
+constexpr uint32_t TICK_LOG_VERSION = 2;     // 2: binary addresses
+constexpr uint8_t TICK_LOG_CALL = 1;
+constexpr uint8_t TICK_LOG_END = 2;
+
+enum class TickLogOutcome : uint8_t { FAILED = 0, SUCCEEDED = 1, UNKNOWN = 2 };
+
+struct TickLogEntry {
+    WorkloadOp call;
+    TickLogOutcome outcome = TickLogOutcome::UNKNOWN;
+};
+
+/** Global counters after the last call; replay checks the engine against them. */
+struct TickLogTotals {
+    uint64_t calls = 0;
+    uint64_t agreementCounter = 0;
+    uint64_t totalValueLocked = 0;
+    uint64_t totalValueReleased = 0;
+    uint64_t protocolFeeAccrued = 0;
+    uint32_t agreementCount = 0;
+    uint32_t reserved = 0;
+};
+
+inline TickLogTotals tickLogTotals(const PronexmaVaultState& vault, uint64_t calls) {
+    TickLogTotals totals;
+    totals.calls = calls;
+    totals.agreementCounter = vault.agreementCounter;
+    totals.totalValueLocked = vault.totalValueLocked;
+    totals.totalValueReleased = vault.totalValueReleased;
+    totals.protocolFeeAccrued = vault.protocolFeeAccrued;
+    totals.agreementCount = vault.activeAgreementCount;
+    return totals;
+}
+
+// ============================================================================
+// BINARY LOG
+// ============================================================================
+
+namespace replay_detail {
+
+inline bool writeKey(FdWriter& out, const QubicAddress& key) {
+    return out.write(key.data(), key.size());
+}
+
+inline bool readKey(FdReader& in, QubicAddress& key) {
+    return in.read(key.data(), key.size());
+}
+
+} // namespace replay_detail
+
+/** Streams calls into a tick log: begin, append per call, finish with the end state. */
+class TickLogWriter {
+public:
+    explicit TickLogWriter(int fd) : out_(fd) {}
+
+    SnapshotStatus begin(uint64_t startTick) {
+        bool ok = out_.write(TICK_LOG_MAGIC, sizeof(TICK_LOG_MAGIC)) &&
+                  out_.write(&TICK_LOG_VERSION, sizeof(TICK_LOG_VERSION)) && out_.write(&startTick, sizeof(startTick));
+        return ok ? SnapshotStatus::OK : SnapshotStatus::IO_ERROR;
+    }
+
+    SnapshotStatus append(const WorkloadOp& call, TickLogOutcome outcome) {
+        using replay_detail::writeKey;
+        uint8_t head[3] = {TICK_LOG_CALL, static_cast<uint8_t>(call.kind), static_cast<uint8_t>(outcome)};
+        bool ok = out_.write(head, sizeof(head)) && out_.write(&call.tick, sizeof(call.tick)) &&
+                  out_.write(&call.value, sizeof(call.value)) &&
+                  out_.write(&call.agreementId, sizeof(call.agreementId)) &&
+                  out_.write(&call.milestoneId, sizeof(call.milestoneId)) && writeKey(out_, call.sender);
+        if (ok && call.kind == WorkloadOpKind::CREATE_AGREEMENT) {
+            uint8_t count = static_cast<uint8_t>(std::min(call.milestoneCount, MAX_MILESTONES_PER_AGREEMENT));
+            ok = writeKey(out_, call.beneficiary) && writeKey(out_, call.oracleAdmin) &&
+                 out_.write(&call.totalAmount, sizeof(call.totalAmount)) && out_.write(&count, 1) &&
+                 out_.write(call.amounts.data(), count * sizeof(uint64_t));
+        }
+        ++calls_;
+        return ok ? SnapshotStatus::OK : SnapshotStatus::IO_ERROR;
+    }
+
+    SnapshotStatus finish(const PronexmaVaultState& vault) {
+        TickLogTotals totals = tickLogTotals(vault, calls_);
+        bool ok = out_.write(&TICK_LOG_END, 1) && out_.write(&totals, sizeof(totals)) && out_.flush();
+        return ok ? SnapshotStatus::OK : SnapshotStatus::IO_ERROR;
+    }
+
+private:
+    FdWriter out_;
+    uint64_t calls_ = 0;
+};
+
+class TickLogReader {
+public:
+    explicit TickLogReader(int fd) : in_(fd) {}
+
+    SnapshotStatus begin() {
+        char magic[8];
+        uint32_t version = 0;
+        if (!in_.read(magic, sizeof(magic)) || !in_.read(&version, sizeof(version)) ||
+            !in_.read(&startTick_, sizeof(startTick_))) {
+            return SnapshotStatus::IO_ERROR;
+        }
+        if (std::memcmp(magic, TICK_LOG_MAGIC, sizeof(magic)) != 0) return SnapshotStatus::BAD_MAGIC;
+        if (version != TICK_LOG_VERSION) return SnapshotStatus::UNSUPPORTED_VERSION;
+        return SnapshotStatus::OK;
+    }
+
+    /**
+     * Reads the next call. At the end record, sets `atEnd` and loads totals().
+     * A log cut off before its end record is CORRUPT_BLOCK.
+     */
+    SnapshotStatus next(TickLogEntry& entry, bool& atEnd) {
+        using replay_detail::readKey;
+        atEnd = false;
+        uint8_t tag = 0;
+        if (!in_.read(&tag, 1)) return SnapshotStatus::CORRUPT_BLOCK;
+        if (tag == TICK_LOG_END) {
+            atEnd = true;
+            return in_.read(&totals_, sizeof(totals_)) ? SnapshotStatus::OK : SnapshotStatus::CORRUPT_BLOCK;
+        }
+        uint8_t head[2];
+        entry = TickLogEntry();
+        WorkloadOp& call = entry.call;
+        if (tag != TICK_LOG_CALL || !in_.read(head, sizeof(head)) || head[0] >= WORKLOAD_OP_KINDS ||
+            head[1] > static_cast<uint8_t>(TickLogOutcome::UNKNOWN)) {
+            return SnapshotStatus::CORRUPT_BLOCK;
+        }
+        call.kind = static_cast<WorkloadOpKind>(head[0]);
+        entry.outcome = static_cast<TickLogOutcome>(head[1]);
+        bool ok = in_.read(&call.tick, sizeof(call.tick)) && in_.read(&call.value, sizeof(call.value)) &&
+                  in_.read(&call.agreementId, sizeof(call.agreementId)) &&
+                  in_.read(&call.milestoneId, sizeof(call.milestoneId)) && readKey(in_, call.sender);
+        if (ok && call.kind == WorkloadOpKind::CREATE_AGREEMENT) {
+            uint8_t count = 0;
+            ok = readKey(in_, call.beneficiary) && readKey(in_, call.oracleAdmin) &&
+                 in_.read(&call.totalAmount, sizeof(call.totalAmount)) && in_.read(&count, 1) &&
+                 count <= MAX_MILESTONES_PER_AGREEMENT && in_.read(call.amounts.data(), count * sizeof(uint64_t));
+            call.milestoneCount = count;
+        }
+        return ok ? SnapshotStatus::OK : SnapshotStatus::CORRUPT_BLOCK;
+    }
+
+    uint64_t startTick() const { return startTick_; }
+    const TickLogTotals& totals() const { return totals_; }
+
+private:
+    FdReader in_;
+    uint64_t startTick_ = 0;
+    TickLogTotals totals_;
+};
+
+// ============================================================================
+// TRANSACTION ROWS (NDJSON)
+// ============================================================================
+
+namespace replay_detail {
+
+// Minimal scanner for one flat JSON object: string, number and number-array
+// values; nested objects are not expected in a transaction row.
+class JsonRow {
+public:
+    explicit JsonRow(const std::string& line) : text_(line) {}
+
+    bool parse() {
+        skipSpace();
+        if (!consume('{')) return false;
+        skipSpace();
+        if (consume('}')) return true;
+        for (;;) {
+            std::string key;
+            skipSpace();
+            if (!readString(key)) return false;
+            skipSpace();
+            if (!consume(':')) return false;
+            skipSpace();
+            Value value;
+            if (!readValue(value)) return false;
+            fields_.emplace_back(std::move(key), std::move(value));
+            skipSpace();
+            if (consume('}')) return true;
+            if (!consume(',')) return false;
+        }
+    }
+
+    const std::string* text(const char* key) const {
+        const Value* value = find(key);
+        return value != nullptr && !value->isArray ? &value->text : nullptr;
+    }
+
+    /** Numbers are accepted bare or as decimal strings (large amounts). */
+    bool number(const char* key, uint64_t& out) const {
+        const Value* value = find(key);
+        if (value == nullptr || value->isArray) return false;
+        return parseNumber(value->text, out);
+    }
+
+    const std::vector<uint64_t>* numbers(const char* key) const {
+        const Value* value = find(key);
+        return value != nullptr && value->isArray ? &value->numbers : nullptr;
+    }
+
+    static bool parseNumber(const std::string& text, uint64_t& out) {
+        if (text.empty()) return false;
+        bool hex = text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X');
+        char* end = nullptr;
+        errno = 0;
+        out = std::strtoull(text.c_str(), &end, hex ? 16 : 10);
+        return errno == 0 && *end == '\0' && text[0] != '-';
+    }
+
+private:
+    struct Value {
+        std::string text;
+        bool isArray = false;
+        std::vector<uint64_t> numbers;
+    };
+
+    const Value* find(const char* key) const {
+        for (const auto& field : fields_) {
+            if (field.first == key) return &field.second;
+        }
+        return nullptr;
+    }
+
+    void skipSpace() {
+        while (pos_ < text_.size() && (text_[pos_] == ' ' || text_[pos_] == '\t' || text_[pos_] == '\r')) ++pos_;
+    }
+
+    bool consume(char c) {
+        if (pos_ < text_.size() && text_[pos_] == c) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    bool readString(std::string& out) {
+        if (!consume('"')) return false;
+        while (pos_ < text_.size() && text_[pos_] != '"') {
+            if (text_[pos_] == '\\' && pos_ + 1 < text_.size()) ++pos_;
+            out.push_back(text_[pos_++]);
+        }
+        return consume('"');
+    }
+
+    bool readScalar(std::string& out) {
+        while (pos_ < text_.size() && text_[pos_] != ',' && text_[pos_] != '}' && text_[pos_] != ']' &&
+               text_[pos_] != ' ') {
+            out.push_back(text_[pos_++]);
+        }
+        return !out.empty();
+    }
+
+    bool readValue(Value& value) {
+        if (pos_ < text_.size() && text_[pos_] == '"') return readString(value.text);
+        if (!consume('[')) return readScalar(value.text);
+        value.isArray = true;
+        skipSpace();
+        if (consume(']')) return true;
+        for (;;) {
+            skipSpace();
+            std::string item;
+            uint64_t number = 0;
+            bool ok = pos_ < text_.size() && text_[pos_] == '"' ? readString(item) : readScalar(item);
+            if (!ok || !parseNumber(item, number)) return false;
+            value.numbers.push_back(number);
+            skipSpace();
+            if (consume(']')) return true;
+            if (!consume(',')) return false;
+        }
+    }
+
+    const std::string& text_;
+    size_t pos_ = 0;
+    std::vector<std::pair<std::string, Value>> fields_;
+};
+
+inline bool copyAddress(const std::string* text, QubicAddress& out) {
+    out = QubicAddress{};
+    return text != nullptr && parseAddressText(text->data(), text->size(), out);
+}
+
+} // namespace replay_detail
+
+enum class TransactionRow : uint8_t { CALL, SKIP, TOTALS, INVALID, INVALID_ADDRESS };
+
+/**
+ * Parses one NDJSON transaction row. Rows use the Transaction table columns
+ * (type, amount, status, fromAddress, toAddress, milestoneId) with the
+ * agreement's onChainId as agreementId, plus the tick:
+ *
+ *   {"type":"DEPOSIT","tick":15000040,"agreementId":"0x50524e5800000001",
+ *    "fromAddress":"PAYER...","amount":"2500000","status":"CONFIRMED"}
+ *
+ * Types DEPOSIT, RELEASE (milestoneId) and REFUND map onto their procedures;
+ * FEE rows are implied by RELEASE and skipped. Calls the table does not keep
+ * use CREATE (fromAddress payer, toAddress beneficiary, oracleAddress,
+ * milestoneAmounts array), VERIFY (fromAddress oracle, milestoneId) and VIEW /
+ * VIEW_MILESTONE / STATS. A {"type":"END",...} row carries the final counters
+ * (agreementCounter, totalValueLocked, totalValueReleased, protocolFeeAccrued,
+ * agreementCount). Status CONFIRMED and FAILED set the expected outcome.
+ * Addresses must be Qubic identities (checksum verified); a row with any other
+ * address text is INVALID_ADDRESS.
+ */
+inline TransactionRow parseTransactionJson(const std::string& line, TickLogEntry& entry, TickLogTotals& totals) {
+    using replay_detail::copyAddress;
+    replay_detail::JsonRow row(line);
+    const std::string* type = nullptr;
+    if (!row.parse() || (type = row.text("type")) == nullptr) return TransactionRow::INVALID;
+    if (*type == "FEE") return TransactionRow::SKIP;
+    if (*type == "END") {
+        uint64_t count = 0;
+        bool ok = row.number("agreementCounter", totals.agreementCounter) &&
+                  row.number("totalValueLocked", totals.totalValueLocked) &&
+                  row.number("totalValueReleased", totals.totalValueReleased) &&
+                  row.number("protocolFeeAccrued", totals.protocolFeeAccrued) && row.number("agreementCount", count);
+        totals.agreementCount = static_cast<uint32_t>(count);
+        row.number("calls", totals.calls);
+        return ok ? TransactionRow::TOTALS : TransactionRow::INVALID;
+    }
+
+    entry = TickLogEntry();
+    WorkloadOp& call = entry.call;
+    uint64_t milestoneId = 0;
+    if (!row.number("tick", call.tick)) return TransactionRow::INVALID;
+    if (!copyAddress(row.text("fromAddress"), call.sender)) return TransactionRow::INVALID_ADDRESS;
+    row.number("agreementId", call.agreementId);
+    row.number("milestoneId", milestoneId);
+    call.milestoneId = static_cast<uint32_t>(milestoneId);
+
+    if (*type == "CREATE") {
+        const std::vector<uint64_t>* amounts = row.numbers("milestoneAmounts");
+        if (amounts == nullptr || amounts->size() > MAX_MILESTONES_PER_AGREEMENT) return TransactionRow::INVALID;
+        if (!copyAddress(row.text("toAddress"), call.beneficiary) ||
+            !copyAddress(row.text("oracleAddress"), call.oracleAdmin)) {
+            return TransactionRow::INVALID_ADDRESS;
+        }
+        call.kind = WorkloadOpKind::CREATE_AGREEMENT;
+        call.milestoneCount = static_cast<uint32_t>(amounts->size());
+        for (size_t m = 0; m < amounts->size(); ++m) {
+            call.amounts[m] = (*amounts)[m];
+            call.totalAmount += (*amounts)[m];
+        }
+        row.number("amount", call.totalAmount);  // Mismatched totals are replayed as recorded
+    } else if (*type == "DEPOSIT") {
+        call.kind = WorkloadOpKind::DEPOSIT;
+        if (!row.number("amount", call.value)) return TransactionRow::INVALID;
+    } else if (*type == "VERIFY") {
+        call.kind = WorkloadOpKind::MARK_MILESTONE_VERIFIED;
+    } else if (*type == "RELEASE") {
+        call.kind = WorkloadOpKind::RELEASE_MILESTONE;
+    } else if (*type == "REFUND") {
+        call.kind = WorkloadOpKind::REFUND;
+    } else if (*type == "VIEW") {
+        call.kind = WorkloadOpKind::GET_AGREEMENT;
+    } else if (*type == "VIEW_MILESTONE") {
+        call.kind = WorkloadOpKind::GET_MILESTONE;
+    } else if (*type == "STATS") {
+        call.kind = WorkloadOpKind::GET_PROTOCOL_STATS;
+    } else {
+        return TransactionRow::INVALID;
+    }
+
+    const std::string* status = row.text("status");
+    if (status != nullptr && *status == "CONFIRMED") entry.outcome = TickLogOutcome::SUCCEEDED;
+    if (status != nullptr && *status == "FAILED") entry.outcome = TickLogOutcome::FAILED;
+    return TransactionRow::CALL;
+}
+
+// ============================================================================
+// REPLAY
+// ============================================================================
+
+struct ReplayProcedureStats {
+    uint64_t calls = 0;
+    uint64_t failures = 0;
+    uint64_t nanos = 0;
+    uint64_t maxNanos = 0;
+};
+
+struct ReplayTick {
+    uint64_t tick = 0;
+    uint64_t calls = 0;
+    uint64_t nanos = 0;
+};
+
+struct ReplayReport {
+    std::array<ReplayProcedureStats, WORKLOAD_OP_KINDS> procedures;
+    uint64_t calls = 0;
+    uint64_t outcomeMismatches = 0;        // Calls whose success differs from the log
+    uint64_t firstMismatch = UINT64_MAX;   // Index of the first such call
+    uint64_t wallNanos = 0;
+    std::vector<ReplayTick> slowestTicks;  // Most engine time first
+    LatencyHistograms latencies;           // Per procedure and outcome, in ns
+    bool totalsPresent = false;
+    bool totalsMatch = false;
+    TickLogTotals expected;
+    TickLogTotals actual;
+    uint64_t accountingViolations = 0;     // Calls after which checkAccountingInvariants failed
+    uint64_t firstAccountingViolation = UINT64_MAX;  // Index of the first such call
+    AccountingViolation accountingViolation = AccountingViolation::NONE;  // What it found
+
+    bool clean() const {
+        return outcomeMismatches == 0 && accountingViolations == 0 && totalsPresent && totalsMatch;
+    }
+};
+
+/**
+ * Replays calls against one engine. The engine must start from the state the
+ * log was recorded on; `host` must be bound to it. Each call's value is minted
+ * to its sender just before the call, so replay never depends on balances the
+ * log does not carry.
+ */
+class VaultReplayer {
+public:
+    VaultReplayer(PronexmaVaultEngine& engine, NativeHost& host, uint32_t slowestTicks = 8)
+        : engine_(engine), host_(host), keepTicks_(slowestTicks) {
+        // Releases and refunds pay out of the contract account; seed it with
+        // what the starting state already holds.
+        host_.credit(host_.contractAccount(), engine_.state.totalValueLocked);
+    }
+
+    void replay(const TickLogEntry& entry) {
+        const WorkloadOp& call = entry.call;
+        if (call.tick != currentTick_.tick) closeTick(call.tick);
+        host_.credit(call.sender, call.value);
+
+        auto started = std::chrono::steady_clock::now();
+        bool ok = runWorkloadOp(engine_, host_, call);
+        uint64_t nanos = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - started).count());
+
+        ReplayProcedureStats& stats = report_.procedures[static_cast<uint32_t>(call.kind)];
+        ++stats.calls;
+        stats.failures += ok ? 0 : 1;
+        stats.nanos += nanos;
+        stats.maxNanos = std::max(stats.maxNanos, nanos);
+        report_.latencies.record(call.kind, latencyOutcome(engine_, ok), nanos);
+        ++currentTick_.calls;
+        currentTick_.nanos += nanos;
+        if (entry.outcome != TickLogOutcome::UNKNOWN && ok != (entry.outcome == TickLogOutcome::SUCCEEDED)) {
+            if (report_.outcomeMismatches++ == 0) report_.firstMismatch = report_.calls;
+        }
+        AccountingViolation violation = checkAccountingInvariants(engine_.state);
+        if (violation != AccountingViolation::NONE && report_.accountingViolations++ == 0) {
+            report_.firstAccountingViolation = report_.calls;
+            report_.accountingViolation = violation;
+        }
+        ++report_.calls;
+    }
+
+    /** Compares the engine's counters with the log's end record and closes the report. */
+    const ReplayReport& finish(const TickLogTotals* expected) {
+        closeTick(0);
+        report_.actual = tickLogTotals(engine_.state, report_.calls);
+        report_.totalsPresent = expected != nullptr;
+        if (expected != nullptr) {
+            const TickLogTotals& a = report_.actual;
+            report_.expected = *expected;
+            report_.totalsMatch = a.agreementCounter == expected->agreementCounter &&
+                                  a.totalValueLocked == expected->totalValueLocked &&
+                                  a.totalValueReleased == expected->totalValueReleased &&
+                                  a.protocolFeeAccrued == expected->protocolFeeAccrued &&
+                                  a.agreementCount == expected->agreementCount &&
+                                  (expected->calls == 0 || a.calls == expected->calls);
+        }
+        return report_;
+    }
+
+    const ReplayReport& report() const { return report_; }
+
+private:
+    void closeTick(uint64_t nextTick) {
+        if (currentTick_.calls > 0 && keepTicks_ > 0) {
+            std::vector<ReplayTick>& slowest = report_.slowestTicks;
+            auto position = std::find_if(slowest.begin(), slowest.end(),
+                                         [&](const ReplayTick& tick) { return tick.nanos < currentTick_.nanos; });
+            if (position != slowest.end() || slowest.size() < keepTicks_) {
+                slowest.insert(position, currentTick_);
+                if (slowest.size() > keepTicks_) slowest.pop_back();
+            }
+        }
+        currentTick_ = ReplayTick();
+        currentTick_.tick = nextTick;
+    }
+
+    PronexmaVaultEngine& engine_;
+    NativeHost& host_;
+    uint32_t keepTicks_;
+    ReplayTick currentTick_;
+    ReplayReport report_;
+};
+
+/** Replays a binary tick log from `fd` to its end record. */
+inline SnapshotStatus replayTickLog(int fd, PronexmaVaultEngine& engine, NativeHost& host, ReplayReport& report) {
+    auto started = std::chrono::steady_clock::now();
+    TickLogReader reader(fd);
+    SnapshotStatus status = reader.begin();
+    if (status != SnapshotStatus::OK) return status;
+    VaultReplayer replayer(engine, host);
+    TickLogEntry entry;
+    bool atEnd = false;
+    while ((status = reader.next(entry, atEnd)) == SnapshotStatus::OK && !atEnd) {
+        replayer.replay(entry);
+    }
+    report = replayer.finish(atEnd ? &reader.totals() : nullptr);
+    report.wallNanos = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - started).count());
+    return status;
+}
@@ -0,0 +1,120 @@
+// contracts/host/VaultRestore.h
+// Pronexma Protocol - Parallel snapshot restore with index rebuild
+//
+// The block index at the end of a snapshot lets workers decode disjoint block
+// ranges independently: each worker preads its blocks, decodes them straight
+// into their slots, verifies hashes and builds a VaultIndexPartial for its
+// range, checking each record's balance as it goes. The partials are then
+// merged in slot order, so the restored state and indexes are identical for
+// any worker count.
+
+#pragma once
+
+#include "VaultIndexes.h"
+
+#include <chrono>
+#include <thread>
+
+struct RestoreStats {
+    uint32_t workers = 0;
+    uint32_t blocks = 0;
+    uint64_t decodeMicros = 0;             // Parallel phase: read, decode, verify, partial indexes
+    uint64_t mergeMicros = 0;              // Deterministic merge of partial indexes
+};
+
+namespace restore_detail {
+
+inline uint64_t elapsedMicros(std::chrono::steady_clock::time_point since) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - since).count());
+}
+
+inline SnapshotStatus restoreBlockRange(int fd, const SnapshotBlockIndexEntry* first, const SnapshotBlockIndexEntry* last,
+                                        PronexmaVaultState& vault, VaultIndexPartial& partial) {
+    std::vector<uint8_t> payload;
+    for (const SnapshotBlockIndexEntry* entry = first; entry != last; ++entry) {
+        const SnapshotBlockHeader& block = entry->block;
+        payload.resize(block.payloadBytes);
+        if (!preadAll(fd, payload.data(), payload.size(), entry->offset + sizeof(SnapshotBlockHeader))) {
+            return SnapshotStatus::IO_ERROR;
+        }
+        Agreement* out = &vault.agreements[block.firstSlot];
+        SnapshotStatus status = decodeSnapshotBlock(block, payload.data(), out);
+        if (status == SnapshotStatus::OK) status = checkSnapshotRecords(out, block.count);
+        if (status != SnapshotStatus::OK) return status;
+        for (uint32_t i = 0; i < block.count; ++i) {
+            partial.add(out[i], block.firstSlot + i);
+        }
+    }
+    partial.finish();
+    return SnapshotStatus::OK;
+}
+
+} // namespace restore_detail
+
+/**
+ * Restores `path` into `vault` and rebuilds `indexes` using up to `workers`
+ * threads (0 = hardware concurrency). On failure `vault` may be partially
+ * written and `indexes` is left untouched; a snapshot whose records or
+ * counters break the accounting identities fails with INVARIANT_VIOLATION.
+ */
+inline SnapshotStatus restoreSnapshotParallel(const std::string& path, PronexmaVaultState& vault, VaultIndexes& indexes,
+                                              uint32_t workers = 0, RestoreStats* stats = nullptr) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return SnapshotStatus::IO_ERROR;
+    }
+    SnapshotHeader header;
+    std::vector<SnapshotBlockIndexEntry> index;
+    SnapshotTicks ticks;
+    SnapshotStatus status = readSnapshotBlockIndex(fd, header, index);
+    if (status == SnapshotStatus::OK) status = readSnapshotTicksAt(fd, index, ticks);
+    if (status != SnapshotStatus::OK) {
+        ::close(fd);
+        return status;
+    }
+
+    if (workers == 0) workers = std::max(1u, std::thread::hardware_concurrency());
+    workers = std::max<uint32_t>(1, std::min<uint32_t>(workers, static_cast<uint32_t>(index.size())));
+
+    // Blocks are near-uniform in record count, so equal block ranges balance well.
+    auto started = std::chrono::steady_clock::now();
+    std::vector<VaultIndexPartial> partials(workers);
+    std::vector<SnapshotStatus> results(workers, SnapshotStatus::OK);
+    std::vector<std::thread> threads;
+    size_t perWorker = index.size() / workers;
+    size_t extra = index.size() % workers;
+    size_t begin = 0;
+    for (uint32_t w = 0; w < workers; ++w) {
+        size_t end = begin + perWorker + (w < extra ? 1 : 0);
+        const SnapshotBlockIndexEntry* first = index.data() + begin;
+        const SnapshotBlockIndexEntry* last = index.data() + end;
+        if (w + 1 == workers) {
+            results[w] = restore_detail::restoreBlockRange(fd, first, last, vault, partials[w]);
+        } else {
+            threads.emplace_back([&, w, first, last] {
+                results[w] = restore_detail::restoreBlockRange(fd, first, last, vault, partials[w]);
+            });
+        }
+        begin = end;
+    }
+    for (std::thread& thread : threads) thread.join();
+    ::close(fd);
+    uint64_t decodeMicros = restore_detail::elapsedMicros(started);
+
+    for (SnapshotStatus result : results) {
+        if (result != SnapshotStatus::OK) return result;
+    }
+
+    status = applySnapshotHeader(header, ticks, vault);
+    if (status != SnapshotStatus::OK) return status;
+    started = std::chrono::steady_clock::now();
+    mergeVaultIndexPartials(partials, indexes);
+    if (stats != nullptr) {
+        stats->workers = workers;
+        stats->blocks = static_cast<uint32_t>(index.size());
+        stats->decodeMicros = decodeMicros;
+        stats->mergeMicros = restore_detail::elapsedMicros(started);
+    }
+    return SnapshotStatus::OK;
+}
@@ -0,0 +1,779 @@
+// contracts/host/VaultSnapshot.h
+// Pronexma Protocol - Native snapshot format for PronexmaVaultState
+//
+// Host-side code (replicas, tools, benchmarks) - never compiled into the contract.
+//
+// File layout:
+//   SnapshotHeader
+//   { SnapshotBlockHeader, payload } * blockCount
+//   SnapshotTickSection, tree entries      (format 2)
+//   SnapshotBlockIndexEntry * blockCount
+//   SnapshotTrailer
+//
+// Blocks hold up to SNAPSHOT_BLOCK_CAPACITY consecutive agreement slots. Each
+// block header repeats its index entry so the file can be consumed as a stream;
+// the trailing index allows random access to any block. The tick section keeps
+// the tick-activity trees as the vault had them: records alone cannot place a
+// refund, so rebuilding the trees from them would not give the same view.
+
+#pragma once
+
+#include "VaultSnapshotCodec.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// ============================================================================
+// FORMAT
+// ============================================================================
+
+constexpr char SNAPSHOT_MAGIC[8] = {'P', 'R', 'N', 'X', 'S', 'N', 'A', 'P'};
+constexpr uint32_t SNAPSHOT_FORMAT_VERSION = 2;     // Container version; 2 added the tick section
+constexpr uint32_t SNAPSHOT_LAYOUT_VERSION = 2;     // Agreement/Milestone layout version
+constexpr uint32_t SNAPSHOT_BLOCK_CAPACITY = 64;    // Agreements per block
+constexpr uint32_t SNAPSHOT_BLOCK_MAGIC = 0x4B4C4250;   // "PBLK"
+constexpr uint32_t SNAPSHOT_TRAILER_MAGIC = 0x444E4550; // "PEND"
+constexpr uint32_t SNAPSHOT_TICKS_MAGIC = 0x4B435450;   // "PTCK"
+
+using VaultTickActivity = TickActivity<DefaultVaultConfig>;
+
+enum class BlockEncoding : uint32_t {
+    RAW = 0,          // Canonical Agreement records, padding zeroed
+    COLUMNAR = 1      // Column-aware compressed records (VaultSnapshotCodec.h)
+};
+
+enum class SnapshotStatus : uint8_t {
+    OK = 0,
+    IO_ERROR = 1,
+    BAD_MAGIC = 2,
+    UNSUPPORTED_VERSION = 3,
+    LAYOUT_MISMATCH = 4,
+    CORRUPT_BLOCK = 5,
+    HASH_MISMATCH = 6,
+    CAPACITY_EXCEEDED = 7,
+    BUSY = 8,
+    INVARIANT_VIOLATION = 9,
+    OUT_OF_ORDER = 10
+};
+
+inline const char* snapshotStatusName(SnapshotStatus status) {
+    switch (status) {
+        case SnapshotStatus::OK: return "OK";
+        case SnapshotStatus::IO_ERROR: return "IO_ERROR";
+        case SnapshotStatus::BAD_MAGIC: return "BAD_MAGIC";
+        case SnapshotStatus::UNSUPPORTED_VERSION: return "UNSUPPORTED_VERSION";
+        case SnapshotStatus::LAYOUT_MISMATCH: return "LAYOUT_MISMATCH";
+        case SnapshotStatus::CORRUPT_BLOCK: return "CORRUPT_BLOCK";
+        case SnapshotStatus::HASH_MISMATCH: return "HASH_MISMATCH";
+        case SnapshotStatus::CAPACITY_EXCEEDED: return "CAPACITY_EXCEEDED";
+        case SnapshotStatus::BUSY: return "BUSY";
+        case SnapshotStatus::INVARIANT_VIOLATION: return "INVARIANT_VIOLATION";
+        case SnapshotStatus::OUT_OF_ORDER: return "OUT_OF_ORDER";
+    }
+    return "UNKNOWN";
+}
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t formatVersion;
+    uint32_t layoutVersion;
+    uint32_t recordSize;                   // sizeof(Agreement) when written
+    uint32_t blockCapacity;
+    uint64_t tick;                         // Tick boundary the view was captured at
+    uint64_t agreementCounter;
+    uint64_t totalValueLocked;
+    uint64_t totalValueReleased;
+    uint64_t protocolFeeAccrued;
+    QubicAddress protocolFeeRecipient;
+    uint8_t protocolFeeRecipientTail[32];  // Zero. Layout 1 kept 64 bytes of identity text across both fields
+    uint32_t agreementCount;               // activeAgreementCount at capture
+    uint32_t flags;                        // Reserved, must be 0
+};
+
+struct SnapshotBlockHeader {
+    uint32_t magic;
+    BlockEncoding encoding;
+    uint32_t firstSlot;
+    uint32_t count;
+    uint64_t payloadBytes;
+    uint64_t recordHash;                   // Hash of the decoded canonical records
+};
+
+struct SnapshotBlockIndexEntry {
+    uint64_t offset;                       // File offset of the block header
+    SnapshotBlockHeader block;
+};
+
+// Followed by the trees' first `span` entries: amounts for each flow, then
+// counts for each flow. Entries at or past span are zero and not stored.
+struct SnapshotTickSection {
+    uint32_t magic;
+    uint32_t bucketCount;                  // TICK_BUCKETS when written
+    uint64_t originTick;
+    uint32_t bucketShift;
+    uint32_t span;
+    uint64_t entryHash;                    // Hash of the entries that follow
+};
+
+struct SnapshotTrailer {
+    uint32_t magic;
+    uint32_t blockCount;
+    uint64_t indexOffset;
+};
+
+static_assert(std::is_trivially_copyable<Agreement>::value, "snapshot records are copied bytewise");
+static_assert(std::is_trivially_copyable<SnapshotHeader>::value, "snapshot header is copied bytewise");
+static_assert(sizeof(SnapshotHeader) == 136, "the container header is shared by every record layout");
+static_assert(sizeof(SnapshotTickSection) == 32, "tick section header has no padding");
+static_assert(SNAPSHOT_BLOCK_CAPACITY * 3 * 2 <= BlockAddressDictionary::TABLE_SIZE,
+              "block address dictionary must stay under half load");
+
+// ============================================================================
+// HASHING AND CANONICAL RECORDS
+// ============================================================================
+
+inline uint64_t snapshotMix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+/**
+ * Fast non-cryptographic 64-bit hash. Chaining calls through `seed` hashes a
+ * sequence of buffers as one stream.
+ */
+inline uint64_t snapshotHashBytes(uint64_t seed, const void* data, size_t length) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint64_t h = seed ^ (length * 0x9E3779B97F4A7C15ull);
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, 8);
+        h = (h ^ word) * 0x9E3779B97F4A7C15ull;
+        h ^= h >> 29;
+    }
+    uint64_t tail = 0;
+    for (size_t shift = 0; i < length; ++i, shift += 8) {
+        tail |= static_cast<uint64_t>(bytes[i]) << shift;
+    }
+    return snapshotMix(h ^ tail);
+}
+
+/**
+ * Copies an agreement field by field into zeroed storage so that padding bytes
+ * never leak into snapshots or hashes.
+ */
+inline void canonicalizeAgreement(const Agreement& in, Agreement& out) {
+    std::memset(static_cast<void*>(&out), 0, sizeof(Agreement));
+    out.id = in.id;
+    out.payer = in.payer;
+    out.beneficiary = in.beneficiary;
+    out.oracleAdmin = in.oracleAdmin;
+    out.totalAmount = in.totalAmount;
+    out.lockedAmount = in.lockedAmount;
+    out.releasedAmount = in.releasedAmount;
+    out.state = in.state;
+    out.createdAtTick = in.createdAtTick;
+    out.fundedAtTick = in.fundedAtTick;
+    out.timeoutTick = in.timeoutTick;
+    out.milestoneCount = in.milestoneCount;
+    for (uint32_t i = 0; i < MAX_MILESTONES_PER_AGREEMENT; ++i) {
+        const Milestone& src = in.milestones[i];
+        Milestone& dst = out.milestones[i];
+        dst.id = src.id;
+        dst.amount = src.amount;
+        dst.state = src.state;
+        dst.verifiedAtTick = src.verifiedAtTick;
+        dst.releasedAtTick = src.releasedAtTick;
+        dst.description = src.description;
+        dst.evidenceHash = src.evidenceHash;
+    }
+    out.title = in.title;
+    out.metadata = in.metadata;
+}
+
+/** Block hash: the canonical records chained through snapshotHashBytes. */
+template <typename Record>
+uint64_t hashAgreementRecords(const Record* canonical, uint32_t count) {
+    uint64_t hash = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        hash = snapshotHashBytes(hash, &canonical[i], sizeof(Record));
+    }
+    return hash;
+}
+
+inline SnapshotHeader makeSnapshotHeader(const PronexmaVaultState& vault, uint64_t tick) {
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.formatVersion = SNAPSHOT_FORMAT_VERSION;
+    header.layoutVersion = SNAPSHOT_LAYOUT_VERSION;
+    header.recordSize = sizeof(Agreement);
+    header.blockCapacity = SNAPSHOT_BLOCK_CAPACITY;
+    header.tick = tick;
+    header.agreementCounter = vault.agreementCounter;
+    header.totalValueLocked = vault.totalValueLocked;
+    header.totalValueReleased = vault.totalValueReleased;
+    header.protocolFeeAccrued = vault.protocolFeeAccrued;
+    header.protocolFeeRecipient = vault.protocolFeeRecipient;
+    header.agreementCount = vault.activeAgreementCount;
+    return header;
+}
+
+// ============================================================================
+// TICK SECTION
+// ============================================================================
+
+/** The tick-activity trees as a snapshot stores them. */
+struct SnapshotTicks {
+    SnapshotTickSection section;
+    std::vector<uint64_t> entries;         // 2 * TICK_FLOW_COUNT * section.span
+};
+
+/** Copies the entries in use, O(span); the vault can move on once this returns. */
+inline void captureSnapshotTicks(const VaultTickActivity& activity, SnapshotTicks& ticks) {
+    uint32_t span = activity.span;
+    ticks.section = {SNAPSHOT_TICKS_MAGIC, DefaultVaultConfig::TICK_BUCKETS, activity.originTick,
+                     activity.bucketShift, span, 0};
+    ticks.entries.resize(size_t(2) * TICK_FLOW_COUNT * span);
+    uint64_t* out = ticks.entries.data();
+    for (uint32_t f = 0; f < TICK_FLOW_COUNT; ++f, out += span) {
+        std::memcpy(out, activity.amounts[f].data(), span * sizeof(uint64_t));
+    }
+    for (uint32_t f = 0; f < TICK_FLOW_COUNT; ++f, out += span) {
+        std::memcpy(out, activity.counts[f].data(), span * sizeof(uint64_t));
+    }
+    ticks.section.entryHash = snapshotHashBytes(0, ticks.entries.data(), ticks.entries.size() * sizeof(uint64_t));
+}
+
+/** Checks a section header before its entries are read; span is 0 only for a never-initialized vault. */
+inline SnapshotStatus validateSnapshotTickSection(const SnapshotTickSection& section) {
+    if (section.magic != SNAPSHOT_TICKS_MAGIC) return SnapshotStatus::CORRUPT_BLOCK;
+    if (section.bucketCount != DefaultVaultConfig::TICK_BUCKETS) return SnapshotStatus::LAYOUT_MISMATCH;
+    bool spanValid = section.span <= section.bucketCount && (section.span & (section.span - 1)) == 0;
+    return spanValid && section.bucketShift < 64 ? SnapshotStatus::OK : SnapshotStatus::CORRUPT_BLOCK;
+}
+
+/** Checks the section header and that the entries match its span and hash. */
+inline SnapshotStatus verifySnapshotTicks(const SnapshotTicks& ticks) {
+    SnapshotStatus status = validateSnapshotTickSection(ticks.section);
+    if (status != SnapshotStatus::OK) return status;
+    if (ticks.entries.size() != size_t(2) * TICK_FLOW_COUNT * ticks.section.span) return SnapshotStatus::CORRUPT_BLOCK;
+    uint64_t hash = snapshotHashBytes(0, ticks.entries.data(), ticks.entries.size() * sizeof(uint64_t));
+    return hash == ticks.section.entryHash ? SnapshotStatus::OK : SnapshotStatus::HASH_MISMATCH;
+}
+
+/** Verifies the entries and replaces `activity` with them, clearing what it had in use. */
+inline SnapshotStatus installSnapshotTicks(const SnapshotTicks& ticks, VaultTickActivity& activity) {
+    SnapshotStatus status = verifySnapshotTicks(ticks);
+    if (status != SnapshotStatus::OK) return status;
+    const SnapshotTickSection& section = ticks.section;
+    resetTickActivity(activity, section.originTick);
+    const uint64_t* in = ticks.entries.data();
+    for (uint32_t f = 0; f < TICK_FLOW_COUNT; ++f, in += section.span) {
+        std::memcpy(activity.amounts[f].data(), in, section.span * sizeof(uint64_t));
+    }
+    for (uint32_t f = 0; f < TICK_FLOW_COUNT; ++f, in += section.span) {
+        std::memcpy(activity.counts[f].data(), in, section.span * sizeof(uint64_t));
+    }
+    activity.bucketShift = section.bucketShift;
+    activity.span = section.span;
+    return SnapshotStatus::OK;
+}
+
+// ============================================================================
+// BUFFERED FILE DESCRIPTOR I/O
+// ============================================================================
+
+class FdWriter {
+public:
+    explicit FdWriter(int fd, size_t bufferSize = 1 << 20) : fd_(fd) { buffer_.reserve(bufferSize); }
+
+    bool write(const void* data, size_t length) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        if (buffer_.size() + length > buffer_.capacity()) {
+            if (!flush()) return false;
+            if (length >= buffer_.capacity()) {
+                offset_ += length;
+                return writeAll(bytes, length);
+            }
+        }
+        buffer_.insert(buffer_.end(), bytes, bytes + length);
+        offset_ += length;
+        return true;
+    }
+
+    bool flush() {
+        bool ok = writeAll(buffer_.data(), buffer_.size());
+        buffer_.clear();
+        return ok;
+    }
+
+    uint64_t offset() const { return offset_; }
+
+private:
+    bool writeAll(const uint8_t* data, size_t length) {
+        while (length > 0) {
+            ssize_t written = ::write(fd_, data, length);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            data += written;
+            length -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    int fd_;
+    uint64_t offset_ = 0;
+    std::vector<uint8_t> buffer_;
+};
+
+class FdReader {
+public:
+    explicit FdReader(int fd, size_t bufferSize = 1 << 20) : fd_(fd), buffer_(bufferSize) {}
+
+    bool read(void* data, size_t length) {
+        uint8_t* out = static_cast<uint8_t*>(data);
+        while (length > 0) {
+            if (pos_ == end_ && !fill()) return false;
+            size_t chunk = std::min(length, end_ - pos_);
+            std::memcpy(out, buffer_.data() + pos_, chunk);
+            pos_ += chunk;
+            out += chunk;
+            length -= chunk;
+        }
+        return true;
+    }
+
+    bool seek(uint64_t offset) {
+        if (::lseek(fd_, static_cast<off_t>(offset), SEEK_SET) < 0) return false;
+        pos_ = end_ = 0;
+        return true;
+    }
+
+private:
+    bool fill() {
+        for (;;) {
+            ssize_t got = ::read(fd_, buffer_.data(), buffer_.size());
+            if (got < 0 && errno == EINTR) continue;
+            if (got <= 0) return false;
+            pos_ = 0;
+            end_ = static_cast<size_t>(got);
+            return true;
+        }
+    }
+
+    int fd_;
+    std::vector<uint8_t> buffer_;
+    size_t pos_ = 0;
+    size_t end_ = 0;
+};
+
+// ============================================================================
+// WRITER
+// ============================================================================
+
+/**
+ * Streams agreements into a snapshot. Call writeHeader once, appendAgreement
+ * for slots 0..agreementCount-1 in order, then finish with the tick section.
+ * appendAgreement is copyAgreement followed by flushFullBlock; callers that
+ * must stop reading the record before the block is encoded and written (the
+ * checkpointer) make the two calls themselves.
+ */
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(int fd, BlockEncoding encoding = BlockEncoding::RAW)
+        : out_(fd), encoding_(encoding), records_(SNAPSHOT_BLOCK_CAPACITY) {}
+
+    SnapshotStatus writeHeader(const SnapshotHeader& header) {
+        expected_ = header.agreementCount;
+        return out_.write(&header, sizeof(header)) ? SnapshotStatus::OK : SnapshotStatus::IO_ERROR;
+    }
+
+    SnapshotStatus appendAgreement(const Agreement& agreement) {
+        SnapshotStatus status = copyAgreement(agreement);
+        return status == SnapshotStatus::OK ? flushFullBlock() : status;
+    }
+
+    /** Copies `agreement` into the open block; no encoding, no I/O. */
+    SnapshotStatus copyAgreement(const Agreement& agreement) {
+        if (appended_ >= expected_) {
+            return SnapshotStatus::CAPACITY_EXCEEDED;
+        }
+        if (blockCount_ == 0) {
+            blockFirstSlot_ = appended_;
+        }
+        canonicalizeAgreement(agreement, records_[blockCount_]);
+        ++appended_;
+        ++blockCount_;
+        return SnapshotStatus::OK;
+    }
+
+    /** Encodes and writes the open block once it holds SNAPSHOT_BLOCK_CAPACITY records. */
+    SnapshotStatus flushFullBlock() {
+        return blockCount_ == SNAPSHOT_BLOCK_CAPACITY ? flushBlock() : SnapshotStatus::OK;
+    }
+
+    SnapshotStatus finish(const SnapshotTicks& ticks) {
+        if (appended_ != expected_) {
+            return SnapshotStatus::CORRUPT_BLOCK;
+        }
+        if (blockCount_ > 0) {
+            SnapshotStatus status = flushBlock();
+            if (status != SnapshotStatus::OK) return status;
+        }
+        if (!out_.write(&ticks.section, sizeof(ticks.section)) ||
+            !out_.write(ticks.entries.data(), ticks.entries.size() * sizeof(uint64_t))) {
+            return SnapshotStatus::IO_ERROR;
+        }
+        SnapshotTrailer trailer{SNAPSHOT_TRAILER_MAGIC, static_cast<uint32_t>(index_.size()), out_.offset()};
+        bool ok = out_.write(index_.data(), index_.size() * sizeof(SnapshotBlockIndexEntry)) &&
+                  out_.write(&trailer, sizeof(trailer)) &&
+                  out_.flush();
+        return ok ? SnapshotStatus::OK : SnapshotStatus::IO_ERROR;
+    }
+
+    uint64_t bytesWritten() const { return out_.offset(); }
+
+private:
+    SnapshotStatus flushBlock() {
+        const uint8_t* payload = reinterpret_cast<const uint8_t*>(records_.data());
+        size_t payloadBytes = size_t(blockCount_) * sizeof(Agreement);
+        BlockEncoding encoding = BlockEncoding::RAW;
+        if (encoding_ == BlockEncoding::COLUMNAR) {
+            encodeColumnarBlock(records_.data(), blockCount_, dictionary_, payload_);
+            // Incompressible blocks (e.g. dense evidence hashes) stay RAW.
+            if (payload_.size() < payloadBytes) {
+                encoding = BlockEncoding::COLUMNAR;
+                payload = payload_.data();
+                payloadBytes = payload_.size();
+            }
+        }
+
+        SnapshotBlockIndexEntry entry;
+        entry.offset = out_.offset();
+        entry.block.magic = SNAPSHOT_BLOCK_MAGIC;
+        entry.block.encoding = encoding;
+        entry.block.firstSlot = blockFirstSlot_;
+        entry.block.count = blockCount_;
+        entry.block.payloadBytes = payloadBytes;
+        entry.block.recordHash = hashAgreementRecords(records_.data(), blockCount_);
+        index_.push_back(entry);
+        blockCount_ = 0;
+        bool ok = out_.write(&entry.block, sizeof(entry.block)) &&
+                  out_.write(payload, payloadBytes);
+        return ok ? SnapshotStatus::OK : SnapshotStatus::IO_ERROR;
+    }
+
+    FdWriter out_;
+    BlockEncoding encoding_;
+    uint32_t expected_ = 0;
+    uint32_t appended_ = 0;
+    uint32_t blockFirstSlot_ = 0;
+    uint32_t blockCount_ = 0;
+    std::vector<Agreement> records_;       // Canonical records of the open block
+    std::vector<uint8_t> payload_;
+    BlockAddressDictionary dictionary_;
+    std::vector<SnapshotBlockIndexEntry> index_;
+};
+
+/**
+ * Makes a finished snapshot durable: fsync the temporary file, then atomically
+ * rename it over the destination so readers never observe a torn image.
+ */
+inline SnapshotStatus commitSnapshotFile(int fd, const std::string& tmpPath, const std::string& path) {
+    bool ok = ::fsync(fd) == 0;
+    ok = (::close(fd) == 0) && ok;
+    if (!ok || ::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        ::unlink(tmpPath.c_str());
+        return SnapshotStatus::IO_ERROR;
+    }
+    return SnapshotStatus::OK;
+}
+
+/**
+ * Writes a snapshot synchronously. Execution is stalled for the full
+ * serialize + fsync; use VaultCheckpointer to keep ticks running.
+ */
+inline SnapshotStatus writeSnapshot(const PronexmaVaultState& vault, uint64_t tick, const std::string& path,
+                                    BlockEncoding encoding = BlockEncoding::RAW) {
+    std::string tmpPath = path + ".tmp";
+    int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return SnapshotStatus::IO_ERROR;
+    }
+    SnapshotWriter writer(fd, encoding);
+    SnapshotStatus status = writer.writeHeader(makeSnapshotHeader(vault, tick));
+    for (uint32_t i = 0; status == SnapshotStatus::OK && i < vault.activeAgreementCount; ++i) {
+        status = writer.appendAgreement(vault.agreements[i]);
+    }
+    if (status == SnapshotStatus::OK) {
+        SnapshotTicks ticks;
+        captureSnapshotTicks(vault.tickActivity, ticks);
+        status = writer.finish(ticks);
+    }
+    if (status != SnapshotStatus::OK) {
+        ::close(fd);
+        ::unlink(tmpPath.c_str());
+        return status;
+    }
+    return commitSnapshotFile(fd, tmpPath, path);
+}
+
+// ============================================================================
+// READER
+// ============================================================================
+
+/** Checks the container only; records may use any layout and the file any format version. */
+inline SnapshotStatus validateSnapshotContainer(const SnapshotHeader& header) {
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0) {
+        return SnapshotStatus::BAD_MAGIC;
+    }
+    if (header.formatVersion == 0 || header.formatVersion > SNAPSHOT_FORMAT_VERSION) {
+        return SnapshotStatus::UNSUPPORTED_VERSION;
+    }
+    if (header.agreementCount > MAX_AGREEMENTS || header.blockCapacity > SNAPSHOT_BLOCK_CAPACITY) {
+        return SnapshotStatus::CAPACITY_EXCEEDED;
+    }
+    return SnapshotStatus::OK;
+}
+
+inline SnapshotStatus validateSnapshotHeader(const SnapshotHeader& header) {
+    SnapshotStatus status = validateSnapshotContainer(header);
+    if (status != SnapshotStatus::OK) {
+        return status;
+    }
+    // Earlier formats and layouts are read through the migration (VaultMigration.h).
+    if (header.formatVersion != SNAPSHOT_FORMAT_VERSION || header.layoutVersion != SNAPSHOT_LAYOUT_VERSION ||
+        header.recordSize != sizeof(Agreement)) {
+        return SnapshotStatus::LAYOUT_MISMATCH;
+    }
+    return SnapshotStatus::OK;
+}
+
+/**
+ * Decodes a block payload into `out[0..block.count)` and verifies its hash.
+ * Record is Agreement, or an earlier layout's record (VaultMigration.h).
+ */
+template <typename Record>
+SnapshotStatus decodeSnapshotBlock(const SnapshotBlockHeader& block, const uint8_t* payload, Record* out) {
+    if (block.magic != SNAPSHOT_BLOCK_MAGIC || block.count > SNAPSHOT_BLOCK_CAPACITY) {
+        return SnapshotStatus::CORRUPT_BLOCK;
+    }
+    switch (block.encoding) {
+        case BlockEncoding::RAW:
+            if (block.payloadBytes != uint64_t(block.count) * sizeof(Record)) {
+                return SnapshotStatus::CORRUPT_BLOCK;
+            }
+            std::memcpy(static_cast<void*>(out), payload, block.payloadBytes);
+            break;
+        case BlockEncoding::COLUMNAR:
+            if (!decodeColumnarBlock(payload, block.payloadBytes, block.count, out)) {
+                return SnapshotStatus::CORRUPT_BLOCK;
+            }
+            break;
+        default:
+            return SnapshotStatus::UNSUPPORTED_VERSION;
+    }
+    return block.recordHash == hashAgreementRecords(out, block.count) ? SnapshotStatus::OK : SnapshotStatus::HASH_MISMATCH;
+}
+
+/**
+ * Sequential block reader. Works on pipes as well as files.
+ */
+class SnapshotReader {
+public:
+    explicit SnapshotReader(int fd) : in_(fd) {}
+
+    SnapshotStatus readHeader(SnapshotHeader& header) {
+        SnapshotStatus status = readHeaderAnyLayout(header);
+        return status == SnapshotStatus::OK ? validateSnapshotHeader(header) : status;
+    }
+
+    /** Accepts any record layout; pair with readRawBlock (see VaultMigration.h). */
+    SnapshotStatus readHeaderAnyLayout(SnapshotHeader& header) {
+        if (!in_.read(&header, sizeof(header))) return SnapshotStatus::IO_ERROR;
+        remaining_ = header.agreementCount;
+        nextSlot_ = 0;
+        recordSize_ = header.recordSize;
+        return validateSnapshotContainer(header);
+    }
+
+    bool done() const { return remaining_ == 0; }
+    uint32_t nextSlot() const { return nextSlot_; }
+
+    /** Reads the next block's framing and undecoded payload. */
+    SnapshotStatus readRawBlock(SnapshotBlockHeader& block, std::vector<uint8_t>& payload) {
+        if (!in_.read(&block, sizeof(block))) return SnapshotStatus::IO_ERROR;
+        if (block.magic != SNAPSHOT_BLOCK_MAGIC || block.firstSlot != nextSlot_ ||
+            block.count == 0 || block.count > remaining_ || block.count > SNAPSHOT_BLOCK_CAPACITY ||
+            block.payloadBytes > uint64_t(SNAPSHOT_BLOCK_CAPACITY) * recordSize_) {
+            return SnapshotStatus::CORRUPT_BLOCK;
+        }
+        payload.resize(block.payloadBytes);
+        if (!in_.read(payload.data(), payload.size())) return SnapshotStatus::IO_ERROR;
+        nextSlot_ += block.count;
+        remaining_ -= block.count;
+        return SnapshotStatus::OK;
+    }
+
+    /** Reads the next block into `out`, which must have room for the remaining records. */
+    SnapshotStatus readBlock(SnapshotBlockHeader& block, Agreement* out) {
+        SnapshotStatus status = readRawBlock(block, payload_);
+        return status == SnapshotStatus::OK ? decodeSnapshotBlock(block, payload_.data(), out) : status;
+    }
+
+    /** Reads the tick section that follows the last block (format 2). Entries are verified on install. */
+    SnapshotStatus readTicks(SnapshotTicks& ticks) {
+        if (!done()) return SnapshotStatus::OUT_OF_ORDER;
+        if (!in_.read(&ticks.section, sizeof(ticks.section))) return SnapshotStatus::IO_ERROR;
+        SnapshotStatus status = validateSnapshotTickSection(ticks.section);
+        if (status != SnapshotStatus::OK) return status;
+        ticks.entries.resize(size_t(2) * TICK_FLOW_COUNT * ticks.section.span);
+        return in_.read(ticks.entries.data(), ticks.entries.size() * sizeof(uint64_t)) ? SnapshotStatus::OK
+                                                                                       : SnapshotStatus::IO_ERROR;
+    }
+
+private:
+    FdReader in_;
+    uint32_t remaining_ = 0;
+    uint32_t nextSlot_ = 0;
+    uint32_t recordSize_ = 0;
+    std::vector<uint8_t> payload_;
+};
+
+/** INVARIANT_VIOLATION unless every record's own books balance (agreementBalanced). */
+inline SnapshotStatus checkSnapshotRecords(const Agreement* records, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i) {
+        if (!agreementBalanced(records[i])) return SnapshotStatus::INVARIANT_VIOLATION;
+    }
+    return SnapshotStatus::OK;
+}
+
+/**
+ * Sets the vault counters and installs the tick trees once every block is in
+ * place, then checks the accounting identities the contract checks after
+ * every call; a snapshot that breaks them is rejected with INVARIANT_VIOLATION.
+ */
+inline SnapshotStatus applySnapshotHeader(const SnapshotHeader& header, const SnapshotTicks& ticks,
+                                          PronexmaVaultState& vault) {
+    SnapshotStatus status = installSnapshotTicks(ticks, vault.tickActivity);
+    if (status != SnapshotStatus::OK) return status;
+    vault.agreementCounter = header.agreementCounter;
+    vault.totalValueLocked = header.totalValueLocked;
+    vault.totalValueReleased = header.totalValueReleased;
+    vault.protocolFeeAccrued = header.protocolFeeAccrued;
+    vault.protocolFeeRecipient = header.protocolFeeRecipient;
+    retireAgreementSlots(vault);
+    vault.activeAgreementCount = header.agreementCount;
+    rebuildCapacityCounters(vault);
+    rebuildAccountingCounters(vault);
+    rebuildAgreementColumns(vault);
+    return checkAccountingInvariants(vault) == AccountingViolation::NONE ? SnapshotStatus::OK
+                                                                         : SnapshotStatus::INVARIANT_VIOLATION;
+}
+
+/**
+ * Restores a snapshot into `vault`. On failure `vault` may be partially written.
+ */
+inline SnapshotStatus readSnapshot(const std::string& path, PronexmaVaultState& vault, SnapshotHeader* headerOut = nullptr) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return SnapshotStatus::IO_ERROR;
+    }
+    SnapshotReader reader(fd);
+    SnapshotHeader header;
+    SnapshotStatus status = reader.readHeader(header);
+    while (status == SnapshotStatus::OK && !reader.done()) {
+        SnapshotBlockHeader block;
+        Agreement* out = &vault.agreements[reader.nextSlot()];
+        status = reader.readBlock(block, out);
+        if (status == SnapshotStatus::OK) status = checkSnapshotRecords(out, block.count);
+    }
+    SnapshotTicks ticks;
+    if (status == SnapshotStatus::OK) status = reader.readTicks(ticks);
+    ::close(fd);
+    if (status == SnapshotStatus::OK) status = applySnapshotHeader(header, ticks, vault);
+    if (status == SnapshotStatus::OK && headerOut != nullptr) *headerOut = header;
+    return status;
+}
+
+// ============================================================================
+// RANDOM ACCESS
+// ============================================================================
+
+inline bool preadAll(int fd, void* data, size_t length, uint64_t offset) {
+    uint8_t* out = static_cast<uint8_t*>(data);
+    while (length > 0) {
+        ssize_t got = ::pread(fd, out, length, static_cast<off_t>(offset));
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return false;
+        out += got;
+        offset += static_cast<uint64_t>(got);
+        length -= static_cast<size_t>(got);
+    }
+    return true;
+}
+
+/**
+ * Reads the header and the trailing block index of a snapshot file. The index
+ * is checked to cover slots 0..agreementCount-1 contiguously.
+ */
+inline SnapshotStatus readSnapshotBlockIndex(int fd, SnapshotHeader& header, std::vector<SnapshotBlockIndexEntry>& index) {
+    if (!preadAll(fd, &header, sizeof(header), 0)) return SnapshotStatus::IO_ERROR;
+    SnapshotStatus status = validateSnapshotHeader(header);
+    if (status != SnapshotStatus::OK) return status;
+
+    off_t fileSize = ::lseek(fd, 0, SEEK_END);
+    if (fileSize < static_cast<off_t>(sizeof(SnapshotHeader) + sizeof(SnapshotTrailer))) {
+        return SnapshotStatus::CORRUPT_BLOCK;
+    }
+    SnapshotTrailer trailer;
+    uint64_t trailerOffset = static_cast<uint64_t>(fileSize) - sizeof(trailer);
+    if (!preadAll(fd, &trailer, sizeof(trailer), trailerOffset)) return SnapshotStatus::IO_ERROR;
+    if (trailer.magic != SNAPSHOT_TRAILER_MAGIC ||
+        trailer.indexOffset + uint64_t(trailer.blockCount) * sizeof(SnapshotBlockIndexEntry) != trailerOffset) {
+        return SnapshotStatus::CORRUPT_BLOCK;
+    }
+
+    index.resize(trailer.blockCount);
+    if (!preadAll(fd, index.data(), index.size() * sizeof(SnapshotBlockIndexEntry), trailer.indexOffset)) {
+        return SnapshotStatus::IO_ERROR;
+    }
+    uint32_t nextSlot = 0;
+    for (const SnapshotBlockIndexEntry& entry : index) {
+        const SnapshotBlockHeader& block = entry.block;
+        if (block.magic != SNAPSHOT_BLOCK_MAGIC || block.firstSlot != nextSlot ||
+            block.count == 0 || block.count > SNAPSHOT_BLOCK_CAPACITY ||
+            entry.offset + sizeof(SnapshotBlockHeader) + block.payloadBytes > trailer.indexOffset) {
+            return SnapshotStatus::CORRUPT_BLOCK;
+        }
+        nextSlot += block.count;
+    }
+    return nextSlot == header.agreementCount ? SnapshotStatus::OK : SnapshotStatus::CORRUPT_BLOCK;
+}
+
+/** Reads the tick section, which starts where the last block in `index` ends. */
+inline SnapshotStatus readSnapshotTicksAt(int fd, const std::vector<SnapshotBlockIndexEntry>& index,
+                                          SnapshotTicks& ticks) {
+    uint64_t offset = sizeof(SnapshotHeader);
+    if (!index.empty()) offset = index.back().offset + sizeof(SnapshotBlockHeader) + index.back().block.payloadBytes;
+    if (!preadAll(fd, &ticks.section, sizeof(ticks.section), offset)) return SnapshotStatus::IO_ERROR;
+    SnapshotStatus status = validateSnapshotTickSection(ticks.section);
+    if (status != SnapshotStatus::OK) return status;
+    ticks.entries.resize(size_t(2) * TICK_FLOW_COUNT * ticks.section.span);
+    bool ok = preadAll(fd, ticks.entries.data(), ticks.entries.size() * sizeof(uint64_t), offset + sizeof(ticks.section));
+    return ok ? SnapshotStatus::OK : SnapshotStatus::IO_ERROR;
+}
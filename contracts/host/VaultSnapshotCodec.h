@@ -0,0 +1,376 @@
+// contracts/host/VaultSnapshotCodec.h
+// Pronexma Protocol - Column-aware block encoding for vault snapshots
+//
+// Vault images are dominated by zero padding (title, metadata, milestone
+// descriptions, unused milestone slots) and by a small set of repeated
+// addresses. A COLUMNAR block stores each field as its own column:
+//
+//   varint dictSize, dictSize * zrle(address)    per-block address dictionary
+//   id                 varint first id, then zigzag deltas
+//   payer, beneficiary, oracleAdmin              varint dictionary indexes
+//   totalAmount, lockedAmount, releasedAmount    varints
+//   state              one byte per record
+//   createdAtTick, fundedAtTick                  varints
+//   timeoutTick        zigzag delta from fundedAtTick
+//   milestoneCount, usedMilestoneSlots           varints
+//   milestone columns over every used slot of every record:
+//     id, amount, state, verifiedAtTick, releasedAtTick (zigzag delta),
+//     zrle(description), zrle(evidenceHash)
+//   zrle(title), zrle(metadata)
+//
+// zrle(bytes) alternates varint(literalLength) literal varint(zeroRunLength)
+// until the fixed field length is covered. Milestone slots past
+// usedMilestoneSlots are all-zero in canonical form and are not stored.
+//
+// Blocks are self-contained so they can be decoded independently. The codec is
+// written against the record's fields, so earlier record layouts (see
+// VaultMigration.h) reuse it.
+
+#pragma once
+
+#include "PronexmaVault.cpp"
+
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// ============================================================================
+// PRIMITIVES
+// ============================================================================
+
+class ByteSink {
+public:
+    explicit ByteSink(std::vector<uint8_t>& out) : out_(out) {}
+
+    void byte(uint8_t value) { out_.push_back(value); }
+
+    void bytes(const void* data, size_t length) {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        out_.insert(out_.end(), p, p + length);
+    }
+
+    void varint(uint64_t value) {
+        uint8_t buffer[10];
+        size_t n = 0;
+        while (value >= 0x80) {
+            buffer[n++] = static_cast<uint8_t>(value) | 0x80;
+            value >>= 7;
+        }
+        buffer[n++] = static_cast<uint8_t>(value);
+        bytes(buffer, n);
+    }
+
+    void zigzag(uint64_t value, uint64_t base) {
+        int64_t delta = static_cast<int64_t>(value - base);
+        varint((static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63));
+    }
+
+    void zrle(const void* data, size_t length) {
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        size_t pos = 0;
+        while (pos < length) {
+            size_t literal = pos;
+            while (literal < length && p[literal] != 0) ++literal;
+            size_t zeros = literal;
+            while (zeros < length && p[zeros] == 0) ++zeros;
+            varint(literal - pos);
+            bytes(p + pos, literal - pos);
+            varint(zeros - literal);
+            pos = zeros;
+        }
+    }
+
+private:
+    std::vector<uint8_t>& out_;
+};
+
+/**
+ * Bounds-checked reader. Any overrun latches `ok() == false` and yields zeros,
+ * so decoders check once at the end instead of after every field.
+ */
+class ByteSource {
+public:
+    ByteSource(const uint8_t* data, size_t length) : p_(data), end_(data + length) {}
+
+    bool ok() const { return ok_; }
+    bool exhausted() const { return p_ == end_; }
+
+    uint8_t byte() {
+        if (p_ == end_) return fail();
+        return *p_++;
+    }
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            if (p_ == end_) return fail();
+            uint8_t b = *p_++;
+            value |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if ((b & 0x80) == 0) return value;
+        }
+        return fail();
+    }
+
+    uint64_t zigzag(uint64_t base) {
+        uint64_t raw = varint();
+        uint64_t delta = (raw >> 1) ^ (~(raw & 1) + 1);
+        return base + delta;
+    }
+
+    // Decodes into `out`, which the caller has already zeroed.
+    void zrle(void* out, size_t length) {
+        uint8_t* dst = static_cast<uint8_t*>(out);
+        size_t pos = 0;
+        while (pos < length && ok_) {
+            uint64_t literal = varint();
+            if (literal > length - pos || literal > static_cast<size_t>(end_ - p_)) {
+                fail();
+                return;
+            }
+            std::memcpy(dst + pos, p_, literal);
+            p_ += literal;
+            pos += literal;
+            uint64_t zeros = varint();
+            if (zeros > length - pos || (literal == 0 && zeros == 0)) {
+                fail();
+                return;
+            }
+            pos += zeros;
+        }
+    }
+
+private:
+    uint8_t fail() {
+        ok_ = false;
+        p_ = end_;
+        return 0;
+    }
+
+    const uint8_t* p_;
+    const uint8_t* end_;
+    bool ok_ = true;
+};
+
+// ============================================================================
+// ADDRESS DICTIONARY
+// ============================================================================
+
+template <typename Address>
+class BasicBlockAddressDictionary {
+public:
+    BasicBlockAddressDictionary() { clear(); }
+
+    void clear() {
+        entries_.clear();
+        std::memset(table_, 0, sizeof(table_));
+    }
+
+    uint32_t intern(const Address& address) {
+        uint64_t h = hashAddress(address);
+        for (uint32_t probe = 0;; ++probe) {
+            uint32_t bucket = static_cast<uint32_t>(h + probe) & (TABLE_SIZE - 1);
+            uint32_t entry = table_[bucket];
+            if (entry == 0) {
+                entries_.push_back(address);
+                table_[bucket] = static_cast<uint32_t>(entries_.size());
+                return static_cast<uint32_t>(entries_.size() - 1);
+            }
+            if (entries_[entry - 1] == address) {
+                return entry - 1;
+            }
+        }
+    }
+
+    const std::vector<Address>& entries() const { return entries_; }
+
+    // Open-addressing slots; a block may intern at most TABLE_SIZE / 2 addresses.
+    static constexpr uint32_t TABLE_SIZE = 512;
+
+private:
+    static_assert(sizeof(Address) % 8 == 0, "addresses are hashed a word at a time");
+
+    static uint64_t hashAddress(const Address& address) {
+        uint64_t h = 0xCBF29CE484222325ull;
+        for (size_t i = 0; i < address.size(); i += 8) {
+            uint64_t word;
+            std::memcpy(&word, address.data() + i, 8);
+            h = (h ^ word) * 0x100000001B3ull;
+        }
+        return h ^ (h >> 31);
+    }
+
+    std::vector<Address> entries_;
+    uint32_t table_[TABLE_SIZE];
+};
+
+using BlockAddressDictionary = BasicBlockAddressDictionary<QubicAddress>;
+
+// ============================================================================
+// BLOCK CODEC
+// ============================================================================
+
+// Field types of a record layout.
+template <typename Record>
+using RecordAddress = typename std::remove_cv<decltype(Record::payer)>::type;
+template <typename Record>
+using RecordMilestone = typename decltype(Record::milestones)::value_type;
+template <typename Record>
+constexpr uint32_t recordMilestoneSlots() {
+    return static_cast<uint32_t>(std::tuple_size<decltype(Record::milestones)>::value);
+}
+
+template <typename Record>
+uint32_t usedMilestoneSlots(const Record& canonical) {
+    using MilestoneRecord = RecordMilestone<Record>;
+    static const MilestoneRecord zero{};
+    uint32_t used = recordMilestoneSlots<Record>();
+    while (used > 0 && std::memcmp(&canonical.milestones[used - 1], &zero, sizeof(MilestoneRecord)) == 0) {
+        --used;
+    }
+    return used;
+}
+
+/**
+ * Encodes `count` canonical records (padding zeroed) as a COLUMNAR payload.
+ */
+template <typename Record>
+void encodeColumnarBlock(const Record* records, uint32_t count,
+                         BasicBlockAddressDictionary<RecordAddress<Record>>& dictionary, std::vector<uint8_t>& out) {
+    out.clear();
+    ByteSink sink(out);
+
+    dictionary.clear();
+    std::vector<uint32_t> addressIndexes(size_t(count) * 3);
+    for (uint32_t i = 0; i < count; ++i) {
+        addressIndexes[i * 3 + 0] = dictionary.intern(records[i].payer);
+        addressIndexes[i * 3 + 1] = dictionary.intern(records[i].beneficiary);
+        addressIndexes[i * 3 + 2] = dictionary.intern(records[i].oracleAdmin);
+    }
+    sink.varint(dictionary.entries().size());
+    for (const RecordAddress<Record>& address : dictionary.entries()) {
+        sink.zrle(address.data(), address.size());
+    }
+
+    uint64_t previousId = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        sink.zigzag(records[i].id, previousId);
+        previousId = records[i].id;
+    }
+    for (uint32_t column = 0; column < 3; ++column) {
+        for (uint32_t i = 0; i < count; ++i) sink.varint(addressIndexes[i * 3 + column]);
+    }
+    for (uint32_t i = 0; i < count; ++i) sink.varint(records[i].totalAmount);
+    for (uint32_t i = 0; i < count; ++i) sink.varint(records[i].lockedAmount);
+    for (uint32_t i = 0; i < count; ++i) sink.varint(records[i].releasedAmount);
+    for (uint32_t i = 0; i < count; ++i) sink.byte(static_cast<uint8_t>(records[i].state));
+    for (uint32_t i = 0; i < count; ++i) sink.varint(records[i].createdAtTick);
+    for (uint32_t i = 0; i < count; ++i) sink.varint(records[i].fundedAtTick);
+    for (uint32_t i = 0; i < count; ++i) sink.zigzag(records[i].timeoutTick, records[i].fundedAtTick);
+    for (uint32_t i = 0; i < count; ++i) sink.varint(records[i].milestoneCount);
+
+    std::vector<uint8_t> used(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        used[i] = static_cast<uint8_t>(usedMilestoneSlots(records[i]));
+        sink.varint(used[i]);
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        for (uint32_t m = 0; m < used[i]; ++m) sink.varint(records[i].milestones[m].id);
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        for (uint32_t m = 0; m < used[i]; ++m) sink.varint(records[i].milestones[m].amount);
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        for (uint32_t m = 0; m < used[i]; ++m) sink.byte(static_cast<uint8_t>(records[i].milestones[m].state));
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        for (uint32_t m = 0; m < used[i]; ++m) {
+            const RecordMilestone<Record>& milestone = records[i].milestones[m];
+            sink.varint(milestone.verifiedAtTick);
+            sink.zigzag(milestone.releasedAtTick, milestone.verifiedAtTick);
+        }
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        for (uint32_t m = 0; m < used[i]; ++m) {
+            const RecordMilestone<Record>& milestone = records[i].milestones[m];
+            sink.zrle(milestone.description.data(), milestone.description.size());
+            sink.zrle(milestone.evidenceHash.data(), milestone.evidenceHash.size());
+        }
+    }
+    for (uint32_t i = 0; i < count; ++i) sink.zrle(records[i].title.data(), records[i].title.size());
+    for (uint32_t i = 0; i < count; ++i) sink.zrle(records[i].metadata.data(), records[i].metadata.size());
+}
+
+/**
+ * Decodes a COLUMNAR payload into `out[0..count)`. Returns false on malformed
+ * input; the caller still verifies the block hash on success.
+ */
+template <typename Record>
+bool decodeColumnarBlock(const uint8_t* payload, size_t length, uint32_t count, Record* out) {
+    using Address = RecordAddress<Record>;
+    std::memset(static_cast<void*>(out), 0, size_t(count) * sizeof(Record));
+    ByteSource src(payload, length);
+
+    uint64_t dictSize = src.varint();
+    if (!src.ok() || dictSize > uint64_t(count) * 3) return false;
+    std::vector<Address> dictionary(dictSize);
+    for (Address& address : dictionary) {
+        address = {};
+        src.zrle(address.data(), address.size());
+    }
+
+    uint64_t previousId = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        out[i].id = src.zigzag(previousId);
+        previousId = out[i].id;
+    }
+    Address Record::*addressColumns[3] = {&Record::payer, &Record::beneficiary, &Record::oracleAdmin};
+    for (Address Record::*column : addressColumns) {
+        for (uint32_t i = 0; i < count; ++i) {
+            uint64_t index = src.varint();
+            if (index >= dictSize) return false;
+            out[i].*column = dictionary[index];
+        }
+    }
+    for (uint32_t i = 0; i < count; ++i) out[i].totalAmount = src.varint();
+    for (uint32_t i = 0; i < count; ++i) out[i].lockedAmount = src.varint();
+    for (uint32_t i = 0; i < count; ++i) out[i].releasedAmount = src.varint();
+    for (uint32_t i = 0; i < count; ++i) out[i].state = static_cast<AgreementState>(src.byte());
+    for (uint32_t i = 0; i < count; ++i) out[i].createdAtTick = src.varint();
+    for (uint32_t i = 0; i < count; ++i) out[i].fundedAtTick = src.varint();
+    for (uint32_t i = 0; i < count; ++i) out[i].timeoutTick = src.zigzag(out[i].fundedAtTick);
+    for (uint32_t i = 0; i < count; ++i) out[i].milestoneCount = static_cast<uint32_t>(src.varint());
+
+    std::vector<uint8_t> used(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        uint64_t slots = src.varint();
+        if (slots > recordMilestoneSlots<Record>()) return false;
+        used[i] = static_cast<uint8_t>(slots);
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        for (uint32_t m = 0; m < used[i]; ++m) out[i].milestones[m].id = static_cast<uint32_t>(src.varint());
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        for (uint32_t m = 0; m < used[i]; ++m) out[i].milestones[m].amount = src.varint();
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        for (uint32_t m = 0; m < used[i]; ++m) out[i].milestones[m].state = static_cast<MilestoneState>(src.byte());
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        for (uint32_t m = 0; m < used[i]; ++m) {
+            RecordMilestone<Record>& milestone = out[i].milestones[m];
+            milestone.verifiedAtTick = src.varint();
+            milestone.releasedAtTick = src.zigzag(milestone.verifiedAtTick);
+        }
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        for (uint32_t m = 0; m < used[i]; ++m) {
+            RecordMilestone<Record>& milestone = out[i].milestones[m];
+            src.zrle(milestone.description.data(), milestone.description.size());
+            src.zrle(milestone.evidenceHash.data(), milestone.evidenceHash.size());
+        }
+    }
+    for (uint32_t i = 0; i < count; ++i) src.zrle(out[i].title.data(), out[i].title.size());
+    for (uint32_t i = 0; i < count; ++i) src.zrle(out[i].metadata.data(), out[i].metadata.size());
+
+    return src.ok() && src.exhausted();
+}
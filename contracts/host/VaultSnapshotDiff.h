@@ -0,0 +1,235 @@
+// contracts/host/VaultSnapshotDiff.h
+// Pronexma Protocol - Field-level diff of two vault snapshots
+//
+// Only the block indexes are read up front. Blocks covering the same slots
+// with equal record hashes are skipped; the rest are decoded and compared
+// field by field, slot by slot (block boundaries need not line up). A handful
+// of changes in a 10,000-agreement vault therefore decodes a handful of blocks.
+// The tick sections are compared bucket by bucket when their buckets line up,
+// and by each flow's total when they do not.
+
+#pragma once
+
+#include "VaultFields.h"
+#include "VaultSnapshot.h"
+
+#include <cstdint>
+
+struct SnapshotFieldDelta {
+    uint32_t slot;                         // AGREEMENT_NOT_FOUND for header fields
+    uint64_t agreementId;                  // ID in the right-hand snapshot (or left if removed)
+    std::string field;
+    std::string before;
+    std::string after;
+};
+
+struct SnapshotDiff {
+    std::vector<SnapshotFieldDelta> deltas;
+    uint32_t changedAgreements = 0;
+    uint32_t addedAgreements = 0;          // Slots only present on the right
+    uint32_t removedAgreements = 0;        // Slots only present on the left
+    uint32_t blocksCompared = 0;
+    uint32_t blocksDecoded = 0;
+
+    bool identical() const { return deltas.empty(); }
+};
+
+namespace diff_detail {
+
+inline void compareScalar(SnapshotDiff& diff, const char* field, uint64_t before, uint64_t after) {
+    if (before != after) {
+        diff.deltas.push_back({AGREEMENT_NOT_FOUND, 0, field, std::to_string(before), std::to_string(after)});
+    }
+}
+
+inline void compareHeaders(const SnapshotHeader& left, const SnapshotHeader& right, SnapshotDiff& diff) {
+    compareScalar(diff, "header.agreementCounter", left.agreementCounter, right.agreementCounter);
+    compareScalar(diff, "header.totalValueLocked", left.totalValueLocked, right.totalValueLocked);
+    compareScalar(diff, "header.totalValueReleased", left.totalValueReleased, right.totalValueReleased);
+    compareScalar(diff, "header.protocolFeeAccrued", left.protocolFeeAccrued, right.protocolFeeAccrued);
+    compareScalar(diff, "header.agreementCount", left.agreementCount, right.agreementCount);
+    if (left.protocolFeeRecipient != right.protocolFeeRecipient) {
+        diff.deltas.push_back({AGREEMENT_NOT_FOUND, 0, "header.protocolFeeRecipient",
+                               addressIdentity(left.protocolFeeRecipient),
+                               addressIdentity(right.protocolFeeRecipient)});
+    }
+}
+
+// Per-bucket values of tree `tree` (amounts for each flow, then counts) of a tick section.
+inline void sectionBuckets(const SnapshotTicks& ticks, uint32_t tree, TickActivity<DefaultVaultConfig>::Tree& out) {
+    const uint32_t span = ticks.section.span;
+    out.fill(0);
+    std::memcpy(out.data(), ticks.entries.data() + size_t(tree) * span, span * sizeof(uint64_t));
+    fenwickToBuckets(out, span);
+}
+
+inline void compareTicks(const SnapshotTicks& left, const SnapshotTicks& right, SnapshotDiff& diff) {
+    const SnapshotTickSection& l = left.section;
+    const SnapshotTickSection& r = right.section;
+    compareScalar(diff, "ticks.originTick", l.originTick, r.originTick);
+    compareScalar(diff, "ticks.bucketShift", l.bucketShift, r.bucketShift);
+    compareScalar(diff, "ticks.span", l.span, r.span);
+    if (l.span == r.span && left.entries == right.entries) return;
+
+    const bool aligned = l.originTick == r.originTick && l.bucketShift == r.bucketShift;
+    const uint32_t buckets = l.span > r.span ? l.span : r.span;
+    TickActivity<DefaultVaultConfig>::Tree before;
+    TickActivity<DefaultVaultConfig>::Tree after;
+    for (uint32_t tree = 0; tree < 2 * TICK_FLOW_COUNT; ++tree) {
+        sectionBuckets(left, tree, before);
+        sectionBuckets(right, tree, after);
+        std::string field = std::string("ticks.") + tickFlowName(static_cast<TickFlow>(tree % TICK_FLOW_COUNT)) +
+                            (tree < TICK_FLOW_COUNT ? ".amount" : ".count");
+        if (!aligned) {
+            uint64_t beforeSum = 0;
+            uint64_t afterSum = 0;
+            for (uint32_t b = 0; b < buckets; ++b) {
+                beforeSum += before[b];
+                afterSum += after[b];
+            }
+            compareScalar(diff, field.c_str(), beforeSum, afterSum);
+            continue;
+        }
+        for (uint32_t b = 0; b < buckets; ++b) {
+            if (before[b] == after[b]) continue;
+            diff.deltas.push_back({AGREEMENT_NOT_FOUND, 0, field + "[" + std::to_string(b) + "]",
+                                   std::to_string(before[b]), std::to_string(after[b])});
+        }
+    }
+}
+
+// Random access to records by slot, decoding (and caching) one block at a time.
+class BlockCursor {
+public:
+    BlockCursor(int fd, const std::vector<SnapshotBlockIndexEntry>& index, SnapshotDiff& diff)
+        : fd_(fd), index_(index), diff_(diff) {}
+
+    SnapshotStatus at(uint32_t slot, const Agreement*& out) {
+        if (loaded_ >= index_.size() || slot < first() || slot >= first() + index_[loaded_].block.count) {
+            size_t block = 0;
+            while (block + 1 < index_.size() && index_[block + 1].block.firstSlot <= slot) ++block;
+            SnapshotStatus status = load(block);
+            if (status != SnapshotStatus::OK) return status;
+        }
+        out = &records_[slot - first()];
+        return SnapshotStatus::OK;
+    }
+
+private:
+    uint32_t first() const { return index_[loaded_].block.firstSlot; }
+
+    SnapshotStatus load(size_t block) {
+        const SnapshotBlockIndexEntry& entry = index_[block];
+        payload_.resize(entry.block.payloadBytes);
+        if (!preadAll(fd_, payload_.data(), payload_.size(), entry.offset + sizeof(SnapshotBlockHeader))) {
+            return SnapshotStatus::IO_ERROR;
+        }
+        records_.resize(entry.block.count);
+        SnapshotStatus status = decodeSnapshotBlock(entry.block, payload_.data(), records_.data());
+        loaded_ = status == SnapshotStatus::OK ? block : index_.size();
+        ++diff_.blocksDecoded;
+        return status;
+    }
+
+    int fd_;
+    const std::vector<SnapshotBlockIndexEntry>& index_;
+    SnapshotDiff& diff_;
+    size_t loaded_ = SIZE_MAX;
+    std::vector<uint8_t> payload_;
+    std::vector<Agreement> records_;
+};
+
+// Decoded records are canonical, so equal bytes mean equal agreements.
+inline void compareAgreements(uint32_t slot, const Agreement& left, const Agreement& right, SnapshotDiff& diff) {
+    if (std::memcmp(&left, &right, sizeof(Agreement)) == 0) {
+        return;
+    }
+    std::vector<FieldValue> before;
+    std::vector<FieldValue> after;
+    describeAgreement(left, before);
+    describeAgreement(right, after);
+    bool changed = false;
+    for (size_t i = 0; i < before.size(); ++i) {
+        if (before[i].value != after[i].value) {
+            diff.deltas.push_back({slot, right.id, before[i].name, before[i].value, after[i].value});
+            changed = true;
+        }
+    }
+    if (changed) ++diff.changedAgreements;
+}
+
+inline void reportOneSided(uint32_t slot, const Agreement& agreement, bool added, SnapshotDiff& diff) {
+    std::string id = std::to_string(agreement.id);
+    diff.deltas.push_back({slot, agreement.id, "agreement", added ? "" : id, added ? id : ""});
+    ++(added ? diff.addedAgreements : diff.removedAgreements);
+}
+
+} // namespace diff_detail
+
+/**
+ * Diffs the snapshots on two file descriptors. Slots are compared position by
+ * position, matching how the contract addresses agreements.
+ */
+inline SnapshotStatus diffSnapshots(int leftFd, int rightFd, SnapshotDiff& diff) {
+    diff = SnapshotDiff();
+    SnapshotHeader leftHeader;
+    SnapshotHeader rightHeader;
+    std::vector<SnapshotBlockIndexEntry> leftIndex;
+    std::vector<SnapshotBlockIndexEntry> rightIndex;
+    SnapshotTicks leftTicks;
+    SnapshotTicks rightTicks;
+    SnapshotStatus status = readSnapshotBlockIndex(leftFd, leftHeader, leftIndex);
+    if (status == SnapshotStatus::OK) status = readSnapshotBlockIndex(rightFd, rightHeader, rightIndex);
+    if (status == SnapshotStatus::OK) status = readSnapshotTicksAt(leftFd, leftIndex, leftTicks);
+    if (status == SnapshotStatus::OK) status = readSnapshotTicksAt(rightFd, rightIndex, rightTicks);
+    if (status == SnapshotStatus::OK) status = verifySnapshotTicks(leftTicks);
+    if (status == SnapshotStatus::OK) status = verifySnapshotTicks(rightTicks);
+    if (status != SnapshotStatus::OK) return status;
+
+    diff_detail::compareHeaders(leftHeader, rightHeader, diff);
+    diff_detail::compareTicks(leftTicks, rightTicks, diff);
+
+    diff_detail::BlockCursor leftCursor(leftFd, leftIndex, diff);
+    diff_detail::BlockCursor rightCursor(rightFd, rightIndex, diff);
+    size_t r = 0;
+    for (const SnapshotBlockIndexEntry& entry : leftIndex) {
+        const SnapshotBlockHeader& lb = entry.block;
+        ++diff.blocksCompared;
+        while (r < rightIndex.size() && rightIndex[r].block.firstSlot < lb.firstSlot) ++r;
+        if (r < rightIndex.size() && rightIndex[r].block.firstSlot == lb.firstSlot &&
+            rightIndex[r].block.count == lb.count && rightIndex[r].block.recordHash == lb.recordHash) {
+            continue;
+        }
+        for (uint32_t slot = lb.firstSlot; slot < lb.firstSlot + lb.count; ++slot) {
+            const Agreement* before = nullptr;
+            const Agreement* after = nullptr;
+            status = leftCursor.at(slot, before);
+            if (status == SnapshotStatus::OK && slot < rightHeader.agreementCount) {
+                status = rightCursor.at(slot, after);
+            }
+            if (status != SnapshotStatus::OK) return status;
+            if (after == nullptr) {
+                diff_detail::reportOneSided(slot, *before, false, diff);
+            } else {
+                diff_detail::compareAgreements(slot, *before, *after, diff);
+            }
+        }
+    }
+    for (uint32_t slot = leftHeader.agreementCount; slot < rightHeader.agreementCount; ++slot) {
+        const Agreement* added = nullptr;
+        status = rightCursor.at(slot, added);
+        if (status != SnapshotStatus::OK) return status;
+        diff_detail::reportOneSided(slot, *added, true, diff);
+    }
+    return SnapshotStatus::OK;
+}
+
+inline SnapshotStatus diffSnapshotFiles(const std::string& leftPath, const std::string& rightPath, SnapshotDiff& diff) {
+    int leftFd = ::open(leftPath.c_str(), O_RDONLY | O_CLOEXEC);
+    int rightFd = ::open(rightPath.c_str(), O_RDONLY | O_CLOEXEC);
+    SnapshotStatus status =
+        (leftFd < 0 || rightFd < 0) ? SnapshotStatus::IO_ERROR : diffSnapshots(leftFd, rightFd, diff);
+    if (leftFd >= 0) ::close(leftFd);
+    if (rightFd >= 0) ::close(rightFd);
+    return status;
+}
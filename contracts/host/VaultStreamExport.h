@@ -0,0 +1,423 @@
+// contracts/host/VaultStreamExport.h
+// Pronexma Protocol - Streaming state export for mirror bootstrap
+//
+// Emits every agreement followed by its used milestones, then an end record
+// carrying the totals, so a database mirror (backend/prisma) can be filled in
+// one pass and can check that it saw the whole stream.
+//
+// NDJSON: one object per line, "type" is "agreement", "milestone" or "end".
+// Amounts are decimal strings (they do not fit a JS number); ticks are numbers;
+// addresses are Qubic identities.
+//
+// Binary: STREAM_MAGIC, uint32 version, then frames
+//   uint8 kind, uint32 payloadBytes, payload
+// with little-endian integers, addresses as their 32 key bytes and strings as
+// uint16 length + bytes. Field order per frame kind is given by the encode*
+// functions below.
+//
+// Output goes through one fixed buffer to a file descriptor. Blocking fds get
+// backpressure from write(); non-blocking fds (sockets, pipes) are waited on
+// with poll() when they return EAGAIN, so the exporter never grows a queue.
+
+#pragma once
+
+#include "VaultFields.h"
+#include "VaultSnapshot.h"
+
+#include <chrono>
+#include <cstdio>
+
+#include <poll.h>
+
+constexpr char STREAM_MAGIC[8] = {'P', 'R', 'N', 'X', 'S', 'T', 'R', 'M'};
+constexpr uint32_t STREAM_FORMAT_VERSION = 2;   // 2: binary addresses
+constexpr size_t STREAM_MIN_BUFFER = 4096;  // Largest single field/frame, rounded up
+
+enum class StreamFormat : uint8_t { NDJSON, BINARY };
+
+enum class StreamFrameKind : uint8_t {
+    AGREEMENT = 1,
+    MILESTONE = 2,
+    END = 3
+};
+
+struct StreamExportOptions {
+    StreamFormat format = StreamFormat::NDJSON;
+    size_t bufferBytes = 64 * 1024;        // Clamped to at least STREAM_MIN_BUFFER
+    int stallTimeoutMillis = 30000;        // Give up if the reader makes no progress
+};
+
+struct StreamExportStats {
+    uint32_t agreements = 0;
+    uint64_t milestones = 0;
+    uint64_t bytes = 0;
+    uint64_t flushes = 0;
+    uint64_t stalls = 0;                   // Times the fd was full (EAGAIN)
+    uint64_t stalledMicros = 0;
+    uint64_t micros = 0;
+};
+
+// ============================================================================
+// OUTPUT BUFFER
+// ============================================================================
+
+namespace stream_export_detail {
+
+/** Fixed-size buffer in front of a possibly non-blocking fd. */
+class StreamBuffer {
+public:
+    StreamBuffer(int fd, size_t capacity, int stallTimeoutMillis, StreamExportStats& stats)
+        : fd_(fd), buffer_(capacity), stallTimeoutMillis_(stallTimeoutMillis), stats_(stats) {}
+
+    /** Makes room for `length` contiguous bytes (length <= capacity). */
+    bool reserve(size_t length) {
+        return used_ + length <= buffer_.size() || flush();
+    }
+
+    char* cursor() { return buffer_.data() + used_; }
+    void advance(size_t length) { used_ += length; }
+
+    bool put(const void* data, size_t length) {
+        if (!reserve(length)) return false;
+        std::memcpy(cursor(), data, length);
+        used_ += length;
+        return true;
+    }
+
+    template <typename T>
+    bool putValue(T value) { return put(&value, sizeof(value)); }
+
+    bool flush() {
+        const char* data = buffer_.data();
+        size_t remaining = used_;
+        while (remaining > 0) {
+            ssize_t written = ::write(fd_, data, remaining);
+            if (written > 0) {
+                data += written;
+                remaining -= static_cast<size_t>(written);
+                continue;
+            }
+            if (written < 0 && errno == EINTR) continue;
+            if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                if (!waitWritable()) return false;
+                continue;
+            }
+            return false;
+        }
+        stats_.bytes += used_;
+        ++stats_.flushes;
+        used_ = 0;
+        return true;
+    }
+
+private:
+    bool waitWritable() {
+        auto started = std::chrono::steady_clock::now();
+        ++stats_.stalls;
+        pollfd descriptor{fd_, POLLOUT, 0};
+        int ready;
+        do {
+            ready = ::poll(&descriptor, 1, stallTimeoutMillis_);
+        } while (ready < 0 && errno == EINTR);
+        stats_.stalledMicros += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - started).count());
+        return ready > 0 && (descriptor.revents & (POLLERR | POLLHUP | POLLNVAL)) == 0;
+    }
+
+    int fd_;
+    std::vector<char> buffer_;
+    size_t used_ = 0;
+    int stallTimeoutMillis_;
+    StreamExportStats& stats_;
+};
+
+// ---- NDJSON ----------------------------------------------------------------
+
+inline bool putText(StreamBuffer& out, const char* text) {
+    return out.put(text, std::strlen(text));
+}
+
+inline bool putNumber(StreamBuffer& out, uint64_t value) {
+    char digits[24];
+    int length = std::snprintf(digits, sizeof(digits), "%llu", static_cast<unsigned long long>(value));
+    return out.put(digits, static_cast<size_t>(length));
+}
+
+inline bool putQuotedNumber(StreamBuffer& out, uint64_t value) {
+    return out.put("\"", 1) && putNumber(out, value) && out.put("\"", 1);
+}
+
+/** Length of the well-formed UTF-8 sequence led by `text[0]` (>= 0x80) within `available` bytes, or 0. */
+inline size_t utf8SequenceLength(const unsigned char* text, size_t available) {
+    const unsigned char lead = text[0];
+    const size_t length = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : 2;
+    if (lead < 0xC2 || lead > 0xF4 || length > available) return 0;
+    unsigned char low = 0x80, high = 0xBF;   // Second byte: no overlongs, surrogates or code points past U+10FFFF
+    if (lead == 0xE0) low = 0xA0;
+    if (lead == 0xED) high = 0x9F;
+    if (lead == 0xF0) low = 0x90;
+    if (lead == 0xF4) high = 0x8F;
+    if (text[1] < low || text[1] > high) return 0;
+    for (size_t k = 2; k < length; ++k) {
+        if ((text[k] & 0xC0) != 0x80) return 0;
+    }
+    return length;
+}
+
+/**
+ * JSON string of a NUL-terminated fixed field. Each byte that does not start
+ * a well-formed UTF-8 sequence becomes U+FFFD. Escaping is at most 6 bytes per byte.
+ */
+template <size_t N>
+inline bool putJsonString(StreamBuffer& out, const std::array<char, N>& field) {
+    static_assert(N * 6 + 2 <= STREAM_MIN_BUFFER, "field must fit the minimum stream buffer");
+    static const char hex[] = "0123456789abcdef";
+    if (!out.reserve(N * 6 + 2)) return false;
+    char* start = out.cursor();
+    char* p = start;
+    *p++ = '"';
+    for (size_t i = 0; i < N && field[i] != '\0'; ++i) {
+        unsigned char c = static_cast<unsigned char>(field[i]);
+        if (c == '"' || c == '\\') {
+            *p++ = '\\';
+            *p++ = static_cast<char>(c);
+        } else if (c < 0x20) {
+            *p++ = '\\'; *p++ = 'u'; *p++ = '0'; *p++ = '0';
+            *p++ = hex[c >> 4];
+            *p++ = hex[c & 0xF];
+        } else if (c < 0x80) {
+            *p++ = static_cast<char>(c);
+        } else if (size_t length = utf8SequenceLength(reinterpret_cast<const unsigned char*>(&field[i]), N - i)) {
+            std::memcpy(p, &field[i], length);
+            p += length;
+            i += length - 1;
+        } else {
+            *p++ = '\xEF'; *p++ = '\xBF'; *p++ = '\xBD';
+        }
+    }
+    *p++ = '"';
+    out.advance(static_cast<size_t>(p - start));
+    return true;
+}
+
+inline bool putJsonIdentity(StreamBuffer& out, const QubicAddress& address) {
+    if (!out.reserve(QUBIC_IDENTITY_LENGTH + 3)) return false;
+    char* p = out.cursor();
+    *p = '"';
+    addressToIdentity(address, p + 1);
+    p[QUBIC_IDENTITY_LENGTH + 1] = '"';
+    out.advance(QUBIC_IDENTITY_LENGTH + 2);
+    return true;
+}
+
+inline bool encodeAgreementJson(StreamBuffer& out, const Agreement& agreement, uint32_t milestoneCount) {
+    return putText(out, "{\"type\":\"agreement\",\"onChainId\":") && putQuotedNumber(out, agreement.id) &&
+           putText(out, ",\"payerAddress\":") && putJsonIdentity(out, agreement.payer) &&
+           putText(out, ",\"beneficiaryAddress\":") && putJsonIdentity(out, agreement.beneficiary) &&
+           putText(out, ",\"oracleAdminAddress\":") && putJsonIdentity(out, agreement.oracleAdmin) &&
+           putText(out, ",\"totalAmount\":") && putQuotedNumber(out, agreement.totalAmount) &&
+           putText(out, ",\"lockedAmount\":") && putQuotedNumber(out, agreement.lockedAmount) &&
+           putText(out, ",\"releasedAmount\":") && putQuotedNumber(out, agreement.releasedAmount) &&
+           putText(out, ",\"state\":\"") && putText(out, agreementStateName(agreement.state)) &&
+           putText(out, "\",\"createdAtTick\":") && putNumber(out, agreement.createdAtTick) &&
+           putText(out, ",\"fundedAtTick\":") && putNumber(out, agreement.fundedAtTick) &&
+           putText(out, ",\"timeoutTick\":") && putNumber(out, agreement.timeoutTick) &&
+           putText(out, ",\"milestoneCount\":") && putNumber(out, milestoneCount) &&
+           putText(out, ",\"title\":") && putJsonString(out, agreement.title) &&
+           putText(out, ",\"metadata\":") && putJsonString(out, agreement.metadata) &&
+           putText(out, "}\n");
+}
+
+inline bool encodeMilestoneJson(StreamBuffer& out, const Agreement& agreement, uint32_t sequence) {
+    const Milestone& milestone = agreement.milestones[sequence];
+    std::string evidence = hexBytes(milestone.evidenceHash);
+    return putText(out, "{\"type\":\"milestone\",\"agreementOnChainId\":") && putQuotedNumber(out, agreement.id) &&
+           putText(out, ",\"sequenceNumber\":") && putNumber(out, sequence) &&
+           putText(out, ",\"milestoneId\":") && putNumber(out, milestone.id) &&
+           putText(out, ",\"amount\":") && putQuotedNumber(out, milestone.amount) &&
+           putText(out, ",\"state\":\"") && putText(out, milestoneStateName(milestone.state)) &&
+           putText(out, "\",\"verifiedAtTick\":") && putNumber(out, milestone.verifiedAtTick) &&
+           putText(out, ",\"releasedAtTick\":") && putNumber(out, milestone.releasedAtTick) &&
+           putText(out, ",\"title\":") && putJsonString(out, milestone.description) &&
+           putText(out, ",\"evidenceHash\":\"") && out.put(evidence.data(), evidence.size()) &&
+           putText(out, "\"}\n");
+}
+
+// ---- Binary ----------------------------------------------------------------
+
+template <size_t N>
+inline size_t textLength(const std::array<char, N>& field) {
+    size_t length = 0;
+    while (length < N && field[length] != '\0') ++length;
+    return length;
+}
+
+template <size_t N>
+inline void putBinaryText(StreamBuffer& out, const std::array<char, N>& field, size_t length) {
+    out.putValue<uint16_t>(static_cast<uint16_t>(length));
+    out.put(field.data(), length);
+}
+
+inline bool encodeAgreementFrame(StreamBuffer& out, const Agreement& agreement, uint32_t milestoneCount) {
+    size_t title = textLength(agreement.title);
+    size_t metadata = textLength(agreement.metadata);
+    size_t payload = 8 + 1 + 8 * 3 + 8 * 3 + 1 + 3 * sizeof(QubicAddress) + 2 * 2 + title + metadata;
+    if (!out.reserve(1 + 4 + payload)) return false;
+    out.putValue<uint8_t>(static_cast<uint8_t>(StreamFrameKind::AGREEMENT));
+    out.putValue<uint32_t>(static_cast<uint32_t>(payload));
+    out.putValue<uint64_t>(agreement.id);
+    out.putValue<uint8_t>(static_cast<uint8_t>(agreement.state));
+    out.putValue<uint64_t>(agreement.totalAmount);
+    out.putValue<uint64_t>(agreement.lockedAmount);
+    out.putValue<uint64_t>(agreement.releasedAmount);
+    out.putValue<uint64_t>(agreement.createdAtTick);
+    out.putValue<uint64_t>(agreement.fundedAtTick);
+    out.putValue<uint64_t>(agreement.timeoutTick);
+    out.putValue<uint8_t>(static_cast<uint8_t>(milestoneCount));
+    out.put(agreement.payer.data(), sizeof(QubicAddress));
+    out.put(agreement.beneficiary.data(), sizeof(QubicAddress));
+    out.put(agreement.oracleAdmin.data(), sizeof(QubicAddress));
+    putBinaryText(out, agreement.title, title);
+    putBinaryText(out, agreement.metadata, metadata);
+    return true;
+}
+
+inline bool encodeMilestoneFrame(StreamBuffer& out, const Agreement& agreement, uint32_t sequence) {
+    const Milestone& milestone = agreement.milestones[sequence];
+    size_t description = textLength(milestone.description);
+    size_t payload = 8 + 1 + 4 + 8 + 1 + 8 * 2 + sizeof(milestone.evidenceHash) + 2 + description;
+    if (!out.reserve(1 + 4 + payload)) return false;
+    out.putValue<uint8_t>(static_cast<uint8_t>(StreamFrameKind::MILESTONE));
+    out.putValue<uint32_t>(static_cast<uint32_t>(payload));
+    out.putValue<uint64_t>(agreement.id);
+    out.putValue<uint8_t>(static_cast<uint8_t>(sequence));
+    out.putValue<uint32_t>(milestone.id);
+    out.putValue<uint64_t>(milestone.amount);
+    out.putValue<uint8_t>(static_cast<uint8_t>(milestone.state));
+    out.putValue<uint64_t>(milestone.verifiedAtTick);
+    out.putValue<uint64_t>(milestone.releasedAtTick);
+    out.put(milestone.evidenceHash.data(), sizeof(milestone.evidenceHash));
+    putBinaryText(out, milestone.description, description);
+    return true;
+}
+
+} // namespace stream_export_detail
+
+// ============================================================================
+// ENCODER
+// ============================================================================
+
+/**
+ * Streams agreements to `fd`: begin, append each agreement in slot order, then
+ * finish with the vault totals (written into the end record).
+ */
+class VaultStreamEncoder {
+public:
+    VaultStreamEncoder(int fd, const StreamExportOptions& options = StreamExportOptions())
+        : format_(options.format),
+          out_(fd, std::max(options.bufferBytes, STREAM_MIN_BUFFER), options.stallTimeoutMillis, stats_) {}
+
+    SnapshotStatus begin() {
+        started_ = std::chrono::steady_clock::now();
+        if (format_ == StreamFormat::BINARY) {
+            bool ok = out_.put(STREAM_MAGIC, sizeof(STREAM_MAGIC)) && out_.putValue<uint32_t>(STREAM_FORMAT_VERSION);
+            if (!ok) return SnapshotStatus::IO_ERROR;
+        }
+        return SnapshotStatus::OK;
+    }
+
+    SnapshotStatus append(const Agreement& agreement) {
+        using namespace stream_export_detail;
+        uint32_t milestoneCount = std::min(agreement.milestoneCount, MAX_MILESTONES_PER_AGREEMENT);
+        bool binary = format_ == StreamFormat::BINARY;
+        bool ok = binary ? encodeAgreementFrame(out_, agreement, milestoneCount)
+                         : encodeAgreementJson(out_, agreement, milestoneCount);
+        for (uint32_t i = 0; ok && i < milestoneCount; ++i) {
+            ok = binary ? encodeMilestoneFrame(out_, agreement, i) : encodeMilestoneJson(out_, agreement, i);
+        }
+        if (!ok) return SnapshotStatus::IO_ERROR;
+        ++stats_.agreements;
+        stats_.milestones += milestoneCount;
+        return SnapshotStatus::OK;
+    }
+
+    SnapshotStatus finish(uint64_t totalValueLocked, uint64_t totalValueReleased) {
+        using namespace stream_export_detail;
+        bool ok;
+        if (format_ == StreamFormat::BINARY) {
+            ok = out_.reserve(1 + 4 + 4 + 8 * 3);
+            if (ok) {
+                out_.putValue<uint8_t>(static_cast<uint8_t>(StreamFrameKind::END));
+                out_.putValue<uint32_t>(4 + 8 * 3);
+                out_.putValue<uint32_t>(stats_.agreements);
+                out_.putValue<uint64_t>(stats_.milestones);
+                out_.putValue<uint64_t>(totalValueLocked);
+                out_.putValue<uint64_t>(totalValueReleased);
+            }
+        } else {
+            ok = putText(out_, "{\"type\":\"end\",\"agreements\":") && putNumber(out_, stats_.agreements) &&
+                 putText(out_, ",\"milestones\":") && putNumber(out_, stats_.milestones) &&
+                 putText(out_, ",\"totalValueLocked\":") && putQuotedNumber(out_, totalValueLocked) &&
+                 putText(out_, ",\"totalValueReleased\":") && putQuotedNumber(out_, totalValueReleased) &&
+                 putText(out_, "}\n");
+        }
+        ok = ok && out_.flush();
+        stats_.micros = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - started_).count());
+        return ok ? SnapshotStatus::OK : SnapshotStatus::IO_ERROR;
+    }
+
+    const StreamExportStats& stats() const { return stats_; }
+
+private:
+    StreamFormat format_;
+    StreamExportStats stats_;
+    stream_export_detail::StreamBuffer out_;
+    std::chrono::steady_clock::time_point started_;
+};
+
+// ============================================================================
+// SOURCES
+// ============================================================================
+
+/** Streams the live slots of `engine`'s state to `fd`. */
+inline SnapshotStatus streamVaultEngine(const PronexmaVaultEngine& engine, int fd,
+                                        const StreamExportOptions& options = StreamExportOptions(),
+                                        StreamExportStats* stats = nullptr) {
+    const PronexmaVaultState& vault = engine.state;
+    VaultStreamEncoder encoder(fd, options);
+    SnapshotStatus status = encoder.begin();
+    for (uint32_t i = 0; status == SnapshotStatus::OK && i < vault.activeAgreementCount; ++i) {
+        status = encoder.append(vault.agreements[i]);
+    }
+    if (status == SnapshotStatus::OK) status = encoder.finish(vault.totalValueLocked, vault.totalValueReleased);
+    if (stats != nullptr) *stats = encoder.stats();
+    return status;
+}
+
+/** Streams a snapshot file to `fd` block by block. */
+inline SnapshotStatus streamSnapshot(const std::string& snapshotPath, int fd,
+                                     const StreamExportOptions& options = StreamExportOptions(),
+                                     StreamExportStats* stats = nullptr) {
+    int in = ::open(snapshotPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (in < 0) {
+        return SnapshotStatus::IO_ERROR;
+    }
+    SnapshotReader reader(in);
+    SnapshotHeader header;
+    SnapshotStatus status = reader.readHeader(header);
+    VaultStreamEncoder encoder(fd, options);
+    if (status == SnapshotStatus::OK) status = encoder.begin();
+    std::vector<Agreement> block(SNAPSHOT_BLOCK_CAPACITY);
+    while (status == SnapshotStatus::OK && !reader.done()) {
+        SnapshotBlockHeader blockHeader;
+        status = reader.readBlock(blockHeader, block.data());
+        for (uint32_t i = 0; status == SnapshotStatus::OK && i < blockHeader.count; ++i) {
+            status = encoder.append(block[i]);
+        }
+    }
+    ::close(in);
+    if (status == SnapshotStatus::OK) status = encoder.finish(header.totalValueLocked, header.totalValueReleased);
+    if (stats != nullptr) *stats = encoder.stats();
+    return status;
+}
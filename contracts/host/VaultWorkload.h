@@ -0,0 +1,584 @@
+// contracts/host/VaultWorkload.h
+// Pronexma Protocol - Seedable synthetic traffic for the vault engine
+//
+// WorkloadGenerator models the production call mix: mostly views with
+// Zipf-skewed popularity, creates and deposits, verifications arriving in
+// bursts after an oracle audit, releases shortly after verification and a
+// trickle of refunds. It keeps a model of the agreements it has created, so
+// every call it emits is one a real client would send; refunds still arrive
+// before the timeout sometimes and fail, as they do in production.
+//
+// The generator never looks at the engine: the same config and seed always
+// give the same operation stream. runWorkloadOp() plays one operation against
+// an engine through a NativeHost.
+
+#pragma once
+
+#include "VaultHost.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <string>
+
+enum class WorkloadOpKind : uint8_t {
+    CREATE_AGREEMENT = 0,
+    DEPOSIT = 1,
+    MARK_MILESTONE_VERIFIED = 2,
+    RELEASE_MILESTONE = 3,
+    REFUND = 4,
+    GET_AGREEMENT = 5,
+    GET_MILESTONE = 6,
+    GET_PROTOCOL_STATS = 7,
+};
+
+constexpr uint32_t WORKLOAD_OP_KINDS = 8;
+
+inline const char* workloadOpName(WorkloadOpKind kind) {
+    switch (kind) {
+        case WorkloadOpKind::CREATE_AGREEMENT: return "createAgreement";
+        case WorkloadOpKind::DEPOSIT: return "deposit";
+        case WorkloadOpKind::MARK_MILESTONE_VERIFIED: return "markMilestoneVerified";
+        case WorkloadOpKind::RELEASE_MILESTONE: return "releaseMilestone";
+        case WorkloadOpKind::REFUND: return "refund";
+        case WorkloadOpKind::GET_AGREEMENT: return "getAgreement";
+        case WorkloadOpKind::GET_MILESTONE: return "getMilestone";
+        case WorkloadOpKind::GET_PROTOCOL_STATS: return "getProtocolStats";
+    }
+    return "unknown";
+}
+
+// ============================================================================
+// CONFIGURATION
+// ============================================================================
+
+/**
+ * Relative weights of each call, indexed by WorkloadOpKind. The default is the
+ * observed backend mix: 60% views. A verification weight counts single calls,
+ * although they are issued in bursts.
+ */
+struct WorkloadMix {
+    std::array<double, WORKLOAD_OP_KINDS> weights = {
+        10.0,   // createAgreement
+        9.0,    // deposit
+        10.0,   // markMilestoneVerified
+        10.0,   // releaseMilestone
+        1.0,    // refund
+        40.0,   // getAgreement
+        15.0,   // getMilestone
+        5.0,    // getProtocolStats
+    };
+
+    double& operator[](WorkloadOpKind kind) { return weights[static_cast<uint32_t>(kind)]; }
+    double operator[](WorkloadOpKind kind) const { return weights[static_cast<uint32_t>(kind)]; }
+};
+
+/**
+ * Parses "name=weight,name=weight" (procedure names as in workloadOpName) over
+ * the defaults; names left out keep their default weight. False on an unknown
+ * name or a malformed weight.
+ */
+inline bool parseWorkloadMix(const char* text, WorkloadMix& mix) {
+    std::string spec(text);
+    size_t start = 0;
+    while (start < spec.size()) {
+        size_t end = spec.find(',', start);
+        if (end == std::string::npos) end = spec.size();
+        std::string item = spec.substr(start, end - start);
+        size_t equals = item.find('=');
+        if (equals == std::string::npos) return false;
+        std::string name = item.substr(0, equals);
+        char* parsedEnd = nullptr;
+        double weight = std::strtod(item.c_str() + equals + 1, &parsedEnd);
+        if (parsedEnd == item.c_str() + equals + 1 || *parsedEnd != '\0' || weight < 0) return false;
+        bool known = false;
+        for (uint32_t k = 0; k < WORKLOAD_OP_KINDS; ++k) {
+            if (name == workloadOpName(static_cast<WorkloadOpKind>(k))) {
+                mix.weights[k] = weight;
+                known = true;
+            }
+        }
+        if (!known) return false;
+        start = end + 1;
+    }
+    return true;
+}
+
+/** Shape of created agreements and the party population. */
+struct WorkloadShape {
+    uint32_t minMilestones = 2;
+    uint32_t maxMilestones = 6;
+    uint64_t minMilestoneAmount = 1000;
+    uint64_t maxMilestoneAmount = 500000000;
+    uint32_t payers = 400;
+    uint32_t beneficiaries = 200;
+    uint32_t oracles = 8;                  // Few oracles, so audits cover many agreements
+};
+
+struct WorkloadConfig {
+    uint64_t seed = 1;
+    uint64_t operations = 100000;          // Measured operations, after the prefill
+    uint32_t prefillAgreements = 2000;     // Created and funded first, flagged as warmup
+    WorkloadMix mix;
+    WorkloadShape shape;
+    double zipfTheta = 0.99;               // 0 = uniform; clamped below 1
+    bool recentIsHot = true;               // Newest agreements most popular; else scrambled ranks
+    uint32_t verificationBurst = 8;        // Verifications per oracle audit
+    uint64_t startTick = 1;
+    uint64_t ticksPerOperation = 20;
+};
+
+// Balance credited to every payer so deposits never run dry.
+constexpr uint64_t WORKLOAD_PAYER_BALANCE = 1ull << 50;
+
+struct WorkloadOp {
+    WorkloadOpKind kind = WorkloadOpKind::GET_PROTOCOL_STATS;
+    bool warmup = false;
+    uint64_t tick = 0;
+    QubicAddress sender = {};
+    uint64_t value = 0;
+    uint64_t agreementId = 0;
+    uint32_t milestoneId = 0;
+    // createAgreement only
+    QubicAddress beneficiary = {};
+    QubicAddress oracleAdmin = {};
+    uint32_t milestoneCount = 0;
+    uint64_t totalAmount = 0;
+    std::array<uint64_t, MAX_MILESTONES_PER_AGREEMENT> amounts = {};
+};
+
+// ============================================================================
+// GENERATOR
+// ============================================================================
+
+namespace workload_detail {
+
+// splitmix64: every stream position depends only on the seed.
+struct Rng {
+    uint64_t s;
+    explicit Rng(uint64_t seed) : s(seed) {}
+    uint64_t next() {
+        uint64_t z = (s += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+    uint32_t below(uint32_t n) { return static_cast<uint32_t>(next() % n); }
+    uint64_t between(uint64_t lo, uint64_t hi) { return lo + next() % (hi - lo + 1); }
+    double unit() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+};
+
+/**
+ * Zipfian ranks over a growing population (Gray et al., as in YCSB): zeta(n)
+ * is extended incrementally, so growing by one item costs one pow().
+ */
+class ZipfSampler {
+public:
+    explicit ZipfSampler(double theta) : theta_(std::min(std::max(theta, 0.0), 0.999)) {
+        alpha_ = 1.0 / (1.0 - theta_);
+        zeta2_ = 1.0 + std::pow(0.5, theta_);
+    }
+
+    void grow(uint64_t n) {
+        while (n_ < n) {
+            ++n_;
+            zetan_ += 1.0 / std::pow(static_cast<double>(n_), theta_);
+        }
+        if (n_ >= 3) {
+            eta_ = (1.0 - std::pow(2.0 / static_cast<double>(n_), 1.0 - theta_)) / (1.0 - zeta2_ / zetan_);
+        }
+    }
+
+    /** Rank in [0, n); 0 is the most popular. */
+    uint64_t sample(double u) const {
+        if (n_ < 2) return 0;
+        double uz = u * zetan_;
+        if (uz < 1.0) return 0;
+        if (uz < zeta2_ || n_ == 2) return 1;
+        uint64_t rank = static_cast<uint64_t>(static_cast<double>(n_) * std::pow(eta_ * u - eta_ + 1.0, alpha_));
+        return std::min(rank, n_ - 1);
+    }
+
+private:
+    double theta_;
+    double alpha_;
+    double zeta2_;
+    double zetan_ = 0;
+    double eta_ = 0;
+    uint64_t n_ = 0;
+};
+
+enum class ModelState : uint8_t { CREATED, FUNDED, CLOSED };
+
+struct ModelAgreement {
+    uint64_t id;
+    uint64_t totalAmount;
+    uint64_t timeoutTick;
+    uint16_t payer;
+    uint16_t oracle;
+    uint8_t milestoneCount;
+    uint8_t verified;
+    uint8_t released;
+    ModelState state;
+};
+
+inline QubicAddress partyAddress(char role, uint64_t seed, uint32_t n) {
+    // A random key tagged with the role byte, unique per (role, n).
+    Rng rng(seed ^ (static_cast<uint64_t>(role) << 56) ^ (static_cast<uint64_t>(n) * 0x100000001B3ull));
+    QubicAddress address = {};
+    address[0] = static_cast<uint8_t>(role);
+    for (size_t i = 1; i < address.size(); ++i) address[i] = static_cast<uint8_t>(rng.below(256));
+    return address;
+}
+
+} // namespace workload_detail
+
+class WorkloadGenerator {
+public:
+    explicit WorkloadGenerator(const WorkloadConfig& config)
+        : config_(config), rng_(config.seed), popularity_(config.zipfTheta), tick_(config.startTick) {
+        config_.shape.payers = std::max(1u, std::min(config_.shape.payers, 65535u));
+        config_.shape.beneficiaries = std::max(1u, config_.shape.beneficiaries);
+        config_.shape.oracles = std::max(1u, std::min(config_.shape.oracles, 65535u));
+        config_.shape.minMilestones = std::max(1u, std::min(config_.shape.minMilestones, MAX_MILESTONES_PER_AGREEMENT));
+        config_.shape.maxMilestones =
+            std::max(config_.shape.minMilestones, std::min(config_.shape.maxMilestones, MAX_MILESTONES_PER_AGREEMENT));
+        config_.shape.maxMilestoneAmount = std::max(config_.shape.minMilestoneAmount, config_.shape.maxMilestoneAmount);
+        config_.verificationBurst = std::max(1u, config_.verificationBurst);
+
+        for (uint32_t i = 0; i < config_.shape.payers; ++i) {
+            payers_.push_back(workload_detail::partyAddress('P', config_.seed, i));
+        }
+        for (uint32_t i = 0; i < config_.shape.beneficiaries; ++i) {
+            beneficiaries_.push_back(workload_detail::partyAddress('B', config_.seed, i));
+        }
+        for (uint32_t i = 0; i < config_.shape.oracles; ++i) {
+            oracles_.push_back(workload_detail::partyAddress('O', config_.seed, i));
+        }
+        verifiable_.resize(config_.shape.oracles);
+
+        // Verifications are drawn once per burst, so their draw weight is
+        // divided by the burst length to keep the configured share of calls.
+        double total = 0;
+        for (uint32_t k = 0; k < WORKLOAD_OP_KINDS; ++k) {
+            double weight = std::max(0.0, config_.mix.weights[k]);
+            if (static_cast<WorkloadOpKind>(k) == WorkloadOpKind::MARK_MILESTONE_VERIFIED) {
+                weight /= config_.verificationBurst;
+            }
+            total += weight;
+            cumulative_[k] = total;
+        }
+        totalWeight_ = total;
+    }
+
+    const WorkloadConfig& config() const { return config_; }
+    const std::vector<QubicAddress>& payers() const { return payers_; }
+
+    /** Prefill plus measured operations; next() returns false after that many. */
+    uint64_t totalOperations() const { return 2ull * config_.prefillAgreements + config_.operations; }
+
+    /**
+     * Fills `op` with the next call. The first 2 * prefillAgreements calls are
+     * create/deposit pairs flagged as warmup.
+     */
+    bool next(WorkloadOp& op) {
+        if (emitted_ >= totalOperations()) return false;
+        op = WorkloadOp();
+        op.tick = tick_;
+        if (emitted_ < 2ull * config_.prefillAgreements) {
+            op.warmup = true;
+            if (emitted_ % 2 == 0 && createAgreementOp(op)) {
+                // Deposit the agreement just created.
+            } else if (!awaitingDeposit_.empty()) {
+                depositOp(op, static_cast<uint32_t>(awaitingDeposit_.size() - 1));
+            } else {
+                protocolStatsOp(op);
+            }
+        } else {
+            generate(op);
+        }
+        ++emitted_;
+        tick_ += config_.ticksPerOperation;
+        return true;
+    }
+
+private:
+    using Model = workload_detail::ModelAgreement;
+    using ModelState = workload_detail::ModelState;
+
+    void generate(WorkloadOp& op) {
+        if (burstRemaining_ > 0 && verifyOp(op, burstOracle_)) {
+            --burstRemaining_;
+            return;
+        }
+        burstRemaining_ = 0;
+
+        bool emitted = false;
+        switch (drawKind()) {
+            case WorkloadOpKind::CREATE_AGREEMENT:
+                emitted = createAgreementOp(op);
+                break;
+            case WorkloadOpKind::DEPOSIT:
+                if (!awaitingDeposit_.empty()) {
+                    depositOp(op, rng_.below(static_cast<uint32_t>(awaitingDeposit_.size())));
+                    emitted = true;
+                }
+                break;
+            case WorkloadOpKind::MARK_MILESTONE_VERIFIED:
+                emitted = startVerificationBurst(op);
+                break;
+            case WorkloadOpKind::RELEASE_MILESTONE:
+                emitted = releaseOp(op);
+                break;
+            case WorkloadOpKind::REFUND:
+                emitted = refundOp(op);
+                break;
+            case WorkloadOpKind::GET_AGREEMENT:
+                emitted = agreementViewOp(op, false);
+                break;
+            case WorkloadOpKind::GET_MILESTONE:
+                emitted = agreementViewOp(op, true);
+                break;
+            case WorkloadOpKind::GET_PROTOCOL_STATS:
+                protocolStatsOp(op);
+                emitted = true;
+                break;
+        }
+        // Nothing eligible for the drawn call (e.g. no verified milestone to
+        // release): read something instead, like an idle client polling.
+        if (!emitted && !agreementViewOp(op, false)) {
+            protocolStatsOp(op);
+        }
+    }
+
+    WorkloadOpKind drawKind() {
+        double u = rng_.unit() * totalWeight_;
+        for (uint32_t k = 0; k < WORKLOAD_OP_KINDS; ++k) {
+            if (u < cumulative_[k]) return static_cast<WorkloadOpKind>(k);
+        }
+        return WorkloadOpKind::GET_PROTOCOL_STATS;
+    }
+
+    bool createAgreementOp(WorkloadOp& op) {
+        if (agreements_.size() >= MAX_AGREEMENTS) return false;
+        const WorkloadShape& shape = config_.shape;
+        Model model = {};
+        model.id = (static_cast<uint64_t>(AGREEMENT_ID_PREFIX) << 32) | (agreements_.size() + 1);
+        model.payer = static_cast<uint16_t>(rng_.below(shape.payers));
+        model.oracle = static_cast<uint16_t>(rng_.below(shape.oracles));
+        model.milestoneCount = static_cast<uint8_t>(rng_.between(shape.minMilestones, shape.maxMilestones));
+        model.state = ModelState::CREATED;
+
+        op.kind = WorkloadOpKind::CREATE_AGREEMENT;
+        op.sender = payers_[model.payer];
+        op.beneficiary = beneficiaries_[rng_.below(shape.beneficiaries)];
+        op.oracleAdmin = oracles_[model.oracle];
+        op.milestoneCount = model.milestoneCount;
+        for (uint32_t m = 0; m < model.milestoneCount; ++m) {
+            op.amounts[m] = rng_.between(shape.minMilestoneAmount, shape.maxMilestoneAmount);
+            op.totalAmount += op.amounts[m];
+        }
+        model.totalAmount = op.totalAmount;
+
+        awaitingDeposit_.push_back(static_cast<uint32_t>(agreements_.size()));
+        agreements_.push_back(model);
+        popularity_.grow(agreements_.size());
+        return true;
+    }
+
+    void depositOp(WorkloadOp& op, uint32_t poolIndex) {
+        uint32_t index = takeAt(awaitingDeposit_, poolIndex);
+        Model& model = agreements_[index];
+        model.state = ModelState::FUNDED;
+        model.timeoutTick = tick_ + REFUND_TIMEOUT_TICKS;
+        verifiable_[model.oracle].push_back(index);
+        fundedOrder_.push_back(index);
+
+        op.kind = WorkloadOpKind::DEPOSIT;
+        op.sender = payers_[model.payer];
+        op.value = model.totalAmount;
+        op.agreementId = model.id;
+    }
+
+    bool startVerificationBurst(WorkloadOp& op) {
+        // An audit finishes for one oracle, which then signs off a run of
+        // milestones back to back.
+        uint32_t oracleCount = static_cast<uint32_t>(oracles_.size());
+        uint32_t first = rng_.below(oracleCount);
+        for (uint32_t i = 0; i < oracleCount; ++i) {
+            uint32_t oracle = (first + i) % oracleCount;
+            if (verifyOp(op, oracle)) {
+                burstOracle_ = oracle;
+                burstRemaining_ = config_.verificationBurst - 1;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool verifyOp(WorkloadOp& op, uint32_t oracle) {
+        std::vector<uint32_t>& pool = verifiable_[oracle];
+        while (!pool.empty()) {
+            uint32_t poolIndex = rng_.below(static_cast<uint32_t>(pool.size()));
+            Model& model = agreements_[pool[poolIndex]];
+            if (model.state != ModelState::FUNDED) {
+                takeAt(pool, poolIndex);     // Refunded since it was queued
+                continue;
+            }
+            uint32_t index = pool[poolIndex];
+            uint32_t milestoneId = ++model.verified;
+            if (model.verified == model.milestoneCount) takeAt(pool, poolIndex);
+            releasable_.push_back({index, milestoneId});
+
+            op.kind = WorkloadOpKind::MARK_MILESTONE_VERIFIED;
+            op.sender = oracles_[oracle];
+            op.agreementId = model.id;
+            op.milestoneId = milestoneId;
+            return true;
+        }
+        return false;
+    }
+
+    bool releaseOp(WorkloadOp& op) {
+        while (!releasable_.empty()) {
+            Pending pending = releasable_.front();
+            releasable_.pop_front();
+            Model& model = agreements_[pending.index];
+            if (model.state != ModelState::FUNDED) continue;
+            if (++model.released == model.milestoneCount) model.state = ModelState::CLOSED;
+
+            op.kind = WorkloadOpKind::RELEASE_MILESTONE;
+            op.sender = beneficiaries_[pending.index % beneficiaries_.size()];  // Anyone may release
+            op.agreementId = model.id;
+            op.milestoneId = pending.milestoneId;
+            return true;
+        }
+        return false;
+    }
+
+    bool refundOp(WorkloadOp& op) {
+        while (!fundedOrder_.empty() && agreements_[fundedOrder_.front()].state != ModelState::FUNDED) {
+            fundedOrder_.pop_front();
+        }
+        if (fundedOrder_.empty()) return false;
+        // The oldest funded agreement; before its timeout the call fails.
+        Model& model = agreements_[fundedOrder_.front()];
+        if (tick_ >= model.timeoutTick && model.released < model.milestoneCount) {
+            model.state = ModelState::CLOSED;
+            fundedOrder_.pop_front();
+        }
+        op.kind = WorkloadOpKind::REFUND;
+        op.sender = payers_[model.payer];
+        op.agreementId = model.id;
+        return true;
+    }
+
+    bool agreementViewOp(WorkloadOp& op, bool milestone) {
+        if (agreements_.empty()) return false;
+        uint64_t count = agreements_.size();
+        uint64_t rank = popularity_.sample(rng_.unit());
+        uint64_t index = config_.recentIsHot ? count - 1 - rank : scramble(rank) % count;
+        const Model& model = agreements_[index];
+        op.kind = milestone ? WorkloadOpKind::GET_MILESTONE : WorkloadOpKind::GET_AGREEMENT;
+        op.sender = beneficiaries_[rng_.below(static_cast<uint32_t>(beneficiaries_.size()))];
+        op.agreementId = model.id;
+        if (milestone) op.milestoneId = 1 + rng_.below(model.milestoneCount);
+        return true;
+    }
+
+    void protocolStatsOp(WorkloadOp& op) {
+        op.kind = WorkloadOpKind::GET_PROTOCOL_STATS;
+        op.sender = beneficiaries_[0];
+    }
+
+    static uint64_t scramble(uint64_t rank) {
+        uint64_t hash = 0xcbf29ce484222325ull;  // FNV-1a over the rank bytes
+        for (int i = 0; i < 8; ++i) hash = (hash ^ ((rank >> (8 * i)) & 0xFF)) * 0x100000001b3ull;
+        return hash;
+    }
+
+    static uint32_t takeAt(std::vector<uint32_t>& pool, uint32_t position) {
+        uint32_t value = pool[position];
+        pool[position] = pool.back();
+        pool.pop_back();
+        return value;
+    }
+
+    struct Pending {
+        uint32_t index;
+        uint32_t milestoneId;
+    };
+
+    WorkloadConfig config_;
+    workload_detail::Rng rng_;
+    workload_detail::ZipfSampler popularity_;
+    std::array<double, WORKLOAD_OP_KINDS> cumulative_ = {};
+    double totalWeight_ = 0;
+    uint64_t tick_;
+    uint64_t emitted_ = 0;
+
+    std::vector<QubicAddress> payers_;
+    std::vector<QubicAddress> beneficiaries_;
+    std::vector<QubicAddress> oracles_;
+
+    std::vector<Model> agreements_;
+    std::vector<uint32_t> awaitingDeposit_;
+    std::vector<std::vector<uint32_t>> verifiable_;  // Per oracle: funded, milestones left to verify
+    std::deque<Pending> releasable_;                 // Verified, in verification order
+    std::deque<uint32_t> fundedOrder_;               // Funded, in timeout order
+    uint32_t burstOracle_ = 0;
+    uint32_t burstRemaining_ = 0;
+};
+
+// ============================================================================
+// EXECUTION
+// ============================================================================
+
+/** Credits every payer of `generator` with WORKLOAD_PAYER_BALANCE. */
+inline void fundWorkloadParties(NativeHost& host, const WorkloadGenerator& generator) {
+    for (const QubicAddress& payer : generator.payers()) host.credit(payer, WORKLOAD_PAYER_BALANCE);
+}
+
+/** Evidence hash the workload attaches to a verification: the agreement and milestone IDs. */
+inline std::array<uint8_t, 64> workloadEvidence(uint64_t agreementId, uint32_t milestoneId) {
+    std::array<uint8_t, 64> evidence = {};
+    std::memcpy(evidence.data(), &agreementId, sizeof(agreementId));
+    std::memcpy(evidence.data() + sizeof(agreementId), &milestoneId, sizeof(milestoneId));
+    return evidence;
+}
+
+/**
+ * Runs `op` on `engine` as its sender at its tick, with its value paid through
+ * `host` (which must be bound to the engine). Views succeed when they find
+ * their agreement or milestone.
+ */
+inline bool runWorkloadOp(PronexmaVaultEngine& engine, NativeHost& host, const WorkloadOp& op) {
+    host.setTick(op.tick);
+    if (!host.beginInvocation(op.sender, op.value)) return false;
+    switch (op.kind) {
+        case WorkloadOpKind::CREATE_AGREEMENT:
+            return engine.createAgreement(op.beneficiary, op.oracleAdmin, op.totalAmount, op.amounts.data(),
+                                          op.milestoneCount, "workload") != 0;
+        case WorkloadOpKind::DEPOSIT:
+            return engine.deposit(op.agreementId);
+        case WorkloadOpKind::MARK_MILESTONE_VERIFIED:
+            return engine.markMilestoneVerified(op.agreementId, op.milestoneId,
+                                                workloadEvidence(op.agreementId, op.milestoneId));
+        case WorkloadOpKind::RELEASE_MILESTONE:
+            return engine.releaseMilestone(op.agreementId, op.milestoneId);
+        case WorkloadOpKind::REFUND:
+            return engine.refund(op.agreementId);
+        case WorkloadOpKind::GET_AGREEMENT:
+            return engine.getAgreement(op.agreementId).id != 0;
+        case WorkloadOpKind::GET_MILESTONE:
+            return engine.getMilestone(op.agreementId, op.milestoneId).id != 0;
+        case WorkloadOpKind::GET_PROTOCOL_STATS: {
+            uint64_t tvl, released, fees;
+            uint32_t count;
+            engine.getProtocolStats(tvl, released, fees, count);
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,475 @@
+// contracts/host/VaultWorstCase.h
+// Pronexma Protocol - Guided search for the costliest vault calls
+//
+// A WorstCaseInput is a vault shape plus a short call sequence:
+//   - the shape: how many agreements are prefilled, their milestone count and
+//     how far along they are;
+//   - the calls, each aiming at a prefilled slot, at an agreement created
+//     earlier in the sequence, or at a crafted missing ID.
+// WorstCaseSearch mutates inputs and keeps, per procedure, the input whose
+// costliest call scores highest. The score is metered work units
+// (deterministic, so a seed reproduces a search) or elapsed clock ticks
+// (cycles in the benchmark). Crashes are not the goal: the search looks for
+// inputs that push a call towards, or past, its WORK_BOUND_*.
+//
+// saveWorstCase() stores a champion as a snapshot of its prefilled vault plus
+// a tick log of its calls. vault_replay --snapshot replays it, and
+// worstcase_bench --run times it as a regression benchmark.
+
+#pragma once
+
+#include "VaultReplay.h"
+
+#include <functional>
+#include <memory>
+
+// ============================================================================
+// INPUTS
+// ============================================================================
+
+enum class WorstCasePrefill : uint8_t {
+    CREATED = 0,                 // Awaiting deposit
+    FUNDED = 1,                  // Deposited, nothing verified
+    VERIFIED = 2,                // Every milestone verified, none released
+    LAST_MILESTONE_LEFT = 3      // All but the last milestone released
+};
+constexpr uint32_t WORST_CASE_PREFILLS = 4;
+
+enum class WorstCaseMetric : uint8_t { WORK_UNITS, CLOCK };
+
+constexpr uint64_t WORST_CASE_MILESTONE_AMOUNT = 1000;
+constexpr uint64_t WORST_CASE_EARLY_TICK = 100;
+constexpr uint64_t WORST_CASE_LATE_TICK = 2 + REFUND_TIMEOUT_TICKS;  // Past every prefilled timeout
+constexpr uint32_t WORST_CASE_MAX_CALLS = 4;
+
+inline QubicAddress worstCasePayer() { return hostAddress("WORSTCASEPAYER"); }
+inline QubicAddress worstCaseBeneficiary() { return hostAddress("WORSTCASEBENEFICIARY"); }
+inline QubicAddress worstCaseOracle() { return hostAddress("WORSTCASEORACLE"); }
+
+struct WorstCaseCall {
+    WorkloadOpKind kind = WorkloadOpKind::GET_PROTOCOL_STATS;
+    uint32_t target = 0;         // Slot; past the prefill and earlier creates means `missingId`
+    uint64_t missingId = 0;
+    uint32_t milestoneId = 1;
+    uint32_t milestoneCount = 1; // createAgreement
+    uint8_t sender = 0;          // 0 payer, 1 beneficiary, 2 oracle
+    bool exactValue = true;      // deposit sends the agreement total
+    bool late = false;           // Called after the prefilled timeouts
+};
+
+struct WorstCaseInput {
+    uint32_t prefill = 0;
+    uint32_t milestones = 1;
+    WorstCasePrefill prefillState = WorstCasePrefill::FUNDED;
+    std::vector<WorstCaseCall> calls;
+};
+
+struct WorstCaseChampion {
+    bool found = false;
+    WorstCaseInput input;
+    uint32_t call = 0;           // Index of the scoring call in input.calls
+    uint64_t score = 0;
+    uint64_t units = 0;
+    uint64_t clock = 0;
+    bool succeeded = false;
+};
+
+/** The documented worst case of the procedure behind `kind`. */
+inline uint64_t workloadWorkBound(WorkloadOpKind kind) {
+    switch (kind) {
+        case WorkloadOpKind::CREATE_AGREEMENT: return WORK_BOUND_CREATE_AGREEMENT;
+        case WorkloadOpKind::DEPOSIT: return WORK_BOUND_DEPOSIT;
+        case WorkloadOpKind::MARK_MILESTONE_VERIFIED: return WORK_BOUND_MARK_MILESTONE_VERIFIED;
+        case WorkloadOpKind::RELEASE_MILESTONE: return WORK_BOUND_RELEASE_MILESTONE;
+        case WorkloadOpKind::REFUND: return WORK_BOUND_REFUND;
+        case WorkloadOpKind::GET_AGREEMENT: return WORK_BOUND_GET_AGREEMENT;
+        case WorkloadOpKind::GET_MILESTONE: return WORK_BOUND_GET_MILESTONE;
+        case WorkloadOpKind::GET_PROTOCOL_STATS: return WORK_BOUND_GET_PROTOCOL_STATS;
+    }
+    return 0;
+}
+
+/**
+ * Writes the prefill of `input` straight into the slots of a freshly
+ * initialized vault, with consistent counters, so a full table costs one pass
+ * instead of MAX_AGREEMENTS calls.
+ */
+inline void fillWorstCasePrefill(PronexmaVaultState& vault, const WorstCaseInput& input) {
+    const QubicAddress payer = worstCasePayer();
+    const QubicAddress beneficiary = worstCaseBeneficiary();
+    const QubicAddress oracle = worstCaseOracle();
+    uint32_t count = std::min(input.prefill, MAX_AGREEMENTS);
+    uint32_t milestones = std::max(1u, std::min(input.milestones, MAX_MILESTONES_PER_AGREEMENT));
+    uint64_t total = milestones * WORST_CASE_MILESTONE_AMOUNT;
+    for (uint32_t i = 0; i < count; ++i) {
+        Agreement& agreement = vault.agreements[i];
+        agreement = Agreement{};
+        agreement.id = (static_cast<uint64_t>(AGREEMENT_ID_PREFIX) << 32) | (i + 1);
+        agreement.payer = payer;
+        agreement.beneficiary = beneficiary;
+        agreement.oracleAdmin = oracle;
+        agreement.totalAmount = total;
+        agreement.milestoneCount = milestones;
+        agreement.createdAtTick = 1;
+        for (uint32_t m = 0; m < milestones; ++m) {
+            agreement.milestones[m].id = m + 1;
+            agreement.milestones[m].amount = WORST_CASE_MILESTONE_AMOUNT;
+        }
+        if (input.prefillState == WorstCasePrefill::CREATED) continue;
+        agreement.state = AgreementState::FUNDED;
+        agreement.lockedAmount = total;
+        agreement.fundedAtTick = 1;
+        agreement.timeoutTick = 1 + REFUND_TIMEOUT_TICKS;
+        if (input.prefillState == WorstCasePrefill::FUNDED) continue;
+        agreement.state = AgreementState::ACTIVE;
+        for (uint32_t m = 0; m < milestones; ++m) {
+            Milestone& milestone = agreement.milestones[m];
+            milestone.state = MilestoneState::VERIFIED;
+            milestone.verifiedAtTick = 1;
+            if (input.prefillState == WorstCasePrefill::LAST_MILESTONE_LEFT && m + 1 < milestones) {
+                milestone.state = MilestoneState::RELEASED;
+                milestone.releasedAtTick = 1;
+                agreement.releasedAmount += milestone.amount - releaseFee(milestone.amount);
+                agreement.lockedAmount -= milestone.amount;
+            }
+        }
+    }
+    vault.activeAgreementCount = count;
+    vault.agreementCounter = count;
+    vault.totalValueLocked = 0;
+    vault.totalValueReleased = 0;
+    vault.protocolFeeAccrued = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        const Agreement& agreement = vault.agreements[i];
+        vault.totalValueLocked += agreement.lockedAmount;
+        vault.totalValueReleased += agreement.releasedAmount;
+        for (uint32_t m = 0; m < agreement.milestoneCount; ++m) {
+            if (agreement.milestones[m].state == MilestoneState::RELEASED) {
+                vault.protocolFeeAccrued += releaseFee(agreement.milestones[m].amount);
+            }
+        }
+    }
+    rebuildCapacityCounters(vault);
+    rebuildAccountingCounters(vault);
+    rebuildAgreementColumns(vault);
+    rebuildTickActivity(vault);
+}
+
+/** The tick-log call for `input.calls[index]`; `created` counts earlier successful creates. */
+inline WorkloadOp lowerWorstCaseCall(const WorstCaseInput& input, size_t index, uint32_t created) {
+    const WorstCaseCall& call = input.calls[index];
+    const QubicAddress parties[3] = {worstCasePayer(), worstCaseBeneficiary(), worstCaseOracle()};
+    WorkloadOp op;
+    op.kind = call.kind;
+    op.tick = call.late ? WORST_CASE_LATE_TICK : WORST_CASE_EARLY_TICK;
+    op.sender = parties[call.sender % 3];
+    op.milestoneId = call.milestoneId;
+    uint32_t slots = std::min(input.prefill, MAX_AGREEMENTS) + created;
+    op.agreementId = call.target < slots ? (static_cast<uint64_t>(AGREEMENT_ID_PREFIX) << 32) | (call.target + 1)
+                                         : call.missingId;
+    if (call.kind == WorkloadOpKind::CREATE_AGREEMENT) {
+        op.sender = parties[0];
+        op.beneficiary = parties[1];
+        op.oracleAdmin = parties[2];
+        op.milestoneCount = std::max(1u, std::min(call.milestoneCount, MAX_MILESTONES_PER_AGREEMENT));
+        for (uint32_t m = 0; m < op.milestoneCount; ++m) op.amounts[m] = WORST_CASE_MILESTONE_AMOUNT;
+        op.totalAmount = op.milestoneCount * WORST_CASE_MILESTONE_AMOUNT;
+    }
+    if (call.kind == WorkloadOpKind::DEPOSIT) {
+        uint32_t milestones = call.target < std::min(input.prefill, MAX_AGREEMENTS) ? input.milestones
+                                                                                     : call.milestoneCount;
+        op.value = call.exactValue ? milestones * WORST_CASE_MILESTONE_AMOUNT : 1;
+    }
+    return op;
+}
+
+// ============================================================================
+// SEARCH
+// ============================================================================
+
+/**
+ * Evolutionary search for the costliest call of each procedure. Each step
+ * mutates a champion (or draws a fresh input), replays it on a freshly filled
+ * vault and promotes it wherever one of its calls beats the current champion.
+ * `clock` is read around every call for the CLOCK metric.
+ */
+class WorstCaseSearch {
+public:
+    using Clock = std::function<uint64_t()>;
+
+    WorstCaseSearch(uint64_t seed, WorstCaseMetric metric, Clock clock)
+        : rng_(seed), metric_(metric), clock_(std::move(clock)), vault_(std::make_unique<PronexmaVaultState>()),
+          engine_(*vault_) {}
+
+    /** Runs `evaluations` candidate inputs. */
+    void run(uint64_t evaluations) {
+        for (uint64_t i = 0; i < evaluations; ++i) step();
+    }
+
+    void step() {
+        WorstCaseInput candidate;
+        const WorstCaseChampion* parent = pickParent();
+        if (parent == nullptr || rng_.below(5) == 0) {
+            candidate = randomInput();
+        } else {
+            candidate = parent->input;
+            uint32_t mutations = 1 + rng_.below(3);
+            for (uint32_t m = 0; m < mutations; ++m) mutate(candidate);
+        }
+        consider(candidate);
+    }
+
+    /** Scores `input` and promotes it where it wins. */
+    void consider(const WorstCaseInput& input) {
+        ++evaluations_;
+        std::array<WorstCaseChampion, WORKLOAD_OP_KINDS> best;
+        evaluate(input, best);
+        for (uint32_t k = 0; k < WORKLOAD_OP_KINDS; ++k) {
+            if (best[k].found && (!champions_[k].found || best[k].score > champions_[k].score)) {
+                champions_[k] = best[k];
+                ++improvements_;
+            }
+        }
+    }
+
+    /**
+     * Replays `input` on a freshly filled vault; `best[k]` receives the
+     * costliest call of each procedure it makes.
+     */
+    void evaluate(const WorstCaseInput& input, std::array<WorstCaseChampion, WORKLOAD_OP_KINDS>& best) {
+        engine_.initialize(hostAddress("WORSTCASEFEES"));
+        fillWorstCasePrefill(*vault_, input);
+        NativeHost host;
+        HostContextBinding binding(engine_, host.context());
+        host.credit(host.contractAccount(), vault_->totalValueLocked);
+        uint32_t created = 0;
+        for (size_t i = 0; i < input.calls.size(); ++i) {
+            WorkloadOp op = lowerWorstCaseCall(input, i, created);
+            host.credit(op.sender, op.value);
+            uint64_t begin = clock_();
+            bool ok = runWorkloadOp(engine_, host, op);
+            uint64_t elapsed = clock_() - begin;
+            if (ok && op.kind == WorkloadOpKind::CREATE_AGREEMENT) ++created;
+
+            WorstCaseChampion score;
+            score.found = true;
+            score.input = input;
+            score.call = static_cast<uint32_t>(i);
+            score.units = engine_.lastWork().units;
+            score.clock = elapsed;
+            score.score = metric_ == WorstCaseMetric::WORK_UNITS ? score.units : score.clock;
+            score.succeeded = ok;
+            WorstCaseChampion& slot = best[static_cast<uint32_t>(op.kind)];
+            if (!slot.found || score.score > slot.score) slot = std::move(score);
+        }
+    }
+
+    const WorstCaseChampion& champion(WorkloadOpKind kind) const { return champions_[static_cast<uint32_t>(kind)]; }
+    uint64_t evaluations() const { return evaluations_; }
+    uint64_t improvements() const { return improvements_; }
+    PronexmaVaultEngine& engine() { return engine_; }
+
+private:
+    const WorstCaseChampion* pickParent() {
+        uint32_t start = rng_.below(WORKLOAD_OP_KINDS);
+        for (uint32_t i = 0; i < WORKLOAD_OP_KINDS; ++i) {
+            const WorstCaseChampion& champion = champions_[(start + i) % WORKLOAD_OP_KINDS];
+            if (champion.found) return &champion;
+        }
+        return nullptr;
+    }
+
+    WorstCaseInput randomInput() {
+        WorstCaseInput input;
+        input.prefill = rng_.below(MAX_AGREEMENTS + 1);
+        input.milestones = 1 + rng_.below(MAX_MILESTONES_PER_AGREEMENT);
+        input.prefillState = static_cast<WorstCasePrefill>(rng_.below(WORST_CASE_PREFILLS));
+        uint32_t calls = 1 + rng_.below(WORST_CASE_MAX_CALLS);
+        for (uint32_t i = 0; i < calls; ++i) input.calls.push_back(randomCall(input));
+        return input;
+    }
+
+    WorstCaseCall randomCall(const WorstCaseInput& input) {
+        WorstCaseCall call;
+        call.kind = static_cast<WorkloadOpKind>(rng_.below(WORKLOAD_OP_KINDS));
+        call.target = randomTarget(input);
+        call.missingId = randomMissingId(input);
+        call.milestoneId = 1 + rng_.below(MAX_MILESTONES_PER_AGREEMENT + 1);
+        call.milestoneCount = 1 + rng_.below(MAX_MILESTONES_PER_AGREEMENT);
+        call.sender = static_cast<uint8_t>(rng_.below(3));
+        call.exactValue = rng_.below(4) != 0;
+        call.late = rng_.below(2) == 0;
+        return call;
+    }
+
+    // Edges first: the first, last and one-past-last slots are where a scan
+    // is cheapest, dearest and falls through to a miss.
+    uint32_t randomTarget(const WorstCaseInput& input) {
+        switch (rng_.below(4)) {
+            case 0: return 0;
+            case 1: return input.prefill == 0 ? 0 : input.prefill - 1;
+            case 2: return input.prefill + rng_.below(WORST_CASE_MAX_CALLS + 1);
+            default: return rng_.below(input.prefill + 1);
+        }
+    }
+
+    // IDs a future hash index could collide on: the next ID to be issued, the
+    // prefix alone, foreign prefixes and arbitrary 64-bit values.
+    uint64_t randomMissingId(const WorstCaseInput& input) {
+        uint64_t prefix = static_cast<uint64_t>(AGREEMENT_ID_PREFIX) << 32;
+        switch (rng_.below(5)) {
+            case 0: return prefix | (input.prefill + WORST_CASE_MAX_CALLS + 1);
+            case 1: return prefix;
+            case 2: return (static_cast<uint64_t>(rng_.next()) << 32) | (1 + rng_.below(input.prefill + 1));
+            case 3: return prefix | (uint64_t(1 + rng_.below(1024)) << 20);
+            default: return rng_.next();
+        }
+    }
+
+    void mutate(WorstCaseInput& input) {
+        switch (rng_.below(8)) {
+            case 0: input.prefill = MAX_AGREEMENTS; break;
+            case 1: input.prefill = std::min<uint32_t>(MAX_AGREEMENTS, input.prefill + 1 + rng_.below(1000)); break;
+            case 2: input.prefill = rng_.below(MAX_AGREEMENTS + 1); break;
+            case 3: input.milestones = pickMilestoneCount(); break;
+            case 4: input.prefillState = static_cast<WorstCasePrefill>(rng_.below(WORST_CASE_PREFILLS)); break;
+            case 5:
+                if (input.calls.size() < WORST_CASE_MAX_CALLS) {
+                    input.calls.insert(input.calls.begin() + rng_.below(static_cast<uint32_t>(input.calls.size()) + 1),
+                                       randomCall(input));
+                } else {
+                    input.calls.erase(input.calls.begin() + rng_.below(static_cast<uint32_t>(input.calls.size())));
+                }
+                break;
+            default: mutateCall(input, input.calls[rng_.below(static_cast<uint32_t>(input.calls.size()))]); break;
+        }
+        if (input.calls.empty()) input.calls.push_back(randomCall(input));
+    }
+
+    uint32_t pickMilestoneCount() {
+        return rng_.below(2) ? MAX_MILESTONES_PER_AGREEMENT : 1 + rng_.below(MAX_MILESTONES_PER_AGREEMENT);
+    }
+
+    void mutateCall(const WorstCaseInput& input, WorstCaseCall& call) {
+        switch (rng_.below(7)) {
+            case 0: call.kind = static_cast<WorkloadOpKind>(rng_.below(WORKLOAD_OP_KINDS)); break;
+            case 1: call.target = randomTarget(input); break;
+            case 2: call.missingId = randomMissingId(input); break;
+            case 3:
+                call.milestoneId = rng_.below(2) ? input.milestones : 1 + rng_.below(MAX_MILESTONES_PER_AGREEMENT + 1);
+                break;
+            case 4: call.milestoneCount = pickMilestoneCount(); break;
+            case 5: call.sender = static_cast<uint8_t>(rng_.below(3)); break;
+            default:
+                call.exactValue = !call.exactValue || rng_.below(2) == 0;
+                call.late = !call.late;
+                break;
+        }
+    }
+
+    struct Rng {
+        workload_detail::Rng inner;
+        explicit Rng(uint64_t seed) : inner(seed) {}
+        uint64_t next() { return inner.next(); }
+        uint32_t below(uint32_t n) { return static_cast<uint32_t>(inner.next() % n); }
+    };
+
+    Rng rng_;
+    WorstCaseMetric metric_;
+    Clock clock_;
+    std::unique_ptr<PronexmaVaultState> vault_;
+    PronexmaVaultEngine engine_;
+    std::array<WorstCaseChampion, WORKLOAD_OP_KINDS> champions_;
+    uint64_t evaluations_ = 0;
+    uint64_t improvements_ = 0;
+};
+
+// ============================================================================
+// REGRESSION CASES
+// ============================================================================
+
+/**
+ * Saves `champion` as `<dir>/<name>.snap` (its prefilled vault) and
+ * `<dir>/<name>.tlog` (its calls), using `engine` as scratch.
+ */
+inline SnapshotStatus saveWorstCase(const std::string& dir, const std::string& name,
+                                    const WorstCaseChampion& champion, PronexmaVaultEngine& engine) {
+    engine.initialize(hostAddress("WORSTCASEFEES"));
+    fillWorstCasePrefill(engine.state, champion.input);
+    SnapshotStatus status = writeSnapshot(engine.state, WORST_CASE_EARLY_TICK - 1, dir + "/" + name + ".snap");
+    if (status != SnapshotStatus::OK) return status;
+
+    std::string logPath = dir + "/" + name + ".tlog";
+    int fd = ::open(logPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return SnapshotStatus::IO_ERROR;
+    NativeHost host;
+    HostContextBinding binding(engine, host.context());
+    host.credit(host.contractAccount(), engine.state.totalValueLocked);
+    TickLogWriter writer(fd);
+    status = writer.begin(WORST_CASE_EARLY_TICK);
+    uint32_t created = 0;
+    for (size_t i = 0; status == SnapshotStatus::OK && i < champion.input.calls.size(); ++i) {
+        WorkloadOp op = lowerWorstCaseCall(champion.input, i, created);
+        host.credit(op.sender, op.value);
+        bool ok = runWorkloadOp(engine, host, op);
+        if (ok && op.kind == WorkloadOpKind::CREATE_AGREEMENT) ++created;
+        status = writer.append(op, ok ? TickLogOutcome::SUCCEEDED : TickLogOutcome::FAILED);
+    }
+    if (status == SnapshotStatus::OK) status = writer.finish(engine.state);
+    ::close(fd);
+    return status;
+}
+
+/** One line of a worst-case manifest (worst.jsonl next to the saved cases). */
+struct WorstCaseManifestEntry {
+    std::string procedure;
+    std::string name;            // <name>.snap and <name>.tlog
+    uint32_t call = 0;
+    uint64_t units = 0;
+    uint64_t clock = 0;
+};
+
+inline void writeWorstCaseManifestEntry(std::FILE* out, const WorstCaseManifestEntry& entry) {
+    std::fprintf(out, "{\"procedure\":\"%s\",\"name\":\"%s\",\"call\":%u,\"units\":%llu,\"clock\":%llu}\n",
+                 entry.procedure.c_str(), entry.name.c_str(), entry.call,
+                 static_cast<unsigned long long>(entry.units), static_cast<unsigned long long>(entry.clock));
+}
+
+inline bool parseWorstCaseManifestEntry(const std::string& line, WorstCaseManifestEntry& entry) {
+    replay_detail::JsonRow row(line);
+    const std::string* procedure = nullptr;
+    const std::string* name = nullptr;
+    uint64_t call = 0;
+    if (!row.parse() || (procedure = row.text("procedure")) == nullptr || (name = row.text("name")) == nullptr ||
+        !row.number("call", call) || !row.number("units", entry.units) || !row.number("clock", entry.clock)) {
+        return false;
+    }
+    entry.procedure = *procedure;
+    entry.name = *name;
+    entry.call = static_cast<uint32_t>(call);
+    return name->find('/') == std::string::npos;
+}
+
+/** A saved case loaded for repeated runs: the prefilled vault and its calls. */
+struct WorstCaseReplay {
+    std::unique_ptr<PronexmaVaultState> vault = std::make_unique<PronexmaVaultState>();
+    std::vector<TickLogEntry> calls;
+};
+
+inline SnapshotStatus loadWorstCase(const std::string& dir, const std::string& name, WorstCaseReplay& replay) {
+    SnapshotStatus status = readSnapshot(dir + "/" + name + ".snap", *replay.vault);
+    if (status != SnapshotStatus::OK) return status;
+    int fd = ::open((dir + "/" + name + ".tlog").c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return SnapshotStatus::IO_ERROR;
+    TickLogReader reader(fd);
+    status = reader.begin();
+    replay.calls.clear();
+    bool atEnd = false;
+    while (status == SnapshotStatus::OK && !atEnd) {
+        TickLogEntry entry;
+        status = reader.next(entry, atEnd);
+        if (status == SnapshotStatus::OK && !atEnd) replay.calls.push_back(entry);
+    }
+    ::close(fd);
+    return status;
+}
@@ -0,0 +1,38 @@
+// contracts/tests/TestSupport.h
+// Pronexma Protocol - Minimal assertion helpers for the native vault tests
+
+#pragma once
+
+#include "PronexmaVault.cpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+static int testFailures = 0;
+
+#define CHECK(cond)                                                                   \
+    do {                                                                              \
+        if (!(cond)) {                                                                \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            ++testFailures;                                                           \
+        }                                                                             \
+    } while (0)
+
+#define CHECK_EQ(a, b) CHECK((a) == (b))
+
+// The key holding the label's bytes, as hostAddress maps labels.
+inline QubicAddress makeAddress(const char* text) {
+    QubicAddress address = {};
+    std::memcpy(address.data(), text, std::min(std::strlen(text), address.size()));
+    return address;
+}
+
+inline int finishTests(const char* suite) {
+    if (testFailures == 0) {
+        std::printf("%s: all checks passed\n", suite);
+        return 0;
+    }
+    std::fprintf(stderr, "%s: %d check(s) failed\n", suite, testFailures);
+    return 1;
+}
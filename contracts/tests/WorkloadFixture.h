@@ -0,0 +1,47 @@
+// contracts/tests/WorkloadFixture.h
+// Pronexma Protocol - A vault engine on a native host, driven by a generated workload
+
+#pragma once
+
+#include "TestSupport.h"
+#include "host/VaultReplay.h"
+
+#include <memory>
+
+// A default vault, its engine and a native host bound to it, initialized.
+struct TestEngine {
+    std::unique_ptr<PronexmaVaultState> vault = std::make_unique<PronexmaVaultState>();
+    PronexmaVaultEngine engine{*vault};
+    NativeHost host;
+    HostContextBinding binding{engine, host.context()};
+
+    TestEngine() { engine.initialize(makeAddress("FEERECIPIENT")); }
+};
+
+// The generated workload the tests share. At 400 ticks per operation the run
+// goes past the tick trees' first horizon and refunds come due within it.
+inline WorkloadConfig testWorkload(uint64_t seed, uint64_t operations) {
+    WorkloadConfig config;
+    config.seed = seed;
+    config.operations = operations;
+    config.prefillAgreements = 100;
+    config.ticksPerOperation = 400;
+    return config;
+}
+
+/**
+ * Funds the parties of the workload `config` describes and runs every
+ * operation on `target`, passing each one and its result to `onOp`.
+ */
+template <typename OnOp>
+inline void runWorkload(TestEngine& target, const WorkloadConfig& config, OnOp onOp) {
+    WorkloadGenerator generator(config);
+    fundWorkloadParties(target.host, generator);
+    WorkloadOp op;
+    while (generator.next(op)) onOp(op, runWorkloadOp(target.engine, target.host, op));
+}
+
+/** Funds the workload's parties and runs every operation on `target`. */
+inline void runWorkload(TestEngine& target, uint64_t seed, uint64_t operations = 4000) {
+    runWorkload(target, testWorkload(seed, operations), [](const WorkloadOp&, bool) {});
+}
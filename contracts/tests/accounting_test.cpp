@@ -0,0 +1,150 @@
+// contracts/tests/accounting_test.cpp
+// Accounting identities: running sums, per-call audit hook and full-scan audit
+//
+// Built with PRONEXMA_VAULT_AUDIT=1, so every procedure checks the O(1)
+// identities whatever the build type.
+
+#include "WorkloadFixture.h"
+#include "host/VaultAudit.h"
+
+#include <memory>
+
+namespace {
+
+struct ViolationLog {
+    uint32_t count = 0;
+    VaultProcedure procedure = VaultProcedure::CREATE_AGREEMENT;
+    AccountingViolation violation = AccountingViolation::NONE;
+};
+
+void logViolation(void* context, VaultProcedure procedure, AccountingViolation violation) {
+    ViolationLog& log = *static_cast<ViolationLog*>(context);
+    if (log.count++ == 0) {
+        log.procedure = procedure;
+        log.violation = violation;
+    }
+}
+
+// A TestEngine whose per-call audit logs violations instead of aborting.
+struct Engine : TestEngine {
+    ViolationLog violations;
+
+    Engine() {
+        engine.hostHooks.onAccountingViolation = &logViolation;
+        engine.hostHooks.violationContext = &violations;
+    }
+};
+
+void testRunningSumsHoldThroughAWorkload() {
+    Engine target;
+    runWorkload(target, 11, 5000);
+    CHECK_EQ(target.violations.count, 0u);
+    const PronexmaVaultState& vault = *target.vault;
+    const AccountingCounters& running = vault.accountingCounters;
+    CHECK(running.refundedToPayers > 0);
+    CHECK(vault.protocolFeeAccrued > 0);
+    CHECK_EQ(running.depositedByPayers, vault.totalValueLocked + vault.totalValueReleased + vault.protocolFeeAccrued +
+                                            running.refundedToPayers);
+    CHECK_EQ(running.lockedByState[static_cast<uint32_t>(AgreementState::REFUNDED)], 0u);
+
+    AccountingAudit audit = auditVaultAccounting(vault);
+    CHECK(audit.clean());
+    CHECK_EQ(audit.unbalancedAgreements, 0u);
+    CHECK_EQ(audit.recounted.lockedByState, running.lockedByState);
+    CHECK_EQ(audit.recounted.depositedByPayers, running.depositedByPayers);
+    CHECK_EQ(audit.recounted.refundedToPayers, running.refundedToPayers);
+    CHECK_EQ(audit.feeSum, vault.protocolFeeAccrued);
+
+    auto rebuilt = std::make_unique<PronexmaVaultState>(vault);
+    rebuildAccountingCounters(*rebuilt);
+    CHECK_EQ(rebuilt->accountingCounters.lockedByState, running.lockedByState);
+    CHECK_EQ(rebuilt->accountingCounters.depositedByPayers, running.depositedByPayers);
+    CHECK_EQ(rebuilt->accountingCounters.refundedToPayers, running.refundedToPayers);
+}
+
+void testBrokenGlobalsTripTheNextCall() {
+    Engine target;
+    QubicAddress payer = makeAddress("PAYER");
+    target.host.credit(payer, 1000);
+    const uint64_t amounts[2] = {400, 600};
+    target.host.setSender(payer);
+    uint64_t id = target.engine.createAgreement(makeAddress("B"), makeAddress("O"), 1000, amounts, 2, "audit");
+    CHECK(target.host.invoke(payer, 1000, [&] { return target.engine.deposit(id); }));
+    CHECK_EQ(target.violations.count, 0u);
+
+    target.vault->totalValueLocked += 5;     // Funds that no agreement holds
+    CHECK(!target.engine.deposit(id));       // Even a failed call is audited
+    CHECK_EQ(target.violations.count, 1u);
+    CHECK(target.violations.procedure == VaultProcedure::DEPOSIT);
+    CHECK(target.violations.violation == AccountingViolation::TVL_NOT_STATE_SUM);
+    CHECK(auditVaultAccounting(*target.vault).violation == AccountingViolation::TVL_NOT_STATE_SUM);
+
+    target.vault->totalValueLocked -= 5;
+    target.vault->protocolFeeAccrued += 1;   // A fee nobody paid
+    CHECK_EQ(checkAccountingInvariants(*target.vault), AccountingViolation::FUNDS_NOT_CONSERVED);
+}
+
+void testFullScanFindsTheUnbalancedSlot() {
+    Engine target;
+    runWorkload(target, 5, 5000);
+    PronexmaVaultState& vault = *target.vault;
+    // A partly released agreement: one milestone paid out, one still locked.
+    uint32_t slot = AGREEMENT_NOT_FOUND, paid = 0, unpaid = 0;
+    for (uint32_t i = 0; i < vault.activeAgreementCount && slot == AGREEMENT_NOT_FOUND; ++i) {
+        const Agreement& agreement = vault.agreements[i];
+        if (agreement.state != AgreementState::ACTIVE) continue;
+        bool havePaid = false, haveUnpaid = false;
+        for (uint32_t m = 0; m < agreement.milestoneCount; ++m) {
+            bool released = agreement.milestones[m].state == MilestoneState::RELEASED;
+            if (released && !havePaid) paid = m;
+            if (!released && !haveUnpaid) unpaid = m;
+            havePaid = havePaid || released;
+            haveUnpaid = haveUnpaid || !released;
+        }
+        if (havePaid && haveUnpaid) slot = i;
+    }
+    CHECK(slot != AGREEMENT_NOT_FOUND);
+
+    // Shift one unit of the total onto the released milestone: the running
+    // sums are untouched, only the agreement itself stops adding up.
+    Agreement& agreement = vault.agreements[slot];
+    agreement.milestones[paid].amount += 1;
+    agreement.milestones[unpaid].amount -= 1;
+    CHECK_EQ(checkAccountingInvariants(vault), AccountingViolation::NONE);
+    AccountingAudit audit = auditVaultAccounting(vault);
+    CHECK(!audit.clean());
+    CHECK_EQ(audit.unbalancedAgreements, 1u);
+    CHECK_EQ(audit.firstUnbalancedSlot, slot);
+}
+
+void testFullScanFindsReleasesBeforeActivation() {
+    for (AgreementState state : {AgreementState::CREATED, AgreementState::FUNDED}) {
+        Engine target;
+        runWorkload(target, 6, 2000);
+        PronexmaVaultState& vault = *target.vault;
+        uint32_t slot = AGREEMENT_NOT_FOUND;
+        for (uint32_t i = 0; i < vault.activeAgreementCount && slot == AGREEMENT_NOT_FOUND; ++i) {
+            if (vault.agreements[i].state == state) slot = i;
+        }
+        CHECK(slot != AGREEMENT_NOT_FOUND);
+        CHECK(auditVaultAccounting(vault).clean());
+
+        // A milestone marked released with every amount left alone: no sum moves,
+        // but an agreement that was never activated cannot have paid it out.
+        vault.agreements[slot].milestones[0].state = MilestoneState::RELEASED;
+        AccountingAudit audit = auditVaultAccounting(vault);
+        CHECK(audit.violation == AccountingViolation::AGREEMENT_UNBALANCED);
+        CHECK_EQ(audit.unbalancedAgreements, 1u);
+        CHECK_EQ(audit.firstUnbalancedSlot, slot);
+    }
+}
+
+} // namespace
+
+int main() {
+    testRunningSumsHoldThroughAWorkload();
+    testBrokenGlobalsTripTheNextCall();
+    testFullScanFindsTheUnbalancedSlot();
+    testFullScanFindsReleasesBeforeActivation();
+    return finishTests("accounting_test");
+}
@@ -0,0 +1,132 @@
+// contracts/tests/address_test.cpp
+// Binary addresses: KangarooTwelve checksum, identity text round trips and
+// rejections, host labels, and the contract's address comparisons
+
+#include "TestSupport.h"
+#include "host/VaultHost.h"
+#include "host/VaultIdentity.h"
+
+#include <string>
+
+namespace {
+
+std::string hex(const uint8_t* bytes, size_t length) {
+    static const char digits[] = "0123456789ABCDEF";
+    std::string out;
+    for (size_t i = 0; i < length; ++i) {
+        out.push_back(digits[bytes[i] >> 4]);
+        out.push_back(digits[bytes[i] & 0xF]);
+    }
+    return out;
+}
+
+QubicAddress patternAddress(uint8_t seed) {
+    QubicAddress address;
+    for (size_t i = 0; i < address.size(); ++i) address[i] = static_cast<uint8_t>(seed * 37 + i * 101);
+    return address;
+}
+
+void testKangarooTwelveVectors() {
+    // RFC 9861: KangarooTwelve(M, C = empty), 32 output bytes.
+    uint8_t digest[32];
+    kangarooTwelveShort("", 0, digest, sizeof(digest));
+    CHECK_EQ(hex(digest, 32), "1AC2D450FC3B4205D19DA7BFCA1B37513C0803577AC7167F06FE2CE1F0EF39E5");
+    const uint8_t zero = 0;
+    kangarooTwelveShort(&zero, 1, digest, sizeof(digest));
+    CHECK_EQ(hex(digest, 32), "2BDA92450E8B147F8A7CB629E784A058EFCA7CF7D8218E02D345DFAA65244A1F");
+}
+
+void testIdentityRoundTrip() {
+    for (uint8_t seed = 0; seed < 50; ++seed) {
+        QubicAddress address = patternAddress(seed);
+        std::string identity = addressIdentity(address);
+        CHECK_EQ(identity.size(), QUBIC_IDENTITY_LENGTH);
+        QubicAddress decoded = {};
+        CHECK(identityToAddress(identity.data(), identity.size(), decoded));
+        CHECK(decoded == address);
+    }
+    QubicAddress ones;
+    ones.fill(0xFF);
+    std::string identity = addressIdentity(ones);
+    QubicAddress decoded = {};
+    CHECK(identityToAddress(identity.data(), identity.size(), decoded));
+    CHECK(decoded == ones);
+    // Qubic's null identity and the identity of contract 1 (QX).
+    CHECK_EQ(addressIdentity(QubicAddress{}), std::string(56, 'A') + "FXIB");
+    QubicAddress contractOne = {};
+    contractOne[0] = 1;
+    CHECK_EQ(addressIdentity(contractOne), "B" + std::string(55, 'A') + "RMID");
+}
+
+void testIdentityRejections() {
+    std::string identity = addressIdentity(patternAddress(7));
+    QubicAddress out = patternAddress(1);
+    const QubicAddress untouched = out;
+
+    std::string badChecksum = identity;
+    badChecksum[59] = badChecksum[59] == 'A' ? 'B' : 'A';
+    CHECK(!identityToAddress(badChecksum.data(), badChecksum.size(), out));
+    std::string badKey = identity;
+    badKey[3] = badKey[3] == 'Z' ? 'Y' : static_cast<char>(badKey[3] + 1);
+    CHECK(!identityToAddress(badKey.data(), badKey.size(), out));
+    std::string lower = identity;
+    lower[10] = static_cast<char>(lower[10] - 'A' + 'a');
+    CHECK(!identityToAddress(lower.data(), lower.size(), out));
+    CHECK(!identityToAddress(identity.data(), identity.size() - 1, out));
+    // 14 'Z's encode 26^14 - 1 > 2^64 - 1: no key has that quarter.
+    std::string overflow = std::string(14, 'Z') + identity.substr(14);
+    CHECK(!identityToAddress(overflow.data(), overflow.size(), out));
+    CHECK(out == untouched);
+}
+
+// Boundary text must be a checksummed identity; labels are for the host's
+// own parties and only hostAddress takes them.
+void testAddressText() {
+    QubicAddress address = {};
+    std::string identity = addressIdentity(patternAddress(3));
+    CHECK(parseAddressText(identity.data(), identity.size(), address));
+    CHECK(address == patternAddress(3));
+
+    QubicAddress untouched = address;
+    std::string typo = identity;
+    typo[0] = typo[0] == 'A' ? 'B' : 'A';
+    CHECK(!parseAddressText(typo.data(), typo.size(), address));
+    CHECK(!parseAddressText(identity.data(), identity.size() - 1, address));    // Truncated
+    CHECK(!parseAddressText("PAYER", 5, address));
+    CHECK(!parseAddressText("", 0, address));
+    CHECK(address == untouched);
+
+    CHECK(hostAddress("PAYER") == makeAddress("PAYER"));
+    CHECK(hostAddress(identity.c_str()) == patternAddress(3));
+    CHECK(hostAddress(typo.c_str()) == QubicAddress{});                         // Too long for a label
+    CHECK(hostAddress(std::string(33, 'x').c_str()) == QubicAddress{});
+}
+
+void testContractComparisons() {
+    static_assert(sizeof(QubicAddress) == 32, "addresses are 32-byte keys");
+    QubicAddress a = patternAddress(9);
+    QubicAddress b = a;
+    CHECK(addressEquals(a, b));
+    b[3] ^= 1;
+    CHECK(!addressEquals(a, b));
+    b = a;
+    b[31] ^= 0x80;
+    CHECK(!addressEquals(a, b));
+
+    CHECK(!isValidAddress(QubicAddress{}));
+    QubicAddress last = {};
+    last[31] = 1;
+    CHECK(isValidAddress(last));
+    CHECK(isValidAddress(makeAddress("ORACLE")));
+}
+
+} // namespace
+
+int main() {
+    testKangarooTwelveVectors();
+    testIdentityRoundTrip();
+    testIdentityRejections();
+    testAddressText();
+    testContractComparisons();
+    return finishTests("address_test");
+}
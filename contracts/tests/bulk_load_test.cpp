@@ -0,0 +1,120 @@
+// contracts/tests/bulk_load_test.cpp
+// Bulk load: equivalence with the per-call path, ordering and invariant checks
+
+#include "TestSupport.h"
+#include "host/VaultAudit.h"
+#include "host/VaultBulkLoad.h"
+
+#include <memory>
+
+namespace {
+
+std::vector<Agreement> makeRecords(uint32_t count) {
+    initialize(makeAddress("FEERECIPIENT"));
+    const uint64_t amounts[3] = {0, 0, 0};
+    for (uint32_t i = 0; i < count; ++i) {
+        const char* beneficiary = i % 3 == 0 ? "BENEFICIARY_A" : "BENEFICIARY_B";
+        CHECK(createAgreement(makeAddress(beneficiary), makeAddress("ORACLE"), 0, amounts, 2 + i % 2, "history") != 0);
+    }
+    for (uint32_t i = 0; i < count; i += 4) {
+        Agreement& agreement = state.agreements[i];
+        agreement.milestones[0].amount = 700;
+        agreement.totalAmount = 700;
+        agreement.lockedAmount = 700;
+        agreement.state = AgreementState::FUNDED;
+        agreement.timeoutTick = 5000 - i;
+        state.totalValueLocked += 700;
+    }
+    return std::vector<Agreement>(state.agreements.begin(), state.agreements.begin() + count);
+}
+
+void testBulkLoadMatchesIncrementalIndexes() {
+    std::vector<Agreement> records = makeRecords(500);
+
+    VaultIndexes incremental;
+    auto replay = std::make_unique<PronexmaVaultState>();
+    for (uint32_t i = 0; i < records.size(); ++i) {
+        addToVaultIndexes(incremental, records[i], i);
+    }
+
+    VaultIndexes bulk;
+    BulkLoadReport report;
+    CHECK_EQ(bulkLoadAgreements(*replay, records.data(), 500, bulk, &report), SnapshotStatus::OK);
+    CHECK_EQ(replay->activeAgreementCount, 500u);
+    CHECK_EQ(replay->agreementCounter, 500u);
+    CHECK_EQ(replay->totalValueLocked, 125u * 700);
+    CHECK_EQ(report.milestones, 250u * 2 + 250u * 3);
+    CHECK_EQ(replay->capacityCounters.milestonesUsed, report.milestones);
+    CapacityCounters loaded = replay->capacityCounters;
+    rebuildCapacityCounters(*replay);
+    CHECK_EQ(loaded.agreementsByState, replay->capacityCounters.agreementsByState);
+    CHECK(auditVaultAccounting(*replay).clean());
+
+    CHECK(bulk.byPayer == incremental.byPayer);
+    CHECK(bulk.byBeneficiary == incremental.byBeneficiary);
+    CHECK(bulk.byTimeout == incremental.byTimeout);
+    CHECK_EQ(bulk.byTimeout.front().slot, 496u);
+    for (uint32_t i = 0; i < records.size(); ++i) {
+        CHECK_EQ(bulk.byId.find(records[i].id), i);
+        CHECK_EQ(incremental.byId.find(records[i].id), i);
+    }
+    CHECK(bulk.byId.loadFactor() > 0.0 && bulk.byId.loadFactor() <= 0.5);
+    CHECK(bulk.byId.meanProbeLength() >= 1.0);
+    CHECK(bulk.byId.maxProbeLength() >= bulk.byId.meanProbeLength());
+    CHECK(incremental.byId.loadFactor() <= 0.5);
+    CHECK(std::memcmp(&replay->agreements[123], &records[123], sizeof(Agreement)) == 0);
+
+    // The vault resumes issuing IDs after the loaded ones.
+    state = *replay;
+    const uint64_t amounts[1] = {0};
+    CHECK_EQ(createAgreement(makeAddress("NEW"), makeAddress("ORACLE"), 0, amounts, 1, "next"),
+             records.back().id + 1);
+}
+
+void testBulkLoadRejectsBadStreams() {
+    std::vector<Agreement> records = makeRecords(10);
+    auto vault = std::make_unique<PronexmaVaultState>();
+    VaultIndexes indexes;
+    BulkLoadReport report;
+
+    std::swap(records[3], records[4]);
+    CHECK_EQ(bulkLoadAgreements(*vault, records.data(), 10, indexes, &report), SnapshotStatus::OUT_OF_ORDER);
+    CHECK_EQ(report.failedRecord, 4u);
+    std::swap(records[3], records[4]);
+
+    vault = std::make_unique<PronexmaVaultState>();
+    records[6].totalAmount += 1;
+    CHECK_EQ(bulkLoadAgreements(*vault, records.data(), 10, indexes, &report), SnapshotStatus::INVARIANT_VIOLATION);
+    CHECK_EQ(report.violation, MigrationViolation::MILESTONE_SUM);
+    CHECK_EQ(report.failedRecord, 6u);
+
+    // A FUNDED record that locks less than it was deposited, nothing released.
+    records[6].totalAmount -= 1;
+    records[8].lockedAmount = 500;
+    vault = std::make_unique<PronexmaVaultState>();
+    CHECK_EQ(bulkLoadAgreements(*vault, records.data(), 10, indexes, &report), SnapshotStatus::INVARIANT_VIOLATION);
+    CHECK_EQ(report.violation, MigrationViolation::UNBALANCED);
+    CHECK_EQ(report.failedRecord, 8u);
+    records[8].lockedAmount = 700;
+
+    // Balanced on its own, but a COMPLETED agreement may not hold funds.
+    records[4].state = AgreementState::COMPLETED;
+    vault = std::make_unique<PronexmaVaultState>();
+    CHECK_EQ(bulkLoadAgreements(*vault, records.data(), 10, indexes, &report), SnapshotStatus::INVARIANT_VIOLATION);
+    CHECK_EQ(report.violation, MigrationViolation::NONE);
+    CHECK_EQ(report.accountingViolation, AccountingViolation::LOCKED_WHILE_SETTLED);
+    records[4].state = AgreementState::FUNDED;
+
+    // A loaded vault is never overwritten.
+    vault = std::make_unique<PronexmaVaultState>();
+    CHECK_EQ(bulkLoadAgreements(*vault, records.data(), 10, indexes, &report), SnapshotStatus::OK);
+    CHECK_EQ(bulkLoadAgreements(*vault, records.data(), 10, indexes, &report), SnapshotStatus::BUSY);
+}
+
+} // namespace
+
+int main() {
+    testBulkLoadMatchesIncrementalIndexes();
+    testBulkLoadRejectsBadStreams();
+    return finishTests("bulk_load_test");
+}
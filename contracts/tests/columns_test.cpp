@@ -0,0 +1,120 @@
+// contracts/tests/columns_test.cpp
+// Hot columns: every procedure keeps them equal to the records, hosts that
+// write slots directly rebuild them, the full-scan audit catches drift, and
+// the aggregate views over them match a scan of the records.
+
+#include "WorkloadFixture.h"
+#include "host/VaultAudit.h"
+#include "host/VaultSnapshot.h"
+
+#include <memory>
+#include <unistd.h>
+
+namespace {
+
+uint64_t lockedByRecords(const PronexmaVaultState& vault, AgreementState agreementState) {
+    uint64_t locked = 0;
+    for (uint32_t i = 0; i < vault.activeAgreementCount; ++i) {
+        if (vault.agreements[i].state == agreementState) locked += vault.agreements[i].lockedAmount;
+    }
+    return locked;
+}
+
+uint32_t expiringByRecords(const PronexmaVaultState& vault, uint64_t tick) {
+    uint32_t expiring = 0;
+    for (uint32_t i = 0; i < vault.activeAgreementCount; ++i) {
+        const Agreement& agreement = vault.agreements[i];
+        bool live = agreement.state == AgreementState::FUNDED || agreement.state == AgreementState::ACTIVE;
+        expiring += live && agreement.timeoutTick < tick;
+    }
+    return expiring;
+}
+
+void testProceduresKeepColumnsInSync() {
+    TestEngine target;
+    runWorkload(target, 21);
+    const PronexmaVaultState& vault = *target.vault;
+    for (uint32_t i = 0; i < vault.activeAgreementCount; ++i) CHECK(agreementColumnsMatch(vault, i));
+    AccountingAudit audit = auditVaultAccounting(vault);
+    CHECK(audit.clean());
+    CHECK_EQ(audit.driftedSlots, 0u);
+}
+
+void testViewsMatchTheRecords() {
+    TestEngine target;
+    runWorkload(target, 22);
+    const PronexmaVaultState& vault = *target.vault;
+    const uint64_t scanWork = workForBytes(uint64_t(vault.activeAgreementCount) * COLUMN_SCAN_BYTES_PER_SLOT);
+    for (uint32_t s = 0; s < AGREEMENT_STATE_COUNT; ++s) {
+        AgreementState agreementState = static_cast<AgreementState>(s);
+        uint64_t locked = target.engine.sumLockedByState(agreementState);
+        CHECK_EQ(locked, lockedByRecords(vault, agreementState));
+        CHECK_EQ(locked, vault.accountingCounters.lockedByState[s]);
+        CHECK_EQ(target.engine.lastWork().units, scanWork);
+    }
+    CHECK(target.engine.sumLockedByState(AgreementState::FUNDED) > 0);
+
+    uint64_t lastTimeout = 0;
+    for (uint32_t i = 0; i < vault.activeAgreementCount; ++i) {
+        lastTimeout = std::max(lastTimeout, vault.agreements[i].timeoutTick);
+    }
+    const uint64_t ticks[] = {0, 1, lastTimeout / 2, lastTimeout, lastTimeout + 1, UINT64_MAX};
+    for (uint64_t tick : ticks) {
+        CHECK_EQ(target.engine.countExpiringBefore(tick), expiringByRecords(vault, tick));
+        CHECK_EQ(target.engine.lastWork().error, VaultError::NONE);
+    }
+    CHECK(target.engine.countExpiringBefore(UINT64_MAX) > 0);
+    CHECK_EQ(target.engine.countExpiringBefore(0), 0u);
+    CHECK(scanWork <= WORK_BOUND_SUM_LOCKED_BY_STATE);
+
+    target.engine.setWorkUnitLimit(scanWork - 1);
+    CHECK_EQ(target.engine.sumLockedByState(AgreementState::FUNDED), 0u);
+    CHECK_EQ(target.engine.lastWork().error, VaultError::WORK_LIMIT_EXCEEDED);
+    CHECK_EQ(target.engine.countExpiringBefore(UINT64_MAX), 0u);
+    CHECK(target.engine.lastWork().aborted);
+}
+
+void testAuditCatchesDriftAndRebuildRepairs() {
+    TestEngine target;
+    runWorkload(target, 23);
+    PronexmaVaultState& vault = *target.vault;
+    vault.columns.timeoutTick[3] += 1;       // A host write that skipped syncAgreementColumns
+    vault.columns.locked[40] += 1;
+    AccountingAudit audit = auditVaultAccounting(vault);
+    CHECK(audit.violation == AccountingViolation::COLUMNS_DRIFTED);
+    CHECK_EQ(audit.driftedSlots, 2u);
+
+    rebuildAgreementColumns(vault);
+    CHECK(auditVaultAccounting(vault).clean());
+}
+
+void testResetAndRestoreLeaveNoStaleColumns() {
+    TestEngine target;
+    runWorkload(target, 24);
+    const std::string path = "/tmp/pronexma_columns_" + std::to_string(::getpid());
+    CHECK_EQ(writeSnapshot(*target.vault, 1, path), SnapshotStatus::OK);
+    uint64_t funded = target.engine.sumLockedByState(AgreementState::FUNDED);
+    uint32_t expiring = target.engine.countExpiringBefore(UINT64_MAX);
+
+    // Leftover column entries past activeAgreementCount are never read.
+    target.engine.initialize(makeAddress("FEERECIPIENT"));
+    CHECK_EQ(target.engine.sumLockedByState(AgreementState::FUNDED), 0u);
+    CHECK_EQ(target.engine.countExpiringBefore(UINT64_MAX), 0u);
+
+    TestEngine restored;
+    CHECK_EQ(readSnapshot(path, *restored.vault), SnapshotStatus::OK);
+    CHECK_EQ(restored.engine.sumLockedByState(AgreementState::FUNDED), funded);
+    CHECK_EQ(restored.engine.countExpiringBefore(UINT64_MAX), expiring);
+    CHECK(auditVaultAccounting(*restored.vault).clean());
+    ::unlink(path.c_str());
+}
+
+} // namespace
+
+int main() {
+    testProceduresKeepColumnsInSync();
+    testViewsMatchTheRecords();
+    testAuditCatchesDriftAndRebuildRepairs();
+    testResetAndRestoreLeaveNoStaleColumns();
+    return finishTests("columns_test");
+}
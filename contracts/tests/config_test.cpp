@@ -0,0 +1,134 @@
+// contracts/tests/config_test.cpp
+// Compile-time vault configurations: layout of dropped fields, capacities,
+// fee basis points, the performance-counter toggle and the audit over each layout
+
+#include "TestSupport.h"
+#include "host/VaultAudit.h"
+#include "host/VaultHost.h"
+
+#include <memory>
+
+namespace {
+
+// No evidence, a fee that does not divide 10000, a tiny table.
+struct TinyOddFeeConfig : LeanInvoiceVaultConfig {
+    static constexpr uint32_t MAX_AGREEMENTS = 2;
+    static constexpr uint32_t FEE_BASIS_POINTS = 30;
+    static constexpr bool STORE_EVIDENCE = false;
+};
+
+const QubicAddress payer = makeAddress("PAYER");
+const QubicAddress beneficiary = makeAddress("BENEFICIARY");
+const QubicAddress oracle = makeAddress("ORACLE");
+const QubicAddress feeRecipient = makeAddress("FEERECIPIENT");
+
+template <typename Config>
+struct ConfiguredVault {
+    std::unique_ptr<BasicVaultState<Config>> vault = std::make_unique<BasicVaultState<Config>>();
+    BasicVaultEngine<Config> engine{*vault};
+    NativeHost host;
+    HostContextBinding binding{engine, host.context()};
+
+    ConfiguredVault() {
+        engine.initialize(feeRecipient);
+        host.credit(payer, 1ull << 40);
+    }
+
+    uint64_t createFunded(const uint64_t* amounts, uint32_t count, uint64_t total, const char* title) {
+        host.setSender(payer);
+        uint64_t id = engine.createAgreement(beneficiary, oracle, total, amounts, count, title);
+        if (id != 0) host.invoke(payer, total, [&] { return engine.deposit(id); });
+        return id;
+    }
+
+    bool verifyAndRelease(uint64_t id, uint32_t milestone) {
+        std::array<uint8_t, 64> evidence = {};
+        evidence[0] = 0xAB;
+        return host.invoke(oracle, 0, [&] { return engine.markMilestoneVerified(id, milestone, evidence); }) &&
+               host.invoke(beneficiary, 0, [&] { return engine.releaseMilestone(id, milestone); });
+    }
+};
+
+void testDroppedFieldsTakeNoBytes() {
+    static_assert(sizeof(BasicMilestone<LeanInvoiceVaultConfig>) == sizeof(MilestoneFields) + 64, "evidence only");
+    static_assert(sizeof(BasicMilestone<TinyOddFeeConfig>) == sizeof(MilestoneFields), "no optional fields");
+    static_assert(sizeof(BasicAgreement<LeanInvoiceVaultConfig>) ==
+                      sizeof(AgreementFields<LeanInvoiceVaultConfig>) + LeanInvoiceVaultConfig::TITLE_BYTES,
+                  "title only");
+    CHECK_EQ(VaultSlotBytes<LeanInvoiceVaultConfig>::TEXT, 64u);
+    CHECK_EQ(VaultSlotBytes<LeanInvoiceVaultConfig>::EVIDENCE, 4u * 64);
+    CHECK_EQ(VaultSlotBytes<TinyOddFeeConfig>::EVIDENCE, 0u);
+    CHECK(sizeof(BasicAgreement<LaunchpadVaultConfig>) * 3 < sizeof(Agreement));
+    CHECK_EQ(VaultWorkBounds<LaunchpadVaultConfig>::DEPOSIT, 100000u * WORK_PER_SLOT_PROBE);
+    CHECK_EQ(VaultWorkBounds<TinyOddFeeConfig>::MARK_MILESTONE_VERIFIED, 2 + WORK_PER_MILESTONE);
+}
+
+void testLeanVaultEnforcesItsCapacities() {
+    ConfiguredVault<LeanInvoiceVaultConfig> lean;
+    const uint64_t amounts[5] = {1000, 1000, 1000, 1000, 1000};
+    CHECK_EQ(lean.createFunded(amounts, 5, 5000, "too many milestones"), 0u);
+    CHECK(lean.engine.lastWork().error == VaultError::INVALID_MILESTONE_COUNT);
+
+    char title[100];
+    std::memset(title, 'L', sizeof(title) - 1);
+    title[sizeof(title) - 1] = '\0';
+    uint64_t id = lean.createFunded(amounts, 4, 4000, title);
+    CHECK(id != 0);
+    CHECK(lean.engine.lastWork().error == VaultError::NONE);
+    BasicAgreement<LeanInvoiceVaultConfig> agreement = lean.engine.getAgreement(id);
+    CHECK_EQ(std::strlen(agreement.title.data()), 63u);                  // Truncated to fit the field
+    CHECK(agreement.state == AgreementState::FUNDED);
+    CHECK_EQ(lean.engine.lastWork().units, WORK_PER_SLOT_PROBE + workForBytes(sizeof(agreement)));  // First slot
+    CHECK(lean.verifyAndRelease(id, 1));
+    CHECK_EQ(lean.engine.getMilestone(id, 1).evidenceHash[0], 0xABu);
+    CHECK_EQ(lean.vault->protocolFeeAccrued, 5u);                        // 0.5% of 1000
+    CHECK_EQ(checkAccountingInvariants(*lean.vault), AccountingViolation::NONE);
+    CHECK(auditVaultAccounting(*lean.vault).clean());
+}
+
+void testFeeBasisPointsAndTinyTable() {
+    CHECK_EQ(releaseFee<TinyOddFeeConfig>(1000003), 3000u);
+    CHECK_EQ(releaseFee<TinyOddFeeConfig>(UINT64_MAX),
+             static_cast<uint64_t>(static_cast<unsigned __int128>(UINT64_MAX) * 30 / 10000));
+    CHECK_EQ(releaseFee<LaunchpadVaultConfig>(1000), 10u);
+    CHECK_EQ(releaseFee(1000), 5u);
+
+    ConfiguredVault<TinyOddFeeConfig> tiny;
+    const uint64_t amounts[2] = {10000, 20000};
+    uint64_t id = tiny.createFunded(amounts, 2, 30000, "a");
+    CHECK(tiny.createFunded(amounts, 2, 30000, "b") != 0);
+    CHECK_EQ(tiny.createFunded(amounts, 2, 30000, "c"), 0u);
+    CHECK(tiny.engine.lastWork().error == VaultError::CAPACITY_REACHED);
+    CHECK(tiny.verifyAndRelease(id, 2));
+    CHECK_EQ(tiny.vault->protocolFeeAccrued, 60u);
+    CHECK_EQ(tiny.host.balanceOf(beneficiary), 19940u);
+    CHECK_EQ(tiny.engine.getCapacityStats().capacity, 2u);
+    AccountingAudit audit = auditVaultAccounting(*tiny.vault);                // The recount uses this vault's fee
+    CHECK(audit.clean());
+    CHECK_EQ(audit.feeSum, 60u);
+}
+
+void testLaunchpadSkipsPerfCounters() {
+    ConfiguredVault<LaunchpadVaultConfig> launchpad;
+    const uint64_t amounts[5] = {100, 100, 100, 100, 100};
+    uint64_t id = launchpad.createFunded(amounts, 5, 500, "raise");
+    CHECK(launchpad.verifyAndRelease(id, 1));
+    CHECK_EQ(launchpad.vault->protocolFeeAccrued, 1u);                   // 1% of 100
+    CHECK(launchpad.engine.lastWork().units > 0);
+    VaultPerfCounters counters = launchpad.engine.getPerfCounters();
+    for (const ProcedureCounters& procedure : counters.procedures) CHECK_EQ(procedure.calls, 0u);
+    VaultCapacityStats stats = launchpad.engine.getCapacityStats();
+    CHECK_EQ(stats.capacity, 100000u);
+    CHECK_EQ(stats.stateBytes, sizeof(BasicVaultState<LaunchpadVaultConfig>));
+    CHECK_EQ(stats.bytesReserved[static_cast<uint32_t>(StateCategory::TEXT)], 100000u * 64);
+}
+
+} // namespace
+
+int main() {
+    testDroppedFieldsTakeNoBytes();
+    testLeanVaultEnforcesItsCapacities();
+    testFeeBasisPointsAndTinyTable();
+    testLaunchpadSkipsPerfCounters();
+    return finishTests("config_test");
+}
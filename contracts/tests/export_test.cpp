@@ -0,0 +1,230 @@
+// contracts/tests/export_test.cpp
+// Columnar and stream exports: column files, dictionaries, NDJSON/binary streams
+
+#include "TestSupport.h"
+#include "host/VaultColumnExport.h"
+#include "host/VaultStreamExport.h"
+
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+namespace {
+
+std::string tempDir(const char* name) {
+    return std::string("/tmp/pronexma_export_") + name + "_" + std::to_string(::getpid());
+}
+
+std::vector<uint8_t> slurp(const std::string& path) {
+    std::vector<uint8_t> bytes;
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return bytes;
+    uint8_t chunk[4096];
+    ssize_t n;
+    while ((n = ::read(fd, chunk, sizeof(chunk))) > 0) bytes.insert(bytes.end(), chunk, chunk + n);
+    ::close(fd);
+    return bytes;
+}
+
+template <typename T>
+std::vector<T> readColumn(const std::string& path) {
+    std::vector<uint8_t> bytes = slurp(path);
+    std::vector<T> values(bytes.size() / sizeof(T));
+    std::memcpy(values.data(), bytes.data(), values.size() * sizeof(T));
+    return values;
+}
+
+std::string dictionaryEntry(const std::string& dir, const char* name, uint32_t code) {
+    std::vector<uint64_t> offsets = readColumn<uint64_t>(dir + "/dict/" + name + ".offsets");
+    std::vector<uint8_t> data = slurp(dir + "/dict/" + name + ".data");
+    if (code + 1 >= offsets.size()) return "<out of range>";
+    return std::string(data.begin() + offsets[code], data.begin() + offsets[code + 1]);
+}
+
+void removeExport(const std::string& dir) {
+    std::string command = "rm -rf '" + dir + "'";
+    CHECK_EQ(std::system(command.c_str()), 0);
+}
+
+void populate() {
+    initialize(makeAddress("FEERECIPIENT"));
+    const uint64_t two[2] = {0, 0};
+    const uint64_t three[3] = {0, 0, 0};
+    for (uint32_t i = 0; i < 200; ++i) {
+        const char* beneficiary = i % 2 == 0 ? "BENEFICIARY_A" : "BENEFICIARY_B";
+        CHECK(createAgreement(makeAddress(beneficiary), makeAddress("ORACLE"), 0, i % 3 == 0 ? three : two,
+                              i % 3 == 0 ? 3 : 2, i == 7 ? "special" : "escrow") != 0);
+    }
+    state.agreements[5].lockedAmount = 1234;
+    state.agreements[5].milestones[1].state = MilestoneState::VERIFIED;
+    state.agreements[5].milestones[1].evidenceHash[0] = 0xAB;
+}
+
+void testExportColumns() {
+    populate();
+    std::string dir = tempDir("vault");
+    ColumnExportStats stats;
+    CHECK_EQ(exportVaultColumns(state, dir, &stats), SnapshotStatus::OK);
+    CHECK_EQ(stats.agreements, 200u);
+    CHECK_EQ(stats.milestones, 67u * 3 + 133u * 2);
+    CHECK_EQ(stats.addressEntries, 4u);   // Null payer, two beneficiaries, the oracle
+    CHECK(!slurp(dir + "/manifest.json").empty());
+
+    std::vector<uint64_t> ids = readColumn<uint64_t>(dir + "/agreements/id.bin");
+    std::vector<uint64_t> locked = readColumn<uint64_t>(dir + "/agreements/lockedAmount.bin");
+    std::vector<uint32_t> beneficiaries = readColumn<uint32_t>(dir + "/agreements/beneficiary.bin");
+    std::vector<uint32_t> titles = readColumn<uint32_t>(dir + "/agreements/title.bin");
+    CHECK_EQ(ids.size(), 200u);
+    CHECK_EQ(ids[42], state.agreements[42].id);
+    CHECK_EQ(locked[5], 1234u);
+    CHECK_EQ(dictionaryEntry(dir, "addresses", beneficiaries[1]), addressIdentity(makeAddress("BENEFICIARY_B")));
+    CHECK_EQ(dictionaryEntry(dir, "text", titles[7]), "special");
+    CHECK_EQ(titles[8], titles[9]);
+
+    // Agreement 5 has two milestones; it follows 0 and 3 (three each) and 1, 2, 4 (two each).
+    std::vector<uint32_t> rows = readColumn<uint32_t>(dir + "/milestones/agreementRow.bin");
+    std::vector<uint8_t> milestoneStates = readColumn<uint8_t>(dir + "/milestones/state.bin");
+    std::vector<uint8_t> evidence = slurp(dir + "/milestones/evidenceHash.bin");
+    size_t row = 3 + 2 + 2 + 3 + 2 + 1;
+    CHECK_EQ(rows.size(), stats.milestones);
+    CHECK_EQ(rows[row], 5u);
+    CHECK_EQ(milestoneStates[row], static_cast<uint8_t>(MilestoneState::VERIFIED));
+    CHECK_EQ(evidence.size(), stats.milestones * 64);
+    CHECK_EQ(evidence[row * 64], 0xAB);
+    removeExport(dir);
+}
+
+void testSnapshotExportMatchesLiveExport() {
+    populate();
+    std::string live = tempDir("live");
+    std::string streamed = tempDir("streamed");
+    std::string snapshot = tempDir("snap") + ".snap";
+    CHECK_EQ(writeSnapshot(state, 9, snapshot, BlockEncoding::COLUMNAR), SnapshotStatus::OK);
+    CHECK_EQ(exportVaultColumns(state, live), SnapshotStatus::OK);
+    CHECK_EQ(exportSnapshotColumns(snapshot, streamed), SnapshotStatus::OK);
+    for (const char* file : {"/agreements/id.bin", "/agreements/payer.bin", "/milestones/amount.bin",
+                             "/milestones/description.bin", "/dict/text.data", "/manifest.json"}) {
+        CHECK(slurp(live + file) == slurp(streamed + file));
+    }
+    removeExport(live);
+    removeExport(streamed);
+    ::unlink(snapshot.c_str());
+}
+
+void testDictionaryCapStillExports() {
+    populate();
+    std::string dir = tempDir("capped");
+    VaultColumnExporter exporter(1);
+    CHECK_EQ(exporter.open(dir), SnapshotStatus::OK);
+    for (uint32_t i = 0; i < state.activeAgreementCount; ++i) {
+        CHECK_EQ(exporter.append(state.agreements[i]), SnapshotStatus::OK);
+    }
+    CHECK_EQ(exporter.finish(), SnapshotStatus::OK);
+    // Only the first address (the null payer) is deduplicated; every later value gets its own entry.
+    std::vector<uint32_t> beneficiaries = readColumn<uint32_t>(dir + "/agreements/beneficiary.bin");
+    CHECK(exporter.stats().addressEntries > 4u);
+    CHECK_EQ(dictionaryEntry(dir, "addresses", beneficiaries[199]), addressIdentity(makeAddress("BENEFICIARY_B")));
+    removeExport(dir);
+}
+
+// Streams into a non-blocking pipe drained by a deliberately slow reader.
+std::string streamThroughPipe(const StreamExportOptions& options, StreamExportStats& stats) {
+    int fds[2];
+    CHECK_EQ(::pipe(fds), 0);
+    CHECK_EQ(::fcntl(fds[1], F_SETFL, O_NONBLOCK), 0);
+    std::string received;
+    std::thread reader([&] {
+        char chunk[1024];
+        ssize_t n;
+        while ((n = ::read(fds[0], chunk, sizeof(chunk))) > 0) {
+            received.append(chunk, static_cast<size_t>(n));
+            std::this_thread::sleep_for(std::chrono::microseconds(20));
+        }
+    });
+    CHECK_EQ(streamVaultEngine(defaultEngine, fds[1], options, &stats), SnapshotStatus::OK);
+    ::close(fds[1]);
+    reader.join();
+    ::close(fds[0]);
+    return received;
+}
+
+void testNdjsonStreamWithBackpressure() {
+    populate();
+    state.agreements[3].title[0] = '"';
+    state.totalValueLocked = 1234;
+    StreamExportOptions options;
+    options.bufferBytes = 1;               // Clamped to STREAM_MIN_BUFFER
+    StreamExportStats stats;
+    std::string out = streamThroughPipe(options, stats);
+
+    size_t lines = 0;
+    for (char c : out) lines += c == '\n';
+    CHECK_EQ(lines, 200u + stats.milestones + 1);
+    CHECK_EQ(stats.bytes, out.size());
+    CHECK(stats.stalls > 0);
+    CHECK(out.find("\"title\":\"\\\"scrow\"") != std::string::npos);
+    CHECK(out.find("{\"type\":\"end\",\"agreements\":200,") != std::string::npos);
+    CHECK(out.find("\"totalValueLocked\":\"1234\"") != std::string::npos);
+}
+
+void testNdjsonReplacesInvalidUtf8() {
+    populate();
+    // Valid two-byte é, a stray 0xFF, a surrogate and a three-byte lead cut short.
+    const char title[] = "a\xC3\xA9\xFF\xED\xA0\x80\xE2\x82";
+    std::memcpy(state.agreements[4].title.data(), title, sizeof(title));
+    StreamExportOptions options;
+    StreamExportStats stats;
+    std::string out = streamThroughPipe(options, stats);
+
+    const std::string replacement = "\xEF\xBF\xBD";
+    std::string expected = "\"title\":\"a\xC3\xA9";
+    for (int i = 0; i < 6; ++i) expected += replacement;
+    CHECK(out.find(expected + "\"") != std::string::npos);
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(out.data());
+    for (size_t i = 0; i < out.size();) {
+        size_t length = bytes[i] < 0x80 ? 1 : stream_export_detail::utf8SequenceLength(bytes + i, out.size() - i);
+        CHECK(length != 0);
+        i += length == 0 ? 1 : length;
+    }
+}
+
+void testBinaryStreamFrames() {
+    populate();
+    StreamExportOptions options;
+    options.format = StreamFormat::BINARY;
+    StreamExportStats stats;
+    std::string out = streamThroughPipe(options, stats);
+    CHECK(out.compare(0, sizeof(STREAM_MAGIC), STREAM_MAGIC, sizeof(STREAM_MAGIC)) == 0);
+
+    size_t offset = sizeof(STREAM_MAGIC) + sizeof(uint32_t);
+    uint32_t agreements = 0, milestones = 0, ends = 0;
+    uint64_t secondId = 0;
+    while (offset + 5 <= out.size()) {
+        uint8_t kind = static_cast<uint8_t>(out[offset]);
+        uint32_t payload;
+        std::memcpy(&payload, out.data() + offset + 1, sizeof(payload));
+        if (kind == static_cast<uint8_t>(StreamFrameKind::AGREEMENT) && ++agreements == 2) {
+            std::memcpy(&secondId, out.data() + offset + 5, sizeof(secondId));
+        }
+        milestones += kind == static_cast<uint8_t>(StreamFrameKind::MILESTONE);
+        ends += kind == static_cast<uint8_t>(StreamFrameKind::END);
+        offset += 5 + payload;
+    }
+    CHECK_EQ(offset, out.size());
+    CHECK_EQ(agreements, 200u);
+    CHECK_EQ(milestones, stats.milestones);
+    CHECK_EQ(ends, 1u);
+    CHECK_EQ(secondId, state.agreements[1].id);
+}
+
+} // namespace
+
+int main() {
+    testExportColumns();
+    testSnapshotExportMatchesLiveExport();
+    testDictionaryCapStillExports();
+    testNdjsonStreamWithBackpressure();
+    testNdjsonReplacesInvalidUtf8();
+    testBinaryStreamFrames();
+    return finishTests("export_test");
+}
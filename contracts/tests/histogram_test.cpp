@@ -0,0 +1,158 @@
+// contracts/tests/histogram_test.cpp
+// Latency histogram accuracy, merging, export round trip and outcome codes
+
+#include "TestSupport.h"
+#include "host/VaultHistogram.h"
+
+#include <memory>
+
+#include <unistd.h>
+
+namespace {
+
+std::string tempPath(const char* name) {
+    return std::string("/tmp/pronexma_histogram_") + name + "_" + std::to_string(::getpid());
+}
+
+uint64_t exactPercentile(std::vector<uint64_t> samples, double percentile) {
+    std::sort(samples.begin(), samples.end());
+    size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * static_cast<double>(samples.size())));
+    return samples[std::max<size_t>(rank, 1) - 1];
+}
+
+void testBucketsCoverEveryValue() {
+    uint64_t values[] = {0, 1, 2047, 2048, 2049, 4095, 4096, 1000003, uint64_t(1) << 40, UINT64_MAX - 1, UINT64_MAX};
+    for (uint64_t value : values) {
+        uint32_t index = LatencyHistogram::indexOf(value);
+        CHECK(index < LatencyHistogram::INDEX_COUNT);
+        CHECK(LatencyHistogram::lowestAt(index) <= value);
+        CHECK(LatencyHistogram::highestAt(index) >= value);
+    }
+    CHECK_EQ(LatencyHistogram::indexOf(UINT64_MAX), LatencyHistogram::INDEX_COUNT - 1);
+    for (uint32_t index = 1; index < LatencyHistogram::INDEX_COUNT; ++index) {
+        CHECK_EQ(LatencyHistogram::lowestAt(index), LatencyHistogram::highestAt(index - 1) + 1);
+    }
+}
+
+void testPercentilesWithinThreeDigits() {
+    LatencyHistogram histogram;
+    std::vector<uint64_t> samples;
+    workload_detail::Rng rng(42);
+    for (uint32_t i = 0; i < 200000; ++i) {
+        // Mostly fast calls with a long tail, like a scan-dominated procedure.
+        uint64_t value = 200 + rng.next() % 5000;
+        if (i % 100 == 0) value = 40000 + rng.next() % 2000000;
+        samples.push_back(value);
+        histogram.record(value);
+    }
+    CHECK_EQ(histogram.count(), samples.size());
+    for (double percentile : {50.0, 90.0, 99.0, 99.9, 99.99}) {
+        uint64_t exact = exactPercentile(samples, percentile);
+        uint64_t reported = histogram.valueAtPercentile(percentile);
+        CHECK(reported >= exact);
+        CHECK(reported - exact <= exact / 1024);
+    }
+    CHECK_EQ(histogram.valueAtPercentile(100.0), exactPercentile(samples, 100.0));
+    CHECK_EQ(histogram.max(), exactPercentile(samples, 100.0));
+
+    LatencyHistogram doubled = histogram.scaled(2.0);
+    CHECK_EQ(doubled.count(), histogram.count());
+    CHECK_EQ(doubled.max(), 2 * histogram.max());
+    uint64_t p99 = histogram.valueAtPercentile(99.0);
+    CHECK(doubled.valueAtPercentile(99.0) + p99 / 256 >= 2 * p99);
+    CHECK(doubled.valueAtPercentile(99.0) <= 2 * p99 + p99 / 256);
+}
+
+void testExportMergesAcrossRuns() {
+    LatencyHistograms first, second, whole;
+    for (uint64_t i = 1; i <= 5000; ++i) {
+        LatencyHistograms& half = i % 2 ? first : second;
+        uint32_t outcome = i % 7 == 0 ? static_cast<uint32_t>(VaultError::AGREEMENT_NOT_FOUND) : 0;
+        half.record(WorkloadOpKind::DEPOSIT, outcome, i * 37);
+        whole.record(WorkloadOpKind::DEPOSIT, outcome, i * 37);
+        half.record(WorkloadOpKind::GET_AGREEMENT, 0, i);
+        whole.record(WorkloadOpKind::GET_AGREEMENT, 0, i);
+    }
+
+    std::string path = tempPath("runs");
+    std::FILE* out = std::fopen(path.c_str(), "w");
+    CHECK(writeLatencyHistograms(out, first, "build-a"));
+    CHECK(writeLatencyHistograms(out, second, "build-b"));
+    std::fclose(out);
+
+    LatencyHistograms merged;
+    std::FILE* in = std::fopen(path.c_str(), "r");
+    char line[1 << 16];
+    uint32_t lines = 0;
+    while (std::fgets(line, sizeof(line), in) != nullptr) {
+        std::string text(line);
+        text.pop_back();
+        CHECK(mergeHistogramLine(text, merged));
+        ++lines;
+    }
+    std::fclose(in);
+    CHECK_EQ(lines, 6u);                   // Two runs of deposit OK/NOT_FOUND and getAgreement OK
+    for (WorkloadOpKind kind : {WorkloadOpKind::DEPOSIT, WorkloadOpKind::GET_AGREEMENT}) {
+        for (uint32_t o = 0; o < LATENCY_OUTCOMES; ++o) {
+            const LatencyHistogram& expected = whole.at(kind, o);
+            const LatencyHistogram& actual = merged.at(kind, o);
+            CHECK_EQ(actual.count(), expected.count());
+            CHECK_EQ(actual.min(), expected.min());
+            CHECK_EQ(actual.max(), expected.max());
+            CHECK_EQ(actual.sum(), expected.sum());
+            CHECK_EQ(actual.valueAtPercentile(99.9), expected.valueAtPercentile(99.9));
+        }
+    }
+    CHECK_EQ(merged.procedure(WorkloadOpKind::DEPOSIT).count(), 5000u);
+
+    std::string good = "{\"histogram\":\"latency\",\"label\":\"\",\"procedure\":\"refund\",\"outcome\":\"OK\","
+                       "\"unit\":\"ns\",\"subBucketBits\":10,\"count\":3,\"min\":5,\"max\":9,\"sum\":21,"
+                       "\"buckets\":[[5,1],[7,1],[9,1]]}";
+    CHECK(mergeHistogramLine(good, merged));
+    CHECK_EQ(merged.at(WorkloadOpKind::REFUND, 0).valueAtPercentile(50.0), 7u);
+    std::string otherLayout = good;
+    otherLayout.replace(otherLayout.find("\"subBucketBits\":10"), 18, "\"subBucketBits\":7");
+    CHECK(!mergeHistogramLine(otherLayout, merged));
+    std::string wrongCount = good;
+    wrongCount.replace(wrongCount.find("\"count\":3"), 9, "\"count\":4");
+    CHECK(!mergeHistogramLine(wrongCount, merged));
+    CHECK(!mergeHistogramLine("{\"histogram\":\"latency\",\"procedure\":\"withdraw\"}", merged));
+    CHECK_EQ(merged.at(WorkloadOpKind::REFUND, 0).count(), 3u);
+    ::unlink(path.c_str());
+}
+
+void testOutcomeCodesFromTheEngine() {
+    auto vault = std::make_unique<PronexmaVaultState>();
+    PronexmaVaultEngine engine(*vault);
+    NativeHost host;
+    HostContextBinding binding(engine, host.context());
+    engine.initialize(makeAddress("FEES"));
+    QubicAddress payer = makeAddress("PAYER");
+    host.credit(payer, 1000);
+
+    const uint64_t amounts[1] = {500};
+    host.setSender(payer);
+    uint64_t id = engine.createAgreement(makeAddress("B"), makeAddress("O"), 500, amounts, 1, "codes");
+    CHECK_EQ(latencyOutcome(engine, id != 0), static_cast<uint32_t>(VaultError::NONE));
+    bool ok = host.invoke(payer, 400, [&] { return engine.deposit(id); });
+    CHECK_EQ(latencyOutcome(engine, ok), static_cast<uint32_t>(VaultError::WRONG_VALUE));
+    ok = engine.getMilestone(id, 2).amount != 0;
+    CHECK_EQ(latencyOutcome(engine, ok), static_cast<uint32_t>(VaultError::INVALID_MILESTONE));
+    ok = engine.getAgreement(id + 1).id != 0;
+    CHECK_EQ(latencyOutcome(engine, ok), static_cast<uint32_t>(VaultError::AGREEMENT_NOT_FOUND));
+    engine.setWorkUnitLimit(1);                                     // Finds the slot, cannot copy it out
+    ok = engine.getAgreement(id).id != 0;
+    CHECK_EQ(latencyOutcome(engine, ok), static_cast<uint32_t>(VaultError::WORK_LIMIT_EXCEEDED));
+    CHECK(std::strcmp(latencyOutcomeName(LATENCY_OUTCOME_FAILED), "FAILED") == 0);
+    CHECK(std::strcmp(latencyOutcomeName(0), "OK") == 0);
+}
+
+} // namespace
+
+int main() {
+    testBucketsCoverEveryValue();
+    testPercentilesWithinThreeDigits();
+    testExportMergesAcrossRuns();
+    testOutcomeCodesFromTheEngine();
+    return finishTests("histogram_test");
+}
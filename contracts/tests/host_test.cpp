@@ -0,0 +1,475 @@
+// contracts/tests/host_test.cpp
+// Procedures against the native host: funding, verification, release, refund,
+// independent engines running side by side, and the synthetic workload
+
+#include "WorkloadFixture.h"
+
+#include <memory>
+#include <thread>
+
+namespace {
+
+const QubicAddress payer = makeAddress("PAYER");
+const QubicAddress beneficiary = makeAddress("BENEFICIARY");
+const QubicAddress oracle = makeAddress("ORACLE");
+const QubicAddress feeRecipient = makeAddress("FEERECIPIENT");
+
+uint64_t createFunded(NativeHost& host, const uint64_t* amounts, uint32_t count, uint64_t total) {
+    uint64_t id = host.invoke(payer, 0, [&] { return createAgreement(beneficiary, oracle, total, amounts, count, "grant"); });
+    CHECK(id != 0);
+    CHECK(host.invoke(payer, total, [&] { return deposit(id); }));
+    return id;
+}
+
+void testLifecycleMovesFunds() {
+    NativeHost host;
+    HostContextBinding binding(host.context());
+    initialize(feeRecipient);
+    host.credit(payer, 1000000);
+    host.setTick(500);
+
+    const uint64_t amounts[2] = {600000, 400000};
+    uint64_t id = createFunded(host, amounts, 2, 1000000);
+    CHECK_EQ(host.balanceOf(payer), 0u);
+    CHECK_EQ(host.balanceOf(host.contractAccount()), 1000000u);
+    CHECK_EQ(state.totalValueLocked, 1000000u);
+    CHECK_EQ(getAgreement(id).timeoutTick, 500 + REFUND_TIMEOUT_TICKS);
+
+    std::array<uint8_t, 64> evidence = {};
+    evidence[0] = 1;
+    CHECK(!host.invoke(payer, 0, [&] { return markMilestoneVerified(id, 1, evidence); }));
+    host.advanceTicks(10);
+    CHECK(host.invoke(oracle, 0, [&] { return markMilestoneVerified(id, 1, evidence); }));
+    CHECK_EQ(getMilestone(id, 1).verifiedAtTick, 510u);
+
+    HostRecorder recorder(host.context());
+    {
+        HostContextBinding recording(recorder.context());
+        CHECK(host.invoke(beneficiary, 0, [&] { return releaseMilestone(id, 1); }));
+    }
+    std::vector<HostCall> transfers = recorder.transfers();
+    CHECK_EQ(transfers.size(), 2u);
+    CHECK(transfers[0].address == beneficiary);
+    CHECK_EQ(transfers[0].amount, 597000u);
+    CHECK(transfers[1].address == feeRecipient);
+    CHECK_EQ(transfers[1].amount, 3000u);
+
+    CHECK_EQ(host.balanceOf(beneficiary), 597000u);
+    CHECK_EQ(host.balanceOf(feeRecipient), 3000u);
+    CHECK_EQ(host.balanceOf(host.contractAccount()), 400000u);
+    CHECK_EQ(host.totalSupply(), 1000000u);
+    CHECK_EQ(host.failedTransfers(), 0u);
+}
+
+void testDepositNeedsExactValueAndRefundNeedsTimeout() {
+    NativeHost host;
+    HostContextBinding binding(host.context());
+    initialize(feeRecipient);
+    host.credit(payer, 5000);
+
+    const uint64_t amounts[1] = {2000};
+    uint64_t id = host.invoke(payer, 0, [&] { return createAgreement(beneficiary, oracle, 2000, amounts, 1, "x"); });
+    CHECK(!host.invoke(payer, 6000, [&] { return deposit(id); }));      // Cannot pay: never runs
+    CHECK_EQ(host.balanceOf(payer), 5000u);
+    CHECK(host.invoke(payer, 2000, [&] { return deposit(id); }));
+
+    CHECK(!host.invoke(payer, 0, [&] { return refund(id); }));
+    host.advanceTicks(REFUND_TIMEOUT_TICKS);
+    CHECK(!host.invoke(beneficiary, 0, [&] { return refund(id); }));
+    CHECK(host.invoke(payer, 0, [&] { return refund(id); }));
+    CHECK_EQ(host.balanceOf(payer), 5000u);
+    CHECK_EQ(state.totalValueLocked, 0u);
+    CHECK_EQ(getMilestone(id, 1).state, MilestoneState::CANCELLED);
+}
+
+void testUnboundHostKeepsPlaceholders() {
+    {
+        NativeHost host;
+        host.setTick(99);
+        HostContextBinding binding(host.context());
+        CHECK_EQ(getCurrentTick(), 99u);
+    }
+    CHECK_EQ(getCurrentTick(), 0u);
+    CHECK_EQ(getMessageValue(), 0u);
+    CHECK(!isValidAddress(getMessageSender()));
+}
+
+// Each engine runs a full lifecycle on its own thread with its own state and
+// ledger; the default engine and the global state are never touched.
+void testEnginesRunConcurrently() {
+    initialize(feeRecipient);
+    const uint32_t engines = 4;
+    std::vector<std::unique_ptr<PronexmaVaultState>> states;
+    std::vector<uint64_t> beneficiaryBalances(engines, 0);
+    std::vector<uint64_t> tvl(engines, 0);
+    std::vector<std::thread> threads;
+    for (uint32_t e = 0; e < engines; ++e) states.push_back(std::make_unique<PronexmaVaultState>());
+    for (uint32_t e = 0; e < engines; ++e) {
+        threads.emplace_back([&, e] {
+            PronexmaVaultEngine engine(*states[e]);
+            NativeHost host;
+            HostContextBinding binding(engine, host.context());
+            engine.initialize(feeRecipient);
+            uint64_t amount = 1000 * (e + 1);
+            host.credit(payer, 200 * amount);
+            std::array<uint8_t, 64> evidence = {};
+            for (uint32_t i = 0; i < 200; ++i) {
+                const uint64_t amounts[2] = {amount / 2, amount / 2};
+                uint64_t id = host.invoke(payer, 0, [&] { return engine.createAgreement(beneficiary, oracle, amount, amounts, 2, "shard"); });
+                host.invoke(payer, amount, [&] { return engine.deposit(id); });
+                host.invoke(oracle, 0, [&] { return engine.markMilestoneVerified(id, 1, evidence); });
+                host.invoke(beneficiary, 0, [&] { return engine.releaseMilestone(id, 1); });
+            }
+            beneficiaryBalances[e] = host.balanceOf(beneficiary);
+            tvl[e] = engine.state.totalValueLocked;
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+
+    for (uint32_t e = 0; e < engines; ++e) {
+        uint64_t half = 500 * (e + 1);
+        CHECK_EQ(states[e]->activeAgreementCount, 200u);
+        CHECK_EQ(tvl[e], 200 * half);
+        CHECK_EQ(beneficiaryBalances[e], 200 * (half - half / 200));
+    }
+    CHECK_EQ(state.activeAgreementCount, 0u);
+    CHECK(hostContext.currentTick == nullptr);
+}
+
+void testPerfCountersByProcedureAndReason() {
+    NativeHost host;
+    HostContextBinding binding(host.context());
+    host.setTick(70);
+    initialize(feeRecipient);
+    uint64_t epoch = getPerfCounters().epoch;
+    CHECK(epoch > 0);
+    CHECK_EQ(getPerfCounters().sinceTick, 70u);
+    host.credit(payer, 3000);
+
+    const uint64_t amounts[3] = {1000, 1000, 1000};
+    uint64_t first = createFunded(host, amounts, 3, 3000);
+    const uint64_t mismatched[2] = {1, 2};
+    CHECK_EQ(host.invoke(payer, 0, [&] { return createAgreement(beneficiary, oracle, 4, mismatched, 2, "x"); }), 0u);
+    CHECK(!host.invoke(oracle, 0, [&] { return deposit(first); }));             // Not the payer
+    CHECK(!host.invoke(payer, 0, [&] { return deposit(first); }));              // Already funded
+    CHECK(!host.invoke(payer, 0, [&] { return deposit(0x1234); }));             // Unknown ID
+    std::array<uint8_t, 64> evidence = {};
+    CHECK(host.invoke(oracle, 0, [&] { return markMilestoneVerified(first, 3, evidence); }));
+    CHECK(!host.invoke(oracle, 0, [&] { return markMilestoneVerified(first, 3, evidence); }));
+    CHECK(host.invoke(beneficiary, 0, [&] { return releaseMilestone(first, 3); }));
+    CHECK(!host.invoke(payer, 0, [&] { return refund(first); }));               // Before timeout
+
+    VaultPerfCounters counters = getPerfCounters();
+    auto procedure = [&](VaultProcedure p) { return counters.procedures[static_cast<uint32_t>(p)]; };
+    auto reason = [](const ProcedureCounters& c, VaultError e) { return c.failuresByReason[static_cast<uint32_t>(e)]; };
+    ProcedureCounters create = procedure(VaultProcedure::CREATE_AGREEMENT);
+    CHECK_EQ(create.calls, 2u);
+    CHECK_EQ(create.successes, 1u);
+    CHECK_EQ(reason(create, VaultError::AMOUNT_MISMATCH), 1u);
+    CHECK_EQ(create.milestonesTouched, 3u);
+    ProcedureCounters deposits = procedure(VaultProcedure::DEPOSIT);
+    CHECK_EQ(deposits.calls, 4u);
+    CHECK_EQ(deposits.successes + deposits.failures, deposits.calls);
+    CHECK_EQ(reason(deposits, VaultError::NOT_PAYER), 1u);
+    CHECK_EQ(reason(deposits, VaultError::INVALID_STATE), 1u);
+    CHECK_EQ(reason(deposits, VaultError::AGREEMENT_NOT_FOUND), 1u);
+    CHECK_EQ(deposits.agreementsScanned, 4u);                                   // 1 + 1 + 1 + full miss of 1
+    CHECK_EQ(reason(procedure(VaultProcedure::MARK_MILESTONE_VERIFIED), VaultError::MILESTONE_NOT_PENDING), 1u);
+    CHECK_EQ(procedure(VaultProcedure::RELEASE_MILESTONE).milestonesTouched, 2u);  // Released one, first check stops
+    CHECK_EQ(reason(procedure(VaultProcedure::REFUND), VaultError::TIMEOUT_NOT_REACHED), 1u);
+
+    host.setTick(90);
+    resetPerfCounters();
+    counters = getPerfCounters();
+    CHECK_EQ(counters.epoch, epoch + 1);
+    CHECK_EQ(counters.sinceTick, 90u);
+    CHECK_EQ(procedure(VaultProcedure::DEPOSIT).calls, 0u);
+    CHECK_EQ(state.totalValueLocked, 2000u);                                     // Reset leaves the vault alone
+}
+
+// initialize does not touch the slots; a reused slot comes back empty when
+// createAgreement claims it, whatever the previous vault left there.
+void testResetClearsSlotsAsTheyAreReclaimed() {
+    TestEngine target;
+    auto& vault = target.vault;
+    PronexmaVaultEngine& engine = target.engine;
+    NativeHost& host = target.host;
+    host.credit(payer, 1u << 20);
+
+    uint64_t amounts[MAX_MILESTONES_PER_AGREEMENT];
+    for (uint64_t& amount : amounts) amount = 100;
+    std::array<uint8_t, 64> evidence = {};
+    evidence.fill(0xEE);
+    host.setSender(payer);
+    uint64_t first = engine.createAgreement(beneficiary, oracle, 1000, amounts, MAX_MILESTONES_PER_AGREEMENT,
+                                            "a long title from the first vault");
+    engine.createAgreement(beneficiary, oracle, 100, amounts, 1, "second");
+    CHECK(host.invoke(payer, 1000, [&] { return engine.deposit(first); }));
+    CHECK(host.invoke(oracle, 0, [&] { return engine.markMilestoneVerified(first, 7, evidence); }));
+    vault->agreements[0].metadata[0] = '{';
+
+    engine.initialize(feeRecipient);
+    CHECK_EQ(vault->staleSlotCount, 2u);
+    CHECK_EQ(vault->activeAgreementCount, 0u);
+    CHECK_EQ(vault->agreements[0].milestones[6].evidenceHash[0], 0xEEu);    // Not cleared by the reset
+
+    host.setSender(payer);
+    uint64_t reused = engine.createAgreement(beneficiary, oracle, 200, amounts, 2, "new");
+    CHECK_EQ(reused, first);                                                // Same counter, same slot
+    Agreement agreement = engine.getAgreement(reused);
+    CHECK(std::strcmp(agreement.title.data(), "new") == 0);
+    CHECK_EQ(agreement.metadata[0], '\0');
+    CHECK_EQ(agreement.milestoneCount, 2u);
+    CHECK(agreement.state == AgreementState::CREATED);
+    for (uint32_t m = 0; m < MAX_MILESTONES_PER_AGREEMENT; ++m) {
+        CHECK_EQ(agreement.milestones[m].evidenceHash[0], 0u);
+        CHECK_EQ(agreement.milestones[m].amount, m < 2 ? 100u : 0u);
+    }
+    CHECK_EQ(vault->agreements[1].milestoneCount, 1u);                      // Still stale until claimed
+
+    engine.initialize(feeRecipient);
+    CHECK_EQ(vault->staleSlotCount, 2u);                                    // Slot 1 is still owed a clear
+}
+
+// Full table, target in the last slot, ten milestones: every procedure costs
+// exactly its documented bound; a missing ID costs the full scan.
+void testWorkUnitsMeetDocumentedWorstCases() {
+    TestEngine target;
+    auto& vault = target.vault;
+    PronexmaVaultEngine& engine = target.engine;
+    NativeHost& host = target.host;
+    host.credit(payer, 1u << 30);
+
+    uint64_t amounts[MAX_MILESTONES_PER_AGREEMENT];
+    for (uint64_t& amount : amounts) amount = 1000;
+    const uint64_t total = 1000 * MAX_MILESTONES_PER_AGREEMENT;
+    char title[300];
+    std::memset(title, 'T', sizeof(title) - 1);
+    title[sizeof(title) - 1] = '\0';
+    for (uint32_t i = 0; i + 1 < MAX_AGREEMENTS; ++i) {
+        vault->agreements[i].id = (static_cast<uint64_t>(AGREEMENT_ID_PREFIX) << 32) | (i + 1);
+    }
+    vault->activeAgreementCount = MAX_AGREEMENTS - 1;
+    vault->agreementCounter = MAX_AGREEMENTS - 1;
+
+    host.setSender(payer);
+    uint64_t id = engine.createAgreement(beneficiary, oracle, total, amounts, MAX_MILESTONES_PER_AGREEMENT, title);
+    CHECK(id != 0);
+    CHECK_EQ(engine.lastWork().units, WORK_BOUND_CREATE_AGREEMENT);
+    CHECK(host.invoke(payer, total, [&] { return engine.deposit(id); }));
+    CHECK_EQ(engine.lastWork().units, WORK_BOUND_DEPOSIT);
+    std::array<uint8_t, 64> evidence = {};
+    for (uint32_t m = 1; m <= MAX_MILESTONES_PER_AGREEMENT; ++m) {
+        CHECK(host.invoke(oracle, 0, [&] { return engine.markMilestoneVerified(id, m, evidence); }));
+        CHECK_EQ(engine.lastWork().units, WORK_BOUND_MARK_MILESTONE_VERIFIED);
+    }
+    for (uint32_t m = 1; m < MAX_MILESTONES_PER_AGREEMENT; ++m) {
+        CHECK(host.invoke(beneficiary, 0, [&] { return engine.releaseMilestone(id, m); }));
+        CHECK(engine.lastWork().units <= WORK_BOUND_RELEASE_MILESTONE);
+    }
+    CHECK_EQ(engine.getAgreement(id).id, id);
+    CHECK_EQ(engine.lastWork().units, WORK_BOUND_GET_AGREEMENT);
+    CHECK_EQ(engine.getMilestone(id, MAX_MILESTONES_PER_AGREEMENT).amount, 1000u);
+    CHECK_EQ(engine.lastWork().units, WORK_BOUND_GET_MILESTONE);
+    host.setTick(REFUND_TIMEOUT_TICKS);
+    CHECK(host.invoke(payer, 0, [&] { return engine.refund(id); }));
+    CHECK_EQ(engine.lastWork().units, WORK_BOUND_REFUND);
+    CHECK(!host.invoke(payer, 0, [&] { return engine.deposit(0x1234); }));
+    CHECK_EQ(engine.lastWork().units, uint64_t(MAX_AGREEMENTS) * WORK_PER_SLOT_PROBE);
+    CHECK(engine.setFeeRecipient(feeRecipient));
+    CHECK_EQ(engine.lastWork().units, WORK_BOUND_SET_FEE_RECIPIENT);
+
+    // The last milestone release on a fresh full-table agreement hits the bound.
+    vault->activeAgreementCount = MAX_AGREEMENTS - 1;
+    host.setTick(0);
+    host.setSender(payer);
+    id = engine.createAgreement(beneficiary, oracle, total, amounts, MAX_MILESTONES_PER_AGREEMENT, "last");
+    CHECK(host.invoke(payer, total, [&] { return engine.deposit(id); }));
+    for (uint32_t m = 1; m <= MAX_MILESTONES_PER_AGREEMENT; ++m) {
+        host.invoke(oracle, 0, [&] { return engine.markMilestoneVerified(id, m, evidence); });
+        CHECK(host.invoke(beneficiary, 0, [&] { return engine.releaseMilestone(id, m); }));
+    }
+    CHECK_EQ(engine.lastWork().units, WORK_BOUND_RELEASE_MILESTONE);
+    CHECK(!engine.lastWork().aborted);
+}
+
+// Below the bound, calls abort cleanly: error result, WORK_LIMIT_EXCEEDED,
+// and not one byte of the vault changed.
+void testWorkLimitAbortsBeforeWriting() {
+    TestEngine target;
+    auto& vault = target.vault;
+    PronexmaVaultEngine& engine = target.engine;
+    NativeHost& host = target.host;
+    host.credit(payer, 1u << 30);
+    const uint64_t amounts[4] = {100, 100, 100, 100};
+    uint64_t ids[40];
+    host.setSender(payer);
+    for (uint64_t& id : ids) id = engine.createAgreement(beneficiary, oracle, 400, amounts, 4, "capped");
+    std::array<uint8_t, 64> evidence = {};
+
+    auto vaultBytes = [&] {
+        const uint8_t* begin = reinterpret_cast<const uint8_t*>(&vault->agreements[0]);
+        std::vector<uint8_t> bytes(begin, begin + sizeof(Agreement) * 40);
+        uint64_t counters[4] = {vault->agreementCounter, vault->totalValueLocked, vault->totalValueReleased,
+                                vault->activeAgreementCount};
+        bytes.insert(bytes.end(), reinterpret_cast<uint8_t*>(counters), reinterpret_cast<uint8_t*>(counters + 4));
+        return bytes;
+    };
+
+    engine.setWorkUnitLimit(39);                                                // Lookup of the last slot needs 40
+    std::vector<uint8_t> before = vaultBytes();
+    CHECK(!host.invoke(payer, 400, [&] { return engine.deposit(ids[39]); }));
+    CHECK(engine.lastWork().aborted);
+    CHECK_EQ(engine.lastWork().units, 39u);
+    CHECK(host.invoke(payer, 400, [&] { return engine.deposit(ids[38]); }));    // 39 probes fit
+    CHECK(!engine.lastWork().aborted);
+    before = vaultBytes();
+
+    CHECK(!host.invoke(oracle, 0, [&] { return engine.markMilestoneVerified(ids[38], 1, evidence); }));
+    CHECK(engine.lastWork().aborted);                                           // 39 probes + 2 > 39
+    CHECK(before == vaultBytes());
+    CHECK_EQ(engine.getAgreement(ids[39]).id, 0u);                               // Views abort too
+    CHECK(engine.lastWork().aborted);
+    CHECK_EQ(engine.createAgreement(beneficiary, oracle, 400, amounts, 4, "fits"), 41u | (uint64_t(AGREEMENT_ID_PREFIX) << 32));
+
+    engine.setWorkUnitLimit(45);
+    CHECK(host.invoke(oracle, 0, [&] { return engine.markMilestoneVerified(ids[38], 1, evidence); }));
+    engine.setWorkUnitLimit(39 + 4);                                            // Release needs 39 + 1 + 4
+    before = vaultBytes();
+    uint64_t beneficiaryBalance = host.balanceOf(beneficiary);
+    CHECK(!host.invoke(beneficiary, 0, [&] { return engine.releaseMilestone(ids[38], 1); }));
+    CHECK(before == vaultBytes());
+    CHECK_EQ(host.balanceOf(beneficiary), beneficiaryBalance);                  // No transfer either
+    engine.setWorkUnitLimit(39 + 5);
+    CHECK(host.invoke(beneficiary, 0, [&] { return engine.releaseMilestone(ids[38], 1); }));
+
+    const ProcedureCounters& release = vault->perfCounters.procedures[static_cast<uint32_t>(VaultProcedure::RELEASE_MILESTONE)];
+    CHECK_EQ(release.failuresByReason[static_cast<uint32_t>(VaultError::WORK_LIMIT_EXCEEDED)], 1u);
+    CHECK_EQ(release.workUnits, 39u + 44u);                                    // A refused charge is not billed
+    engine.setWorkUnitLimit(0);
+    CHECK(host.invoke(payer, 400, [&] { return engine.deposit(ids[39]); }));
+}
+
+// The O(1) capacity view agrees with a full recount after a mixed run that
+// completes and refunds agreements.
+void testCapacityStatsMatchRecount() {
+    TestEngine target;
+    runWorkload(target, 5);
+    auto& vault = target.vault;
+    PronexmaVaultEngine& engine = target.engine;
+
+    VaultCapacityStats stats = engine.getCapacityStats();
+    CHECK_EQ(engine.lastWork().units, WORK_BOUND_GET_CAPACITY_STATS);
+    CapacityCounters incremental = vault->capacityCounters;
+    rebuildCapacityCounters(*vault);
+    CHECK_EQ(incremental.agreementsByState, vault->capacityCounters.agreementsByState);
+    CHECK_EQ(incremental.milestonesUsed, vault->capacityCounters.milestonesUsed);
+
+    uint32_t byState = 0;
+    for (uint32_t count : stats.agreementsByState) byState += count;
+    CHECK_EQ(stats.usedSlots, vault->activeAgreementCount);
+    CHECK_EQ(byState, stats.usedSlots);
+    CHECK(stats.agreementsByState[static_cast<uint32_t>(AgreementState::COMPLETED)] > 0);
+    CHECK(stats.agreementsByState[static_cast<uint32_t>(AgreementState::REFUNDED)] > 0);
+    CHECK_EQ(stats.liveSlots + stats.tombstonedSlots, stats.usedSlots);
+    CHECK_EQ(stats.freeSlots, MAX_AGREEMENTS - stats.usedSlots);
+    CHECK(stats.milestoneSlotsUsed <= stats.milestoneSlotsReserved);
+    CHECK_EQ(stats.indexLoadBasisPoints, stats.usedSlots * 10000 / MAX_AGREEMENTS);
+    CHECK(stats.observedLookups > 0 && stats.observedProbes >= stats.observedLookups);
+
+    uint64_t slotBytes = 0, reservedBytes = 0;
+    for (uint32_t c = 0; c < STATE_CATEGORY_COUNT; ++c) {
+        slotBytes += stats.bytesInUse[c];
+        reservedBytes += stats.bytesReserved[c];
+    }
+    CHECK_EQ(slotBytes, uint64_t(stats.usedSlots) * sizeof(Agreement));
+    CHECK_EQ(reservedBytes, uint64_t(MAX_AGREEMENTS) * sizeof(Agreement));
+    CHECK(stats.stateBytes > reservedBytes);
+}
+
+struct WorkloadRun {
+    uint64_t streamHash = 0xcbf29ce484222325ull;
+    uint64_t failures[WORKLOAD_OP_KINDS] = {};
+    uint64_t calls[WORKLOAD_OP_KINDS] = {};
+    uint64_t tvl = 0, released = 0, fees = 0, lockedSum = 0, contractBalance = 0;
+    uint32_t agreements = 0;
+};
+
+WorkloadRun recordWorkload(const WorkloadConfig& config) {
+    WorkloadRun run;
+    TestEngine target;
+    NativeHost& host = target.host;
+    uint64_t supply = 0;                     // Taken after funding, at the first call
+    runWorkload(target, config, [&](const WorkloadOp& op, bool ok) {
+        if (supply == 0) supply = host.totalSupply();
+        uint32_t kind = static_cast<uint32_t>(op.kind);
+        run.calls[kind] += op.warmup ? 0 : 1;
+        run.failures[kind] += ok ? 0 : 1;
+        uint64_t fields[5] = {kind, op.tick, op.value, op.agreementId, op.milestoneId};
+        for (uint64_t field : fields) run.streamHash = (run.streamHash ^ field) * 0x100000001b3ull;
+    });
+    const PronexmaVaultState& vault = *target.vault;
+    target.engine.getProtocolStats(run.tvl, run.released, run.fees, run.agreements);
+    for (uint32_t i = 0; i < vault.activeAgreementCount; ++i) run.lockedSum += vault.agreements[i].lockedAmount;
+    run.contractBalance = host.balanceOf(host.contractAccount());
+    CHECK_EQ(host.totalSupply(), supply);
+    CHECK_EQ(host.failedTransfers(), 0u);
+    return run;
+}
+
+// Same seed, same stream and end state; every call the generator emits is
+// valid except refunds that come before the timeout.
+void testWorkloadIsDeterministicAndValid() {
+    WorkloadConfig config;
+    config.seed = 42;
+    config.operations = 20000;
+    config.prefillAgreements = 300;
+    config.ticksPerOperation = 100;          // Long enough for refunds to come due
+
+    WorkloadRun first = recordWorkload(config);
+    WorkloadRun second = recordWorkload(config);
+    CHECK_EQ(first.streamHash, second.streamHash);
+    CHECK_EQ(first.tvl, second.tvl);
+    CHECK_EQ(first.released, second.released);
+    CHECK_EQ(first.agreements, second.agreements);
+
+    for (uint32_t k = 0; k < WORKLOAD_OP_KINDS; ++k) {
+        if (static_cast<WorkloadOpKind>(k) != WorkloadOpKind::REFUND) CHECK_EQ(first.failures[k], 0u);
+    }
+    CHECK(first.failures[static_cast<uint32_t>(WorkloadOpKind::REFUND)] <
+          first.calls[static_cast<uint32_t>(WorkloadOpKind::REFUND)]);
+    uint64_t views = first.calls[static_cast<uint32_t>(WorkloadOpKind::GET_AGREEMENT)] +
+                     first.calls[static_cast<uint32_t>(WorkloadOpKind::GET_MILESTONE)] +
+                     first.calls[static_cast<uint32_t>(WorkloadOpKind::GET_PROTOCOL_STATS)];
+    CHECK(views > 11000 && views < 13000);   // About 60% of 20000
+    CHECK(first.calls[static_cast<uint32_t>(WorkloadOpKind::MARK_MILESTONE_VERIFIED)] > 1500);
+    CHECK_EQ(first.tvl, first.lockedSum);
+    CHECK_EQ(first.contractBalance, first.tvl);
+
+    config.seed = 43;
+    CHECK(recordWorkload(config).streamHash != first.streamHash);
+
+    WorkloadMix mix;
+    CHECK(parseWorkloadMix("refund=0,getAgreement=2.5", mix));
+    CHECK_EQ(mix[WorkloadOpKind::REFUND], 0.0);
+    CHECK_EQ(mix[WorkloadOpKind::GET_AGREEMENT], 2.5);
+    CHECK_EQ(mix[WorkloadOpKind::DEPOSIT], 9.0);
+    CHECK(!parseWorkloadMix("withdraw=1", mix));
+    CHECK(!parseWorkloadMix("deposit=x", mix));
+}
+
+} // namespace
+
+int main() {
+    testLifecycleMovesFunds();
+    testDepositNeedsExactValueAndRefundNeedsTimeout();
+    testUnboundHostKeepsPlaceholders();
+    testEnginesRunConcurrently();
+    testPerfCountersByProcedureAndReason();
+    testResetClearsSlotsAsTheyAreReclaimed();
+    testWorkUnitsMeetDocumentedWorstCases();
+    testWorkLimitAbortsBeforeWriting();
+    testCapacityStatsMatchRecount();
+    testWorkloadIsDeterministicAndValid();
+    return finishTests("host_test");
+}
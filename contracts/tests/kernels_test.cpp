@@ -0,0 +1,142 @@
+// contracts/tests/kernels_test.cpp
+// SIMD kernels: every level this CPU runs agrees with the portable one on
+// address equality and milestone state/amount scans, at every length and
+// alignment, and the packed milestone columns match the records.
+
+#include "WorkloadFixture.h"
+#include "host/VaultKernels.h"
+
+#include <random>
+#include <vector>
+
+namespace {
+
+std::vector<const VaultKernels*> availableLevels() {
+    std::vector<const VaultKernels*> levels;
+    for (uint32_t level = 0; level < KERNEL_LEVEL_COUNT; ++level) {
+        if (const VaultKernels* kernels = vaultKernelsFor(static_cast<KernelLevel>(level))) levels.push_back(kernels);
+    }
+    return levels;
+}
+
+void testDispatch() {
+    const VaultKernels* portable = vaultKernelsFor(KernelLevel::PORTABLE);
+    CHECK(portable != nullptr);
+    const VaultKernels& best = vaultKernels();
+    CHECK(vaultKernelsFor(best.level) == &best);
+    for (uint32_t level = static_cast<uint32_t>(best.level) + 1; level < KERNEL_LEVEL_COUNT; ++level) {
+        CHECK(vaultKernelsFor(static_cast<KernelLevel>(level)) == nullptr);
+    }
+    std::printf("kernels_test: dispatching to %s\n", kernelLevelName(best.level));
+}
+
+void testAddressEquality() {
+    QubicAddress a;
+    for (size_t i = 0; i < a.size(); ++i) a[i] = static_cast<uint8_t>(i * 29 + 3);
+    for (const VaultKernels* kernels : availableLevels()) {
+        QubicAddress b = a;
+        CHECK(kernels->addressEquals(a, b));
+        for (size_t i = 0; i < a.size(); ++i) {
+            for (uint8_t bit = 1; bit != 0; bit = static_cast<uint8_t>(bit << 1)) {
+                b = a;
+                b[i] ^= bit;
+                CHECK(!kernels->addressEquals(a, b));
+            }
+        }
+
+        // A column of keys, one byte of storage off alignment.
+        std::vector<uint8_t> storage(sizeof(QubicAddress) * 65 + 1);
+        QubicAddress* keys = reinterpret_cast<QubicAddress*>(storage.data() + 1);
+        uint32_t expected = 0;
+        for (uint32_t i = 0; i < 64; ++i) {
+            QubicAddress key = a;
+            if (i % 3 != 0) key[i % 32] ^= 0x40;
+            std::memcpy(&keys[i], &key, sizeof(key));
+            expected += i % 3 == 0;
+        }
+        CHECK_EQ(kernels->countAddressMatches(keys, 64, a), expected);
+        CHECK_EQ(kernels->countAddressMatches(keys, 0, a), 0u);
+    }
+}
+
+void testStateScans() {
+    const VaultKernels& portable = *vaultKernelsFor(KernelLevel::PORTABLE);
+    std::mt19937_64 rng(5);
+    std::vector<uint8_t> stateStorage(200);
+    std::vector<uint64_t> amountStorage(200);
+    for (uint32_t offset = 0; offset < 3; ++offset) {
+        for (uint32_t count = 0; count <= 150; ++count) {
+            uint8_t* states = stateStorage.data() + offset;
+            uint64_t* amounts = amountStorage.data() + offset;
+            // Mostly one state, so all/any are not decided by the first block.
+            uint8_t common = static_cast<uint8_t>(rng() % 4);
+            for (uint32_t i = 0; i < count; ++i) {
+                states[i] = rng() % 8 == 0 ? static_cast<uint8_t>(rng() % 4) : common;
+                amounts[i] = rng() >> (rng() % 64);
+            }
+            for (const VaultKernels* kernels : availableLevels()) {
+                for (uint8_t state = 0; state < 5; ++state) {
+                    CHECK_EQ(kernels->allInState(states, count, state), portable.allInState(states, count, state));
+                    CHECK_EQ(kernels->anyInState(states, count, state), portable.anyInState(states, count, state));
+                    CHECK_EQ(kernels->sumInState(states, amounts, count, state),
+                             portable.sumInState(states, amounts, count, state));
+                }
+            }
+        }
+    }
+
+    // A lone differing state in the last position, past any full vector.
+    std::vector<uint8_t> states(97, static_cast<uint8_t>(MilestoneState::RELEASED));
+    std::vector<uint64_t> amounts(97, 5);
+    CHECK(allMilestonesReleased(states.data(), 97));
+    CHECK(!anyMilestoneVerified(states.data(), 97));
+    CHECK_EQ(sumPendingAmounts(states.data(), amounts.data(), 97), 0u);
+    states[96] = static_cast<uint8_t>(MilestoneState::VERIFIED);
+    CHECK(!allMilestonesReleased(states.data(), 97));
+    CHECK(anyMilestoneVerified(states.data(), 97));
+    states[40] = static_cast<uint8_t>(MilestoneState::PENDING);
+    amounts[40] = UINT64_MAX - 4;
+    CHECK_EQ(sumPendingAmounts(states.data(), amounts.data(), 97), UINT64_MAX - 4);
+}
+
+void testPackedColumns() {
+    TestEngine target;
+    runWorkload(target, 3, 2000);
+    auto& vault = target.vault;
+
+    MilestoneColumns columns;
+    packMilestoneColumns(*vault, columns);
+    CHECK_EQ(columns.first.size(), vault->activeAgreementCount + 1u);
+    uint64_t pending = 0;
+    for (uint32_t slot = 0; slot < vault->activeAgreementCount; ++slot) {
+        const Agreement& agreement = vault->agreements[slot];
+        CHECK_EQ(columns.milestonesOf(slot), agreement.milestoneCount);
+        const uint8_t* states = columns.state.data() + columns.first[slot];
+        const uint64_t* amounts = columns.amount.data() + columns.first[slot];
+        bool allReleased = true, anyVerified = false;
+        uint64_t slotPending = 0;
+        for (uint32_t m = 0; m < agreement.milestoneCount; ++m) {
+            allReleased = allReleased && agreement.milestones[m].state == MilestoneState::RELEASED;
+            anyVerified = anyVerified || agreement.milestones[m].state == MilestoneState::VERIFIED;
+            if (agreement.milestones[m].state == MilestoneState::PENDING) slotPending += agreement.milestones[m].amount;
+        }
+        CHECK_EQ(allMilestonesReleased(states, agreement.milestoneCount), allReleased);
+        CHECK_EQ(anyMilestoneVerified(states, agreement.milestoneCount), anyVerified);
+        CHECK_EQ(sumPendingAmounts(states, amounts, agreement.milestoneCount), slotPending);
+        CHECK(!allReleased || agreement.state == AgreementState::COMPLETED);
+        pending += slotPending;
+    }
+    CHECK(pending > 0);
+    CHECK_EQ(sumPendingAmounts(columns.state.data(), columns.amount.data(), static_cast<uint32_t>(columns.state.size())),
+             pending);
+}
+
+} // namespace
+
+int main() {
+    testDispatch();
+    testAddressEquality();
+    testStateScans();
+    testPackedColumns();
+    return finishTests("kernels_test");
+}
@@ -0,0 +1,232 @@
+// contracts/tests/migration_test.cpp
+// Streaming layout migration: re-encoding, invariant validation, bad inputs,
+// and the layout 1 (text address) upgrade
+
+#include "TestSupport.h"
+#include "host/VaultMigration.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string tempPath(const char* name) {
+    return std::string("/tmp/pronexma_migration_") + name + "_" + std::to_string(::getpid()) + ".snap";
+}
+
+void populate(uint32_t count) {
+    initialize(makeAddress("FEERECIPIENT"));
+    const uint64_t amounts[2] = {600, 400};
+    for (uint32_t i = 0; i < count; ++i) {
+        CHECK(createAgreement(makeAddress("BENEFICIARY"), makeAddress("ORACLE"), 1000, amounts, 2, "escrow") != 0);
+    }
+    for (uint32_t i = 0; i < count; i += 2) {
+        state.agreements[i].lockedAmount = 1000;
+        state.agreements[i].state = AgreementState::FUNDED;
+        state.totalValueLocked += 1000;
+    }
+}
+
+void testMigratesAndValidates() {
+    populate(300);
+    std::string in = tempPath("in");
+    std::string out = tempPath("out");
+    CHECK_EQ(writeSnapshot(state, 3, in, BlockEncoding::RAW), SnapshotStatus::OK);
+
+    MigrationReport report;
+    CHECK_EQ(migrateSnapshotFile(in, out, BlockEncoding::COLUMNAR, true, report), SnapshotStatus::OK);
+    CHECK_EQ(report.agreements, 300u);
+    CHECK_EQ(report.lockedSum, 150000u);
+    CHECK_EQ(report.violations, 0u);
+
+    auto restored = std::make_unique<PronexmaVaultState>();
+    CHECK_EQ(readSnapshot(out, *restored), SnapshotStatus::OK);
+    CHECK_EQ(restored->activeAgreementCount, 300u);
+    CHECK_EQ(restored->agreements[298].lockedAmount, 1000u);
+    ::unlink(in.c_str());
+    ::unlink(out.c_str());
+}
+
+void testRejectsBrokenAccounting() {
+    populate(100);
+    state.totalValueLocked += 1;               // TVL no longer matches the slots
+    state.agreements[42].totalAmount = 999;    // Milestones no longer add up
+    std::string in = tempPath("broken");
+    std::string out = tempPath("broken_out");
+    CHECK_EQ(writeSnapshot(state, 3, in), SnapshotStatus::OK);
+
+    MigrationReport report;
+    CHECK_EQ(migrateSnapshotFile(in, out, BlockEncoding::RAW, true, report), SnapshotStatus::INVARIANT_VIOLATION);
+    CHECK_EQ(report.violations, 3u);           // And the header totals no longer conserve funds
+    CHECK_EQ(report.firstViolation, MigrationViolation::MILESTONE_SUM);
+    CHECK_EQ(report.firstViolationSlot, 42u);
+    CHECK(::access(out.c_str(), F_OK) != 0);
+
+    CHECK_EQ(migrateSnapshotFile(in, out, BlockEncoding::RAW, false, report), SnapshotStatus::OK);
+    ::unlink(in.c_str());
+    ::unlink(out.c_str());
+}
+
+void testRejectsUnknownLayout() {
+    populate(10);
+    std::string in = tempPath("future");
+    std::string out = tempPath("future_out");
+    CHECK_EQ(writeSnapshot(state, 3, in), SnapshotStatus::OK);
+    int fd = ::open(in.c_str(), O_RDWR);
+    uint32_t futureLayout = SNAPSHOT_LAYOUT_VERSION + 1;
+    CHECK_EQ(::pwrite(fd, &futureLayout, sizeof(futureLayout), offsetof(SnapshotHeader, layoutVersion)), 4);
+    ::close(fd);
+
+    MigrationReport report;
+    CHECK_EQ(migrateSnapshotFile(in, out, BlockEncoding::RAW, true, report), SnapshotStatus::LAYOUT_MISMATCH);
+    ::unlink(in.c_str());
+}
+
+// A layout 1 snapshot as the previous writer produced it: addresses as text.
+void writeLayoutV1Snapshot(const std::string& path, const std::vector<AgreementLayoutV1>& records,
+                           const std::string& feeRecipient, BlockEncoding encoding) {
+    SnapshotHeader header = makeSnapshotHeader(state, 5);
+    header.formatVersion = 1;                 // No tick section either
+    header.layoutVersion = 1;
+    header.recordSize = sizeof(AgreementLayoutV1);
+    header.agreementCount = static_cast<uint32_t>(records.size());
+    header.totalValueLocked = 0;
+    header.totalValueReleased = 0;
+    for (const AgreementLayoutV1& record : records) header.totalValueLocked += record.lockedAmount;
+    char text[64] = {};
+    std::memcpy(text, feeRecipient.data(), feeRecipient.size());
+    std::memcpy(header.protocolFeeRecipient.data(), text, 32);
+    std::memcpy(header.protocolFeeRecipientTail, text + 32, 32);
+
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    FdWriter out(fd);
+    CHECK(out.write(&header, sizeof(header)));
+    BasicBlockAddressDictionary<TextAddressV1> dictionary;
+    std::vector<uint8_t> payload;
+    std::vector<SnapshotBlockIndexEntry> index;
+    for (uint32_t first = 0; first < records.size(); first += SNAPSHOT_BLOCK_CAPACITY) {
+        uint32_t count = std::min<uint32_t>(SNAPSHOT_BLOCK_CAPACITY, static_cast<uint32_t>(records.size()) - first);
+        const AgreementLayoutV1* block = records.data() + first;
+        if (encoding == BlockEncoding::COLUMNAR) {
+            encodeColumnarBlock(block, count, dictionary, payload);
+        } else {
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(block);
+            payload.assign(bytes, bytes + size_t(count) * sizeof(AgreementLayoutV1));
+        }
+        SnapshotBlockIndexEntry entry;
+        entry.offset = out.offset();
+        entry.block = {SNAPSHOT_BLOCK_MAGIC, encoding, first, count, payload.size(),
+                       hashAgreementRecords(block, count)};
+        index.push_back(entry);
+        CHECK(out.write(&entry.block, sizeof(entry.block)) && out.write(payload.data(), payload.size()));
+    }
+    SnapshotTrailer trailer{SNAPSHOT_TRAILER_MAGIC, static_cast<uint32_t>(index.size()), out.offset()};
+    CHECK(out.write(index.data(), index.size() * sizeof(SnapshotBlockIndexEntry)) &&
+          out.write(&trailer, sizeof(trailer)) && out.flush());
+    ::close(fd);
+}
+
+AgreementLayoutV1 layoutV1Record(uint64_t id, const std::string& payer, const std::string& beneficiary,
+                                 const std::string& oracle) {
+    AgreementLayoutV1 record;
+    std::memset(static_cast<void*>(&record), 0, sizeof(record));
+    record.id = id;
+    std::memcpy(record.payer.data(), payer.data(), payer.size());
+    std::memcpy(record.beneficiary.data(), beneficiary.data(), beneficiary.size());
+    std::memcpy(record.oracleAdmin.data(), oracle.data(), oracle.size());
+    record.totalAmount = 1000;
+    record.lockedAmount = 1000;
+    record.state = AgreementState::FUNDED;
+    record.milestoneCount = 2;
+    record.milestones[0].id = 1;
+    record.milestones[0].amount = 600;
+    record.milestones[1].id = 2;
+    record.milestones[1].amount = 400;
+    std::memcpy(record.title.data(), "legacy", 6);
+    return record;
+}
+
+// Layout 1 text is upgraded only when it is a checksummed identity. A label
+// or a typo names no key: the migration reports it rather than invent one.
+void testUpgradesTextAddresses() {
+    populate(1);
+    QubicAddress payerKey;
+    for (size_t i = 0; i < payerKey.size(); ++i) payerKey[i] = static_cast<uint8_t>(i * 7 + 3);
+    const std::string payer = addressIdentity(payerKey);
+    const std::string beneficiaryA = addressIdentity(makeAddress("BENEFICIARY_A"));
+    const std::string beneficiaryB = addressIdentity(makeAddress("BENEFICIARY_B"));
+    const std::string oracle = addressIdentity(makeAddress("ORACLE"));
+    const std::string feeRecipient = addressIdentity(makeAddress("FEERECIPIENT"));
+    std::vector<AgreementLayoutV1> records;
+    for (uint32_t i = 0; i < 100; ++i) {
+        records.push_back(layoutV1Record(1000 + i, payer, i % 2 ? beneficiaryA : beneficiaryB, oracle));
+    }
+    for (BlockEncoding encoding : {BlockEncoding::RAW, BlockEncoding::COLUMNAR}) {
+        std::string in = tempPath("layout1");
+        std::string out = tempPath("layout1_out");
+        writeLayoutV1Snapshot(in, records, feeRecipient, encoding);
+
+        MigrationReport report;
+        CHECK_EQ(migrateSnapshotFile(in, out, BlockEncoding::COLUMNAR, true, report), SnapshotStatus::OK);
+        CHECK_EQ(report.fromLayout, 1u);
+        CHECK_EQ(report.agreements, 100u);
+        CHECK_EQ(report.violations, 0u);
+
+        auto restored = std::make_unique<PronexmaVaultState>();
+        CHECK_EQ(readSnapshot(out, *restored), SnapshotStatus::OK);
+        CHECK(restored->protocolFeeRecipient == makeAddress("FEERECIPIENT"));
+        CHECK(restored->agreements[0].payer == payerKey);
+        CHECK(restored->agreements[1].beneficiary == makeAddress("BENEFICIARY_A"));
+        CHECK(restored->agreements[99].oracleAdmin == makeAddress("ORACLE"));
+        CHECK_EQ(restored->agreements[99].id, 1099u);
+        CHECK_EQ(restored->agreements[42].milestones[1].amount, 400u);
+        CHECK_EQ(std::string(restored->agreements[42].title.data()), "legacy");
+
+        // The trees are recorded from the records, as a rebuild would give them.
+        auto rebuilt = std::make_unique<PronexmaVaultState>(*restored);
+        rebuildTickActivity(*rebuilt);
+        CHECK_EQ(restored->tickActivity.span, rebuilt->tickActivity.span);
+        CHECK(restored->tickActivity.amounts == rebuilt->tickActivity.amounts);
+        CHECK(restored->tickActivity.counts == rebuilt->tickActivity.counts);
+        CHECK_EQ(sumTickFlow(restored->tickActivity, TickFlow::FUNDED, 0, UINT64_MAX).amount, 100000u);
+        ::unlink(in.c_str());
+        ::unlink(out.c_str());
+    }
+
+    std::string typo = payer;
+    typo[0] = typo[0] == 'A' ? 'B' : 'A';
+    struct BadText {
+        uint32_t slot;
+        AgreementLayoutV1 record;
+        std::string feeRecipient;
+    };
+    const BadText cases[] = {
+        {7, layoutV1Record(1007, payer, typo, oracle), feeRecipient},              // Broken checksum
+        {9, layoutV1Record(1009, typo, beneficiaryA, oracle), feeRecipient},       // Even for the payer
+        {11, layoutV1Record(1011, payer, beneficiaryA, "ORACLE"), feeRecipient},   // Host label
+        {100, records[0], "FEERECIPIENT"},                                        // Header: slot = count
+    };
+    for (const BadText& bad : cases) {
+        std::vector<AgreementLayoutV1> broken = records;
+        if (bad.slot < broken.size()) broken[bad.slot] = bad.record;
+        std::string in = tempPath("layout1_bad");
+        std::string out = tempPath("layout1_bad_out");
+        writeLayoutV1Snapshot(in, broken, bad.feeRecipient, BlockEncoding::RAW);
+        MigrationReport report;
+        CHECK_EQ(migrateSnapshotFile(in, out, BlockEncoding::RAW, true, report), SnapshotStatus::INVARIANT_VIOLATION);
+        CHECK_EQ(report.firstViolation, MigrationViolation::INVALID_ADDRESS);
+        CHECK_EQ(report.firstViolationSlot, bad.slot);
+        ::unlink(in.c_str());
+    }
+}
+
+} // namespace
+
+int main() {
+    testMigratesAndValidates();
+    testRejectsBrokenAccounting();
+    testRejectsUnknownLayout();
+    testUpgradesTextAddresses();
+    return finishTests("migration_test");
+}
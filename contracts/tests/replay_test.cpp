@@ -0,0 +1,177 @@
+// contracts/tests/replay_test.cpp
+// Tick log round trip, replay verification and transaction-row import
+
+#include "WorkloadFixture.h"
+
+#include <memory>
+
+namespace {
+
+std::string tempPath(const char* name) {
+    return std::string("/tmp/pronexma_replay_") + name + "_" + std::to_string(::getpid());
+}
+
+// Records a workload run; returns the recorded end state.
+TickLogTotals recordWorkload(const std::string& path, uint64_t seed) {
+    WorkloadConfig config = testWorkload(seed, 5000);
+
+    TestEngine recorded;
+    WorkloadGenerator generator(config);
+    fundWorkloadParties(recorded.host, generator);
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    CHECK(fd >= 0);
+    TickLogWriter writer(fd);
+    CHECK(writer.begin(config.startTick) == SnapshotStatus::OK);
+    WorkloadOp op;
+    uint64_t calls = 0;
+    while (generator.next(op)) {
+        bool ok = runWorkloadOp(recorded.engine, recorded.host, op);
+        CHECK(writer.append(op, ok ? TickLogOutcome::SUCCEEDED : TickLogOutcome::FAILED) == SnapshotStatus::OK);
+        ++calls;
+    }
+    CHECK(writer.finish(*recorded.vault) == SnapshotStatus::OK);
+    ::close(fd);
+    return tickLogTotals(*recorded.vault, calls);
+}
+
+SnapshotStatus replayFile(const std::string& path, TestEngine& target, ReplayReport& report) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    CHECK(fd >= 0);
+    SnapshotStatus status = replayTickLog(fd, target.engine, target.host, report);
+    ::close(fd);
+    return status;
+}
+
+void testReplayReproducesRecordedRun() {
+    std::string path = tempPath("run");
+    TickLogTotals recorded = recordWorkload(path, 9);
+    CHECK(recorded.totalValueReleased > 0);
+
+    TestEngine target;
+    ReplayReport report;
+    CHECK(replayFile(path, target, report) == SnapshotStatus::OK);
+    CHECK(report.clean());
+    CHECK_EQ(report.calls, recorded.calls);
+    CHECK_EQ(target.vault->totalValueLocked, recorded.totalValueLocked);
+    CHECK_EQ(target.vault->protocolFeeAccrued, recorded.protocolFeeAccrued);
+    CHECK_EQ(target.vault->agreementCounter, recorded.agreementCounter);
+    const ReplayProcedureStats& refunds = report.procedures[static_cast<uint32_t>(WorkloadOpKind::REFUND)];
+    CHECK(refunds.calls > refunds.failures && refunds.failures > 0);  // Early refunds fail on replay too
+    CHECK(!report.slowestTicks.empty());
+    CHECK_EQ(report.latencies.total().count(), report.calls);
+    CHECK_EQ(report.latencies.at(WorkloadOpKind::REFUND, static_cast<uint32_t>(VaultError::TIMEOUT_NOT_REACHED)).count(),
+             refunds.failures);
+    for (size_t i = 1; i < report.slowestTicks.size(); ++i) {
+        CHECK(report.slowestTicks[i - 1].nanos >= report.slowestTicks[i].nanos);
+    }
+
+    // Replaying onto a vault that already holds an agreement diverges.
+    TestEngine diverged;
+    const uint64_t amounts[1] = {5};
+    diverged.host.invoke(makeAddress("OTHER"), 0, [&] {
+        return diverged.engine.createAgreement(makeAddress("B"), makeAddress("O"), 5, amounts, 1, "extra");
+    });
+    CHECK(replayFile(path, diverged, report) == SnapshotStatus::OK);
+    CHECK(!report.clean());
+    CHECK(report.outcomeMismatches > 0);
+    CHECK(!report.totalsMatch);
+    ::unlink(path.c_str());
+}
+
+void testTruncatedAndForeignLogsAreRejected() {
+    std::string path = tempPath("cut");
+    recordWorkload(path, 3);
+    CHECK(::truncate(path.c_str(), 4000) == 0);
+    TestEngine target;
+    ReplayReport report;
+    CHECK(replayFile(path, target, report) == SnapshotStatus::CORRUPT_BLOCK);
+    CHECK(!report.totalsPresent);
+
+    int fd = ::open(path.c_str(), O_WRONLY | O_TRUNC);
+    CHECK(::write(fd, "PRNXSNAPxxxxxxxxxxxx", 20) == 20);
+    ::close(fd);
+    TestEngine other;
+    CHECK(replayFile(path, other, report) == SnapshotStatus::BAD_MAGIC);
+    ::unlink(path.c_str());
+}
+
+// Rows name parties by the identities of the test's labels, as an export would.
+std::string withIdentities(std::string row) {
+    for (const char* label : {"PAYER", "BENEFICIARY", "ORACLE", "PRONEXMA_VAULT"}) {
+        const std::string quoted = std::string("\"") + label + "\"";
+        const std::string identity = "\"" + addressIdentity(makeAddress(label)) + "\"";
+        for (size_t at = row.find(quoted); at != std::string::npos; at = row.find(quoted, at + identity.size())) {
+            row.replace(at, quoted.size(), identity);
+        }
+    }
+    return row;
+}
+
+void testTransactionRowsReplay() {
+    const char* rows[] = {
+        "{\"type\":\"CREATE\",\"tick\":100,\"fromAddress\":\"PAYER\",\"toAddress\":\"BENEFICIARY\","
+        "\"oracleAddress\":\"ORACLE\",\"milestoneAmounts\":[\"600000\", 400000],\"status\":\"CONFIRMED\"}",
+        "{\"type\":\"DEPOSIT\",\"tick\":140,\"agreementId\":\"0x50524e5800000001\",\"fromAddress\":\"PAYER\","
+        "\"toAddress\":\"PRONEXMA_VAULT\",\"amount\":\"1000000\",\"status\":\"CONFIRMED\"}",
+        "{\"type\":\"VERIFY\",\"tick\":900,\"agreementId\":\"0x50524e5800000001\",\"fromAddress\":\"ORACLE\","
+        "\"milestoneId\":1}",
+        "{\"type\":\"RELEASE\",\"tick\":950,\"agreementId\":\"0x50524e5800000001\",\"fromAddress\":\"PRONEXMA_VAULT\","
+        "\"toAddress\":\"BENEFICIARY\",\"milestoneId\":1,\"amount\":\"597000\",\"status\":\"CONFIRMED\"}",
+        "{\"type\":\"FEE\",\"tick\":950,\"amount\":\"3000\"}",
+        "{\"type\":\"REFUND\",\"tick\":960,\"agreementId\":\"0x50524e5800000001\",\"fromAddress\":\"PAYER\","
+        "\"status\":\"FAILED\"}",
+        "{\"type\":\"END\",\"agreementCounter\":1,\"totalValueLocked\":\"400000\",\"totalValueReleased\":\"597000\","
+        "\"protocolFeeAccrued\":\"3000\",\"agreementCount\":1}",
+    };
+
+    TestEngine target;
+    VaultReplayer replayer(target.engine, target.host);
+    TickLogEntry entry;
+    TickLogTotals totals;
+    uint32_t calls = 0, skipped = 0;
+    bool haveTotals = false;
+    for (const char* row : rows) {
+        switch (parseTransactionJson(withIdentities(row), entry, totals)) {
+            case TransactionRow::CALL: replayer.replay(entry); ++calls; break;
+            case TransactionRow::SKIP: ++skipped; break;
+            case TransactionRow::TOTALS: haveTotals = true; break;
+            case TransactionRow::INVALID:
+            case TransactionRow::INVALID_ADDRESS: CHECK(false); break;
+        }
+    }
+    CHECK_EQ(calls, 5u);
+    CHECK_EQ(skipped, 1u);
+    CHECK(haveTotals);
+    const ReplayReport& report = replayer.finish(&totals);
+    CHECK(report.clean());
+    CHECK_EQ(target.host.balanceOf(makeAddress("BENEFICIARY")), 597000u);
+    CHECK_EQ(target.engine.getAgreement(0x50524e5800000001ull).createdAtTick, 100u);
+
+    auto parse = [&](const char* row) { return parseTransactionJson(withIdentities(row), entry, totals); };
+    CHECK(parse("{\"type\":\"WITHDRAW\",\"tick\":1,\"fromAddress\":\"PAYER\"}") == TransactionRow::INVALID);
+    CHECK(parse("{\"type\":\"DEPOSIT\",\"fromAddress\":\"PAYER\",\"amount\":5}") ==
+          TransactionRow::INVALID);           // No tick
+    CHECK(parse("{\"type\":\"DEPOSIT\",\"tick\":1,\"fromAddress\":\"PAYER\",\"amount\":-5}") ==
+          TransactionRow::INVALID);
+    CHECK(parse("not json") == TransactionRow::INVALID);
+
+    // Labels, typos and truncated identities name no key.
+    std::string typo = addressIdentity(makeAddress("PAYER"));
+    typo[3] = typo[3] == 'A' ? 'B' : 'A';
+    const std::string deposit = "{\"type\":\"DEPOSIT\",\"tick\":1,\"amount\":5,\"fromAddress\":";
+    CHECK(parseTransactionJson(deposit + "\"PAYER\"}", entry, totals) == TransactionRow::INVALID_ADDRESS);
+    CHECK(parseTransactionJson(deposit + "\"" + typo + "\"}", entry, totals) == TransactionRow::INVALID_ADDRESS);
+    CHECK(parseTransactionJson(deposit + "\"" + typo.substr(0, 59) + "\"}", entry, totals) ==
+          TransactionRow::INVALID_ADDRESS);
+    CHECK(parse("{\"type\":\"CREATE\",\"tick\":1,\"fromAddress\":\"PAYER\",\"toAddress\":\"BENEFICIARY\","
+                "\"oracleAddress\":\"ORACLE_X\",\"milestoneAmounts\":[1]}") == TransactionRow::INVALID_ADDRESS);
+}
+
+} // namespace
+
+int main() {
+    testReplayReproducesRecordedRun();
+    testTruncatedAndForeignLogsAreRejected();
+    testTransactionRowsReplay();
+    return finishTests("replay_test");
+}
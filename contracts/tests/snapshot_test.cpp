@@ -0,0 +1,346 @@
+// contracts/tests/snapshot_test.cpp
+// Snapshot round trip and background checkpoint consistency
+
+#include "TestSupport.h"
+#include "host/VaultCheckpoint.h"
+#include "host/VaultRestore.h"
+#include "host/VaultSnapshotDiff.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <string>
+#include <thread>
+
+namespace {
+
+std::string tempPath(const char* name) {
+    return std::string("/tmp/pronexma_") + name + "_" + std::to_string(::getpid()) + ".snap";
+}
+
+void populate(uint32_t count) {
+    initialize(makeAddress("FEERECIPIENT"));
+    const uint64_t amounts[3] = {0, 0, 0};
+    for (uint32_t i = 0; i < count; ++i) {
+        uint64_t id = createAgreement(makeAddress("BENEFICIARY"), makeAddress("ORACLE"), 0, amounts, 3, "Series A vesting");
+        CHECK(id != 0);
+    }
+}
+
+bool sameAgreement(const Agreement& a, const Agreement& b) {
+    Agreement ca;
+    Agreement cb;
+    canonicalizeAgreement(a, ca);
+    canonicalizeAgreement(b, cb);
+    return std::memcmp(&ca, &cb, sizeof(Agreement)) == 0;
+}
+
+void testRoundTrip(BlockEncoding encoding) {
+    populate(150);
+    state.agreements[7].state = AgreementState::FUNDED;
+    state.agreements[7].milestones[0].amount = 42;
+    state.agreements[7].totalAmount = 42;
+    state.agreements[7].lockedAmount = 42;
+    state.agreements[7].timeoutTick = 5;
+    state.agreements[7].fundedAtTick = 1000005;
+    state.agreements[149].milestones[2].state = MilestoneState::VERIFIED;
+    state.agreements[149].milestones[2].verifiedAtTick = ~0ull;
+    state.agreements[149].milestones[2].evidenceHash.fill(0xAB);
+    state.agreements[149].milestones[2].evidenceHash[10] = 0;
+    state.agreements[149].metadata[300] = '{';
+    state.agreements[80].payer = makeAddress("PAYER");
+    state.totalValueLocked = 42;
+    rebuildCapacityCounters(state);
+
+    std::string path = tempPath("roundtrip");
+    CHECK_EQ(writeSnapshot(state, 77, path, encoding), SnapshotStatus::OK);
+
+    auto restored = std::make_unique<PronexmaVaultState>();
+    SnapshotHeader header;
+    CHECK_EQ(readSnapshot(path, *restored, &header), SnapshotStatus::OK);
+    CHECK_EQ(header.tick, 77u);
+    CHECK_EQ(restored->activeAgreementCount, 150u);
+    CHECK_EQ(restored->agreementCounter, state.agreementCounter);
+    CHECK_EQ(restored->totalValueLocked, 42u);
+    CHECK_EQ(restored->capacityCounters.agreementsByState, state.capacityCounters.agreementsByState);
+    CHECK_EQ(restored->capacityCounters.milestonesUsed, 450u);
+    for (uint32_t i = 0; i < 150; ++i) {
+        CHECK(sameAgreement(restored->agreements[i], state.agreements[i]));
+    }
+    ::unlink(path.c_str());
+}
+
+void testColumnarIsSmaller() {
+    populate(640);
+    std::string rawPath = tempPath("raw");
+    std::string packedPath = tempPath("packed");
+    CHECK_EQ(writeSnapshot(state, 1, rawPath, BlockEncoding::RAW), SnapshotStatus::OK);
+    CHECK_EQ(writeSnapshot(state, 1, packedPath, BlockEncoding::COLUMNAR), SnapshotStatus::OK);
+
+    struct stat rawStat;
+    struct stat packedStat;
+    CHECK_EQ(::stat(rawPath.c_str(), &rawStat), 0);
+    CHECK_EQ(::stat(packedPath.c_str(), &packedStat), 0);
+    CHECK(packedStat.st_size * 20 < rawStat.st_size);
+    ::unlink(rawPath.c_str());
+    ::unlink(packedPath.c_str());
+}
+
+void testCorruptionDetected() {
+    populate(10);
+    std::string path = tempPath("corrupt");
+    CHECK_EQ(writeSnapshot(state, 1, path), SnapshotStatus::OK);
+
+    // Flip a byte inside the first record's title.
+    int fd = ::open(path.c_str(), O_RDWR);
+    const Agreement& first = state.agreements[0];
+    off_t titleOffset = reinterpret_cast<const char*>(first.title.data()) - reinterpret_cast<const char*>(&first);
+    off_t offset = sizeof(SnapshotHeader) + sizeof(SnapshotBlockHeader) + titleOffset;
+    char byte = 'X';
+    CHECK_EQ(::pwrite(fd, &byte, 1, offset), 1);
+    ::close(fd);
+
+    auto restored = std::make_unique<PronexmaVaultState>();
+    CHECK_EQ(readSnapshot(path, *restored), SnapshotStatus::HASH_MISMATCH);
+    ::unlink(path.c_str());
+}
+
+void testCheckpointSeesTickBoundary() {
+    populate(2000);
+    auto expected = std::make_unique<PronexmaVaultState>(state);
+
+    std::string path = tempPath("checkpoint");
+    {
+        VaultCheckpointer checkpointer(defaultEngine);
+        CHECK_EQ(checkpointer.begin(path, 500, BlockEncoding::COLUMNAR), SnapshotStatus::OK);
+        CHECK_EQ(checkpointer.begin(path, 501), SnapshotStatus::BUSY);
+
+        // Keep executing while the checkpoint is in flight.
+        for (uint32_t i = 0; i < 2000; i += 3) {
+            CHECK(deposit(state.agreements[i].id));
+        }
+        const uint64_t amounts[1] = {0};
+        createAgreement(makeAddress("LATE"), makeAddress("ORACLE"), 0, amounts, 1, "after capture");
+
+        CHECK_EQ(checkpointer.wait(), SnapshotStatus::OK);
+        CHECK_EQ(checkpointer.lastStats().agreements, 2000u);
+    }
+
+    auto restored = std::make_unique<PronexmaVaultState>();
+    CHECK_EQ(readSnapshot(path, *restored), SnapshotStatus::OK);
+    CHECK_EQ(restored->activeAgreementCount, 2000u);
+    for (uint32_t i = 0; i < 2000; ++i) {
+        CHECK(sameAgreement(restored->agreements[i], expected->agreements[i]));
+    }
+    CHECK_EQ(state.agreements[0].state, AgreementState::FUNDED);
+    ::unlink(path.c_str());
+}
+
+// The checkpoint writes into a FIFO nobody drains yet, so its thread blocks in
+// write() in the middle of a block flush. A procedure hitting the slot that
+// ended that block must not wait for the flush: the slot was released as soon
+// as its record was copied into the block buffer.
+void testBarrierNeverWaitsOnBlockWrites() {
+    populate(2000);
+    auto expected = std::make_unique<PronexmaVaultState>(state);
+    std::string path = tempPath("stalled");
+    std::string tmpPath = path + ".tmp";
+    CHECK_EQ(::mkfifo(tmpPath.c_str(), 0600), 0);
+    int drain = ::open(tmpPath.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    CHECK(drain >= 0);
+    const int pipeBytes = ::fcntl(drain, F_GETPIPE_SZ);
+
+    std::string stream;
+    {
+        VaultCheckpointer checkpointer(defaultEngine);
+        CHECK_EQ(checkpointer.begin(path, 500), SnapshotStatus::OK);
+        int queued = 0;
+        while (queued < pipeBytes) {                       // Full pipe: the writer is blocked
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            CHECK_EQ(::ioctl(drain, FIONREAD, &queued), 0);
+        }
+
+        std::atomic<bool> mutated{false};
+        std::thread mutator([&] {
+            for (uint32_t i = SNAPSHOT_BLOCK_CAPACITY - 1; i < 2000; i += SNAPSHOT_BLOCK_CAPACITY) {
+                deposit(state.agreements[i].id);
+            }
+            mutated.store(true, std::memory_order_release);
+        });
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!mutated.load(std::memory_order_acquire) && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        CHECK(mutated.load(std::memory_order_acquire));
+
+        char chunk[1 << 16];
+        for (;;) {
+            ssize_t got = ::read(drain, chunk, sizeof(chunk));
+            if (got == 0) break;                           // Writer closed: the stream is complete
+            if (got > 0) stream.append(chunk, static_cast<size_t>(got));
+            else std::this_thread::yield();
+        }
+        mutator.join();
+        checkpointer.wait();                               // IO_ERROR: a FIFO cannot be fsynced
+    }
+    ::close(drain);
+    ::unlink(tmpPath.c_str());
+
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    CHECK_EQ(::write(fd, stream.data(), stream.size()), static_cast<ssize_t>(stream.size()));
+    ::close(fd);
+    auto restored = std::make_unique<PronexmaVaultState>();
+    CHECK_EQ(readSnapshot(path, *restored), SnapshotStatus::OK);
+    CHECK_EQ(restored->activeAgreementCount, 2000u);
+    for (uint32_t i = 0; i < 2000; ++i) {
+        CHECK(sameAgreement(restored->agreements[i], expected->agreements[i]));
+    }
+    CHECK_EQ(state.agreements[SNAPSHOT_BLOCK_CAPACITY - 1].state, AgreementState::FUNDED);
+    ::unlink(path.c_str());
+}
+
+void testParallelRestoreIsDeterministic() {
+    populate(1000);
+    for (uint32_t i = 0; i < 1000; i += 7) {
+        state.agreements[i].payer = makeAddress(i % 2 ? "PAYER_A" : "PAYER_B");
+        state.agreements[i].state = AgreementState::FUNDED;
+        state.agreements[i].milestones[0].amount = 10;
+        state.agreements[i].totalAmount = 10;
+        state.agreements[i].lockedAmount = 10;
+        state.agreements[i].timeoutTick = 5000 - i % 13;
+        state.totalValueLocked += 10;
+    }
+    std::string path = tempPath("parallel");
+    CHECK_EQ(writeSnapshot(state, 9, path, BlockEncoding::COLUMNAR), SnapshotStatus::OK);
+
+    auto serialState = std::make_unique<PronexmaVaultState>();
+    VaultIndexes serialIndexes;
+    CHECK_EQ(readSnapshot(path, *serialState), SnapshotStatus::OK);
+    buildVaultIndexes(*serialState, serialIndexes);
+
+    for (uint32_t workers : {1u, 3u, 8u}) {
+        auto parallelState = std::make_unique<PronexmaVaultState>();
+        VaultIndexes parallelIndexes;
+        RestoreStats stats;
+        CHECK_EQ(restoreSnapshotParallel(path, *parallelState, parallelIndexes, workers, &stats), SnapshotStatus::OK);
+        CHECK_EQ(stats.workers, workers);
+        CHECK(parallelIndexes == serialIndexes);
+        CHECK_EQ(parallelState->activeAgreementCount, 1000u);
+        for (uint32_t i = 0; i < 1000; ++i) {
+            CHECK(sameAgreement(parallelState->agreements[i], state.agreements[i]));
+        }
+    }
+
+    CHECK_EQ(serialIndexes.byId.find(state.agreements[321].id), 321u);
+    CHECK_EQ(serialIndexes.byId.find(12345), AGREEMENT_NOT_FOUND);
+    CHECK_EQ(serialIndexes.byPayer[makeAddress("PAYER_A")].size(), 71u);
+    CHECK(std::is_sorted(serialIndexes.byTimeout.begin(), serialIndexes.byTimeout.end()));
+    CHECK_EQ(serialIndexes.byTimeout.size(), 143u);
+    ::unlink(path.c_str());
+}
+
+void testRestoreRejectsBrokenAccounting() {
+    populate(200);
+    std::string path = tempPath("unbalanced");
+    state.agreements[120].state = AgreementState::FUNDED;   // Deposited 700, locks 500, released nothing
+    state.agreements[120].milestones[0].amount = 700;
+    state.agreements[120].totalAmount = 700;
+    state.agreements[120].lockedAmount = 500;
+    state.totalValueLocked = 500;
+    CHECK_EQ(writeSnapshot(state, 1, path, BlockEncoding::COLUMNAR), SnapshotStatus::OK);
+    auto restored = std::make_unique<PronexmaVaultState>();
+    VaultIndexes indexes;
+    CHECK_EQ(readSnapshot(path, *restored), SnapshotStatus::INVARIANT_VIOLATION);
+    CHECK_EQ(restoreSnapshotParallel(path, *restored, indexes, 3), SnapshotStatus::INVARIANT_VIOLATION);
+
+    // Every record balances, but the header's TVL does not match them.
+    state.agreements[120].lockedAmount = 700;
+    CHECK_EQ(writeSnapshot(state, 2, path), SnapshotStatus::OK);
+    CHECK_EQ(readSnapshot(path, *restored), SnapshotStatus::INVARIANT_VIOLATION);
+    CHECK_EQ(restoreSnapshotParallel(path, *restored, indexes, 3), SnapshotStatus::INVARIANT_VIOLATION);
+
+    state.totalValueLocked = 700;
+    CHECK_EQ(writeSnapshot(state, 3, path), SnapshotStatus::OK);
+    CHECK_EQ(readSnapshot(path, *restored), SnapshotStatus::OK);
+    CHECK_EQ(restoreSnapshotParallel(path, *restored, indexes, 3), SnapshotStatus::OK);
+    ::unlink(path.c_str());
+}
+
+void testDiffReportsFieldDeltas() {
+    populate(1000);
+    std::string left = tempPath("diff_left");
+    std::string right = tempPath("diff_right");
+    CHECK_EQ(writeSnapshot(state, 1, left, BlockEncoding::RAW), SnapshotStatus::OK);
+
+    const uint64_t amounts[1] = {0};
+    createAgreement(makeAddress("NEW"), makeAddress("ORACLE"), 0, amounts, 1, "added");
+    state.agreements[10].lockedAmount = 500;   // Direct writes: the audit would reject them in a call
+    state.agreements[700].milestones[1].state = MilestoneState::RELEASED;
+    state.totalValueLocked = 500;
+    CHECK_EQ(writeSnapshot(state, 2, right, BlockEncoding::COLUMNAR), SnapshotStatus::OK);
+
+    SnapshotDiff diff;
+    CHECK_EQ(diffSnapshotFiles(left, right, diff), SnapshotStatus::OK);
+    CHECK_EQ(diff.changedAgreements, 2u);
+    CHECK_EQ(diff.addedAgreements, 1u);
+    CHECK(diff.blocksDecoded <= 6u);
+
+    bool sawLocked = false;
+    bool sawMilestone = false;
+    for (const SnapshotFieldDelta& delta : diff.deltas) {
+        if (delta.slot == 10 && delta.field == "lockedAmount") {
+            sawLocked = delta.before == "0" && delta.after == "500";
+        }
+        if (delta.slot == 700 && delta.field == "milestones[1].state") {
+            sawMilestone = delta.before == "PENDING" && delta.after == "RELEASED";
+        }
+    }
+    CHECK(sawLocked);
+    CHECK(sawMilestone);
+
+    CHECK_EQ(diffSnapshotFiles(left, left, diff), SnapshotStatus::OK);
+    CHECK(diff.identical());
+    CHECK_EQ(diff.blocksDecoded, 0u);
+
+    // Same records, different trees: a flow the slots do not show is a bucket delta.
+    const VaultTickActivity& activity = state.tickActivity;
+    const uint64_t tick = activity.originTick + (uint64_t(3) << activity.bucketShift);
+    CHECK_EQ(writeSnapshot(state, 3, left), SnapshotStatus::OK);
+    recordTickFlow(state.tickActivity, TickFlow::RELEASED, tick, 250);
+    CHECK_EQ(writeSnapshot(state, 3, right), SnapshotStatus::OK);
+    CHECK_EQ(diffSnapshotFiles(left, right, diff), SnapshotStatus::OK);
+    CHECK_EQ(diff.changedAgreements, 0u);
+    CHECK_EQ(diff.deltas.size(), 3u);
+    CHECK(diff.deltas[0].field == "ticks.span");
+    CHECK(diff.deltas[1].field == "ticks.released.amount[3]");
+    CHECK(diff.deltas[1].before == "0" && diff.deltas[1].after == "250");
+    CHECK(diff.deltas[2].field == "ticks.released.count[3]");
+
+    // Buckets that do not line up are compared by each flow's total.
+    state.tickActivity.originTick += 1;
+    CHECK_EQ(writeSnapshot(state, 3, right), SnapshotStatus::OK);
+    CHECK_EQ(diffSnapshotFiles(left, right, diff), SnapshotStatus::OK);
+    CHECK_EQ(diff.deltas.size(), 4u);
+    CHECK(diff.deltas[0].field == "ticks.originTick");
+    CHECK(diff.deltas[2].field == "ticks.released.amount" && diff.deltas[2].after == "250");
+    CHECK(diff.deltas[3].field == "ticks.released.count");
+    ::unlink(left.c_str());
+    ::unlink(right.c_str());
+}
+
+} // namespace
+
+int main() {
+    testRoundTrip(BlockEncoding::RAW);
+    testRoundTrip(BlockEncoding::COLUMNAR);
+    testColumnarIsSmaller();
+    testCorruptionDetected();
+    testCheckpointSeesTickBoundary();
+    testBarrierNeverWaitsOnBlockWrites();
+    testParallelRestoreIsDeterministic();
+    testRestoreRejectsBrokenAccounting();
+    testDiffReportsFieldDeltas();
+    return finishTests("snapshot_test");
+}
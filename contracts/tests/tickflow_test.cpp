@@ -0,0 +1,269 @@
+// contracts/tests/tickflow_test.cpp
+// Tick activity: range views over the Fenwick trees match a scan of the
+// records over the ticks they report covering, buckets widen without losing
+// totals, snapshots keep the trees, and the full-scan audit catches drift.
+
+#include "WorkloadFixture.h"
+#include "host/VaultAudit.h"
+#include "host/VaultCheckpoint.h"
+#include "host/VaultRestore.h"
+
+#include <memory>
+#include <random>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+/** Totals of one flow over [fromTick, toTick), by scanning the records (refunds at their timeoutTick). */
+TickFlowTotals flowByRecords(const PronexmaVaultState& vault, TickFlow flow, uint64_t fromTick, uint64_t toTick) {
+    TickFlowTotals totals = {};
+    auto add = [&](uint64_t tick, uint64_t amount) {
+        if (tick < fromTick || tick >= toTick) return;
+        totals.amount += amount;
+        ++totals.count;
+    };
+    for (uint32_t i = 0; i < vault.activeAgreementCount; ++i) {
+        const Agreement& agreement = vault.agreements[i];
+        if (flow == TickFlow::CREATED) add(agreement.createdAtTick, agreement.totalAmount);
+        if (agreement.state == AgreementState::CREATED) continue;
+        if (flow == TickFlow::FUNDED) add(agreement.fundedAtTick, agreement.totalAmount);
+        uint64_t paidOut = 0;
+        for (uint32_t m = 0; m < agreement.milestoneCount; ++m) {
+            const Milestone& milestone = agreement.milestones[m];
+            if (milestone.state != MilestoneState::RELEASED) continue;
+            if (flow == TickFlow::RELEASED) add(milestone.releasedAtTick, milestone.amount);
+            paidOut += milestone.amount;
+        }
+        if (flow == TickFlow::REFUNDED && agreement.state == AgreementState::REFUNDED) {
+            add(agreement.timeoutTick, agreement.totalAmount - paidOut);
+        }
+    }
+    return totals;
+}
+
+void testBucketConversions() {
+    std::mt19937_64 rng(9);
+    std::array<uint64_t, 64> buckets, tree;
+    for (uint64_t& value : buckets) value = rng() >> 8;
+    tree = buckets;
+    fenwickFromBuckets(tree, 64);
+    for (uint32_t end = 0; end <= 64; ++end) {
+        uint64_t prefix = 0;
+        for (uint32_t b = 0; b < end; ++b) prefix += buckets[b];
+        CHECK_EQ(fenwickPrefix(tree, end), prefix);
+    }
+    fenwickToBuckets(tree, 64);
+    CHECK(tree == buckets);
+
+    std::array<uint64_t, 64> incremental = {};
+    for (uint32_t b = 0; b < 64; ++b) fenwickAdd(incremental, 64, b, buckets[b]);
+    std::array<uint64_t, 64> built = buckets;
+    fenwickFromBuckets(built, 64);
+    CHECK(incremental == built);
+
+    // Merging pairs halves the tree; the upper half is left zero.
+    mergeBucketPairs(built, 64);
+    for (uint32_t end = 0; end <= 32; ++end) {
+        uint64_t prefix = 0;
+        for (uint32_t b = 0; b < 2 * end; ++b) prefix += buckets[b];
+        CHECK_EQ(fenwickPrefix(built, end), prefix);
+    }
+    for (uint32_t i = 32; i < 64; ++i) CHECK_EQ(built[i], 0u);
+}
+
+void testSpanGrowsWithTheBucketsWritten() {
+    auto activity = std::make_unique<TickActivity<DefaultVaultConfig>>();
+    resetTickActivity(*activity, 1000);
+    CHECK_EQ(activity->span, 1u);
+    recordTickFlow(*activity, TickFlow::FUNDED, 1000, 5);
+    recordTickFlow(*activity, TickFlow::FUNDED, 900, 7);        // Before the origin: bucket 0
+    CHECK_EQ(activity->span, 1u);
+    const uint64_t width = uint64_t(1) << DefaultVaultConfig::TICK_BUCKET_SHIFT;
+    recordTickFlow(*activity, TickFlow::FUNDED, 1000 + 37 * width, 11);
+    CHECK_EQ(activity->span, 64u);
+    CHECK_EQ(sumTickFlow(*activity, TickFlow::FUNDED, 0, UINT64_MAX).amount, 23u);
+    CHECK_EQ(sumTickFlow(*activity, TickFlow::FUNDED, 1000 + width, UINT64_MAX).amount, 11u);
+    CHECK_EQ(sumTickFlow(*activity, TickFlow::FUNDED, 0, 1000 + width).count, 2u);
+    for (uint32_t i = activity->span; i < DefaultVaultConfig::TICK_BUCKETS; ++i) {
+        CHECK_EQ(activity->amounts[static_cast<uint32_t>(TickFlow::FUNDED)][i], 0u);
+    }
+
+    // A reset clears the span in use and nothing past it.
+    resetTickActivity(*activity, 5000);
+    CHECK_EQ(activity->span, 1u);
+    for (uint32_t f = 0; f < TICK_FLOW_COUNT; ++f) {
+        CHECK_EQ(sumTickFlow(*activity, static_cast<TickFlow>(f), 0, UINT64_MAX).count, 0u);
+        for (uint32_t i = 0; i < 64; ++i) CHECK_EQ(activity->counts[f][i], 0u);
+    }
+}
+
+void testRangesMatchTheRecords() {
+    TestEngine target;
+    runWorkload(target, 31);
+    const PronexmaVaultState& vault = *target.vault;
+    CHECK(vault.tickActivity.bucketShift > DefaultVaultConfig::TICK_BUCKET_SHIFT);
+
+    std::mt19937_64 rng(31);
+    const uint64_t lastTick = target.host.tick();
+    const TickFlow flows[] = {TickFlow::CREATED, TickFlow::FUNDED, TickFlow::RELEASED, TickFlow::REFUNDED};
+    for (uint32_t q = 0; q < 300; ++q) {
+        uint64_t fromTick = rng() % (lastTick + 1);
+        uint64_t toTick = fromTick + 1 + rng() % (lastTick / 4);
+        for (TickFlow flow : flows) {
+            TickFlowTotals totals = target.engine.getTickFlow(flow, fromTick, toTick);
+            CHECK(totals.fromTick <= fromTick && totals.toTick >= toTick);
+            TickFlowTotals expected = flowByRecords(vault, flow, totals.fromTick, totals.toTick);
+            CHECK_EQ(totals.amount, expected.amount);
+            CHECK_EQ(totals.count, expected.count);
+            CHECK_EQ(target.engine.lastWork().units, WORK_BOUND_GET_TICK_FLOW);
+        }
+    }
+
+    // All time, against the running sums.
+    const AccountingCounters& running = vault.accountingCounters;
+    auto allTime = [&](TickFlow flow) { return target.engine.getTickFlow(flow, 0, UINT64_MAX); };
+    CHECK_EQ(allTime(TickFlow::FUNDED).amount, running.depositedByPayers);
+    CHECK_EQ(allTime(TickFlow::RELEASED).amount, vault.totalValueReleased + vault.protocolFeeAccrued);
+    CHECK_EQ(allTime(TickFlow::REFUNDED).amount, running.refundedToPayers);
+    CHECK(running.refundedToPayers > 0);
+    CHECK_EQ(allTime(TickFlow::CREATED).count, uint64_t(vault.activeAgreementCount));
+
+    // Empty, reversed and out-of-range queries.
+    CHECK_EQ(target.engine.getTickFlow(TickFlow::CREATED, 10, 10).count, 0u);
+    CHECK_EQ(target.engine.getTickFlow(TickFlow::CREATED, 10, 5).count, 0u);
+    CHECK_EQ(target.engine.getTickFlow(static_cast<TickFlow>(TICK_FLOW_COUNT), 0, UINT64_MAX).count, 0u);
+    CHECK(auditVaultAccounting(vault).clean());
+}
+
+void testRefundsAndWidening() {
+    TestEngine target;
+    NativeHost& host = target.host;
+    const QubicAddress payer = makeAddress("PAYER"), beneficiary = makeAddress("BENEFICIARY");
+    const QubicAddress oracle = makeAddress("ORACLE");
+    host.credit(payer, 10000);
+    const uint64_t amounts[2] = {600, 400};
+    host.setTick(100);
+    uint64_t id = host.invoke(payer, 0, [&] {
+        return target.engine.createAgreement(beneficiary, oracle, 1000, amounts, 2, "early");
+    });
+    CHECK(host.invoke(payer, 1000, [&] { return target.engine.deposit(id); }));
+    const std::array<uint8_t, 64> evidence = {1};
+    CHECK(host.invoke(oracle, 0, [&] { return target.engine.markMilestoneVerified(id, 1, evidence); }));
+    CHECK(host.invoke(beneficiary, 0, [&] { return target.engine.releaseMilestone(id, 1); }));
+    const uint32_t shift = target.vault->tickActivity.bucketShift;
+
+    // The refund lands far past the last bucket: buckets widen, totals hold. It
+    // is recorded at the timeout tick, not the later tick it was asked at.
+    host.advanceTicks(REFUND_TIMEOUT_TICKS + 5000);
+    const uint64_t refundTick = target.vault->agreements[0].timeoutTick;
+    CHECK(refundTick + 5000 <= host.tick());
+    CHECK(host.invoke(payer, 0, [&] { return target.engine.refund(id); }));
+    CHECK(target.vault->tickActivity.bucketShift > shift);
+    TickFlowTotals refunded = target.engine.getTickFlow(TickFlow::REFUNDED, refundTick, refundTick + 1);
+    CHECK_EQ(refunded.amount, 400u);
+    CHECK_EQ(refunded.count, 1u);
+    CHECK_EQ(target.engine.getTickFlow(TickFlow::REFUNDED, 0, refunded.fromTick).count, 0u);
+    TickFlowTotals early = target.engine.getTickFlow(TickFlow::RELEASED, 0, 101);
+    CHECK_EQ(early.amount, 600u);
+    CHECK_EQ(target.engine.getTickFlow(TickFlow::CREATED, 0, UINT64_MAX).amount, 1000u);
+    CHECK(auditVaultAccounting(*target.vault).clean());
+
+    // A rebuild from the slots puts the refund where the live path did.
+    TestEngine rebuilt;
+    *rebuilt.vault = *target.vault;
+    rebuildTickActivity(*rebuilt.vault);
+    TickFlowTotals again = rebuilt.engine.getTickFlow(TickFlow::REFUNDED, refundTick, refundTick + 1);
+    CHECK_EQ(again.amount, 400u);
+    CHECK_EQ(rebuilt.engine.getTickFlow(TickFlow::REFUNDED, 0, again.fromTick).count, 0u);
+    CHECK_EQ(rebuilt.engine.getTickFlow(TickFlow::REFUNDED, again.toTick, UINT64_MAX).count, 0u);
+
+    // Reset starts the trees over at the current tick.
+    target.engine.initialize(makeAddress("FEERECIPIENT"));
+    CHECK_EQ(target.vault->tickActivity.originTick, host.tick());
+    CHECK_EQ(target.vault->tickActivity.bucketShift, DefaultVaultConfig::TICK_BUCKET_SHIFT);
+    CHECK_EQ(target.engine.getTickFlow(TickFlow::REFUNDED, 0, UINT64_MAX).count, 0u);
+}
+
+/** Every flow's view over the whole run and random ranges of it is the same in both engines. */
+void checkSameTickViews(TestEngine& expected, TestEngine& actual, uint64_t lastTick) {
+    const VaultTickActivity& before = expected.vault->tickActivity;
+    const VaultTickActivity& after = actual.vault->tickActivity;
+    CHECK_EQ(after.originTick, before.originTick);
+    CHECK_EQ(after.bucketShift, before.bucketShift);
+    CHECK_EQ(after.span, before.span);
+    std::mt19937_64 rng(lastTick);
+    for (uint32_t q = 0; q < 100; ++q) {
+        uint64_t fromTick = q == 0 ? 0 : rng() % (lastTick + 1);
+        uint64_t toTick = q == 0 ? UINT64_MAX : fromTick + 1 + rng() % (lastTick / 4);
+        for (uint32_t f = 0; f < TICK_FLOW_COUNT; ++f) {
+            TickFlow flow = static_cast<TickFlow>(f);
+            TickFlowTotals want = expected.engine.getTickFlow(flow, fromTick, toTick);
+            TickFlowTotals got = actual.engine.getTickFlow(flow, fromTick, toTick);
+            CHECK_EQ(got.amount, want.amount);
+            CHECK_EQ(got.count, want.count);
+            CHECK_EQ(got.fromTick, want.fromTick);
+            CHECK_EQ(got.toTick, want.toTick);
+        }
+    }
+}
+
+void testRestoreKeepsTheTreesAndAuditCatchesDrift() {
+    TestEngine target;
+    runWorkload(target, 32);
+    const uint64_t lastTick = target.host.tick();
+    const std::string path = "/tmp/pronexma_tickflow_" + std::to_string(::getpid());
+    for (BlockEncoding encoding : {BlockEncoding::RAW, BlockEncoding::COLUMNAR}) {
+        CHECK_EQ(writeSnapshot(*target.vault, lastTick, path, encoding), SnapshotStatus::OK);
+        TestEngine restored;
+        CHECK_EQ(readSnapshot(path, *restored.vault), SnapshotStatus::OK);
+        CHECK(auditVaultAccounting(*restored.vault).clean());
+        checkSameTickViews(target, restored, lastTick);   // REFUNDED too: the trees keep the refund ticks
+
+        TestEngine parallel;
+        VaultIndexes indexes;
+        CHECK_EQ(restoreSnapshotParallel(path, *parallel.vault, indexes, 3), SnapshotStatus::OK);
+        checkSameTickViews(target, parallel, lastTick);
+    }
+
+    // A checkpoint writes the trees as they were at its tick boundary.
+    {
+        VaultCheckpointer checkpointer(target.engine);
+        CHECK_EQ(checkpointer.begin(path, lastTick), SnapshotStatus::OK);
+        CHECK_EQ(checkpointer.wait(), SnapshotStatus::OK);
+    }
+    TestEngine checkpointed;
+    CHECK_EQ(readSnapshot(path, *checkpointed.vault), SnapshotStatus::OK);
+    checkSameTickViews(target, checkpointed, lastTick);
+
+    // A corrupted tree entry fails the section hash.
+    int fd = ::open(path.c_str(), O_RDWR);
+    SnapshotHeader header;
+    std::vector<SnapshotBlockIndexEntry> index;
+    CHECK_EQ(readSnapshotBlockIndex(fd, header, index), SnapshotStatus::OK);
+    uint64_t entryOffset = index.back().offset + sizeof(SnapshotBlockHeader) + index.back().block.payloadBytes +
+                           sizeof(SnapshotTickSection);
+    uint64_t bogus = 12345;
+    CHECK_EQ(::pwrite(fd, &bogus, sizeof(bogus), static_cast<off_t>(entryOffset)), 8);
+    ::close(fd);
+    TestEngine corrupted;
+    CHECK_EQ(readSnapshot(path, *corrupted.vault), SnapshotStatus::HASH_MISMATCH);
+    ::unlink(path.c_str());
+
+    PronexmaVaultState& vault = *target.vault;
+    recordTickFlow(vault.tickActivity, TickFlow::RELEASED, lastTick, 1);   // A host write the slots do not show
+    CHECK(auditVaultAccounting(vault).violation == AccountingViolation::TICK_FLOWS_DRIFTED);
+    rebuildTickActivity(vault);
+    CHECK(auditVaultAccounting(vault).clean());
+}
+
+} // namespace
+
+int main() {
+    testBucketConversions();
+    testSpanGrowsWithTheBucketsWritten();
+    testRangesMatchTheRecords();
+    testRefundsAndWidening();
+    testRestoreKeepsTheTreesAndAuditCatchesDrift();
+    return finishTests("tickflow_test");
+}
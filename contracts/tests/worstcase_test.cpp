@@ -0,0 +1,109 @@
+// contracts/tests/worstcase_test.cpp
+// Worst-case search: determinism, documented bounds, and saved-case round trip
+
+#include "TestSupport.h"
+#include "host/VaultWorstCase.h"
+
+#include <memory>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+std::string tempDir(const char* name) {
+    return std::string("/tmp/pronexma_worstcase_") + name + "_" + std::to_string(::getpid());
+}
+
+uint64_t noClock() { return 0; }
+
+void testSearchIsDeterministicAndBounded() {
+    auto first = std::make_unique<WorstCaseSearch>(7, WorstCaseMetric::WORK_UNITS, noClock);
+    auto second = std::make_unique<WorstCaseSearch>(7, WorstCaseMetric::WORK_UNITS, noClock);
+    first->run(300);
+    second->run(300);
+    CHECK_EQ(first->evaluations(), 300u);
+    for (uint32_t k = 0; k < WORKLOAD_OP_KINDS; ++k) {
+        WorkloadOpKind kind = static_cast<WorkloadOpKind>(k);
+        const WorstCaseChampion& a = first->champion(kind);
+        const WorstCaseChampion& b = second->champion(kind);
+        CHECK(a.found);
+        CHECK_EQ(a.units, b.units);
+        CHECK_EQ(a.call, b.call);
+        CHECK(a.units <= workloadWorkBound(kind));
+    }
+    // Full-table scans are cheap to reach and pin the bounds from above.
+    CHECK_EQ(first->champion(WorkloadOpKind::DEPOSIT).units, WORK_BOUND_DEPOSIT);
+    CHECK_EQ(first->champion(WorkloadOpKind::REFUND).units, WORK_BOUND_REFUND);
+    CHECK_EQ(first->champion(WorkloadOpKind::GET_AGREEMENT).units, WORK_BOUND_GET_AGREEMENT);
+}
+
+void testSavedCaseReplaysTheSameWork() {
+    auto searcher = std::make_unique<WorstCaseSearch>(3, WorstCaseMetric::WORK_UNITS, noClock);
+    searcher->run(60);
+    const WorstCaseChampion& champion = searcher->champion(WorkloadOpKind::RELEASE_MILESTONE);
+    CHECK(champion.found);
+
+    std::string dir = tempDir("saved");
+    ::mkdir(dir.c_str(), 0755);
+    CHECK(saveWorstCase(dir, "release", champion, searcher->engine()) == SnapshotStatus::OK);
+    WorstCaseReplay saved;
+    CHECK(loadWorstCase(dir, "release", saved) == SnapshotStatus::OK);
+    CHECK_EQ(saved.calls.size(), champion.input.calls.size());
+
+    auto work = std::make_unique<PronexmaVaultState>();
+    *work = *saved.vault;
+    PronexmaVaultEngine engine(*work);
+    NativeHost host;
+    HostContextBinding binding(engine, host.context());
+    host.credit(host.contractAccount(), work->totalValueLocked);
+    for (size_t c = 0; c < saved.calls.size(); ++c) {
+        const TickLogEntry& call = saved.calls[c];
+        host.credit(call.call.sender, call.call.value);
+        bool ok = runWorkloadOp(engine, host, call.call);
+        CHECK(ok == (call.outcome == TickLogOutcome::SUCCEEDED));
+        if (c == champion.call) {
+            CHECK_EQ(engine.lastWork().units, champion.units);
+            CHECK(ok == champion.succeeded);
+        }
+    }
+
+    WorstCaseManifestEntry entry;
+    entry.procedure = "releaseMilestone";
+    entry.name = "release";
+    entry.call = champion.call;
+    entry.units = champion.units;
+    entry.clock = 123;
+    std::string manifestPath = dir + "/worst.jsonl";
+    std::FILE* out = std::fopen(manifestPath.c_str(), "w");
+    writeWorstCaseManifestEntry(out, entry);
+    std::fclose(out);
+    std::FILE* in = std::fopen(manifestPath.c_str(), "r");
+    char line[1024];
+    CHECK(std::fgets(line, sizeof(line), in) != nullptr);
+    std::fclose(in);
+    std::string text(line);
+    text.pop_back();
+    WorstCaseManifestEntry parsed;
+    CHECK(parseWorstCaseManifestEntry(text, parsed));
+    CHECK(parsed.name == "release");
+    CHECK_EQ(parsed.call, champion.call);
+    CHECK_EQ(parsed.units, champion.units);
+    CHECK_EQ(parsed.clock, 123u);
+    std::string escaping = text;
+    escaping.replace(escaping.find("\"release\""), 9, "\"../etc\"");
+    CHECK(!parseWorstCaseManifestEntry(escaping, parsed));
+
+    ::unlink(manifestPath.c_str());
+    ::unlink((dir + "/release.snap").c_str());
+    ::unlink((dir + "/release.tlog").c_str());
+    ::rmdir(dir.c_str());
+}
+
+} // namespace
+
+int main() {
+    testSearchIsDeterministicAndBounded();
+    testSavedCaseReplaysTheSameWork();
+    return finishTests("worstcase_test");
+}
@@ -0,0 +1,44 @@
+// contracts/tools/vault_diff.cpp
+// Field-level diff of two vault snapshots for state forensics.
+//
+// Usage: vault_diff <left.snap> <right.snap>
+// Exit status follows diff(1): 0 identical, 1 different, 2 on error.
+
+#include "host/VaultSnapshotDiff.h"
+
+#include <chrono>
+#include <cstdio>
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::fprintf(stderr, "usage: %s <left.snap> <right.snap>\n", argv[0]);
+        return 2;
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    SnapshotDiff diff;
+    SnapshotStatus status = diffSnapshotFiles(argv[1], argv[2], diff);
+    auto elapsed = std::chrono::steady_clock::now() - started;
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    if (status != SnapshotStatus::OK) {
+        std::fprintf(stderr, "vault_diff: %s\n", snapshotStatusName(status));
+        return 2;
+    }
+
+    uint32_t currentSlot = AGREEMENT_NOT_FOUND - 1;
+    for (const SnapshotFieldDelta& delta : diff.deltas) {
+        if (delta.slot == AGREEMENT_NOT_FOUND) {
+            std::printf("%s: %s -> %s\n", delta.field.c_str(), delta.before.c_str(), delta.after.c_str());
+            continue;
+        }
+        if (delta.slot != currentSlot) {
+            currentSlot = delta.slot;
+            std::printf("slot %u (id 0x%016llx):\n", delta.slot, static_cast<unsigned long long>(delta.agreementId));
+        }
+        std::printf("  %s: \"%s\" -> \"%s\"\n", delta.field.c_str(), delta.before.c_str(), delta.after.c_str());
+    }
+    std::fprintf(stderr, "# %u changed, %u added, %u removed; decoded %u of %u blocks in %lld us\n",
+                 diff.changedAgreements, diff.addedAgreements, diff.removedAgreements,
+                 diff.blocksDecoded, diff.blocksCompared, static_cast<long long>(micros));
+    return diff.identical() ? 0 : 1;
+}
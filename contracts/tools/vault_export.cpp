@@ -0,0 +1,21 @@
+// contracts/tools/vault_export.cpp
+// Exports a vault snapshot as per-column files for analytics tools.
+//
+// Usage: vault_export <in.snap> <out-dir>
+// Prints a JSON summary; see host/VaultColumnExport.h for the layout.
+
+#include "host/VaultColumnExport.h"
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::fprintf(stderr, "usage: %s <in.snap> <out-dir>\n", argv[0]);
+        return 2;
+    }
+    ColumnExportStats stats;
+    SnapshotStatus status = exportSnapshotColumns(argv[1], argv[2], &stats);
+    std::printf("{\"status\":\"%s\",\"agreements\":%u,\"milestones\":%llu,\"addressEntries\":%u,"
+                "\"textEntries\":%u,\"micros\":%llu}\n",
+                snapshotStatusName(status), stats.agreements, static_cast<unsigned long long>(stats.milestones),
+                stats.addressEntries, stats.textEntries, static_cast<unsigned long long>(stats.micros));
+    return status == SnapshotStatus::OK ? 0 : 1;
+}
@@ -0,0 +1,102 @@
+// contracts/tools/vault_histo.cpp
+// Merges latency histogram exports and compares them against a baseline.
+//
+// Usage: vault_histo [--baseline base.hist]... <run.hist>...
+//
+// Inputs are the --histograms files of workload_bench and vault_replay (see
+// host/VaultHistogram.h); all runs given are merged, as are all baselines.
+// Prints one JSON line per procedure/outcome with p50, p99, p99.9 and max.
+// With a baseline, each line also carries the baseline's percentiles and the
+// run/baseline ratios. Exit status: 0 on success, 2 on an unreadable file or
+// a line that is not a compatible histogram.
+
+#include "host/VaultHistogram.h"
+
+#include <cstring>
+
+namespace {
+
+bool mergeFile(const char* path, LatencyHistograms& histograms) {
+    std::FILE* file = std::fopen(path, "r");
+    if (file == nullptr) {
+        std::fprintf(stderr, "vault_histo: cannot open %s\n", path);
+        return false;
+    }
+    char* buffer = nullptr;
+    size_t capacity = 0;
+    ssize_t length;
+    uint64_t lineNumber = 0;
+    bool ok = true;
+    while ((length = ::getline(&buffer, &capacity, file)) >= 0) {
+        ++lineNumber;
+        while (length > 0 && (buffer[length - 1] == '\n' || buffer[length - 1] == '\r')) --length;
+        if (length == 0) continue;
+        if (!mergeHistogramLine(std::string(buffer, static_cast<size_t>(length)), histograms)) {
+            std::fprintf(stderr, "vault_histo: %s: not a compatible histogram at line %llu\n", path,
+                         static_cast<unsigned long long>(lineNumber));
+            ok = false;
+            break;
+        }
+    }
+    std::free(buffer);
+    std::fclose(file);
+    return ok;
+}
+
+double ratio(uint64_t run, uint64_t base) {
+    return base == 0 ? 0.0 : static_cast<double>(run) / static_cast<double>(base);
+}
+
+void printLine(const char* procedure, const char* outcome, const LatencyHistogram& run,
+               const LatencyHistogram* base) {
+    std::printf("{\"tool\":\"vault_histo\",\"procedure\":\"%s\",\"outcome\":\"%s\",\"calls\":%llu,", procedure,
+                outcome, static_cast<unsigned long long>(run.count()));
+    printLatencyPercentiles(stdout, run);
+    if (base != nullptr) {
+        std::printf(",\"baselineCalls\":%llu,\"baseline\":{", static_cast<unsigned long long>(base->count()));
+        printLatencyPercentiles(stdout, *base);
+        std::printf("},\"p50Ratio\":%.3f,\"p99Ratio\":%.3f,\"p999Ratio\":%.3f,\"maxRatio\":%.3f",
+                    ratio(run.valueAtPercentile(50.0), base->valueAtPercentile(50.0)),
+                    ratio(run.valueAtPercentile(99.0), base->valueAtPercentile(99.0)),
+                    ratio(run.valueAtPercentile(99.9), base->valueAtPercentile(99.9)),
+                    ratio(run.max(), base->max()));
+    }
+    std::printf("}\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    LatencyHistograms runs, baselines;
+    bool haveRun = false, haveBaseline = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            if (!mergeFile(argv[++i], baselines)) return 2;
+            haveBaseline = true;
+        } else if (argv[i][0] != '-') {
+            if (!mergeFile(argv[i], runs)) return 2;
+            haveRun = true;
+        } else {
+            haveRun = false;
+            break;
+        }
+    }
+    if (!haveRun) {
+        std::fprintf(stderr, "usage: %s [--baseline base.hist]... <run.hist>...\n", argv[0]);
+        return 2;
+    }
+
+    for (uint32_t k = 0; k < WORKLOAD_OP_KINDS; ++k) {
+        WorkloadOpKind kind = static_cast<WorkloadOpKind>(k);
+        for (uint32_t o = 0; o < LATENCY_OUTCOMES; ++o) {
+            const LatencyHistogram& run = runs.at(kind, o);
+            const LatencyHistogram& base = baselines.at(kind, o);
+            if (run.count() == 0 && base.count() == 0) continue;
+            printLine(workloadOpName(kind), latencyOutcomeName(o), run, haveBaseline ? &base : nullptr);
+        }
+    }
+    LatencyHistogram run = runs.total();
+    LatencyHistogram base = baselines.total();
+    printLine("all", "all", run, haveBaseline ? &base : nullptr);
+    return 0;
+}
@@ -0,0 +1,268 @@
+// contracts/tools/vault_replay.cpp
+// Deterministic replay of a tick log or transaction export against the engine.
+//
+// Usage: vault_replay [--snapshot base.snap] [--fee-recipient ADDRESS]
+//                     [--histograms out.hist] [--label NAME] [--audit] <log>
+//
+// <log> is a binary tick log (workload_bench --record) or NDJSON transaction
+// rows (see parseTransactionJson in host/VaultReplay.h), whose addresses must
+// be Qubic identities. ADDRESS is an identity or a host label (hostAddress in
+// host/VaultHost.h). Without --snapshot
+// the engine starts fresh. Prints one JSON line per procedure and per
+// procedure/outcome with latency percentiles, a summary with the slowest
+// ticks, the contract's own counters (getPerfCounters) for the replayed epoch
+// and its capacity view (getCapacityStats) at the end. --histograms writes the latency histograms in the mergeable format of
+// host/VaultHistogram.h, tagged with --label. The O(1) accounting identities
+// are checked after every call; --audit also runs the full-scan audit of
+// host/VaultAudit.h on the starting and final state. Exit status: 0 when every outcome and the final counters
+// match the log and the accounting holds, 1 otherwise, 2 on error.
+
+#include "host/VaultAudit.h"
+#include "host/VaultFields.h"
+#include "host/VaultReplay.h"
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+namespace {
+
+SnapshotStatus replayTransactionRows(const char* path, PronexmaVaultEngine& engine, NativeHost& host,
+                                     ReplayReport& report, uint64_t& badLine, TransactionRow& badRow) {
+    std::FILE* file = std::fopen(path, "r");
+    if (file == nullptr) return SnapshotStatus::IO_ERROR;
+    auto started = std::chrono::steady_clock::now();
+    VaultReplayer replayer(engine, host);
+    TickLogEntry entry;
+    TickLogTotals totals;
+    bool haveTotals = false;
+    char* buffer = nullptr;
+    size_t capacity = 0;
+    ssize_t length;
+    uint64_t lineNumber = 0;
+    SnapshotStatus status = SnapshotStatus::OK;
+    std::string line;
+    while ((length = ::getline(&buffer, &capacity, file)) >= 0) {
+        ++lineNumber;
+        while (length > 0 && (buffer[length - 1] == '\n' || buffer[length - 1] == '\r')) --length;
+        if (length == 0) continue;
+        line.assign(buffer, static_cast<size_t>(length));
+        TransactionRow row = parseTransactionJson(line, entry, totals);
+        if (row == TransactionRow::INVALID || row == TransactionRow::INVALID_ADDRESS) {
+            badLine = lineNumber;
+            badRow = row;
+            status = SnapshotStatus::CORRUPT_BLOCK;
+            break;
+        }
+        if (row == TransactionRow::CALL) replayer.replay(entry);
+        if (row == TransactionRow::TOTALS) haveTotals = true;
+    }
+    std::free(buffer);
+    std::fclose(file);
+    report = replayer.finish(haveTotals ? &totals : nullptr);
+    report.wallNanos = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - started).count());
+    return status;
+}
+
+bool isTickLog(const char* path) {
+    char magic[sizeof(TICK_LOG_MAGIC)] = {};
+    std::FILE* file = std::fopen(path, "rb");
+    if (file == nullptr) return false;
+    bool match = std::fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+                 std::memcmp(magic, TICK_LOG_MAGIC, sizeof(magic)) == 0;
+    std::fclose(file);
+    return match;
+}
+
+bool printAudit(const PronexmaVaultState& vault, const char* when) {
+    AccountingAudit audit = auditVaultAccounting(vault);
+    std::printf("{\"tool\":\"vault_replay\",\"audit\":\"%s\",\"result\":", when);
+    printAccountingAudit(stdout, audit);
+    std::printf("}\n");
+    return audit.clean();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* snapshotPath = nullptr;
+    const char* feeRecipient = "PRONEXMAPROTOCOLFEES";
+    const char* histogramPath = nullptr;
+    const char* label = "vault_replay";
+    const char* logPath = nullptr;
+    bool audit = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--snapshot") == 0 && i + 1 < argc) {
+            snapshotPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--fee-recipient") == 0 && i + 1 < argc) {
+            feeRecipient = argv[++i];
+        } else if (std::strcmp(argv[i], "--histograms") == 0 && i + 1 < argc) {
+            histogramPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--label") == 0 && i + 1 < argc) {
+            label = argv[++i];
+        } else if (std::strcmp(argv[i], "--audit") == 0) {
+            audit = true;
+        } else if (logPath == nullptr && argv[i][0] != '-') {
+            logPath = argv[i];
+        } else {
+            logPath = nullptr;
+            break;
+        }
+    }
+    if (logPath == nullptr) {
+        std::fprintf(stderr,
+                     "usage: %s [--snapshot base.snap] [--fee-recipient ADDRESS] [--histograms out.hist] "
+                     "[--label NAME] [--audit] <log>\n",
+                     argv[0]);
+        return 2;
+    }
+
+    auto vault = std::make_unique<PronexmaVaultState>();
+    PronexmaVaultEngine engine(*vault);
+    NativeHost host;
+    HostContextBinding binding(engine, host.context());
+    engine.initialize(hostAddress(feeRecipient));
+    if (snapshotPath != nullptr) {
+        SnapshotStatus status = readSnapshot(snapshotPath, *vault);
+        if (status != SnapshotStatus::OK) {
+            std::fprintf(stderr, "vault_replay: %s: %s\n", snapshotPath, snapshotStatusName(status));
+            return 2;
+        }
+    }
+    bool audited = !audit || printAudit(*vault, "start");
+
+    ReplayReport report;
+    SnapshotStatus status;
+    uint64_t badLine = 0;
+    TransactionRow badRow = TransactionRow::INVALID;
+    if (isTickLog(logPath)) {
+        int fd = ::open(logPath, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            std::fprintf(stderr, "vault_replay: cannot open %s\n", logPath);
+            return 2;
+        }
+        status = replayTickLog(fd, engine, host, report);
+        ::close(fd);
+    } else {
+        status = replayTransactionRows(logPath, engine, host, report, badLine, badRow);
+    }
+    if (status != SnapshotStatus::OK) {
+        bool badAddress = badLine != 0 && badRow == TransactionRow::INVALID_ADDRESS;
+        const char* reason = badAddress ? "INVALID_ADDRESS" : snapshotStatusName(status);
+        std::fprintf(stderr, "vault_replay: %s: %s", logPath, reason);
+        if (badLine != 0) std::fprintf(stderr, " at line %llu", static_cast<unsigned long long>(badLine));
+        std::fprintf(stderr, " after %llu calls\n", static_cast<unsigned long long>(report.calls));
+        return 2;
+    }
+
+    uint64_t engineNanos = 0;
+    for (uint32_t k = 0; k < WORKLOAD_OP_KINDS; ++k) {
+        const ReplayProcedureStats& stats = report.procedures[k];
+        if (stats.calls == 0) continue;
+        engineNanos += stats.nanos;
+        WorkloadOpKind kind = static_cast<WorkloadOpKind>(k);
+        std::printf("{\"tool\":\"vault_replay\",\"procedure\":\"%s\",\"calls\":%llu,\"failures\":%llu,"
+                    "\"totalNs\":%llu,\"meanNs\":%.1f,",
+                    workloadOpName(kind), static_cast<unsigned long long>(stats.calls),
+                    static_cast<unsigned long long>(stats.failures), static_cast<unsigned long long>(stats.nanos),
+                    static_cast<double>(stats.nanos) / static_cast<double>(stats.calls));
+        printLatencyPercentiles(stdout, report.latencies.procedure(kind));
+        std::printf("}\n");
+        for (uint32_t o = 0; o < LATENCY_OUTCOMES; ++o) {
+            const LatencyHistogram& outcome = report.latencies.at(kind, o);
+            if (outcome.count() == 0) continue;
+            std::printf("{\"tool\":\"vault_replay\",\"procedure\":\"%s\",\"outcome\":\"%s\",\"calls\":%llu,",
+                        workloadOpName(kind), latencyOutcomeName(o), static_cast<unsigned long long>(outcome.count()));
+            printLatencyPercentiles(stdout, outcome);
+            std::printf("}\n");
+        }
+    }
+    if (histogramPath != nullptr) {
+        std::FILE* out = std::fopen(histogramPath, "w");
+        bool written = out != nullptr && writeLatencyHistograms(out, report.latencies, label);
+        if (out != nullptr && std::fclose(out) != 0) written = false;
+        if (!written) {
+            std::fprintf(stderr, "vault_replay: failed writing %s\n", histogramPath);
+            return 2;
+        }
+    }
+
+    double seconds = static_cast<double>(report.wallNanos) / 1e9;
+    std::printf("{\"tool\":\"vault_replay\",\"summary\":true,\"calls\":%llu,\"seconds\":%.3f,\"callsPerSec\":%.0f,"
+                "\"engineSeconds\":%.3f,\"outcomeMismatches\":%llu,\"accountingViolations\":%llu,"
+                "\"totalsPresent\":%s,\"totalsMatch\":%s,"
+                "\"tvl\":%llu,\"expectedTvl\":%llu,\"slowestTicks\":[",
+                static_cast<unsigned long long>(report.calls), seconds,
+                seconds > 0 ? static_cast<double>(report.calls) / seconds : 0.0,
+                static_cast<double>(engineNanos) / 1e9, static_cast<unsigned long long>(report.outcomeMismatches),
+                static_cast<unsigned long long>(report.accountingViolations),
+                report.totalsPresent ? "true" : "false", report.totalsMatch ? "true" : "false",
+                static_cast<unsigned long long>(report.actual.totalValueLocked),
+                static_cast<unsigned long long>(report.expected.totalValueLocked));
+    for (size_t i = 0; i < report.slowestTicks.size(); ++i) {
+        const ReplayTick& tick = report.slowestTicks[i];
+        std::printf("%s{\"tick\":%llu,\"calls\":%llu,\"ns\":%llu}", i == 0 ? "" : ",",
+                    static_cast<unsigned long long>(tick.tick), static_cast<unsigned long long>(tick.calls),
+                    static_cast<unsigned long long>(tick.nanos));
+    }
+    std::printf("]}\n");
+
+    VaultPerfCounters counters = engine.getPerfCounters();
+    for (uint32_t p = 0; p < VAULT_PROCEDURE_COUNT; ++p) {
+        const ProcedureCounters& procedure = counters.procedures[p];
+        if (procedure.calls == 0) continue;
+        std::printf("{\"tool\":\"vault_replay\",\"contractCounters\":\"%s\",\"epoch\":%llu,\"calls\":%llu,"
+                    "\"successes\":%llu,\"agreementsScanned\":%llu,\"milestonesTouched\":%llu,\"failures\":{",
+                    vaultProcedureName(static_cast<VaultProcedure>(p)), static_cast<unsigned long long>(counters.epoch),
+                    static_cast<unsigned long long>(procedure.calls), static_cast<unsigned long long>(procedure.successes),
+                    static_cast<unsigned long long>(procedure.agreementsScanned),
+                    static_cast<unsigned long long>(procedure.milestonesTouched));
+        const char* separator = "";
+        for (uint32_t e = 0; e < VAULT_ERROR_COUNT; ++e) {
+            if (procedure.failuresByReason[e] == 0) continue;
+            std::printf("%s\"%s\":%llu", separator, vaultErrorName(static_cast<VaultError>(e)),
+                        static_cast<unsigned long long>(procedure.failuresByReason[e]));
+            separator = ",";
+        }
+        std::printf("}}\n");
+    }
+
+    VaultCapacityStats capacity = engine.getCapacityStats();
+    std::printf("{\"tool\":\"vault_replay\",\"capacity\":true,\"usedSlots\":%u,\"liveSlots\":%u,"
+                "\"tombstonedSlots\":%u,\"freeSlots\":%u,\"milestoneSlotsUsed\":%llu,\"milestoneSlotsReserved\":%llu,"
+                "\"indexLoadBasisPoints\":%u,\"expectedMissProbes\":%u,\"meanObservedProbes\":%.1f,\"byState\":{",
+                capacity.usedSlots, capacity.liveSlots, capacity.tombstonedSlots, capacity.freeSlots,
+                static_cast<unsigned long long>(capacity.milestoneSlotsUsed),
+                static_cast<unsigned long long>(capacity.milestoneSlotsReserved), capacity.indexLoadBasisPoints,
+                capacity.expectedMissProbes,
+                capacity.observedLookups == 0 ? 0.0
+                    : static_cast<double>(capacity.observedProbes) / static_cast<double>(capacity.observedLookups));
+    for (uint32_t s = 0; s < AGREEMENT_STATE_COUNT; ++s) {
+        std::printf("%s\"%s\":%u", s == 0 ? "" : ",", agreementStateName(static_cast<AgreementState>(s)),
+                    capacity.agreementsByState[s]);
+    }
+    std::printf("},\"bytesInUse\":{");
+    for (uint32_t c = 0; c < STATE_CATEGORY_COUNT; ++c) {
+        std::printf("%s\"%s\":%llu", c == 0 ? "" : ",", stateCategoryName(static_cast<StateCategory>(c)),
+                    static_cast<unsigned long long>(capacity.bytesInUse[c]));
+    }
+    std::printf("},\"stateBytes\":%llu}\n", static_cast<unsigned long long>(capacity.stateBytes));
+    if (audit) audited = printAudit(*vault, "end") && audited;
+
+    if (report.outcomeMismatches > 0) {
+        std::fprintf(stderr, "vault_replay: %llu outcome mismatch(es), first at call %llu\n",
+                     static_cast<unsigned long long>(report.outcomeMismatches),
+                     static_cast<unsigned long long>(report.firstMismatch));
+    }
+    if (report.accountingViolations > 0) {
+        std::fprintf(stderr, "vault_replay: accounting broken after %llu call(s), first %s at call %llu\n",
+                     static_cast<unsigned long long>(report.accountingViolations),
+                     accountingViolationName(report.accountingViolation),
+                     static_cast<unsigned long long>(report.firstAccountingViolation));
+    }
+    if (!audited) std::fprintf(stderr, "vault_replay: full-scan audit failed\n");
+    if (!report.totalsPresent) std::fprintf(stderr, "vault_replay: log has no end record; totals not checked\n");
+    if (report.totalsPresent && !report.totalsMatch) std::fprintf(stderr, "vault_replay: final counters differ from the log\n");
+    return report.clean() && audited ? 0 : 1;
+}
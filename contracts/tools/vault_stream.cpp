@@ -0,0 +1,37 @@
+// contracts/tools/vault_stream.cpp
+// Streams a vault snapshot to stdout for mirror bootstrap.
+//
+// Usage: vault_stream <in.snap> [--format ndjson|binary] [--buffer bytes]
+// Records go to stdout; a JSON summary goes to stderr.
+
+#include "host/VaultStreamExport.h"
+
+#include <cstdlib>
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <in.snap> [--format ndjson|binary] [--buffer bytes]\n", argv[0]);
+        return 2;
+    }
+    StreamExportOptions options;
+    for (int i = 2; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            options.format = std::strcmp(argv[++i], "binary") == 0 ? StreamFormat::BINARY : StreamFormat::NDJSON;
+        } else if (std::strcmp(argv[i], "--buffer") == 0 && i + 1 < argc) {
+            options.bufferBytes = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            std::fprintf(stderr, "unknown option: %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    StreamExportStats stats;
+    SnapshotStatus status = streamSnapshot(argv[1], STDOUT_FILENO, options, &stats);
+    std::fprintf(stderr, "{\"status\":\"%s\",\"agreements\":%u,\"milestones\":%llu,\"bytes\":%llu,"
+                 "\"flushes\":%llu,\"stalls\":%llu,\"stalledMicros\":%llu,\"micros\":%llu}\n",
+                 snapshotStatusName(status), stats.agreements, static_cast<unsigned long long>(stats.milestones),
+                 static_cast<unsigned long long>(stats.bytes), static_cast<unsigned long long>(stats.flushes),
+                 static_cast<unsigned long long>(stats.stalls), static_cast<unsigned long long>(stats.stalledMicros),
+                 static_cast<unsigned long long>(stats.micros));
+    return status == SnapshotStatus::OK ? 0 : 1;
+}